@@ -177,6 +177,7 @@ typedef struct SeqSCdFHeader
 **
 ** @attr Header [SeqPCdFHeader] Header data
 ** @attr File [AjPFile] File
+** @attr Cdfile [AjPCdfile] Shared index file and memory map
 ** @attr NRecords [ajuint] Number of records
 ** @attr RecSize [ajuint] Record length (for calculating record offsets)
 ** @@
@@ -186,6 +187,7 @@ typedef struct SeqSCdFile
 {
     SeqPCdFHeader Header;
     AjPFile File;
+    AjPCdfile Cdfile;
     ajuint NRecords;
     ajuint RecSize;
 } SeqOCdFile;
@@ -497,6 +499,9 @@ static void       seqBlastStripNcbi(AjPStr* line);
 static int        seqCdEntryCmp(const void* a, const void* b);
 static void       seqCdEntryDel(void** pentry, void* cl);
 static void       seqCdFileClose(SeqPCdFile *thys);
+static const char* seqCdFileNode(SeqPCdFile fil, ajulong inode, ajuint ipos,
+                                 char* (*readname)(ajuint ipos,
+                                                   SeqPCdFile fil));
 static SeqPCdFile seqCdFileOpen(const AjPStr dir, const char* name,
                                 AjPStr* fullname);
 static ajint      seqCdFileSeek(SeqPCdFile fil, ajuint ipos);
@@ -733,6 +738,9 @@ static AjPFile seqBlastFileOpen(const AjPStr dir, const AjPStr name)
 **
 ** Opens a named EMBL CD-ROM index file.
 **
+** The open file and its memory map are shared with other queries
+** through ajCdfileOpen.
+**
 ** @param [r] dir [const AjPStr] Directory
 ** @param [r] name [const char*] File name.
 ** @param [w] fullname [AjPStr*] Full file name with directory path
@@ -746,19 +754,18 @@ static SeqPCdFile seqCdFileOpen(const AjPStr dir, const char* name,
                                 AjPStr* fullname)
 {
     SeqPCdFile thys = NULL;
+    AjPCdfile cdfile = NULL;
 
+    cdfile = ajCdfileOpen(dir, name);
 
-    AJNEW0(thys);
-
-    thys->File = ajFileNewInNamePathC(name, dir);
-
-    if(!thys->File)
-    {
-        AJFREE(thys);
-
+    if(!cdfile)
         return NULL;
-    }
 
+    AJNEW0(thys);
+
+    thys->Cdfile = cdfile;
+    thys->File = cdfile->File;
+    ajFileSeek(thys->File, 0, 0);
 
     AJNEW0(thys->Header);
 
@@ -771,7 +778,6 @@ static SeqPCdFile seqCdFileOpen(const AjPStr dir, const char* name,
     ajDebug("seqCdFileOpen '%F' NRecords: %d RecSize: %d\n",
             thys->File, thys->NRecords, thys->RecSize);
 
-
     return thys;
 }
 
@@ -810,9 +816,47 @@ static ajint seqCdFileSeek(SeqPCdFile fil, ajuint ipos)
 
 
 
+/* @funcstatic seqCdFileNode **************************************************
+**
+** Returns the name of a record at a node of the binary search of an
+** EMBL CD-ROM index or target file. The children of node n are nodes
+** 2n+1 (lower records) and 2n+2 (higher records).
+**
+** Names at the top nodes are kept with the shared index file, so
+** repeated searches follow the same path but only read records below
+** the top levels.
+**
+** @param [u] fil [SeqPCdFile] EMBL CD-ROM index or target file.
+** @param [r] inode [ajulong] Node number in the binary search.
+** @param [r] ipos [ajuint] Record number.
+** @param [f] readname [char* function] Record name reader for this file
+** @return [const char*] Name.
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static const char* seqCdFileNode(SeqPCdFile fil, ajulong inode, ajuint ipos,
+                                 char* (*readname)(ajuint ipos,
+                                                   SeqPCdFile fil))
+{
+    const char* name;
+
+    name = ajCdfileNodeGet(fil->Cdfile, inode, ipos);
+
+    if(name)
+        return name;
+
+    return ajCdfileNodePut(fil->Cdfile, inode, ipos, (*readname)(ipos, fil));
+}
+
+
+
+
 /* @funcstatic seqCdFileClose *************************************************
 **
-** Closes an EMBL CD-ROM index file.
+** Closes an EMBL CD-ROM index file. The shared file is closed by
+** ajCdfileClose when no longer in use.
 **
 ** @param [d] pthis [SeqPCdFile*] EMBL CD-ROM index file.
 ** @return [void]
@@ -830,9 +874,9 @@ static void seqCdFileClose(SeqPCdFile* pthis)
     if(!thys)
         return;
 
-    ajDebug("seqCdFileClose of %F\n", (*pthis)->File);
+    ajDebug("seqCdFileClose of %F\n", thys->File);
 
-    ajFileClose(&thys->File);
+    ajCdfileClose(&thys->Cdfile);
     AJFREE(thys->Header);
     AJFREE(*pthis);
 
@@ -863,7 +907,8 @@ static ajuint seqCdIdxSearch(SeqPCdIdx idxLine, const AjPStr entry,
     ajint ilo;
     ajint ipos = 0;
     ajint icmp = 0;
-    char *name;
+    ajulong inode = 0;
+    const char *name;
 
     ajStrAssignS(&entrystr, entry);
     ajStrFmtUpper(&entrystr);
@@ -880,7 +925,7 @@ static ajuint seqCdIdxSearch(SeqPCdIdx idxLine, const AjPStr entry,
     while(ilo <= ihi)
     {
         ipos = (ilo + ihi)/2;
-        name = seqCdIdxName(ipos, fil);
+        name = seqCdFileNode(fil, inode, ipos, &seqCdIdxName);
         icmp = ajStrCmpC(entrystr, name);
         ajDebug("idx test %u '%s' %2d (+/- %u)\n", ipos, name, icmp, ihi-ilo);
 
@@ -888,9 +933,15 @@ static ajuint seqCdIdxSearch(SeqPCdIdx idxLine, const AjPStr entry,
             break;
 
         if(icmp < 0)
+        {
             ihi = ipos-1;
+            inode = 2*inode + 1;
+        }
         else
+        {
             ilo = ipos+1;
+            inode = 2*inode + 2;
+        }
     }
 
     ajStrDel(&entrystr);
@@ -1136,7 +1187,8 @@ static ajuint seqCdTrgSearch(SeqPCdTrg trgLine, const AjPStr entry,
     ajint ipos;
     ajint icmp;
     ajint itry;
-    char *name;
+    ajulong inode = 0;
+    const char *name;
 
     ajStrAssignS(&entrystr, entry);
     ajStrFmtUpper(&entrystr);
@@ -1149,7 +1201,7 @@ static ajuint seqCdTrgSearch(SeqPCdTrg trgLine, const AjPStr entry,
     ipos = (ilo + ihi)/2;
     icmp = -1;
     ajDebug("seqCdTrgSearch '%S' recSize: %d\n", entry, fp->RecSize);
-    name = seqCdTrgName(ipos, fp);
+    name = seqCdFileNode(fp, inode, ipos, &seqCdTrgName);
     icmp = ajStrCmpC(entrystr, name);
 
     ajDebug("trg testa %d '%s' %2d (+/- %d)\n", ipos, name, icmp, ihi-ilo);
@@ -1157,9 +1209,15 @@ static ajuint seqCdTrgSearch(SeqPCdTrg trgLine, const AjPStr entry,
     while(icmp)
     {
         if(icmp < 0)
+        {
             ihi = ipos;
+            inode = 2*inode + 1;
+        }
         else
+        {
             ilo = ipos;
+            inode = 2*inode + 2;
+        }
 
         itry = (ilo + ihi)/2;
 
@@ -1172,7 +1230,7 @@ static ajuint seqCdTrgSearch(SeqPCdTrg trgLine, const AjPStr entry,
         }
 
         ipos = itry;
-        name = seqCdTrgName(ipos, fp);
+        name = seqCdFileNode(fp, inode, ipos, &seqCdTrgName);
         icmp = ajStrCmpC(entrystr, name);
         ajDebug("trg testb %d '%s' %2d (+/- %d)\n",
                 ipos, name, icmp, ihi-ilo);
@@ -1209,6 +1267,7 @@ static ajuint seqCdTrgSearch(SeqPCdTrg trgLine, const AjPStr entry,
 
 static char* seqCdIdxName(ajuint ipos, SeqPCdFile fil)
 {
+    const unsigned char* rec;
     ajuint nameSize;
 
     nameSize = fil->RecSize-10;
@@ -1221,6 +1280,15 @@ static char* seqCdIdxName(ajuint ipos, SeqPCdFile fil)
         seqCdName = ajCharNewRes(seqCdMaxNameSize+1);
     }
 
+    rec = ajCdfileRecord(fil->Cdfile, ipos, 0, nameSize);
+
+    if(rec)
+    {
+        ajCdfileRecCharTrim(rec, nameSize, seqCdName);
+
+        return seqCdName;
+    }
+
     seqCdFileSeek(fil, ipos);
     ajReadbinCharTrim(fil->File, nameSize, seqCdName);
 
@@ -1245,6 +1313,7 @@ static char* seqCdIdxName(ajuint ipos, SeqPCdFile fil)
 
 static void seqCdIdxLine(SeqPCdIdx idxLine, ajuint ipos, SeqPCdFile fil)
 {
+    const unsigned char* rec;
     ajuint nameSize;
 
     nameSize = fil->RecSize-10;
@@ -1262,14 +1331,28 @@ static void seqCdIdxLine(SeqPCdIdx idxLine, ajuint ipos, SeqPCdFile fil)
         seqCdName = ajCharNewRes(seqCdMaxNameSize+1);
     }
 
-    seqCdFileSeek(fil, ipos);
-    ajReadbinCharTrim(fil->File, nameSize, seqCdName);
+    rec = ajCdfileRecord(fil->Cdfile, ipos, 0, nameSize+10);
+
+    if(rec)
+    {
+        ajCdfileRecCharTrim(rec, nameSize, seqCdName);
+        ajStrAssignC(&idxLine->EntryName,seqCdName);
+
+        idxLine->AnnOffset = ajCdfileRecUint(rec+nameSize);
+        idxLine->SeqOffset = ajCdfileRecUint(rec+nameSize+4);
+        idxLine->DivCode   = ajCdfileRecUint2(rec+nameSize+8);
+    }
+    else
+    {
+        seqCdFileSeek(fil, ipos);
+        ajReadbinCharTrim(fil->File, nameSize, seqCdName);
 
-    ajStrAssignC(&idxLine->EntryName,seqCdName);
+        ajStrAssignC(&idxLine->EntryName,seqCdName);
 
-    ajReadbinUint(fil->File, &idxLine->AnnOffset);
-    ajReadbinUint(fil->File, &idxLine->SeqOffset);
-    ajReadbinUint2(fil->File, &idxLine->DivCode);
+        ajReadbinUint(fil->File, &idxLine->AnnOffset);
+        ajReadbinUint(fil->File, &idxLine->SeqOffset);
+        ajReadbinUint2(fil->File, &idxLine->DivCode);
+    }
 
     ajDebug("read ann: %u seq: %u div: %u\n",
             idxLine->AnnOffset, idxLine->SeqOffset,
@@ -1294,6 +1377,7 @@ static void seqCdIdxLine(SeqPCdIdx idxLine, ajuint ipos, SeqPCdFile fil)
 
 static char* seqCdTrgName(ajuint ipos, SeqPCdFile fil)
 {
+    const unsigned char* rec;
     ajuint nameSize;
     ajint i;
 
@@ -1309,10 +1393,17 @@ static char* seqCdTrgName(ajuint ipos, SeqPCdFile fil)
         seqCdName = ajCharNewRes(seqCdMaxNameSize+1);
     }
 
-    seqCdFileSeek(fil, ipos);
-    ajReadbinInt(fil->File, &i);
-    ajReadbinInt(fil->File, &i);
-    ajReadbinCharTrim(fil->File, nameSize, seqCdName);
+    rec = ajCdfileRecord(fil->Cdfile, ipos, 8, nameSize);
+
+    if(rec)
+        ajCdfileRecCharTrim(rec, nameSize, seqCdName);
+    else
+    {
+        seqCdFileSeek(fil, ipos);
+        ajReadbinInt(fil->File, &i);
+        ajReadbinInt(fil->File, &i);
+        ajReadbinCharTrim(fil->File, nameSize, seqCdName);
+    }
 
     ajDebug("seqCdTrgName maxNameSize:%d nameSize:%d name '%s'\n",
             seqCdMaxNameSize, nameSize, seqCdName);
@@ -1338,6 +1429,7 @@ static char* seqCdTrgName(ajuint ipos, SeqPCdFile fil)
 
 static void seqCdTrgLine(SeqPCdTrg trgLine, ajuint ipos, SeqPCdFile fil)
 {
+    const unsigned char* rec;
     ajuint nameSize;
 
     nameSize = fil->RecSize-8;
@@ -1352,11 +1444,22 @@ static void seqCdTrgLine(SeqPCdTrg trgLine, ajuint ipos, SeqPCdFile fil)
         seqCdName = ajCharNewRes(seqCdMaxNameSize+1);
     }
 
-    seqCdFileSeek(fil, ipos);
+    rec = ajCdfileRecord(fil->Cdfile, ipos, 0, nameSize+8);
 
-    ajReadbinUint(fil->File, &trgLine->NHits);
-    ajReadbinUint(fil->File, &trgLine->FirstHit);
-    ajReadbinCharTrim(fil->File, nameSize, seqCdName);
+    if(rec)
+    {
+        trgLine->NHits    = ajCdfileRecUint(rec);
+        trgLine->FirstHit = ajCdfileRecUint(rec+4);
+        ajCdfileRecCharTrim(rec+8, nameSize, seqCdName);
+    }
+    else
+    {
+        seqCdFileSeek(fil, ipos);
+
+        ajReadbinUint(fil->File, &trgLine->NHits);
+        ajReadbinUint(fil->File, &trgLine->FirstHit);
+        ajReadbinCharTrim(fil->File, nameSize, seqCdName);
+    }
 
     ajStrAssignC(&trgLine->Target,seqCdName);
 
@@ -3086,8 +3189,6 @@ static AjBool seqCdQryEntry(AjPQuery qry)
 
                         if(trghit >= 0)
                         {
-                            seqCdFileSeek(qryd->hitfp,
-                                          qryd->trgLine->FirstHit-1);
                             ajDebug("%s First: %d Count: %d\n",
                                     emblcdfields[i],
                                     qryd->trgLine->FirstHit,
@@ -3096,7 +3197,9 @@ static AjBool seqCdQryEntry(AjPQuery qry)
 
                             for(ii = 0; ii < qryd->trgLine->NHits; ii++)
                             {
-                                ajReadbinInt(qryd->hitfp->File, &j);
+                                j = ajCdfileReadHit(qryd->hitfp->Cdfile,
+                                                    qryd->trgLine->FirstHit-1,
+                                                    ii);
                                 j--;
                                 ajDebug("hitlist[%u] entry = %d\n", ii, j);
                                 seqCdIdxLine(qryd->idxLine, j, qryd->ifp);
@@ -3135,8 +3238,6 @@ static AjBool seqCdQryEntry(AjPQuery qry)
 
                 if(trghit >= 0)
                 {
-                    seqCdFileSeek(qryd->hitfp,
-                                  qryd->trgLine->FirstHit-1);
                     ajDebug("%s First: %d Count: %d\n",
                             fd->Field, qryd->trgLine->FirstHit,
                             qryd->trgLine->NHits);
@@ -3144,7 +3245,8 @@ static AjBool seqCdQryEntry(AjPQuery qry)
 
                     for(ii = 0; ii < qryd->trgLine->NHits; ii++)
                     {
-                        ajReadbinInt(qryd->hitfp->File, &j);
+                        j = ajCdfileReadHit(qryd->hitfp->Cdfile,
+                                            qryd->trgLine->FirstHit-1, ii);
                         j--;
                         ajDebug("hitlist[%u] entry = %d\n", ii, j);
                         seqCdIdxLine(qryd->idxLine, j, qryd->ifp);
@@ -7254,14 +7356,13 @@ static ajuint seqCdTrgFind(AjPQuery qry, const char* indexname,
             continue;
 
         seqCdTrgLine(trgline, i, trgfp);
-        seqCdFileSeek(hitfp,trgline->FirstHit-1);
         ajDebug("Query First: %d Count: %d\n",
                 trgline->FirstHit, trgline->NHits);
         pos = trgline->FirstHit;
 
         for(j=0;j<(ajint)trgline->NHits;++j)
         {
-            ajReadbinInt(hitfp->File, &k);
+            k = ajCdfileReadHit(hitfp->Cdfile, trgline->FirstHit-1, j);
             --k;
             ajDebug("hitlist[%d] entry = %d\n",j,k);
             seqCdIdxLine(idxline,k,idxfp);
@@ -231,6 +231,7 @@ typedef struct TextSCdFHeader
 **
 ** @attr Header [TextPCdFHeader] Header data
 ** @attr File [AjPFile] File
+** @attr Cdfile [AjPCdfile] Shared index file and memory map
 ** @attr NRecords [ajuint] Number of records
 ** @attr RecSize [ajuint] Record length (for calculating record offsets)
 ** @@
@@ -240,6 +241,7 @@ typedef struct TextSCdFile
 {
     TextPCdFHeader Header;
     AjPFile File;
+    AjPCdfile Cdfile;
     ajuint NRecords;
     ajuint RecSize;
 } TextOCdFile;
@@ -638,6 +640,9 @@ static int         textObdaEntryCmp(const void* a, const void* b);
 static int         textCdEntryCmp(const void* a, const void* b);
 static void        textCdEntryDel(void** pentry, void* cl);
 static void        textCdFileClose(TextPCdFile *thys);
+static const char* textCdFileNode(TextPCdFile fil, ajulong inode, ajuint ipos,
+                                  char* (*readname)(ajuint ipos,
+                                                    TextPCdFile fil));
 static TextPObdaFile textObdaFileOpen(const AjPStr dir, const AjPStr name,
                                       AjPStr* fullname);
 static TextPCdFile textCdFileOpen(const AjPStr dir, const char* name,
@@ -1168,6 +1173,9 @@ static AjBool textCdAll(AjPTextin textin)
 **
 ** Opens a named EMBL CD-ROM index file.
 **
+** The open file and its memory map are shared with other queries
+** through ajCdfileOpen.
+**
 ** @param [r] dir [const AjPStr] Directory
 ** @param [r] name [const char*] File name.
 ** @param [w] fullname [AjPStr*] Full file name with directory path
@@ -1181,19 +1189,18 @@ static TextPCdFile textCdFileOpen(const AjPStr dir, const char* name,
                                   AjPStr* fullname)
 {
     TextPCdFile thys = NULL;
+    AjPCdfile cdfile = NULL;
 
+    cdfile = ajCdfileOpen(dir, name);
 
-    AJNEW0(thys);
-
-    thys->File = ajFileNewInNamePathC(name, dir);
-
-    if(!thys->File)
-    {
-	AJFREE(thys);
+    if(!cdfile)
+        return NULL;
 
-	return NULL;
-    }
+    AJNEW0(thys);
 
+    thys->Cdfile = cdfile;
+    thys->File = cdfile->File;
+    ajFileSeek(thys->File, 0, 0);
 
     AJNEW0(thys->Header);
 
@@ -1204,8 +1211,7 @@ static TextPCdFile textCdFileOpen(const AjPStr dir, const char* name,
     ajStrAssignS(fullname, ajFileGetPrintnameS(thys->File));
 
     ajDebug("textCdFileOpen '%F' NRecords: %d RecSize: %d\n",
-	    thys->File, thys->NRecords, thys->RecSize);
-
+            thys->File, thys->NRecords, thys->RecSize);
 
     return thys;
 }
@@ -1213,6 +1219,43 @@ static TextPCdFile textCdFileOpen(const AjPStr dir, const char* name,
 
 
 
+/* @funcstatic textCdFileNode *************************************************
+**
+** Returns the name of a record at a node of the binary search of an
+** EMBL CD-ROM index or target file. The children of node n are nodes
+** 2n+1 (lower records) and 2n+2 (higher records).
+**
+** Names at the top nodes are kept with the shared index file, so
+** repeated searches follow the same path but only read records below
+** the top levels.
+**
+** @param [u] fil [TextPCdFile] EMBL CD-ROM index or target file.
+** @param [r] inode [ajulong] Node number in the binary search.
+** @param [r] ipos [ajuint] Record number.
+** @param [f] readname [char* function] Record name reader for this file
+** @return [const char*] Name.
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static const char* textCdFileNode(TextPCdFile fil, ajulong inode, ajuint ipos,
+                                  char* (*readname)(ajuint ipos,
+                                                    TextPCdFile fil))
+{
+    const char* name;
+
+    name = ajCdfileNodeGet(fil->Cdfile, inode, ipos);
+
+    if(name)
+        return name;
+
+    return ajCdfileNodePut(fil->Cdfile, inode, ipos, (*readname)(ipos, fil));
+}
+
+
+
+
 /* @funcstatic textObdaFileSeek ***********************************************
 **
 ** Sets the file position in an OBDA index file.
@@ -1305,7 +1348,8 @@ static void textObdaFileClose(TextPObdaFile* pthis)
 
 /* @funcstatic textCdFileClose ************************************************
 **
-** Closes an EMBL CD-ROM index file.
+** Closes an EMBL CD-ROM index file. The shared file is closed by
+** ajCdfileClose when no longer in use.
 **
 ** @param [d] pthis [TextPCdFile*] EMBL CD-ROM index file.
 ** @return [void]
@@ -1323,9 +1367,9 @@ static void textCdFileClose(TextPCdFile* pthis)
     if(!thys)
         return;
 
-    ajDebug("textCdFileClose of %F\n", (*pthis)->File);
+    ajDebug("textCdFileClose of %F\n", thys->File);
 
-    ajFileClose(&thys->File);
+    ajCdfileClose(&thys->Cdfile);
     AJFREE(thys->Header);
     AJFREE(*pthis);
 
@@ -1356,7 +1400,8 @@ static ajuint textCdIdxSearch(TextPCdIdx idxLine, const AjPStr entry,
     ajint ilo;
     ajint ipos = 0;
     ajint icmp = 0;
-    char *name;
+    ajulong inode = 0;
+    const char *name;
 
     ajStrAssignS(&entrystr, entry);
     ajStrFmtUpper(&entrystr);
@@ -1373,7 +1418,7 @@ static ajuint textCdIdxSearch(TextPCdIdx idxLine, const AjPStr entry,
     while(ilo <= ihi)
     {
 	ipos = (ilo + ihi)/2;
-	name = textCdIdxName(ipos, fil);
+	name = textCdFileNode(fil, inode, ipos, &textCdIdxName);
 	icmp = ajStrCmpC(entrystr, name);
 	ajDebug("idx test %u '%s' %2d (+/- %u)\n", ipos, name, icmp, ihi-ilo);
 
@@ -1381,9 +1426,15 @@ static ajuint textCdIdxSearch(TextPCdIdx idxLine, const AjPStr entry,
             break;
 
 	if(icmp < 0)
+        {
 	    ihi = ipos-1;
+            inode = 2*inode + 1;
+        }
 	else
+        {
 	    ilo = ipos+1;
+            inode = 2*inode + 2;
+        }
     }
 
     ajStrDel(&entrystr);
@@ -1895,7 +1946,8 @@ static ajint textCdTrgSearch(TextPCdTrg trgLine, const AjPStr entry,
     ajint ipos;
     ajint icmp;
     ajint itry;
-    char *name;
+    ajulong inode = 0;
+    const char *name;
 
     ajStrAssignS(&entrystr, entry);
     ajStrFmtUpper(&entrystr);
@@ -1908,7 +1960,7 @@ static ajint textCdTrgSearch(TextPCdTrg trgLine, const AjPStr entry,
     ipos = (ilo + ihi)/2;
     icmp = -1;
     ajDebug("textCdTrgSearch '%S' recSize: %d\n", entry, fp->RecSize);
-    name = textCdTrgName(ipos, fp);
+    name = textCdFileNode(fp, inode, ipos, &textCdTrgName);
     icmp = ajStrCmpC(entrystr, name);
 
     ajDebug("trg testa %d '%s' %2d (+/- %d)\n", ipos, name, icmp, ihi-ilo);
@@ -1916,9 +1968,15 @@ static ajint textCdTrgSearch(TextPCdTrg trgLine, const AjPStr entry,
     while(icmp)
     {
 	if(icmp < 0)
+        {
 	    ihi = ipos;
+            inode = 2*inode + 1;
+        }
 	else
+        {
 	    ilo = ipos;
+            inode = 2*inode + 2;
+        }
 
 	itry = (ilo + ihi)/2;
 
@@ -1931,7 +1989,7 @@ static ajint textCdTrgSearch(TextPCdTrg trgLine, const AjPStr entry,
 	}
 
 	ipos = itry;
-	name = textCdTrgName(ipos, fp);
+	name = textCdFileNode(fp, inode, ipos, &textCdTrgName);
 	icmp = ajStrCmpC(entrystr, name);
 	ajDebug("trg testb %d '%s' %2d (+/- %d)\n",
 		 ipos, name, icmp, ihi-ilo);
@@ -2045,6 +2103,7 @@ static ajlong textObdaSecSearch(TextPObdaSecidx trgLine, const AjPStr entry,
 
 static char* textCdIdxName(ajuint ipos, TextPCdFile fil)
 {
+    const unsigned char* rec;
     ajuint nameSize;
 
     nameSize = fil->RecSize-10;
@@ -2057,6 +2116,15 @@ static char* textCdIdxName(ajuint ipos, TextPCdFile fil)
 	textCdName = ajCharNewRes(textCdMaxNameSize+1);
     }
 
+    rec = ajCdfileRecord(fil->Cdfile, ipos, 0, nameSize);
+
+    if(rec)
+    {
+        ajCdfileRecCharTrim(rec, nameSize, textCdName);
+
+        return textCdName;
+    }
+
     textCdFileSeek(fil, ipos);
     ajReadbinCharTrim(fil->File, nameSize, textCdName);
 
@@ -2122,6 +2190,7 @@ static const AjPStr textObdaIdxName(ajulong ipos, TextPObdaFile fil)
 
 static void textCdIdxLine(TextPCdIdx idxLine, ajuint ipos, TextPCdFile fil)
 {
+    const unsigned char* rec;
     ajuint nameSize;
     ajuint secoffset;
 
@@ -2137,14 +2206,27 @@ static void textCdIdxLine(TextPCdIdx idxLine, ajuint ipos, TextPCdFile fil)
 	textCdName = ajCharNewRes(textCdMaxNameSize+1);
     }
 
-    textCdFileSeek(fil, ipos);
-    ajReadbinCharTrim(fil->File, nameSize, textCdName);
+    rec = ajCdfileRecord(fil->Cdfile, ipos, 0, nameSize+10);
+
+    if(rec)
+    {
+        ajCdfileRecCharTrim(rec, nameSize, textCdName);
+        ajStrAssignC(&idxLine->EntryName,textCdName);
+
+        idxLine->AnnOffset = ajCdfileRecUint(rec+nameSize);
+        idxLine->DivCode   = (ajshort) ajCdfileRecUint2(rec+nameSize+8);
+    }
+    else
+    {
+        textCdFileSeek(fil, ipos);
+        ajReadbinCharTrim(fil->File, nameSize, textCdName);
 
-    ajStrAssignC(&idxLine->EntryName,textCdName);
+        ajStrAssignC(&idxLine->EntryName,textCdName);
 
-    ajReadbinUint(fil->File, &idxLine->AnnOffset);
-    ajReadbinUint(fil->File, &secoffset);
-    ajReadbinInt2(fil->File, &idxLine->DivCode);
+        ajReadbinUint(fil->File, &idxLine->AnnOffset);
+        ajReadbinUint(fil->File, &secoffset);
+        ajReadbinInt2(fil->File, &idxLine->DivCode);
+    }
 
     return;
 }
@@ -2247,6 +2329,7 @@ static const AjPStr textObdaSecName(ajulong ipos, TextPObdaFile fil)
 
 static char* textCdTrgName(ajuint ipos, TextPCdFile fil)
 {
+    const unsigned char* rec;
     ajuint nameSize;
     ajint i;
 
@@ -2262,10 +2345,17 @@ static char* textCdTrgName(ajuint ipos, TextPCdFile fil)
 	textCdName = ajCharNewRes(textCdMaxNameSize+1);
     }
 
-    textCdFileSeek(fil, ipos);
-    ajReadbinInt(fil->File, &i);
-    ajReadbinInt(fil->File, &i);
-    ajReadbinCharTrim(fil->File, nameSize, textCdName);
+    rec = ajCdfileRecord(fil->Cdfile, ipos, 8, nameSize);
+
+    if(rec)
+        ajCdfileRecCharTrim(rec, nameSize, textCdName);
+    else
+    {
+        textCdFileSeek(fil, ipos);
+        ajReadbinInt(fil->File, &i);
+        ajReadbinInt(fil->File, &i);
+        ajReadbinCharTrim(fil->File, nameSize, textCdName);
+    }
 
     ajDebug("textCdTrgName maxNameSize:%d nameSize:%d name '%s'\n",
 	    textCdMaxNameSize, nameSize, textCdName);
@@ -2329,6 +2419,7 @@ static void textObdaSecLine(TextPObdaSecidx trgLine, ajulong ipos,
 
 static void textCdTrgLine(TextPCdTrg trgLine, ajuint ipos, TextPCdFile fil)
 {
+    const unsigned char* rec;
     ajuint nameSize;
 
     nameSize = fil->RecSize-8;
@@ -2343,11 +2434,22 @@ static void textCdTrgLine(TextPCdTrg trgLine, ajuint ipos, TextPCdFile fil)
 	textCdName = ajCharNewRes(textCdMaxNameSize+1);
     }
 
-    textCdFileSeek(fil, ipos);
+    rec = ajCdfileRecord(fil->Cdfile, ipos, 0, nameSize+8);
 
-    ajReadbinUint(fil->File, &trgLine->NHits);
-    ajReadbinUint(fil->File, &trgLine->FirstHit);
-    ajReadbinCharTrim(fil->File, nameSize, textCdName);
+    if(rec)
+    {
+        trgLine->NHits    = ajCdfileRecUint(rec);
+        trgLine->FirstHit = ajCdfileRecUint(rec+4);
+        ajCdfileRecCharTrim(rec+8, nameSize, textCdName);
+    }
+    else
+    {
+        textCdFileSeek(fil, ipos);
+
+        ajReadbinUint(fil->File, &trgLine->NHits);
+        ajReadbinUint(fil->File, &trgLine->FirstHit);
+        ajReadbinCharTrim(fil->File, nameSize, textCdName);
+    }
 
     ajStrAssignC(&trgLine->Target,textCdName);
 
@@ -5238,8 +5340,6 @@ static AjBool textCdQryEntry(AjPQuery qry)
 
                         if(trghit >= 0)
                         {
-                            textCdFileSeek(qryd->hitfp,
-                                           qryd->trgLine->FirstHit-1);
                             ajDebug("%s First: %d Count: %d\n",
                                     emblcdfields[i],
                                     qryd->trgLine->FirstHit,
@@ -5248,7 +5348,9 @@ static AjBool textCdQryEntry(AjPQuery qry)
 
                             for(ii = 0; ii < qryd->trgLine->NHits; ii++)
                             {
-                                ajReadbinInt(qryd->hitfp->File, &j);
+                                j = ajCdfileReadHit(qryd->hitfp->Cdfile,
+                                                    qryd->trgLine->FirstHit-1,
+                                                    ii);
                                 j--;
                                 ajDebug("hitlist[%u] entry = %d\n", ii, j);
                                 textCdIdxLine(qryd->idxLine, j, qryd->ifp);
@@ -5287,8 +5389,6 @@ static AjBool textCdQryEntry(AjPQuery qry)
 
                 if(trghit >= 0)
                 {
-                    textCdFileSeek(qryd->hitfp,
-                                   qryd->trgLine->FirstHit-1);
                     ajDebug("%s First: %d Count: %d\n",
                             fd->Field, qryd->trgLine->FirstHit,
                             qryd->trgLine->NHits);
@@ -5296,7 +5396,8 @@ static AjBool textCdQryEntry(AjPQuery qry)
 
                     for(ii = 0; ii < qryd->trgLine->NHits; ii++)
                     {
-                        ajReadbinInt(qryd->hitfp->File, &j);
+                        j = ajCdfileReadHit(qryd->hitfp->Cdfile,
+                                            qryd->trgLine->FirstHit-1, ii);
                         j--;
                         ajDebug("hitlist[%u] entry = %d\n", ii, j);
                         textCdIdxLine(qryd->idxLine, j, qryd->ifp);
@@ -8107,14 +8208,13 @@ static ajuint textCdTrgFind(AjPQuery qry, const char* indexname,
             continue;
 
 	textCdTrgLine(trgline, i, trgfp);
-	textCdFileSeek(hitfp,trgline->FirstHit-1);
 	ajDebug("Query First: %d Count: %d\n",
 		trgline->FirstHit, trgline->NHits);
 	pos = trgline->FirstHit;
 
 	for(j=0;j<(ajint)trgline->NHits;++j)
 	{
-	    ajReadbinInt(hitfp->File, &k);
+	    k = ajCdfileReadHit(hitfp->Cdfile, trgline->FirstHit-1, j);
 	    --k;
 	    ajDebug("hitlist[%d] entry = %d\n",j,k);
 	    textCdIdxLine(idxline,k,idxfp);
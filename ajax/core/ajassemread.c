@@ -1220,9 +1220,12 @@ static AjPSeqBamHeader asseminReadBamHeader(AjPAssemin assemin, AjPAssem assem)
 	    assem->Count = tid_new;
 	    tid_new++;
 
+	    /* range is 1-based, fetch region is 0-based and half-open */
+
 	    ajBamFetch(gzfile, idx, tid,
-		    assemin->cbegin,
-		    assemin->cend,
+		    assemin->cbegin > 0 ? assemin->cbegin - 1 : 0,
+		    assemin->cend > 0 ? assemin->cend :
+		    (ajint) header->target_len[tid],
 		    assem,
 		    asseminAppendAlignmentRecs);
 	}
@@ -3088,7 +3091,9 @@ static AjBool asseminQryProcess(AjPAssemin assemin, AjPAssem assem)
 
     /* (seq/feat) DO NOT look for a [range] suffix */
 
-    ajQuerystrParseRange(&qrystr, &assemin->cbegin, &assemin->cend, &foo);
+    if(!ajQuerystrParseRange(&qrystr, &assemin->cbegin, &assemin->cend, &foo))
+        ajQuerystrParseRegion(&qrystr, fmtstr,
+                              &assemin->cbegin, &assemin->cend);
 
 
     /* look for a list:: or @:: listfile of queries  - process and return */
@@ -101,23 +101,8 @@
 #define BAM_MAX_BIN 37450 /* =(8^6-1)/7+1 */
 
 
-struct __bam_iter_t
-{
-    int from_first; /* read from the first record; no random access */
-    int tid, beg, end, n_off, i, finished;
-    ajulong curr_off;
-    pair64_t *off;
-};
-
-typedef struct __bam_iter_t *bam_iter_t;
-
-
 static void bamBinDel(void** bin);
 static void bamIndexSave(const AjPBamIndex idx, FILE *fp);
-static void bamIterDel(bam_iter_t* iter);
-static bam_iter_t bamIterQuery(const AjPBamIndex idx, int tid,
-			       int beg, int end);
-static int bamIterRead(AjPSeqBamBgzf fp, bam_iter_t iter, AjPSeqBam);
 static AjPBamIndex bamIndexCore(AjPSeqBamBgzf fp);
 
 
@@ -1046,22 +1031,26 @@ static ajint bamChunkCompare(const void* a, const void* b)
 
 
 
-/* @funcstatic bamIterQuery ***************************************************
+/* @func ajBamIterQuery *****************************************************
 **
 ** query a region on a reference sequence
 **
+** The chunks of the file that can hold alignments overlapping the region
+** are found from the binning index and the linear index. Alignments are
+** then read with ajBamIterRead.
+**
 ** @param [r] idx [const AjPBamIndex] BAM index
 ** @param [r] tid [int] reference sequence id
-** @param [r] beg [int] 1-based start of target region, inclusive
-** @param [r] end [int] 1-based end of target region, inclusive
-** @return [bam_iter_t] iteration object
+** @param [r] beg [int] 0-based start of target region, inclusive
+** @param [r] end [int] 0-based end of target region, exclusive
+** @return [bam_iter_t] iteration object, or NULL if the region is empty
 **
 ** @release 6.5.0
 ** @@
 ******************************************************************************/
 
-static bam_iter_t bamIterQuery(const AjPBamIndex idx, int tid,
-			       int beg, int end)
+bam_iter_t ajBamIterQuery(const AjPBamIndex idx, int tid,
+                          int beg, int end)
 {
     pair64_t *off=NULL;
     AjPTable bindex = NULL;
@@ -1081,7 +1070,7 @@ static bam_iter_t bamIterQuery(const AjPBamIndex idx, int tid,
     if (beg < 0)
 	beg = 0;
 
-    if (end < beg)
+    if (end < beg || tid < 0 || tid >= idx->n)
 	return 0;
 
     /* initialize iter */
@@ -1217,7 +1206,7 @@ static bam_iter_t bamIterQuery(const AjPBamIndex idx, int tid,
 
 
 
-/* @funcstatic bamIterDel *****************************************************
+/* @func ajBamIterDel *******************************************************
 **
 ** Deletes a BAM iteration object
 **
@@ -1228,7 +1217,7 @@ static bam_iter_t bamIterQuery(const AjPBamIndex idx, int tid,
 ** @@
 ******************************************************************************/
 
-static void bamIterDel(bam_iter_t* iterp)
+void ajBamIterDel(bam_iter_t* iterp)
 {
     bam_iter_t iter;
 
@@ -1246,20 +1235,22 @@ static void bamIterDel(bam_iter_t* iterp)
 
 
 
-/* @funcstatic bamIterRead ****************************************************
+/* @func ajBamIterRead ******************************************************
 **
-** ajBamFetch helper function retrieves data into alignment record b
+** Retrieves the next alignment overlapping the region of a BAM iteration
+** object into alignment record b
 **
 ** @param [u] fp [AjPSeqBamBgzf] BAM file
 ** @param [u] iter [bam_iter_t] BAM iteration object
 ** @param [u] b [AjPSeqBam] BAM record
-** @return [int] positive integer (1 or more) if a record successfully read
+** @return [int] positive integer (1 or more) if a record successfully read,
+**               -1 at the end of the region, less than -1 on error
 **
 ** @release 6.5.0
 ** @@
 ******************************************************************************/
 
-static int bamIterRead(AjPSeqBamBgzf fp, bam_iter_t iter, AjPSeqBam b)
+int ajBamIterRead(AjPSeqBamBgzf fp, bam_iter_t iter, AjPSeqBam b)
 {
     int ret;
 
@@ -1354,12 +1345,12 @@ int ajBamFetch(AjPSeqBamBgzf fp, const AjPBamIndex idx, int tid,
     AjPSeqBam b;
 
     AJNEW0(b);
-    iter = bamIterQuery(idx, tid, beg, end);
+    iter = ajBamIterQuery(idx, tid, beg, end);
 
-    while ((ret = bamIterRead(fp, iter, b)) >= 0)
+    while ((ret = ajBamIterRead(fp, iter, b)) >= 0)
 	func(b, data);
 
-    bamIterDel(&iter);
+    ajBamIterDel(&iter);
     ajSeqBamDel(&b);
 
     return (ret == -1)? 0 : ret;
@@ -141,6 +141,42 @@ typedef struct AjSBamIndex
 
 
 
+/* @data bam_iter_t ***********************************************************
+**
+** Iterator over the alignments overlapping a region of a reference sequence
+** in an indexed BAM file
+**
+** @attr from_first [int] read from the first record; no random access
+** @attr tid [int] reference sequence id
+** @attr beg [int] 0-based start of the region
+** @attr end [int] 0-based end of the region, exclusive
+** @attr n_off [int] number of chunks
+** @attr i [int] current chunk
+** @attr finished [int] true when no more alignments can be read
+** @attr Padding [int] Padding to alignment boundary
+** @attr curr_off [ajulong] virtual file offset of the next alignment
+** @attr off [pair64_t*] array of chunk start/stop offsets
+******************************************************************************/
+
+struct __bam_iter_t
+{
+    int from_first;
+    int tid;
+    int beg;
+    int end;
+    int n_off;
+    int i;
+    int finished;
+    int Padding;
+    ajulong curr_off;
+    pair64_t *off;
+};
+
+typedef struct __bam_iter_t *bam_iter_t;
+
+
+
+
 /*
  * Return a virtual file pointer to the current location in the file.
  * No interpretation of the value should be made, other than a subsequent
@@ -172,5 +208,10 @@ int ajBamIndexBuild(const char *fn);
 void ajBamIndexDel(AjPBamIndex* idx);
 AjPBamIndex ajBamIndexLoad(const char *fn);
 
+void ajBamIterDel(bam_iter_t* iterp);
+bam_iter_t ajBamIterQuery(const AjPBamIndex idx, int tid,
+                          int beg, int end);
+int ajBamIterRead(AjPSeqBamBgzf fp, bam_iter_t iter, AjPSeqBam b);
+
 
 #endif /* !AJBAMINDEX_H */
@@ -478,6 +478,7 @@ static ajuint feattabinReadFmt(AjPFeattabin feattabin,
                                 ajuint format);
 static AjBool feattabinRead(AjPFeattabin feattabin,
                              AjPFeattable ftable);
+static ajuint feattabinFormatSniff(const AjPFilebuff buff);
 static AjBool feattabinformatFind(const AjPStr format,
                                   ajint* iformat);
 static AjBool feattabinFormatSet(AjPFeattabin feattabin,
@@ -1296,6 +1297,70 @@ static ajuint feattabinReadFmt(AjPFeattabin feattabin, AjPFeattable ftable,
 
 
 
+/* @funcstatic feattabinFormatSniff *******************************************
+**
+** Looks at the first line of a buffered feature file of unknown format
+** for a header that names the format.
+**
+** Only the GFF version header is recognised. Other formats are found by
+** trying each in turn, as their readers search the whole input.
+**
+** @param [r] buff [const AjPFilebuff] Buffered input file
+** @return [ajuint] Format code, or zero if not known
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static ajuint feattabinFormatSniff(const AjPFilebuff buff)
+{
+    const AjPStr line;
+    const char* cp;
+    const char* name;
+    ajuint i;
+
+    line = ajFilebuffGetFirst(buff);
+
+    if(!line)
+        return 0;
+
+    cp = MAJSTRGETPTR(line);
+
+    while(isspace((ajint) *cp))
+        cp++;
+
+    if(strncmp(cp, "##gff-version", 13))
+        return 0;
+
+    cp += 13;
+
+    while(*cp == ' ' || *cp == '\t')
+        cp++;
+
+    if(*cp >= '3' && *cp <= '9')
+        name = "gff3";
+    else if(*cp == '1' || *cp == '2')
+        name = "gff2";
+    else
+        return 0;
+
+    for(i = 1; featinformatDef[i].Name; i++)
+    {
+        if(!strcmp(featinformatDef[i].Name, name))
+        {
+            ajDebug("feattabinFormatSniff '%S' try format %d (%s) first\n",
+                    line, i, name);
+
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+
+
+
 /* @funcstatic feattabinRead **************************************************
 **
 ** Given data in a feature table input structure,
@@ -1313,6 +1378,8 @@ static ajuint feattabinReadFmt(AjPFeattabin feattabin, AjPFeattable ftable,
 static AjBool feattabinRead(AjPFeattabin feattabin, AjPFeattable ftable)
 {
     ajuint i;
+    ajuint j;
+    ajuint ifirst = 0;
     ajuint istat = 0;
     ajuint jstat = 0;
 
@@ -1392,8 +1459,18 @@ static AjBool feattabinRead(AjPFeattabin feattabin, AjPFeattable ftable)
 /*
         regfile = ajFileIsFile(ajFilebuffGetFile(feattabin->Input->Filebuff));
 */
-	for(i = 1; featinformatDef[i].Name; i++)
+        ifirst = feattabinFormatSniff(feattabin->Input->Filebuff);
+
+	for(j = 0; featinformatDef[j].Name; j++)
 	{
+            /* first try any format named at the start of the file */
+            if(!j)
+                i = ifirst;
+            else if(j == ifirst)
+                continue;
+            else
+                i = j;
+
 	    if(!featinformatDef[i].Try)	/* skip if Try is ajFalse */
 		continue;
 
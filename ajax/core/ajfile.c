@@ -118,6 +118,7 @@
 /* ========================================================================= */
 
 static ajuint fileBuffSize   = 2049;
+static ajuint fileBlockSize  = 1048576;
 static AjBool fileUsedStdin  = AJFALSE;
 static AjBool fileUsedStdout = AJFALSE;
 static AjBool fileUsedStderr = AJFALSE;
@@ -155,6 +156,7 @@ static AjPRegexp fileFilenameExp = NULL;
 static void   fileBuffLineDel(AjPFilebuff thys);
 static AjBool fileBuffLineNext(AjPFilebuff thys);
 static void   fileClose(AjPFile thys);
+static AjBool fileIsRegular(const AjPFile thys);
 static void   fileListRecurs(const AjPStr file, AjPList list, ajint *recurs);
 static DIR*   fileOpenDir(AjPStr *dir);
 static void   filebuffFreeClear(AjPFilebuff buff);
@@ -1062,17 +1064,9 @@ AjPFile ajFileNewInBlockS(const AjPStr name, ajuint blocksize)
 {
     AjPFile ret;
     ret = ajFileNewInNameS(name);
-    ret->Blocksize = blocksize;
 
     if(blocksize)
-    {
-        ret->Workbuffer = ajCharNewRes(blocksize);
-        /*setvbuf(ret->fp, ret->Workbuffer, _IOFBF, blocksize);*/
-        ret->Readblock = ajCharNewRes(blocksize+1);
-        ret->Blockpos = 0;
-        ret->Blocklen = 0;
-        ret->Blocksize = blocksize;
-    }
+        ajFileSetBlocksize(ret, blocksize);
 
     ajDebug("ajFileNewInBlock '%S' blocksize:%u\n", name, blocksize);
 
@@ -2181,6 +2175,9 @@ AjBool ajFileReopenName(AjPFile file, const AjPStr name)
     if(!freopen(MAJSTRGETPTR(file->Name), "rb", file->fp))
         return ajFalse;
 
+    file->Blockpos = 0;
+    file->Blocklen = 0;
+
     return ajTrue;
 }
 
@@ -2259,14 +2256,17 @@ AjBool ajFileReopenNext(AjPFile file)
 **                    'ftell' function
 ** @nam4rule SetEof Set the end of file value for a file that has been read
 **                  without going past the last record.
+** @nam4rule SetBlocksize Set block size for reading lines
 ** @nam4rule SetUnbuffer Set file unbuffered
 **
 ** @argrule * file [AjPFile] File object
 ** @argrule Seek offset [ajlong] File offset to pass to system seek call
 ** @argrule Seek wherefrom [ajint] File wherefrom value to pass to
 **                                 system seek call
+** @argrule SetBlocksize blocksize [ajuint] Block size
 **
 ** @valrule Seek [ajint] Return value from seek
+** @valrule SetBlocksize [ajuint] Previous block size
 ** @valrule SetUnbuffer [void]
 ** @valrule Fix [AjBool] End of file reached
 ** @valrule Eof [AjBool] End of file reached
@@ -2315,7 +2315,9 @@ AjBool ajFileFix(AjPFile file)
 
 AjBool ajFileResetEof(AjPFile file)
 {
-    if(feof(file->fp))
+    if(file->Blockpos < file->Blocklen)
+        file->End = ajFalse;
+    else if(feof(file->fp))
         file->End = ajTrue;
     else
         file->End = ajFalse;
@@ -2344,6 +2346,10 @@ ajlong ajFileResetPos(AjPFile file)
 
     file->Filepos = ftell(file->fp);
 
+    /* block reads are ahead of the last line returned */
+    if(file->Readblock)
+        file->Filepos -= file->Blocklen - file->Blockpos;
+
     return file->Filepos;
 }
 
@@ -2370,9 +2376,19 @@ ajint ajFileSeek(AjPFile file, ajlong offset, ajint wherefrom)
 {
     ajint ret;
 
+    /* relative seeks start from the last line returned */
+    if(file->Readblock && wherefrom == SEEK_CUR)
+        offset -= file->Blocklen - file->Blockpos;
+
     clearerr(file->fp);
     ret = fseek(file->fp, offset, wherefrom);
 
+    if(file->Readblock && !ret)
+    {
+        file->Blockpos = 0;
+        file->Blocklen = 0;
+    }
+
     if(feof(file->fp))
     {
         file->End = ajTrue;
@@ -2440,6 +2456,53 @@ void ajFileSetUnbuffer(AjPFile file)
 
 
 
+/* @func ajFileSetBlocksize ***************************************************
+**
+** Switches an input file to read lines from large blocks with fread
+** rather than one line at a time with fgets.
+**
+** Any data already read by the system is kept, as the next block is read
+** from the current file position.
+**
+** @param [u] file [AjPFile] File object.
+** @param [r] blocksize [ajuint] Block size, zero to read single lines
+** @return [ajuint] Previous block size
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+ajuint ajFileSetBlocksize(AjPFile file, ajuint blocksize)
+{
+    ajuint ret = 0;
+
+    if(file->Readblock)
+        ret = file->Blocksize;
+
+    if(blocksize == ret)
+        return ret;
+
+    ajDebug("ajFileSetBlocksize '%F' blocksize:%u was:%u\n",
+            file, blocksize, ret);
+
+    /* return unread block data to the system before changing size */
+    if(file->Blockpos < file->Blocklen)
+        ajFileSeek(file, 0L, SEEK_CUR);
+
+    AJFREE(file->Readblock);
+    file->Blockpos  = 0;
+    file->Blocklen  = 0;
+    file->Blocksize = blocksize;
+
+    if(blocksize)
+        file->Readblock = ajCharNewRes(blocksize+1);
+
+    return ret;
+}
+
+
+
+
 /* @section File casts ********************************************************
 **
 ** Returns attributes of a file object
@@ -3698,37 +3761,38 @@ void ajFilebuffClear(AjPFilebuff buff, ajint lines)
         }
         else
         {
+            /*
+            ** a line still referenced by the caller is released,
+            ** but the list item is saved with no string
+            */
+
             if(ajStrDelStatic(&list->Line))
             {
-                /* move free line to the end */
-
                 /*ajDebug("can save to free list %x %d bytes\n",
                   list->Line, ajStrGetRes(list->Line));*/
 
                 ifree++;
-                /* just save the one line */
-                list->Next = NULL;
+            }
 
-                if(!buff->Freelines)
-                {
-                    /* start a new free list */
-                    buff->Freelines = list;
-                    buff->Freelast = list;
-                    /*ajDebug("start  list Free %x Freelast %x \n",
-                      buff->Freelines, buff->Freelast);*/
-                }
-                else
-                {
-                    /* append to free list */
-                    buff->Freelast->Next = list;
-                    buff->Freelast = buff->Freelast->Next;
-                    /*ajDebug("append list Free %x Freelast %x \n",
-                      buff->Freelines, buff->Freelast);*/
-                }
+            /* move free line to the end */
+            /* just save the one line */
+            list->Next = NULL;
+
+            if(!buff->Freelines)
+            {
+                /* start a new free list */
+                buff->Freelines = list;
+                buff->Freelast = list;
+                /*ajDebug("start  list Free %x Freelast %x \n",
+                  buff->Freelines, buff->Freelast);*/
             }
             else
             {
-                ajDebug("ajStrDelReuse was false\n");
+                /* append to free list */
+                buff->Freelast->Next = list;
+                buff->Freelast = buff->Freelast->Next;
+                /*ajDebug("append list Free %x Freelast %x \n",
+                  buff->Freelines, buff->Freelast);*/
             }
         }
         list = next;
@@ -4016,6 +4080,78 @@ AjBool ajFilebuffSetBuffered(AjPFilebuff buff)
 
 
 
+/* @funcstatic fileIsRegular **************************************************
+**
+** Tests whether a file object is a regular file that can be repositioned,
+** rather than a pipe or a terminal.
+**
+** @param [r] thys [const AjPFile] File object.
+** @return [AjBool] ajTrue if the file is a regular file.
+**
+** @release 6.6.0
+******************************************************************************/
+
+static AjBool fileIsRegular(const AjPFile thys)
+{
+#if defined(AJ_IRIXLF)
+    struct stat64 buf;
+#else /* !AJ_IRIXLF */
+    struct stat buf;
+#endif /* AJ_IRIXLF */
+
+    if(
+#if defined(AJ_IRIXLF)
+        !fstat64(fileno(thys->fp), &buf)
+#else /* !AJ_IRIXLF */
+        !fstat(fileno(thys->fp), &buf)
+#endif /* AJ_IRIXLF */
+       )
+        if(((ajuint)buf.st_mode & S_IFMT) == S_IFREG)
+            return ajTrue;
+
+    return ajFalse;
+}
+
+
+
+
+/* @func ajFilebuffSetBlocked *************************************************
+**
+** Sets a buffered regular file to read lines from large blocks, avoiding
+** a system call per line for large inputs. Seeks and position resets
+** on the file allow for the data already read into the block.
+**
+** Only for text data. Readers that use the C file pointer directly
+** would not see data already in the block.
+**
+** @param [u] buff [AjPFilebuff] Buffered file object.
+** @return [AjBool] ajTrue if the file was reading blocks before
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjBool ajFilebuffSetBlocked(AjPFilebuff buff)
+{
+    if(!buff || !buff->File || !buff->File->fp)
+        return ajFalse;
+
+    if(buff->File->Readblock)
+        return ajTrue;
+
+    if(!fileIsRegular(buff->File))
+        return ajFalse;
+
+    ajDebug("ajFilebuffSetBlocked '%F' blocksize: %u\n",
+            buff->File, fileBlockSize);
+    ajFileSetBlocksize(buff->File, fileBlockSize);
+
+    return ajFalse;
+}
+
+
+
+
 /* @func ajFilebuffSetUnbuffered **********************************************
 **
 ** Sets file to be unbuffered. If it already has buffered data, we have to
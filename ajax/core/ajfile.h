@@ -422,6 +422,7 @@ AjPFilebuff    ajFilebuffNewFromCfile(FILE *fp);
 AjPFilebuff    ajFilebuffNewFromFile(AjPFile file);
 AjPFilebuff    ajFilebuffNewLine(const AjPStr line);
 AjPFilebuff    ajFilebuffNewListinList(AjPList list);
+AjBool         ajFilebuffSetBlocked(AjPFilebuff thys);
 AjBool         ajFilebuffSetBuffered(AjPFilebuff thys);
 void           ajFilebuffClear(AjPFilebuff thys, ajint lines);
 void           ajFilebuffClearStore(AjPFilebuff thys, ajint lines,
@@ -540,6 +541,7 @@ AjBool         ajFilenameTestIncludePath(const AjPStr filename,
                                          const AjPStr exclude,
                                          const AjPStr include);
 void           ajFileTrace(const AjPFile thys);
+ajuint         ajFileSetBlocksize(AjPFile thys, ajuint blocksize);
 void           ajFileSetUnbuffer(AjPFile thys);
 
 ajuint         ajFileValueBuffsize(void);
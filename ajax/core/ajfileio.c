@@ -239,18 +239,27 @@ AjBool ajReadlinePos(AjPFile file, AjPStr* Pdest, ajlong* Ppos)
 
                 /* we know we have something in Readblock to process */
 
-                pnewline = strchr(&file->Readblock[file->Blockpos], '\n');
+                jlen = file->Blocklen - file->Blockpos;
+                pnewline = memchr(&file->Readblock[file->Blockpos], '\n',
+                                  jlen);
 
                 if(pnewline)
                     jlen = pnewline - &file->Readblock[file->Blockpos] + 1;
-                else
-                    jlen = file->Blocklen - file->Blockpos;
+
+                /* the line can be longer than the buffer */
+                if(jlen >= isize)
+                {
+                    MAJSTRSETVALIDLEN(&file->Buff, ipos);
+                    ajStrSetResRound(&file->Buff, ipos+jlen+1);
+                    buff = MAJSTRGETUNIQUEPTR(&file->Buff);
+                    isize = MAJSTRGETRES(file->Buff) - ipos;
+                }
 
                 /*ajDebug("ipos:%d jlen:%d pnewline:%p "
                           "Readblock:%p blockpos:%d blocklen:%d\n",
                           ipos, jlen, pnewline, file->Readblock,
                           file->Blockpos, file->Blocklen);*/
-                memmove(&buff[ipos], &file->Readblock[file->Blockpos], jlen);
+                memcpy(&buff[ipos], &file->Readblock[file->Blockpos], jlen);
                 buff[ipos+jlen]='\0';
                 cp = &buff[ipos];
                 file->Blockpos += jlen;
@@ -302,7 +311,7 @@ AjBool ajReadlinePos(AjPFile file, AjPStr* Pdest, ajlong* Ppos)
 	 ** (must be careful about that - we may just have read enough)
 	 */
 
-	if(((file->Readblock && !pnewline) || (jlen == (isize-1))) &&
+	if(((file->Readblock && cp && !pnewline) || (jlen == (isize-1))) &&
 	   (buff[ilen-1] != '\n'))
 	{
             MAJSTRSETVALIDLEN(&file->Buff, ilen); /* fix before resizing! */
@@ -1921,7 +1930,8 @@ AjBool ajBuffreadLinePos(AjPFilebuff buff, AjPStr* Pdest, ajlong* Ppos)
     
     if(buff->Pos < buff->Size)
     {
-	ajStrAssignS(Pdest, buff->Curr->Line);
+        /* a reference to the buffered line, copied only if changed */
+	ajStrAssignRef(Pdest, buff->Curr->Line);
 	*Ppos = buff->Curr->Fpos;
 	buff->Prev = buff->Curr;
 	buff->Curr = buff->Curr->Next;
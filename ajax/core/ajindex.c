@@ -36,10 +36,15 @@
 #include <errno.h>
 #ifndef WIN32
 #include <unistd.h>
+#include <sys/mman.h>
 #endif
 
 #include <sys/types.h>
 
+#ifndef MAP_FILE      /* Solaris does not have MAP_FILE */
+#define MAP_FILE 0
+#endif
+
 
 #ifdef WIN32
 #include <io.h>
@@ -55,6 +60,9 @@
 #define AJINDEX_DOSTATS 1
 #define AJINDEX_STATIC 0
 
+#define AJINDEX_CDFANOUT 1023 /* binary search nodes cached per EMBLCD file */
+#define AJINDEX_CDIDLE   16   /* EMBLCD files kept open with no users */
+
 static AjPBtpage btreeTestpage = NULL;
 
 static AjBool btreeDoRootSync = AJFALSE;
@@ -221,6 +229,8 @@ BtreeOFielddef btreeFields[] =
 
 
 static AjPTable btreeFieldsTable = NULL;
+static AjPTable btreeCdfileTable = NULL;
+static AjPList  btreeCdfileIdle = NULL;
 static AjPStr   btreeFieldnameTmp = NULL;
 
 static AjBool btreeDoExtra = AJFALSE;
@@ -254,6 +264,9 @@ static AjBool        btreeKeyidInsert(AjPBtcache cache, const AjPStr id);
 static AjPBtpage     btreePrimaryFetchFindleafWild(AjPBtcache cache,
                                                    const AjPStr key);
 
+static void          btreeCacheMap(AjPBtcache cache);
+static void          btreeCdfileDel(AjPCdfile* Pfile);
+static void          btreeCdfileMap(AjPCdfile file);
 static void          btreeCacheSync(AjPBtcache cache, ajulong rootpage);
 static void          btreeCacheRootSync(AjPBtcache cache, ajulong rootpage);
 
@@ -271,11 +284,11 @@ static ajulong       btreeCacheCompress(AjPBtcache thys);
 static ajulong       btreeCacheUncompress(AjPBtcache thys);
 
 static ajulong       btreePageposCompress(ajulong oldpos,
-                                          const AjPTable newpagetable,
+                                          const AjPTableinline newpagetable,
                                           const char* desc);
 
 static ajulong       btreePageposUncompress(ajulong oldpos,
-                                            const AjPTable newpagetable,
+                                            const AjPTableinline newpagetable,
                                             const char* desc);
 
 static AjPBtpage     btreePripageNew(AjPBtcache cache);
@@ -291,29 +304,35 @@ static ajuint        btreePageGetSizePribucket(const AjPBtpage page);
 static ajuint        btreePageGetSizeSecbucket(const AjPBtpage page);
 
 static AjBool        btreePageCompress(AjPBtpage page,
-                                       const AjPTable newpagetable,
+                                       const AjPTableinline newpagetable,
                                        ajuint refcount);
-static void          btreePageCompressIdbucket(AjPBtpage page,
-                                               const AjPTable newpagetable,
-                                               ajuint refcount);
+static void          btreePageCompressIdbucket(
+    AjPBtpage page,
+    const AjPTableinline newpagetable,
+    ajuint refcount);
 static void          btreePageCompressNode(AjPBtpage page,
-                                           const AjPTable newpagetable);
-static void          btreePageCompressNumnode(AjPBtpage page,
-                                              const AjPTable newpagetable);
-static void          btreePageCompressPribucket(AjPBtpage page,
-                                                const AjPTable newpagetable);
+                                           const AjPTableinline newpagetable);
+static void          btreePageCompressNumnode(
+    AjPBtpage page,
+    const AjPTableinline newpagetable);
+static void          btreePageCompressPribucket(
+    AjPBtpage page,
+    const AjPTableinline newpagetable);
 static AjBool        btreePageUncompress(AjPBtpage page,
-                                         const AjPTable newpagetable,
+                                         const AjPTableinline newpagetable,
                                          ajuint refcount);
-static void          btreePageUncompressIdbucket(AjPBtpage page,
-                                                 const AjPTable newpagetable,
-                                                 ajuint refcount);
+static void          btreePageUncompressIdbucket(
+    AjPBtpage page,
+    const AjPTableinline newpagetable,
+    ajuint refcount);
 static void          btreePageUncompressNode(AjPBtpage page,
-                                             const AjPTable newpagetable);
-static void          btreePageUncompressNumnode(AjPBtpage page,
-                                                const AjPTable newpagetable);
-static void          btreePageUncompressPribucket(AjPBtpage page,
-                                                  const AjPTable newpagetable);
+                                             const AjPTableinline newpagetable);
+static void          btreePageUncompressNumnode(
+    AjPBtpage page,
+    const AjPTableinline newpagetable);
+static void          btreePageUncompressPribucket(
+    AjPBtpage page,
+    const AjPTableinline newpagetable);
 
 static void          btreeNocacheFetch(const AjPBtcache cache, AjPBtpage cpage,
                                        ajulong pagepos);
@@ -1280,8 +1299,8 @@ AjPBtcache ajBtreeIdcacheNewC(const char *filetxt, const char *exttxt,
     cache->bsmem = NULL;
     cache->tsmem = NULL;
 
-    cache->pripagetable = ajTableulongNewConst(cache->pricachesize);
-    cache->secpagetable = ajTableulongNewConst(cache->seccachesize);
+    cache->pripagetable = ajTableinlineNewUlong(cache->pricachesize);
+    cache->secpagetable = ajTableinlineNewUlong(cache->seccachesize);
 
     cache->basename = ajStrNewC(exttxt);
 
@@ -1367,6 +1386,9 @@ AjPBtcache ajBtreeIdcacheNewC(const char *filetxt, const char *exttxt,
     cache->filesize    = filelen;
     cache->maxsize = filelen;
 
+    if(cache->readonly)
+        btreeCacheMap(cache);
+
     if(writemode)
     {
         if(cache->maxsize)
@@ -1687,9 +1709,15 @@ static AjPBtpage btreePripageNew(AjPBtcache cache)
     /* ajDebug("In btreePripageNew\n"); */
 
     AJNEW0(thys);
-    AJCNEW0(thys->buf,cache->pripagesize);
-    nodetype     = BT_FREEPAGE;
-    SBT_NODETYPE(thys->buf,nodetype);
+
+    /* pages of a mapped cache point into the map when fetched */
+
+    if(!cache->mapped)
+    {
+        AJCNEW0(thys->buf,cache->pripagesize);
+        nodetype     = BT_FREEPAGE;
+        SBT_NODETYPE(thys->buf,nodetype);
+    }
 
     thys->next = NULL;
     thys->prev = NULL;
@@ -1723,10 +1751,13 @@ static AjPBtpage btreeSecpageNew(AjPBtcache cache)
     /* ajDebug("In btreeSecpageNew\n"); */
 
     AJNEW0(thys);
-    AJCNEW0(thys->buf,cache->secpagesize);
 
-    nodetype     = BT_SECFREEPAGE;
-    SBT_NODETYPE(thys->buf,nodetype);
+    if(!cache->mapped)
+    {
+        AJCNEW0(thys->buf,cache->secpagesize);
+        nodetype     = BT_SECFREEPAGE;
+        SBT_NODETYPE(thys->buf,nodetype);
+    }
 
     thys->next = NULL;
     thys->prev = NULL;
@@ -1845,7 +1876,7 @@ static AjPBtpage btreePricacheLocate(AjPBtcache cache, ajulong page)
     /*ajDebug("In btreePricacheLocate %Lu\n", page);*/
     
 
-    cpage = ajTableFetchmodV(cache->pripagetable, (const void*) &page);
+    cpage = ajTableinlineFetchmodUlong(cache->pripagetable, page);
 
     if(!cpage)
         return NULL;
@@ -1882,7 +1913,7 @@ static AjPBtpage btreeSeccacheLocate(AjPBtcache cache, ajulong page)
     /*ajDebug("In btreeSeccacheLocate %Lu\n", page);*/
     
 
-    cpage = ajTableFetchmodV(cache->secpagetable, (const void*) &page);
+    cpage = ajTableinlineFetchmodUlong(cache->secpagetable, page);
 
     if(!cpage)
         return NULL;
@@ -1920,7 +1951,7 @@ static void btreePricacheUnlink(AjPBtcache cache, AjPBtpage cpage)
         ajWarn("btreePricacheUnlink secondary page %Lu '%s'",
                cpage->pagepos, btreeNodetype(cpage->buf));
 
-    ajTableRemove(cache->pripagetable, (void*) &cpage->pagepos);
+    ajTableinlineRemoveUlong(cache->pripagetable, cpage->pagepos);
 
     if(cache->pmru == cpage)
     {
@@ -1972,7 +2003,7 @@ static void btreeSeccacheUnlink(AjPBtcache cache, AjPBtpage cpage)
         ajWarn("btreeSeccacheUnlink primary page %Lu '%s'",
                cpage->pagepos, btreeNodetype(cpage->buf));
 
-    ajTableRemove(cache->secpagetable, (void*) &cpage->pagepos);
+    ajTableinlineRemoveUlong(cache->secpagetable, cpage->pagepos);
 
     if(cache->smru == cpage)
     {
@@ -2025,8 +2056,7 @@ static void btreePricacheMruAdd(AjPBtcache cache, AjPBtpage cpage)
         ajWarn("btreePricacheMruAdd secondary page %Lu '%s'",
                cpage->pagepos, btreeNodetype(cpage->buf));
 
-    ajTablePut(cache->pripagetable,
-               (void*) &cpage->pagepos, (void*) cpage);
+    ajTableinlinePutUlong(cache->pripagetable, cpage->pagepos, (void*) cpage);
 
     cpage->prev = cache->pmru;
     cpage->next = NULL;
@@ -2067,8 +2097,7 @@ static void btreeSeccacheMruAdd(AjPBtcache cache, AjPBtpage cpage)
         ajWarn("btreeSeccacheMruAdd primary page %Lu '%s'",
                cpage->pagepos, btreeNodetype(cpage->buf));
 
-    ajTablePut(cache->secpagetable,
-               (void*) &cpage->pagepos, (void*) cpage);
+    ajTableinlinePutUlong(cache->secpagetable, cpage->pagepos, (void*) cpage);
 
     cpage->prev = cache->smru;
     cpage->next = NULL;
@@ -2114,7 +2143,7 @@ static AjPBtpage btreePricacheLruUnlink(AjPBtcache cache)
 	ret = cache->plru;
 	ret->next->prev = NULL;
 	cache->plru = ret->next;
-        ajTableRemove(cache->pripagetable, (void*) &ret->pagepos);
+        ajTableinlineRemoveUlong(cache->pripagetable, ret->pagepos);
 
         if(!ajBtreePageIsPrimary(ret))
             ajWarn("btreePricacheLruUnlink secondary page %Lu '%s'",
@@ -2168,7 +2197,7 @@ static AjPBtpage btreeSeccacheLruUnlink(AjPBtcache cache)
 	ret->next->prev = NULL;
 	cache->slru = ret->next;
 
-        ajTableRemove(cache->secpagetable, (void*) &ret->pagepos);
+        ajTableinlineRemoveUlong(cache->secpagetable, ret->pagepos);
 
         if(ajBtreePageIsPrimary(ret))
             ajWarn("btreeSeccacheLruUnlink primary page %Lu '%s'",
@@ -2376,6 +2405,20 @@ static void btreePricacheFetch(AjPBtcache cache, AjPBtpage cpage,
 
     /* ajDebug("In btreePricacheFetch\n"); */
 
+    if(cache->mapped)
+    {
+        if(pagepos + cache->pripagesize > cache->mapsize)
+            ajFatal("Page %Lu beyond end of mapped index '%S' "
+                    "in btreePricacheFetch",
+                    pagepos, cache->filename);
+
+        cpage->buf = cache->mapped + pagepos;
+        cpage->pagepos = pagepos;
+        cache->prireads++;
+
+        return;
+    }
+
     if(fseek(cache->fp,pagepos,SEEK_SET))
 	ajFatal("Seek error %d: '%s' in ajBtreePricacheFetch file %S",
                 ferror(cache->fp),
@@ -2426,6 +2469,20 @@ static void btreeSeccacheFetch(AjPBtcache cache, AjPBtpage cpage,
 
     /* ajDebug("In btreeSeccacheFetch\n"); */
 
+    if(cache->mapped)
+    {
+        if(pagepos + cache->secpagesize > cache->mapsize)
+            ajFatal("Page %Lu beyond end of mapped index '%S' "
+                    "in btreeSeccacheFetch",
+                    pagepos, cache->filename);
+
+        cpage->buf = cache->mapped + pagepos;
+        cpage->pagepos = pagepos;
+        cache->secreads++;
+
+        return;
+    }
+
     if(fseek(cache->fp,pagepos,SEEK_SET))
 	ajFatal("Seek error %d: '%s' in ajBtreeSeccacheFetch file %S",
                 ferror(cache->fp),
@@ -2564,7 +2621,7 @@ static void btreeCacheWriteUncompress(AjPBtcache cache, AjPBtpage cpage,
 
 static ajulong btreeCacheCompress(AjPBtcache thys)
 {
-    AjPTable  newpostable;
+    AjPTableinline newpostable;
     ajulong  *oldpagepos = NULL;
     ajulong  *newpagepos = NULL;
     ajuint    oldpagesize;
@@ -2599,7 +2656,7 @@ static ajulong btreeCacheCompress(AjPBtcache thys)
     AJCNEW(newpagepos, pagecount);
     AJCNEW(newpagesizes, pagecount);
 
-    newpostable = ajTableulongNewConst((ajint) pagecount);
+    newpostable = ajTableinlineNewUlong(pagecount);
 
     oldpos = 0UL;
     newpos = 0UL;
@@ -2622,8 +2679,8 @@ static ajulong btreeCacheCompress(AjPBtcache thys)
         newpagepos[i] = newpos;
         newpagesizes[i] = newpagesize;
 
-        ajTablePut(newpostable, (void*) &oldpagepos[i],
-                   (void*) &newpagepos[i]);
+        ajTableinlinePutUlong(newpostable, oldpagepos[i],
+                              (void*) &newpagepos[i]);
 
         oldpos += oldpagesize;
         newpos += newpagesize;
@@ -2662,7 +2719,7 @@ static ajulong btreeCacheCompress(AjPBtcache thys)
     AJFREE(newpagepos);
     AJFREE(newpagesizes);
 
-    ajTableFree(&newpostable);
+    ajTableinlineDel(&newpostable);
 
     AJFREE(page->buf);
     AJFREE(page);
@@ -2687,7 +2744,7 @@ static ajulong btreeCacheCompress(AjPBtcache thys)
 
 static ajulong btreeCacheUncompress(AjPBtcache thys)
 {
-    AjPTable  newpostable;
+    AjPTableinline newpostable;
     ajulong  *oldpagepos = NULL;
     ajulong  *newpagepos = NULL;
     ajuint    oldpagesize;
@@ -2727,7 +2784,7 @@ static ajulong btreeCacheUncompress(AjPBtcache thys)
 
     AJCNEW0(oldpagepos, pagecount);
     AJCNEW0(newpagepos, pagecount);
-    newpostable = ajTableulongNewConst((ajint) pagecount);
+    newpostable = ajTableinlineNewUlong(pagecount);
 
     oldpos = 0UL;
     newpos = 0UL;
@@ -2744,8 +2801,8 @@ static ajulong btreeCacheUncompress(AjPBtcache thys)
         oldpagepos[i] = oldpos;
         newpagepos[i] = newpos;
 
-        ajTablePut(newpostable, (void*) &oldpagepos[i],
-                   (void*) &newpagepos[i]);
+        ajTableinlinePutUlong(newpostable, oldpagepos[i],
+                              (void*) &newpagepos[i]);
 
         oldpos += oldpagesize;
         newpos += newpagesize;
@@ -2798,7 +2855,7 @@ static ajulong btreeCacheUncompress(AjPBtcache thys)
     AJFREE(oldpagepos);
     AJFREE(newpagepos);
 
-    ajTableFree(&newpostable);
+    ajTableinlineDel(&newpostable);
 
     AJFREE(page->buf);
     AJFREE(page);
@@ -2809,6 +2866,56 @@ static ajulong btreeCacheUncompress(AjPBtcache thys)
 
 
 
+/* @funcstatic btreeCacheMap ************************************************
+**
+** Memory map a read-only b+tree index file.
+**
+** Pages are then read directly from the map, with no copy into private
+** page buffers, and the operating system page cache is shared between
+** all processes reading the same index. If the file cannot be mapped
+** pages are read from the file as before.
+**
+** @param [u] cache [AjPBtcache] Read-only cache
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeCacheMap(AjPBtcache cache)
+{
+#ifndef WIN32
+    void *map;
+
+    if(!cache->filesize)
+        return;
+
+    if((ajulong) (size_t) cache->filesize != cache->filesize)
+        return;
+
+    map = mmap(NULL, (size_t) cache->filesize, PROT_READ,
+               MAP_FILE | MAP_SHARED, fileno(cache->fp), 0);
+
+    if(map == MAP_FAILED)
+    {
+        ajDebug("btreeCacheMap '%S' mmap failed: '%s'\n",
+                cache->filename, strerror(errno));
+        return;
+    }
+
+    cache->mapped  = (unsigned char*) map;
+    cache->mapsize = cache->filesize;
+#else
+    (void) cache;
+#endif
+
+    return;
+}
+
+
+
+
 /* @func ajBtreeCacheDel ******************************************************
 **
 ** Close a b+tree cache
@@ -2848,19 +2955,26 @@ ajulong ajBtreeCacheDel(AjPBtcache *Pthis)
     for(page=thys->plru;page;page=temp)
     {
 	temp = page->next;
-        ajTableRemove(thys->pripagetable, (void*) &page->pagepos);
-	AJFREE(page->buf);
+        ajTableinlineRemoveUlong(thys->pripagetable, page->pagepos);
+        if(!thys->mapped)
+            AJFREE(page->buf);
 	AJFREE(page);
     }
 
     for(page=thys->slru;page;page=temp)
     {
 	temp = page->next;
-        ajTableRemove(thys->secpagetable, (void*) &page->pagepos);
-	AJFREE(page->buf);
+        ajTableinlineRemoveUlong(thys->secpagetable, page->pagepos);
+        if(!thys->mapped)
+            AJFREE(page->buf);
 	AJFREE(page);
     }
 
+#ifndef WIN32
+    if(thys->mapped)
+        munmap((void*) thys->mapped, (size_t) thys->mapsize);
+#endif
+
     if(!thys->readonly)
     {
         /* Ubuntu warns if ftruncate return is not used */
@@ -2886,8 +3000,8 @@ ajulong ajBtreeCacheDel(AjPBtcache *Pthis)
 
     fclose(thys->fp);
 
-    ajTableFree(&thys->pripagetable);
-    ajTableFree(&thys->secpagetable);
+    ajTableinlineDel(&thys->pripagetable);
+    ajTableinlineDel(&thys->secpagetable);
 
     AJFREE(*Pthis);
     *Pthis = NULL;
@@ -3184,6 +3298,24 @@ static AjPBtpage btreeSeccacheControl(AjPBtcache cache, ajulong pagepos,
 AjPBtpage ajBtreeCacheRead(AjPBtcache cache, ajulong pagepos)
 {
     AjPBtpage ret = NULL;
+    AjOBtpage mappage;
+
+    /* ajDebug("In ajBtreeCacheRead\n"); */
+
+    if(cache->mapped)
+    {
+        if(pagepos >= cache->mapsize)
+            ajFatal("Page %Lu beyond end of mapped index '%S' "
+                    "in ajBtreeCacheRead",
+                    pagepos, cache->filename);
+
+        mappage.buf = cache->mapped + pagepos;
+
+        if(ajBtreePageIsPrimary(&mappage))
+            return btreePricacheControl(cache,pagepos,BT_READ);
+
+        return btreeSeccacheControl(cache,pagepos,BT_READ);
+    }
 
     if(!btreeTestpage)
     {
@@ -3192,8 +3324,6 @@ AjPBtpage ajBtreeCacheRead(AjPBtcache cache, ajulong pagepos)
         else        
             btreeTestpage = btreePripageNew(cache);
     }
-    
-    /* ajDebug("In ajBtreeCacheRead\n"); */
 
     btreeNocacheFetch(cache, btreeTestpage, pagepos);
 
@@ -14120,8 +14250,8 @@ AjPBtcache ajBtreeSeccacheNewC(const char *filetxt, const char *exttxt,
 
     cache->secondary = ajTrue;
     
-    cache->pripagetable = ajTablelongNewConst(cache->pricachesize);
-    cache->secpagetable = ajTablelongNewConst(cache->seccachesize);
+    cache->pripagetable = ajTableinlineNewUlong(cache->pricachesize);
+    cache->secpagetable = ajTableinlineNewUlong(cache->seccachesize);
 
     cache->basename = ajStrNewC(exttxt);
 
@@ -14205,6 +14335,9 @@ AjPBtcache ajBtreeSeccacheNewC(const char *filetxt, const char *exttxt,
     cache->filesize  = filelen;
     cache->maxsize = filelen;
 
+    if(cache->readonly)
+        btreeCacheMap(cache);
+
     if(writemode)
     {
         if(cache->maxsize)
@@ -31850,7 +31983,7 @@ const char* ajBtreePageGetTypename(const AjPBtpage page)
 ** @param [w] overflows [ajuint*] Number of overflow pages
 ** @param [w] freespace [ajuint*] Unused space in this page
 ** @param [u] refs [ajulong*] References to pages
-** @param [r] newpostable [const AjPTable] Page numbers for page offsets
+** @param [r] newpostable [const AjPTableinline] Page numbers for page offsets
 ** @return [AjBool] True on success
 **
 ** @release 6.4.0
@@ -31860,7 +31993,7 @@ const char* ajBtreePageGetTypename(const AjPBtpage page)
 AjBool ajBtreeStatNode(AjPBtcache cache, const AjPBtpage page, AjBool full,
                        ajuint* nkeys, ajuint* overflows,
                        ajuint* freespace, ajulong* refs,
-                       const AjPTable newpostable)
+                       const AjPTableinline newpostable)
 {
     ajuint i;
     ajuint m;
@@ -31974,7 +32107,7 @@ AjBool ajBtreeStatNode(AjPBtcache cache, const AjPBtpage page, AjBool full,
         kp = keyptr;
         keyptr += klen+1;
         BT_GETAJULONG(keyptr,&lv);
-        ++refs[*ajTableulongFetch(newpostable, &lv)];
+        ++refs[*(const ajulong*) ajTableinlineFetchUlong(newpostable, lv)];
 	keyptr += sizeof(ajulong);
 
         if(full)
@@ -31986,7 +32119,7 @@ AjBool ajBtreeStatNode(AjPBtcache cache, const AjPBtpage page, AjBool full,
 
     BT_GETAJULONG(keyptr,&lv);
     keyptr += sizeof(ajulong);
-    ++refs[*ajTableulongFetch(newpostable, &lv)];
+    ++refs[*(const ajulong*) ajTableinlineFetchUlong(newpostable, lv)];
 
     if(full)
         ajDebug("#StatNode     %12Lu %12Lu '<end>'\n",
@@ -32016,7 +32149,7 @@ AjBool ajBtreeStatNode(AjPBtcache cache, const AjPBtpage page, AjBool full,
 ** @param [w] overflows [ajuint*] Number of overflow pages
 ** @param [w] freespace [ajuint*] Unused space in this page
 ** @param [u] refs [ajulong*] References to pages
-** @param [r] newpostable [const AjPTable] Page numbers for page offsets
+** @param [r] newpostable [const AjPTableinline] Page numbers for page offsets
 ** @return [AjBool] True on success
 **
 ** @release 6.4.0
@@ -32026,7 +32159,7 @@ AjBool ajBtreeStatNode(AjPBtcache cache, const AjPBtpage page, AjBool full,
 AjBool ajBtreeStatNumnode(AjPBtcache cache, const AjPBtpage page, AjBool full,
                           ajuint* nkeys, ajuint* overflows,
                           ajuint* freespace, ajulong *refs,
-                          const AjPTable newpostable)
+                          const AjPTableinline newpostable)
 {
     ajuint i;
     ajuint m;
@@ -32075,14 +32208,14 @@ AjBool ajBtreeStatNumnode(AjPBtcache cache, const AjPBtpage page, AjBool full,
     for(i=0;i<m;i++)
     {
         BT_GETAJULONG(valptr,&lv);
-        ++refs[*ajTableulongFetch(newpostable, &lv)];
+        ++refs[*(const ajulong*) ajTableinlineFetchUlong(newpostable, lv)];
         BT_GETAJULONG(keyptr,&lk);
         keyptr += sizeof(ajulong);
 	valptr += sizeof(ajulong);
     }
     BT_GETAJULONG(valptr,&lv);
     valptr += sizeof(ajulong);
-    ++refs[*ajTableulongFetch(newpostable, &lv)];
+    ++refs[*(const ajulong*) ajTableinlineFetchUlong(newpostable, lv)];
     *freespace += pagesize - (valptr-tbuf);
 
     return ajTrue;
@@ -32181,7 +32314,7 @@ static void btreeStatNumnode(AjPBtcache cache, const AjPBtpage page)
 ** @param [w] overflows [ajuint*] Number of overflow pages
 ** @param [w] freespace [ajuint*] Unused space in this page
 ** @param [u] refs [ajulong*] References to pages
-** @param [r] newpostable [const AjPTable] Page numbers for page offsets
+** @param [r] newpostable [const AjPTableinline] Page numbers for page offsets
 ** @return [AjBool] True on success
 **
 ** @release 6.4.0
@@ -32191,7 +32324,7 @@ static void btreeStatNumnode(AjPBtcache cache, const AjPBtpage page)
 AjBool ajBtreeStatIdbucket(AjPBtcache cache, const AjPBtpage page, AjBool full,
                            ajuint* nentries, ajuint *ndups, ajuint *nextra,
                            ajuint* overflows, ajuint* freespace, ajulong* refs,
-                           const AjPTable newpostable)
+                           const AjPTableinline newpostable)
 {
     ajuint i;
     ajuint iref;
@@ -32303,7 +32436,7 @@ AjBool ajBtreeStatIdbucket(AjPBtcache cache, const AjPBtpage page, AjBool full,
 	idptr += sizeof(ajuint);	
 	BT_GETAJULONG(idptr,&lv);
         if(uv2)
-            ++refs[*ajTableulongFetch(newpostable, &lv)];
+            ++refs[*(const ajulong*) ajTableinlineFetchUlong(newpostable, lv)];
 	idptr += sizeof(ajulong);
 
         if(full)
@@ -32463,7 +32596,7 @@ AjBool ajBtreeStatNumbucket(AjPBtcache cache, const AjPBtpage page, AjBool full,
 ** @param [w] overflows [ajuint*] Number of overflow pages
 ** @param [w] freespace [ajuint*] Unused space in this page
 ** @param [u] refs [ajulong*] References to pages
-** @param [r] newpostable [const AjPTable] Page numbers for page offsets
+** @param [r] newpostable [const AjPTableinline] Page numbers for page offsets
 ** @return [AjBool] True on success
 **
 ** @release 6.4.0
@@ -32473,7 +32606,7 @@ AjBool ajBtreeStatNumbucket(AjPBtcache cache, const AjPBtpage page, AjBool full,
 AjBool ajBtreeStatPribucket(AjPBtcache cache, const AjPBtpage page, AjBool full,
                             ajuint* nentries, ajuint* overflows,
                             ajuint* freespace, ajulong *refs,
-                            const AjPTable newpostable)
+                            const AjPTableinline newpostable)
 {
     ajuint i;
     ajuint m;
@@ -32540,7 +32673,7 @@ AjBool ajBtreeStatPribucket(AjPBtcache cache, const AjPBtpage page, AjBool full,
 
         lp = idptr+ klen-8;
         BT_GETAJULONG(lp,&lv);
-        ++refs[*ajTableulongFetch(newpostable, &lv)];
+        ++refs[*(const ajulong*) ajTableinlineFetchUlong(newpostable, lv)];
         if(full)
             ajDebug("#StatPribucket %12Lu %12Lu '%*s'\n",
                     page->pagepos, lv, klen-9, idptr);
@@ -33132,7 +33265,7 @@ static AjBool btreeBucketCalc(ajuint totalkeys, ajuint totalbuckets,
 ** Return the new start position of a compressed page position
 **
 ** @param [r] oldpos [ajulong] Page position
-** @param [r] newpostable [const AjPTable] Table of new page positions
+** @param [r] newpostable [const AjPTableinline] Table of new page positions
 ** @param [r] where [const char*] Location in index for reporting in
 **                                warning message.
 ** @return [ajulong] New page start position
@@ -33142,15 +33275,15 @@ static AjBool btreeBucketCalc(ajuint totalkeys, ajuint totalbuckets,
 ******************************************************************************/
 
 static ajulong btreePageposCompress(ajulong oldpos,
-                                    const AjPTable newpostable,
+                                    const AjPTableinline newpostable,
                                     const char* where)
 {
     const ajulong *newpos;
 
     ajDebug("btreePageposCompress oldpos %Lu table size:%Lu\n",
-            oldpos, ajTableGetLength(newpostable));
+            oldpos, ajTableinlineGetLength(newpostable));
 
-    newpos =  ajTableulongFetch(newpostable, &oldpos);
+    newpos = ajTableinlineFetchUlong(newpostable, oldpos);
 
     if(!newpos)
     {
@@ -33173,7 +33306,7 @@ static ajulong btreePageposCompress(ajulong oldpos,
 ** Return the new start position of a compressed page
 **
 ** @param [r] oldpos [ajulong] Page position
-** @param [r] newpostable [const AjPTable] Array of new page positions
+** @param [r] newpostable [const AjPTableinline] Array of new page positions
 ** @param [r] where [const char*] Location in index for reporting in
 **                                warning message.
 ** @return [ajulong] new start position
@@ -33183,15 +33316,15 @@ static ajulong btreePageposCompress(ajulong oldpos,
 ******************************************************************************/
 
 static ajulong btreePageposUncompress(ajulong oldpos,
-                                      const AjPTable newpostable,
+                                      const AjPTableinline newpostable,
                                       const char* where)
 {
     const ajulong *newpos;
 
     ajDebug("btreePageposUncompress oldpos %Lu table size:%Lu\n",
-            oldpos, ajTableGetLength(newpostable));
+            oldpos, ajTableinlineGetLength(newpostable));
 
-    newpos =  ajTableulongFetch(newpostable, &oldpos);
+    newpos = ajTableinlineFetchUlong(newpostable, oldpos);
 
     if(!newpos)
     {
@@ -33214,7 +33347,7 @@ static ajulong btreePageposUncompress(ajulong oldpos,
 ** Uncompress a cache page using a table of new positions for pages
 **
 ** @param [u] page [AjPBtpage] Page
-** @param [r] newpostable [const AjPTable] Table of new page positions
+** @param [r] newpostable [const AjPTableinline] Table of new page positions
 ** @param [r] refcount [ajuint] Reference offset count
 ** @return [AjBool] True on success
 **
@@ -33223,7 +33356,7 @@ static ajulong btreePageposUncompress(ajulong oldpos,
 ******************************************************************************/
 
 static AjBool btreePageUncompress(AjPBtpage page,
-                                  const AjPTable newpostable,
+                                  const AjPTableinline newpostable,
                                   ajuint refcount)
 {
     const unsigned char* buf = page->buf;
@@ -33283,7 +33416,7 @@ static AjBool btreePageUncompress(AjPBtpage page,
 ** uncompressed pages
 **
 ** @param [u] page [AjPBtpage] Page
-** @param [r] newpostable [const AjPTable] Table of new page positions
+** @param [r] newpostable [const AjPTableinline] Table of new page positions
 ** @param [r] refcount [ajuint] Number of reference offsets
 ** @return [void]
 **
@@ -33292,7 +33425,7 @@ static AjBool btreePageUncompress(AjPBtpage page,
 ******************************************************************************/
 
 static void btreePageUncompressIdbucket(AjPBtpage page,
-                                        const AjPTable newpostable,
+                                        const AjPTableinline newpostable,
                                         ajuint refcount)
 {
     unsigned char* buf = page->buf;
@@ -33359,7 +33492,7 @@ static void btreePageUncompressIdbucket(AjPBtpage page,
 ** Uncompress a node cache page using a table of new positions
 **
 ** @param [u] page [AjPBtpage] Page
-** @param [r] newpostable [const AjPTable] Table of new page positions
+** @param [r] newpostable [const AjPTableinline] Table of new page positions
 ** @return [void]
 **
 ** @release 6.4.0
@@ -33367,7 +33500,7 @@ static void btreePageUncompressIdbucket(AjPBtpage page,
 ******************************************************************************/
 
 static void btreePageUncompressNode(AjPBtpage page,
-                                    const AjPTable newpostable)
+                                    const AjPTableinline newpostable)
 {
     unsigned char* buf = page->buf;
     ajuint nkeys = 0U;
@@ -33480,7 +33613,7 @@ static void btreePageUncompressNode(AjPBtpage page,
 ** uncompress a numeric node cache page using a table of new positions
 **
 ** @param [u] page [AjPBtpage] Page
-** @param [r] newpostable [const AjPTable] Table of new page positions
+** @param [r] newpostable [const AjPTableinline] Table of new page positions
 ** @return [void]
 **
 ** @release 6.4.0
@@ -33488,7 +33621,7 @@ static void btreePageUncompressNode(AjPBtpage page,
 ******************************************************************************/
 
 static void btreePageUncompressNumnode(AjPBtpage page,
-                                       const AjPTable newpostable)
+                                       const AjPTableinline newpostable)
 {
     unsigned char* buf = page->buf;
     ajuint nkeys;
@@ -33588,7 +33721,7 @@ static void btreePageUncompressNumnode(AjPBtpage page,
 ** Uncompress a primary bucket cache page using a table of new positions
 **
 ** @param [u] page [AjPBtpage] Page
-** @param [r] newpostable [const AjPTable] Table of new page positions
+** @param [r] newpostable [const AjPTableinline] Table of new page positions
 ** @return [void]
 **
 ** @release 6.4.0
@@ -33596,7 +33729,7 @@ static void btreePageUncompressNumnode(AjPBtpage page,
 ******************************************************************************/
 
 static void btreePageUncompressPribucket(AjPBtpage page,
-                                         const AjPTable newpostable)
+                                         const AjPTableinline newpostable)
 {
     unsigned char* buf = page->buf;
     ajuint nentries;
@@ -33653,7 +33786,7 @@ static void btreePageUncompressPribucket(AjPBtpage page,
 ** Compress a cache page using an array of new positions for uncompressed pages
 **
 ** @param [u] page [AjPBtpage] Page
-** @param [r] newpostable [const AjPTable] Table of new page positions
+** @param [r] newpostable [const AjPTableinline] Table of new page positions
 ** @param [r] refcount [ajuint] Number of reference offsets
 ** @return [AjBool] True on success
 **
@@ -33662,7 +33795,7 @@ static void btreePageUncompressPribucket(AjPBtpage page,
 ******************************************************************************/
 
 static AjBool btreePageCompress(AjPBtpage page,
-                                const AjPTable newpostable,
+                                const AjPTableinline newpostable,
                                 ajuint refcount)
 {
     const unsigned char* buf = page->buf;
@@ -33720,7 +33853,7 @@ static AjBool btreePageCompress(AjPBtpage page,
 ** uncompressed pages
 **
 ** @param [u] page [AjPBtpage] Page
-** @param [r] newpostable [const AjPTable] Table of new page positions
+** @param [r] newpostable [const AjPTableinline] Table of new page positions
 ** @param [r] refcount [ajuint] Number of reference offsets
 ** @return [void]
 **
@@ -33729,7 +33862,7 @@ static AjBool btreePageCompress(AjPBtpage page,
 ******************************************************************************/
 
 static void btreePageCompressIdbucket(AjPBtpage page,
-                                      const AjPTable newpostable,
+                                      const AjPTableinline newpostable,
                                       ajuint refcount)
 {
     unsigned char* buf = page->buf;
@@ -33799,7 +33932,7 @@ static void btreePageCompressIdbucket(AjPBtpage page,
 ** uncompressed pages
 **
 ** @param [u] page [AjPBtpage] Page
-** @param [r] newpostable [const AjPTable] Table of new page positions
+** @param [r] newpostable [const AjPTableinline] Table of new page positions
 ** @return [void]
 **
 ** @release 6.5.0
@@ -33807,7 +33940,7 @@ static void btreePageCompressIdbucket(AjPBtpage page,
 ******************************************************************************/
 
 static void btreePageCompressNode(AjPBtpage page,
-                                 const AjPTable newpostable)
+                                 const AjPTableinline newpostable)
 {
     unsigned char* buf = page->buf;
     ajuint nkeys = 0U;
@@ -33922,7 +34055,7 @@ static void btreePageCompressNode(AjPBtpage page,
 ** positions for uncompressed pages
 **
 ** @param [u] page [AjPBtpage] Page
-** @param [r] newpostable [const AjPTable] Table of new page positions
+** @param [r] newpostable [const AjPTableinline] Table of new page positions
 ** @return [void]
 **
 ** @release 6.5.0
@@ -33930,7 +34063,7 @@ static void btreePageCompressNode(AjPBtpage page,
 ******************************************************************************/
 
 static void btreePageCompressNumnode(AjPBtpage page,
-                                     const AjPTable newpostable)
+                                     const AjPTableinline newpostable)
 {
     unsigned char* buf = page->buf;
     ajuint nkeys;
@@ -34031,7 +34164,7 @@ static void btreePageCompressNumnode(AjPBtpage page,
 ** positions for uncompressed pages
 **
 ** @param [u] page [AjPBtpage] Page
-** @param [r] newpostable [const AjPTable] Table of new page positions
+** @param [r] newpostable [const AjPTableinline] Table of new page positions
 ** @return [void]
 **
 ** @release 6.5.0
@@ -34039,7 +34172,7 @@ static void btreePageCompressNumnode(AjPBtpage page,
 ******************************************************************************/
 
 static void btreePageCompressPribucket(AjPBtpage page,
-                                       const AjPTable newpostable)
+                                       const AjPTableinline newpostable)
 {
     unsigned char* buf = page->buf;
     ajuint nentries;
@@ -35044,6 +35177,447 @@ void ajBtreeStatsOut(AjPFile outf,
 
 
 
+/* @func ajCdfileOpen *********************************************************
+**
+** Opens a named EMBL CD-ROM (dbi) index file for reading.
+**
+** Each file is opened, and memory mapped where possible, only once.
+** Later calls for the same file return the same object until every
+** caller has closed it. A few files no longer in use are kept open for
+** later queries; beyond AJINDEX_CDIDLE the oldest is closed.
+**
+** @param [r] dir [const AjPStr] Directory
+** @param [r] name [const char*] File name
+** @return [AjPCdfile] EMBL CD-ROM index file, or NULL if not found
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjPCdfile ajCdfileOpen(const AjPStr dir, const char* name)
+{
+    AjPCdfile thys = NULL;
+    AjPStr key = NULL;
+    AjIList iter = NULL;
+    short recsize = 0;
+
+    if(!btreeCdfileTable)
+    {
+        btreeCdfileTable = ajTablestrNew(16);
+        ajTableSetDestroykey(btreeCdfileTable, NULL);
+        btreeCdfileIdle = ajListNew();
+    }
+
+    ajFmtPrintS(&key, "%S/%s", dir, name);
+    thys = ajTableFetchmodS(btreeCdfileTable, key);
+
+    if(thys)
+    {
+        ajStrDel(&key);
+
+        if(!thys->Users++)
+        {
+            iter = ajListIterNew(btreeCdfileIdle);
+
+            while(!ajListIterDone(iter))
+                if(ajListIterGet(iter) == thys)
+                {
+                    ajListIterRemove(iter);
+                    break;
+                }
+
+            ajListIterDel(&iter);
+        }
+
+        ajDebug("ajCdfileOpen '%F' reused users: %u\n",
+                thys->File, thys->Users);
+
+        return thys;
+    }
+
+    AJNEW0(thys);
+
+    thys->File = ajFileNewInNamePathC(name, dir);
+
+    if(!thys->File)
+    {
+        ajStrDel(&key);
+        AJFREE(thys);
+
+        return NULL;
+    }
+
+    ajFileSeek(thys->File, 8, 0);
+    ajReadbinInt2(thys->File, &recsize);
+
+    thys->Key     = key;
+    thys->RecSize = (ajuint) recsize;
+    thys->Users   = 1;
+
+    btreeCdfileMap(thys);
+
+    ajDebug("ajCdfileOpen '%F' RecSize: %u mapped: %B\n",
+            thys->File, thys->RecSize, (thys->Mapped != NULL));
+
+    ajTablePut(btreeCdfileTable, thys->Key, thys);
+
+    return thys;
+}
+
+
+
+
+/* @funcstatic btreeCdfileMap *************************************************
+**
+** Memory maps a read-only EMBL CD-ROM index file.
+**
+** Binary search probes then read records directly from the map, with no
+** seek and read for each probe. If the file cannot be mapped records are
+** read from the file as before.
+**
+** @param [u] file [AjPCdfile] EMBL CD-ROM index file
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeCdfileMap(AjPCdfile file)
+{
+#ifndef WIN32
+    ajlong filesize;
+    void *map;
+
+    filesize = ajFilenameGetSize(ajFileGetNameS(file->File));
+
+    if(filesize <= 0)
+        return;
+
+    if((ajulong) (size_t) filesize != (ajulong) filesize)
+        return;
+
+    map = mmap(NULL, (size_t) filesize, PROT_READ,
+               MAP_FILE | MAP_SHARED, fileno(ajFileGetFileptr(file->File)),
+               0);
+
+    if(map == MAP_FAILED)
+    {
+        ajDebug("btreeCdfileMap '%F' mmap failed: '%s'\n",
+                file->File, strerror(errno));
+        return;
+    }
+
+    file->Mapped  = (unsigned char*) map;
+    file->Mapsize = (ajulong) filesize;
+#else
+    (void) file;
+#endif
+
+    return;
+}
+
+
+
+
+/* @func ajCdfileClose ********************************************************
+**
+** Closes an EMBL CD-ROM index file for the caller.
+**
+** The file stays open for reuse until AJINDEX_CDIDLE more recently used
+** files are also idle, or until ajBtreeExit is called.
+**
+** @param [d] Pfile [AjPCdfile*] EMBL CD-ROM index file
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void ajCdfileClose(AjPCdfile* Pfile)
+{
+    AjPCdfile thys = *Pfile;
+    AjPCdfile idle = NULL;
+
+    if(!thys)
+        return;
+
+    *Pfile = NULL;
+
+    if(--thys->Users)
+        return;
+
+    ajListPushAppend(btreeCdfileIdle, thys);
+
+    if(ajListGetLength(btreeCdfileIdle) <= AJINDEX_CDIDLE)
+        return;
+
+    ajListPop(btreeCdfileIdle, (void**) &idle);
+    ajTableRemove(btreeCdfileTable, idle->Key);
+    btreeCdfileDel(&idle);
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeCdfileDel *************************************************
+**
+** Deletes an EMBL CD-ROM index file, closing the file and its memory map.
+**
+** @param [d] Pfile [AjPCdfile*] EMBL CD-ROM index file
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeCdfileDel(AjPCdfile* Pfile)
+{
+    AjPCdfile thys = *Pfile;
+
+    if(!thys)
+        return;
+
+    ajDebug("btreeCdfileDel '%F'\n", thys->File);
+
+#ifndef WIN32
+    if(thys->Mapped)
+        munmap((void*) thys->Mapped, (size_t) thys->Mapsize);
+#endif
+
+    ajFileClose(&thys->File);
+    ajStrDel(&thys->Key);
+    AJFREE(thys->Fanout);
+    AJFREE(thys->Fanpos);
+    AJFREE(*Pfile);
+
+    return;
+}
+
+
+
+
+/* @func ajCdfileNodeGet ******************************************************
+**
+** Returns the saved name of a record at a node of the binary search of an
+** EMBL CD-ROM index or target file. The children of node n are nodes
+** 2n+1 (lower records) and 2n+2 (higher records).
+**
+** @param [r] file [const AjPCdfile] EMBL CD-ROM index or target file
+** @param [r] inode [ajulong] Node number in the binary search
+** @param [r] ipos [ajuint] Record number
+** @return [const char*] Name, or NULL if not yet saved by ajCdfileNodePut
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+const char* ajCdfileNodeGet(const AjPCdfile file, ajulong inode, ajuint ipos)
+{
+    if(inode >= AJINDEX_CDFANOUT || !file->Fanpos)
+        return NULL;
+
+    if(file->Fanpos[inode] != ipos+1)
+        return NULL;
+
+    return &file->Fanout[inode * (file->RecSize+1)];
+}
+
+
+
+
+/* @func ajCdfileNodePut ******************************************************
+**
+** Saves the name of a record at a node of the binary search of an
+** EMBL CD-ROM index or target file.
+**
+** Names at the top AJINDEX_CDFANOUT nodes are kept with the file, so
+** repeated searches of a reused index file follow the same path but
+** only read records below the top levels.
+**
+** @param [u] file [AjPCdfile] EMBL CD-ROM index or target file
+** @param [r] inode [ajulong] Node number in the binary search
+** @param [r] ipos [ajuint] Record number
+** @param [r] name [const char*] Record name
+** @return [const char*] Name
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+const char* ajCdfileNodePut(AjPCdfile file, ajulong inode, ajuint ipos,
+                            const char* name)
+{
+    char* savename;
+
+    if(inode >= AJINDEX_CDFANOUT)
+        return name;
+
+    if(!file->Fanpos)
+    {
+        AJCNEW0(file->Fanpos, AJINDEX_CDFANOUT);
+        AJCNEW(file->Fanout, AJINDEX_CDFANOUT * (file->RecSize+1));
+    }
+
+    savename = &file->Fanout[inode * (file->RecSize+1)];
+    strcpy(savename, name);
+    file->Fanpos[inode] = ipos+1;
+
+    return savename;
+}
+
+
+
+
+/* @func ajCdfileReadHit ******************************************************
+**
+** Reads an entry number from the hit list starting at a numbered record
+** of an EMBL CD-ROM index hit file.
+**
+** @param [u] file [AjPCdfile] EMBL CD-ROM index hit file
+** @param [r] ipos [ajuint] Record number of the first hit
+** @param [r] ihit [ajuint] Hit number in the list
+** @return [ajuint] Entry number (counting from 1)
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+ajuint ajCdfileReadHit(AjPCdfile file, ajuint ipos, ajuint ihit)
+{
+    const unsigned char* rec;
+    ajuint j;
+
+    rec = ajCdfileRecord(file, ipos, 4*ihit, 4);
+
+    if(rec)
+        return ajCdfileRecUint(rec);
+
+    ajFileSeek(file->File, 300 + ipos*file->RecSize + 4*ihit, 0);
+    ajReadbinUint(file->File, &j);
+
+    return j;
+}
+
+
+
+
+/* @func ajCdfileRecord *******************************************************
+**
+** Returns the address of part of a record in a memory mapped EMBL CD-ROM
+** index file.
+**
+** @param [r] file [const AjPCdfile] EMBL CD-ROM index file
+** @param [r] ipos [ajuint] Record number
+** @param [r] offset [ajuint] Offset within the record
+** @param [r] size [ajuint] Number of bytes needed
+** @return [const unsigned char*] Record data, or NULL if the file is not
+**                                mapped or is too short
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+const unsigned char* ajCdfileRecord(const AjPCdfile file, ajuint ipos,
+                                    ajuint offset, ajuint size)
+{
+    ajulong jpos;
+
+    if(!file->Mapped)
+        return NULL;
+
+    jpos = 300 + (ajulong) ipos*file->RecSize + offset;
+
+    if(jpos + size > file->Mapsize)
+        return NULL;
+
+    return file->Mapped + jpos;
+}
+
+
+
+
+/* @func ajCdfileRecCharTrim **************************************************
+**
+** Copies a character string from a memory mapped EMBL CD-ROM index record
+** and trims trailing spaces, as ajReadbinCharTrim does for a file.
+**
+** @param [r] rec [const unsigned char*] Record data
+** @param [r] size [ajuint] Number of bytes to copy
+** @param [w] buffer [char*] Buffer of at least size+1 bytes
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void ajCdfileRecCharTrim(const unsigned char* rec, ajuint size, char* buffer)
+{
+    char* sp;
+
+    memcpy(buffer, rec, size);
+
+    buffer[size] = '\0';
+    sp = &buffer[strlen(buffer)];
+
+    while(sp > buffer)
+    {
+        sp--;
+
+        if(*sp != ' ')
+            break;
+
+        *sp = '\0';
+    }
+
+    return;
+}
+
+
+
+
+/* @func ajCdfileRecUint ******************************************************
+**
+** Decodes a little-endian unsigned integer from a memory mapped EMBL CD-ROM
+** index record, as ajReadbinUint does for a file.
+**
+** @param [r] rec [const unsigned char*] Record data
+** @return [ajuint] Unsigned integer value
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+ajuint ajCdfileRecUint(const unsigned char* rec)
+{
+    return ((ajuint) rec[0] | ((ajuint) rec[1] << 8) |
+            ((ajuint) rec[2] << 16) | ((ajuint) rec[3] << 24));
+}
+
+
+
+
+/* @func ajCdfileRecUint2 *****************************************************
+**
+** Decodes a little-endian unsigned short integer from a memory mapped
+** EMBL CD-ROM index record, as ajReadbinUint2 does for a file.
+**
+** @param [r] rec [const unsigned char*] Record data
+** @return [ajushort] Unsigned short integer value
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+ajushort ajCdfileRecUint2(const unsigned char* rec)
+{
+    return (ajushort) ((ajuint) rec[0] | ((ajuint) rec[1] << 8));
+}
+
+
+
+
 /* @func ajBtreeExit **********************************************************
 **
 ** Cleans up B+tree indexing internal memory
@@ -35060,6 +35634,14 @@ void ajBtreeExit(void)
     
     ajDebug("ajBtreeExit\n");
 
+    if(btreeCdfileTable)
+    {
+        ajTableSetDestroyvalue(btreeCdfileTable,
+                               (void(*)(void**)) &btreeCdfileDel);
+        ajTableDel(&btreeCdfileTable);
+        ajListFree(&btreeCdfileIdle);
+    }
+
     ajDebug("sync calls: %Lu Lock:%Lu Write: %Lu\n",
             statCallSync, statSyncLocked, statSyncWrite);
 
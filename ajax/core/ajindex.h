@@ -447,12 +447,14 @@ typedef struct AjSBtpage
 ** @attr tmem [AjPBtMem] Primary array allocation MRU top
 ** @attr bsmem [AjPBtMem] Secondary array allocation MRU bottom
 ** @attr tsmem [AjPBtMem] Secondary array allocation MRU top
+** @attr mapped [unsigned char*] Read-only memory map of the index file
 ** @attr replace [AjPStr] Replacement ID
-** @attr pripagetable [AjPTable] Table of cached primary pages
-** @attr secpagetable [AjPTable] Table of cached secondary pages
+** @attr pripagetable [AjPTableinline] Table of cached primary pages
+** @attr secpagetable [AjPTableinline] Table of cached secondary pages
 ** @attr totsize [ajulong] Tree index total length used
 ** @attr maxsize [ajulong] Tree index total length available
 ** @attr filesize [ajulong] Tree index length after any compression
+** @attr mapsize [ajulong] Length of memory map, zero if not mapped
 ** @attr pripagecount [ajulong] Tree index number of primary pages
 ** @attr secpagecount [ajulong] Tree index number of secondary pages
 ** @attr secrootblock [ajulong] Secondary tree root block
@@ -499,12 +501,14 @@ typedef struct AjSBtCache
     AjPBtMem tmem;
     AjPBtMem bsmem;
     AjPBtMem tsmem;
+    unsigned char *mapped;
     AjPStr replace;
-    AjPTable pripagetable;
-    AjPTable secpagetable;
+    AjPTableinline pripagetable;
+    AjPTableinline secpagetable;
     ajulong totsize;
     ajulong maxsize;
     ajulong filesize;
+    ajulong mapsize;
     ajulong pripagecount;
     ajulong secpagecount;
     ajulong secrootblock;
@@ -655,6 +659,39 @@ typedef struct AjSBtKeywild
 
 
 
+/* @data AjPCdfile ************************************************************
+**
+** EMBL CD-ROM (dbi) index file, opened and memory mapped once and shared
+** by all queries that read it
+**
+** @attr Key [AjPStr] Directory and file name
+** @attr File [AjPFile] Index file
+** @attr Mapped [unsigned char*] Read-only memory map of the file, or NULL
+** @attr Fanout [char*] Record names at the top nodes of the binary search
+** @attr Fanpos [ajuint*] Record number plus one of each fanout name,
+**                        zero if not yet read
+** @attr Mapsize [ajulong] Size of the memory map
+** @attr RecSize [ajuint] Record length
+** @attr Users [ajuint] Number of callers with the file open
+******************************************************************************/
+
+typedef struct AjSCdfile
+{
+    AjPStr Key;
+    AjPFile File;
+    unsigned char* Mapped;
+    char* Fanout;
+    ajuint* Fanpos;
+    ajulong Mapsize;
+    ajuint RecSize;
+    ajuint Users;
+} AjOCdfile;
+
+#define AjPCdfile AjOCdfile*
+
+
+
+
 #if 0
 /* #data AjPBtHybrid **********************************************************
 **
@@ -1133,7 +1170,8 @@ AjBool       ajBtreeStatIdbucket(AjPBtcache cache,
                                  const AjPBtpage page, AjBool full,
                                  ajuint* nkeys, ajuint* ndups, ajuint* nextra,
                                  ajuint* overflows, ajuint* freespace,
-                                 ajulong *refs, const AjPTable newpostable);
+                                 ajulong *refs,
+                                 const AjPTableinline newpostable);
 AjBool       ajBtreeStatNumbucket(AjPBtcache cache,
                                   const AjPBtpage page, AjBool full,
                                   ajuint* nkeys, ajuint* overflows,
@@ -1142,7 +1180,7 @@ AjBool       ajBtreeStatPribucket(AjPBtcache cache,
                                   const AjPBtpage page, AjBool full,
                                   ajuint* nkeys, ajuint* overflows,
                                   ajuint* freespace, ajulong *refs,
-                                  const AjPTable newpostable);
+                                  const AjPTableinline newpostable);
 AjBool       ajBtreeStatSecbucket(AjPBtcache cache,
                                   const AjPBtpage page, AjBool full,
                                   ajuint* nkeys, ajuint* overflows,
@@ -1151,14 +1189,28 @@ AjBool       ajBtreeStatNode(AjPBtcache cache,
                              const AjPBtpage page, AjBool full,
                              ajuint* nkeys, ajuint* overflows,
                              ajuint* freespace, ajulong* refs,
-                             const AjPTable newpostable);
+                             const AjPTableinline newpostable);
 AjBool       ajBtreeStatNumnode(AjPBtcache cache,
                                 const AjPBtpage page, AjBool full,
                                 ajuint* nkeys, ajuint* overflows,
                                 ajuint* freespace, ajulong* refs,
-                                const AjPTable newpostable);
+                                const AjPTableinline newpostable);
 void         ajBtreeExit(void);
 
+AjPCdfile    ajCdfileOpen(const AjPStr dir, const char* name);
+void         ajCdfileClose(AjPCdfile *Pfile);
+const char*  ajCdfileNodeGet(const AjPCdfile file, ajulong inode,
+                             ajuint ipos);
+const char*  ajCdfileNodePut(AjPCdfile file, ajulong inode, ajuint ipos,
+                             const char* name);
+ajuint       ajCdfileReadHit(AjPCdfile file, ajuint ipos, ajuint ihit);
+const unsigned char* ajCdfileRecord(const AjPCdfile file, ajuint ipos,
+                                    ajuint offset, ajuint size);
+void         ajCdfileRecCharTrim(const unsigned char* rec, ajuint size,
+                                 char* buffer);
+ajuint       ajCdfileRecUint(const unsigned char* rec);
+ajushort     ajCdfileRecUint2(const unsigned char* rec);
+
 /*
 ** future functions for index updating
 */
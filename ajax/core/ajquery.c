@@ -56,6 +56,8 @@ static AjPRegexp queryRegId       = NULL;
 static AjPRegexp queryRegList     = NULL;
 static AjPRegexp queryRegRange    = NULL;
 static AjPRegexp queryRegRefrange = NULL;
+static AjPRegexp queryRegRegion   = NULL;
+static AjPRegexp queryRegBamfile  = NULL;
 static AjPRegexp queryRegWild     = NULL;
 
 static void queryWildComp(void);
@@ -1450,6 +1452,8 @@ void ajQueryExit(void)
     ajRegFree(&queryRegQryField);
     ajRegFree(&queryRegRange);
     ajRegFree(&queryRegRefrange);
+    ajRegFree(&queryRegRegion);
+    ajRegFree(&queryRegBamfile);
 
     ajRegFree(&queryRegWild);
 
@@ -1727,6 +1731,7 @@ static void queryWildComp(void)
 ** @nam4rule ParseFormat Parse the format prefix
 ** @nam4rule ParseListfile Parse the listfile prefix
 ** @nam4rule ParseRange Parse the range suffix
+** @nam4rule ParseRegion Parse the reference region suffix
 ** @nam4rule ParseRead Parse a text query and read data
 **
 ** @argrule Parse Pqry [AjPStr*]  Query string
@@ -1736,6 +1741,9 @@ static void queryWildComp(void)
 ** @argrule Range Pbegin [ajint*]  Begin position
 ** @argrule Range Pend [ajint*]  End position
 ** @argrule Range Prev [AjBool*]  Reverse orientation
+** @argrule Region fmtstr [const AjPStr]  Format name
+** @argrule Region Pbegin [ajint*]  Begin position
+** @argrule Region Pend [ajint*]  End position
 ** @argrule Read textin [AjPTextin]  Text input object
 ** @argrule Read findformat [AjBool function] Function to validate format name
 ** @argrule Read Pnontext [AjBool*] True if access is a non-text method
@@ -1869,6 +1877,9 @@ AjBool ajQuerystrParseListfile(AjPStr *Pqry)
 ** Tests for "[n:n:r]" range and sets this if it is found,
 ** removing the range part of the original query.
 **
+** Also tests for a ":n:n" or ":n..n" range suffix, with an optional
+** ":r".
+**
 ** @param [u] Pqry [AjPStr*]  Query string
 ** @param [u] Pbegin [ajint*]  Begin position
 ** @param [u] Pend [ajint*]  End position
@@ -1950,6 +1961,64 @@ AjBool ajQuerystrParseRange(AjPStr *Pqry, ajint *Pbegin, ajint *Pend,
 
 
 
+/* @func ajQuerystrParseRegion ************************************************
+**
+** Parses a query (USA, UFO or general query).
+**
+** Tests for a ":n-n" region suffix on a query for a BAM file, and sets
+** the range if it is found, removing the region part of the original
+** query. The end position is optional.
+**
+** Only BAM files have an index to fetch regions of a reference sequence.
+** They are recognised by the format name or a ".bam" file extension.
+** For any other query the region suffix is not tested, so a query ending
+** in ":n-n" keeps its usual meaning.
+**
+** @param [u] Pqry [AjPStr*]  Query string
+** @param [r] fmtstr [const AjPStr]  Format name, or NULL if not known
+** @param [u] Pbegin [ajint*]  Begin position
+** @param [u] Pend [ajint*]  End position
+** @return [AjBool] True if a region was found.
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjBool ajQuerystrParseRegion(AjPStr *Pqry, const AjPStr fmtstr,
+                             ajint *Pbegin, ajint *Pend)
+{
+    AjPStr tmpstr  = NULL;
+
+    if(!queryRegInitDone)
+        queryRegInit();
+
+    ajDebug("ajQuerystrParseRegion: '%S' format '%S'\n", *Pqry, fmtstr);
+
+    if(!ajStrMatchCaseC(fmtstr, "bam") &&
+       !ajRegExec(queryRegBamfile, *Pqry))
+        return ajFalse;
+
+    if(!ajRegExec(queryRegRegion, *Pqry))
+        return ajFalse;
+
+    ajRegSubI(queryRegRegion, 2, &tmpstr);
+    ajStrToInt(tmpstr, Pbegin);
+
+    ajRegSubI(queryRegRegion, 3, &tmpstr);
+
+    if(ajStrGetLen(tmpstr))
+        ajStrToInt(tmpstr, Pend);
+
+    ajStrDel(&tmpstr);
+    ajRegSubI(queryRegRegion, 1, Pqry);
+    ajDebug("region found [%d:%d]\n", *Pbegin, *Pend);
+
+    return ajTrue;
+}
+
+
+
+
 /* @func ajQuerystrParseRead **************************************************
 **
 ** Parses a query (USA, UFO or general query).
@@ -3041,9 +3110,15 @@ static void queryRegInit(void)
                                    "(:([Rr])?)?[]]$");
 
     if(!queryRegRefrange)    /* \1 is rest of USA \2 start \4 end \6 rev */
-	queryRegRefrange = ajRegCompC("(.*):([0-9]*)(:|\\.\\.)([0-9]*)"
+	queryRegRefrange = ajRegCompC("(.*):([0-9]+)(:|\\.\\.)([0-9]*)"
                                    "(:([Rr]))?$");
 
+    if(!queryRegRegion)    /* \1 is rest of USA \2 start \3 end */
+	queryRegRegion = ajRegCompC("(.*):([0-9]+)-([0-9]*)$");
+
+    if(!queryRegBamfile)
+	queryRegBamfile = ajRegCompC("^[^:]*[.][Bb][Aa][Mm]:");
+
     queryRegInitDone = ajTrue;
 
     return;
@@ -78,6 +78,8 @@ const AjPStr  ajQuerystrParseFormat(AjPStr *Pqry, AjPTextin textin,
 AjBool        ajQuerystrParseListfile(AjPStr *Pqry);
 AjBool        ajQuerystrParseRange(AjPStr *Pqry,
                                    ajint *Pbegin, ajint *Pend, AjBool *Prev);
+AjBool        ajQuerystrParseRegion(AjPStr *Pqry, const AjPStr fmtstr,
+                                    ajint *Pbegin, ajint *Pend);
 AjBool        ajQuerystrParseRead(AjPStr *Pqry,
                                   AjPTextin textin,
                                   AjBool findformat(const AjPStr format,
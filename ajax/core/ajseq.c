@@ -49,6 +49,8 @@
 #include <float.h>
 #include <math.h>
 
+#define SEQWIN_CHUNKSIZE 65536
+
 static AjPStr seqVersionAccnum = NULL;
 
 static AjPStr seqTempUsa = NULL;
@@ -10361,6 +10363,276 @@ AjBool ajSeqrangeSetRange(AjPSeqRange range, ajulong pos, ajulong len)
 
 
 
+/* @datasection [AjPSeqwin] Sequence window scanners **************************
+**
+** Functions handling chunked scans of sliding windows over a sequence region
+**
+** @nam2rule Seqwin
+**
+******************************************************************************/
+
+
+
+
+/* @section Sequence window scanner constructors ******************************
+**
+** @fdata [AjPSeqwin]
+** @fcategory new
+**
+** @nam3rule New Constructor
+**
+** @argrule New seq [const AjPSeq] Sequence
+** @argrule New begin [ajuint] Region start position (1 for the first base)
+** @argrule New end [ajuint] Region end position
+** @argrule New window [ajuint] Window size
+** @argrule New size [ajuint] Number of window starts per chunk
+**
+** @valrule * [AjPSeqwin]
+**
+******************************************************************************/
+
+
+
+
+/* @func ajSeqwinNew **********************************************************
+**
+** Constructor for a window scanner over a region of a sequence.
+**
+** The sequence must not be modified while the scanner is in use.
+** No residues are read until the first call to ajSeqwinNext.
+**
+** @param [r] seq [const AjPSeq] Sequence
+** @param [r] begin [ajuint] Region start position (1 for the first base)
+** @param [r] end [ajuint] Region end position
+** @param [r] window [ajuint] Window size
+** @param [r] size [ajuint] Number of window starts per chunk,
+**                          zero for the default
+** @return [AjPSeqwin] Sequence window scanner
+**
+** @release 6.6.0
+******************************************************************************/
+
+AjPSeqwin ajSeqwinNew(const AjPSeq seq, ajuint begin, ajuint end,
+                      ajuint window, ajuint size)
+{
+    AjPSeqwin ret;
+    ajuint len;
+
+    AJNEW0(ret);
+
+    ret->Seq = seq;
+    ret->Window = window ? window : 1;
+    ret->Size = size ? size : SEQWIN_CHUNKSIZE;
+
+    len = ajSeqGetLen(seq);
+
+    if(end > len)
+        end = len;
+
+    if(begin && begin <= end)
+    {
+        ret->Begin  = begin - 1;
+        ret->Length = end - begin + 1;
+    }
+
+    if(ret->Length >= ret->Window)
+        ret->Nwin = ret->Length - ret->Window + 1;
+
+    return ret;
+}
+
+
+
+
+/* @section destructors *******************************************************
+**
+** Destruction destroys all internal data structures and frees the
+** memory allocated for a sequence window scanner
+**
+** @fdata [AjPSeqwin]
+** @fcategory delete
+**
+** @nam3rule Del Destroy (free) a window scanner
+**
+** @argrule * Pseqwin [AjPSeqwin*] Window scanner address
+**
+** @valrule * [void]
+**
+******************************************************************************/
+
+
+
+
+/* @func ajSeqwinDel **********************************************************
+**
+** Deletes a sequence window scanner. The sequence is not deleted.
+**
+** @param [d] Pseqwin [AjPSeqwin*] Window scanner
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void ajSeqwinDel(AjPSeqwin* Pseqwin)
+{
+    if(!Pseqwin || !*Pseqwin)
+        return;
+
+    ajStrDel(&(*Pseqwin)->Chunk);
+
+    AJFREE(*Pseqwin);
+
+    return;
+}
+
+
+
+
+/* @section iterators *********************************************************
+**
+** Moves a window scanner to its next chunk
+**
+** @fdata [AjPSeqwin]
+** @fcategory modify
+**
+** @nam3rule Next Load the next chunk
+**
+** @argrule * seqwin [AjPSeqwin] Window scanner
+**
+** @valrule * [AjBool] True if a chunk was loaded
+**
+******************************************************************************/
+
+
+
+
+/* @func ajSeqwinNext *********************************************************
+**
+** Loads the next chunk of a window scanner.
+**
+** The chunk holds the residues of up to Size successive windows in
+** uppercase, plus the residue following the last window where the region
+** has one. Chunks are read in order from the start of the region.
+**
+** @param [u] seqwin [AjPSeqwin] Window scanner
+** @return [AjBool] True if a chunk was loaded, false at the end of
+**                  the region
+**
+** @release 6.6.0
+******************************************************************************/
+
+AjBool ajSeqwinNext(AjPSeqwin seqwin)
+{
+    ajuint start;
+    ajuint len;
+
+    start = seqwin->Start + seqwin->Count;
+    seqwin->Start = start;
+    seqwin->Count = 0;
+
+    if(start >= seqwin->Nwin)
+        return ajFalse;
+
+    seqwin->Count = seqwin->Nwin - start;
+
+    if(seqwin->Count > seqwin->Size)
+        seqwin->Count = seqwin->Size;
+
+    len = seqwin->Count + seqwin->Window;
+
+    if(start + len > seqwin->Length)
+        len = seqwin->Length - start;
+
+    ajStrAssignLenC(&seqwin->Chunk,
+                    ajSeqGetSeqC(seqwin->Seq) + seqwin->Begin + start, len);
+    ajStrFmtUpper(&seqwin->Chunk);
+
+    return ajTrue;
+}
+
+
+
+
+/* @section element retrieval *************************************************
+**
+** These functions return the contents of a window scanner.
+**
+** @fdata [AjPSeqwin]
+** @fcategory use
+**
+** @nam3rule Get       Return window scanner attribute(s)
+** @nam4rule GetCount  Return number of window starts in the current chunk
+** @nam4rule GetPtr    Return residues of the current chunk
+** @nam4rule GetStart  Return region offset of the current chunk
+**
+** @argrule * seqwin [const AjPSeqwin] Window scanner
+**
+** @valrule GetCount [ajuint] Number of window starts
+** @valrule GetPtr [const char*] Uppercase residues
+** @valrule GetStart [ajuint] Region offset (0 for the first base)
+**
+******************************************************************************/
+
+
+
+
+/* @func ajSeqwinGetCount *****************************************************
+**
+** Returns the number of window starts in the current chunk
+**
+** @param [r] seqwin [const AjPSeqwin] Window scanner
+** @return [ajuint] Number of window starts
+**
+** @release 6.6.0
+******************************************************************************/
+
+ajuint ajSeqwinGetCount(const AjPSeqwin seqwin)
+{
+    return seqwin->Count;
+}
+
+
+
+
+/* @func ajSeqwinGetPtr *******************************************************
+**
+** Returns the uppercase residues of the current chunk. The first residue
+** is the start of the first window in the chunk.
+**
+** @param [r] seqwin [const AjPSeqwin] Window scanner
+** @return [const char*] Uppercase residues
+**
+** @release 6.6.0
+******************************************************************************/
+
+const char* ajSeqwinGetPtr(const AjPSeqwin seqwin)
+{
+    return ajStrGetPtr(seqwin->Chunk);
+}
+
+
+
+
+/* @func ajSeqwinGetStart *****************************************************
+**
+** Returns the offset in the region of the first window start in the
+** current chunk
+**
+** @param [r] seqwin [const AjPSeqwin] Window scanner
+** @return [ajuint] Region offset (0 for the first base)
+**
+** @release 6.6.0
+******************************************************************************/
+
+ajuint ajSeqwinGetStart(const AjPSeqwin seqwin)
+{
+    return seqwin->Start;
+}
+
+
+
+
 /* @datasection [AjPStr] string tests *****************************************
 **
 ** Functions handling strings for specialist sequence-related tests
@@ -223,6 +223,13 @@ AjPSeqRange  ajSeqrangeNewValues(ajulong pos, ajulong len, const AjPStr qry);
 void         ajSeqrangeDel(AjPSeqRange* Prange);
 AjBool       ajSeqrangeSetQuery(AjPSeqRange range, const AjPStr qry);
 AjBool       ajSeqrangeSetRange(AjPSeqRange range, ajulong pos, ajulong len);
+AjPSeqwin    ajSeqwinNew(const AjPSeq seq, ajuint begin, ajuint end,
+                         ajuint window, ajuint size);
+void         ajSeqwinDel(AjPSeqwin* Pseqwin);
+AjBool       ajSeqwinNext(AjPSeqwin seqwin);
+ajuint       ajSeqwinGetCount(const AjPSeqwin seqwin);
+const char*  ajSeqwinGetPtr(const AjPSeqwin seqwin);
+ajuint       ajSeqwinGetStart(const AjPSeqwin seqwin);
 AjPSeqRef    ajSeqrefNew(void);
 AjPSeqRef    ajSeqrefNewRef(const AjPSeqRef);
 void         ajSeqrefDel(AjPSeqRef*);
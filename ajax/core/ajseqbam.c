@@ -895,6 +895,8 @@ typedef struct BamSCache
 **
 ** @value AJSEQBAM_DEFAULT_BLOCK_SIZE [int] Default block size of 64k
 ** @value AJSEQBAM_MAX_BLOCK_SIZE [int] Maximum block size also 64k
+** @value AJSEQBAM_QUEUE_SIZE [int] Size of queue for compressed blocks
+**                                  waiting to be written
 ** @value AJSEQBAM_BLOCK_FOOTER_LENGTH [int] Block footer length
 ** @value AJSEQBAM_GZIP_ID1 [int] Gzip magic id 1
 ** @value AJSEQBAM_GZIP_ID2 [int] Gzip magic id 2
@@ -911,6 +913,7 @@ typedef struct BamSCache
 
 static const int AJSEQBAM_DEFAULT_BLOCK_SIZE = 64 * 1024;
 static const int AJSEQBAM_MAX_BLOCK_SIZE = 64 * 1024;
+static const int AJSEQBAM_QUEUE_SIZE = 16 * 64 * 1024;
 
 static const int AJSEQBAM_BLOCK_FOOTER_LENGTH = 8;
 
@@ -1137,6 +1140,11 @@ static AjPSeqBamBgzf bamBgzfOpenfdWrite(int fd, char is_uncompressed)
     fp->block_offset = 0;
     fp->block_length = 0;
     fp->error = NULL;
+    fp->cache_size = 0;
+    fp->cache = NULL;
+    fp->zstream = NULL;
+    fp->queue = NULL;
+    fp->queue_length = 0;
 
     return fp;
 }
@@ -1255,6 +1263,9 @@ AjBool ajSeqBamBgzfSetInfile(AjPSeqBamBgzf gzfile, AjPFile inf)
     gzfile->block_offset = 0;
     gzfile->block_length = 0;
     gzfile->error = NULL;
+    gzfile->zstream = NULL;
+    gzfile->queue = NULL;
+    gzfile->queue_length = 0;
 
     return ajTrue;
 }
@@ -1290,6 +1301,9 @@ AjBool ajSeqBamBgzfSetOutfile(AjPSeqBamBgzf gzfile, AjPFile outf)
     gzfile->block_offset = 0;
     gzfile->block_length = 0;
     gzfile->error = NULL;
+    gzfile->zstream = NULL;
+    gzfile->queue = NULL;
+    gzfile->queue_length = 0;
 
     return ajTrue;
 }
@@ -1361,7 +1375,7 @@ static int bamDeflateBlock(AjPSeqBamBgzf fp, int block_length)
     int compressed_length;
     int compress_level;
     int status;
-    z_stream zs;
+    z_stream *zs;
     ajuint crc;
     int remaining;
 
@@ -1388,39 +1402,56 @@ static int bamDeflateBlock(AjPSeqBamBgzf fp, int block_length)
     buffer[16] = 0; /* placeholder for block length */
     buffer[17] = 0;
 
-    /* loop to retry for blocks that do not compress enough */
-    input_length = block_length;
-    compressed_length = 0;
+    /*
+    ** The deflate stream is set up once for the file and reset for each
+    ** block, which gives the same output as a new stream per block
+    */
 
-    while(1)
+    if(!fp->zstream)
     {
 	compress_level = fp->is_uncompressed ? Z_NO_COMPRESSION :
 		Z_DEFAULT_COMPRESSION;
-        zs.zalloc = NULL;
-        zs.zfree  = NULL;
-        zs.next_in   = fp->uncompressed_block;
-        zs.avail_in  = input_length;
-        zs.next_out  = (void*)&buffer[AJSEQBAM_BLOCK_HEADER_LENGTH];
-        zs.avail_out = buffer_size - AJSEQBAM_BLOCK_HEADER_LENGTH -
-            AJSEQBAM_BLOCK_FOOTER_LENGTH;
+        AJNEW0(fp->zstream);
 
-        status = deflateInit2(&zs, compress_level, Z_DEFLATED,
+        status = deflateInit2(fp->zstream, compress_level, Z_DEFLATED,
                               AJSEQBAM_GZIP_WINDOW_BITS,
                               AJSEQBAM_Z_DEFAULT_MEM_LEVEL,
                               Z_DEFAULT_STRATEGY);
 
         if(status != Z_OK)
         {
+            AJFREE(fp->zstream);
             bamReportError(fp, "deflate init failed");
             return -1;
         }
+    }
 
-        status = deflate(&zs, Z_FINISH);
+    zs = fp->zstream;
 
-        if(status != Z_STREAM_END)
+    /* loop to retry for blocks that do not compress enough */
+    input_length = block_length;
+    compressed_length = 0;
+
+    while(1)
+    {
+        status = deflateReset(zs);
+
+        if(status != Z_OK)
         {
-            deflateEnd(&zs);
+            bamReportError(fp, "deflate reset failed");
+            return -1;
+        }
+
+        zs->next_in   = fp->uncompressed_block;
+        zs->avail_in  = input_length;
+        zs->next_out  = (void*)&buffer[AJSEQBAM_BLOCK_HEADER_LENGTH];
+        zs->avail_out = buffer_size - AJSEQBAM_BLOCK_HEADER_LENGTH -
+            AJSEQBAM_BLOCK_FOOTER_LENGTH;
+
+        status = deflate(zs, Z_FINISH);
 
+        if(status != Z_STREAM_END)
+        {
             if(status == Z_OK)
             {
                 /*
@@ -1445,15 +1476,7 @@ static int bamDeflateBlock(AjPSeqBamBgzf fp, int block_length)
             return -1;
         }
 
-        status = deflateEnd(&zs);
-
-        if(status != Z_OK)
-        {
-            bamReportError(fp, "deflate end failed");
-            return -1;
-        }
-
-        compressed_length = zs.total_out;
+        compressed_length = zs->total_out;
         compressed_length += AJSEQBAM_BLOCK_HEADER_LENGTH +
             AJSEQBAM_BLOCK_FOOTER_LENGTH;
 
@@ -1513,41 +1536,49 @@ static int bamInflateBlock(AjPSeqBamBgzf fp, int block_length)
 {
     /* Inflate the block in fp->compressed_block into fp->uncompressed_block */
     int status;
-    z_stream zs;
+    z_stream *zs;
 
-    zs.zalloc = NULL;
-    zs.zfree = NULL;
-    zs.next_in = (unsigned char*)fp->compressed_block + 18;
-    zs.avail_in = block_length - 16;
-    zs.next_out = fp->uncompressed_block;
-    zs.avail_out = fp->uncompressed_block_size;
+    /* The inflate stream is set up once and reset for each block */
 
-    status = inflateInit2(&zs, AJSEQBAM_GZIP_WINDOW_BITS);
-
-    if(status != Z_OK)
+    if(!fp->zstream)
     {
-        bamReportError(fp, "inflate init failed");
-        return -1;
-    }
+        AJNEW0(fp->zstream);
 
-    status = inflate(&zs, Z_FINISH);
+        status = inflateInit2(fp->zstream, AJSEQBAM_GZIP_WINDOW_BITS);
 
-    if(status != Z_STREAM_END)
+        if(status != Z_OK)
+        {
+            AJFREE(fp->zstream);
+            bamReportError(fp, "inflate init failed");
+            return -1;
+        }
+    }
+    else
     {
-        inflateEnd(&zs);
-        bamReportError(fp, "inflate failed");
-        return -1;
+        status = inflateReset(fp->zstream);
+
+        if(status != Z_OK)
+        {
+            bamReportError(fp, "inflate reset failed");
+            return -1;
+        }
     }
 
-    status = inflateEnd(&zs);
+    zs = fp->zstream;
+    zs->next_in = (unsigned char*)fp->compressed_block + 18;
+    zs->avail_in = block_length - 16;
+    zs->next_out = fp->uncompressed_block;
+    zs->avail_out = fp->uncompressed_block_size;
+
+    status = inflate(zs, Z_FINISH);
 
-    if(status != Z_OK)
+    if(status != Z_STREAM_END)
     {
         bamReportError(fp, "inflate failed");
         return -1;
     }
 
-    return zs.total_out;
+    return zs->total_out;
 }
 
 
@@ -1850,47 +1881,148 @@ int ajSeqBamBgzfRead(AjPSeqBamBgzf fp, void *data, int length)
 
 
 
-/* @func ajSeqBamBgzfFlush ****************************************************
+/* @funcstatic bamQueueWrite ************************************************
 **
-** Flush block to output file
+** Write the queued compressed blocks to the output file
 **
 ** @param [u] fp [AjPSeqBamBgzf] Output file
 ** @return [int] 0 on success, -1 on failure
 **
-** @release 6.3.0
+** @release 6.6.0
 ******************************************************************************/
 
-int ajSeqBamBgzfFlush(AjPSeqBamBgzf fp)
+static int bamQueueWrite(AjPSeqBamBgzf fp)
 {
     int count;
-    int block_length;
 
-    while (fp->block_offset > 0)
+    if(!fp->queue_length)
+        return 0;
+
+    count = fwrite(fp->queue, 1, fp->queue_length, fp->file);
+
+    if(count != fp->queue_length)
     {
-        block_length = bamDeflateBlock(fp, fp->block_offset);
+        bamReportError(fp, "write failed");
+        return -1;
+    }
 
-        if (block_length < 0)
-        {
-            return -1;
-        }
+    fp->queue_length = 0;
 
+    return 0;
+}
+
+
+
+
+/* @funcstatic bamQueueBlock **************************************************
+**
+** Add the compressed block to the queue of blocks waiting to be written,
+** first writing the queue if it is full.
+**
+** The block address is updated so that virtual offsets are the same as
+** when each block is written as soon as it is compressed.
+**
+** If the queue cannot be allocated, the block is written at once.
+**
+** @param [u] fp [AjPSeqBamBgzf] Output file
+** @param [r] block_length [int] Compressed block length
+** @return [int] 0 on success, -1 on failure
+**
+** @release 6.6.0
+******************************************************************************/
+
+static int bamQueueBlock(AjPSeqBamBgzf fp, int block_length)
+{
+    int count;
+
+    if(!fp->queue)
+        fp->queue = malloc(AJSEQBAM_QUEUE_SIZE);
+
+    if(!fp->queue)
+    {
         count = fwrite(fp->compressed_block, 1, block_length, fp->file);
 
-        if (count != block_length)
+        if(count != block_length)
         {
             bamReportError(fp, "write failed");
             return -1;
         }
 
         fp->block_address += block_length;
+
+        return 0;
     }
 
+    if(fp->queue_length + block_length > AJSEQBAM_QUEUE_SIZE)
+    {
+        if(bamQueueWrite(fp) != 0)
+            return -1;
+    }
+
+    memcpy(fp->queue + fp->queue_length, fp->compressed_block, block_length);
+    fp->queue_length += block_length;
+    fp->block_address += block_length;
+
     return 0;
 }
 
 
 
 
+/* @funcstatic bamFlushBlocks *************************************************
+**
+** Compress the current block and add it to the queue for writing
+**
+** @param [u] fp [AjPSeqBamBgzf] Output file
+** @return [int] 0 on success, -1 on failure
+**
+** @release 6.6.0
+******************************************************************************/
+
+static int bamFlushBlocks(AjPSeqBamBgzf fp)
+{
+    int block_length;
+
+    while (fp->block_offset > 0)
+    {
+        block_length = bamDeflateBlock(fp, fp->block_offset);
+
+        if (block_length < 0)
+        {
+            return -1;
+        }
+
+        if(bamQueueBlock(fp, block_length) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+
+
+
+/* @func ajSeqBamBgzfFlush ****************************************************
+**
+** Flush block to output file
+**
+** @param [u] fp [AjPSeqBamBgzf] Output file
+** @return [int] 0 on success, -1 on failure
+**
+** @release 6.3.0
+******************************************************************************/
+
+int ajSeqBamBgzfFlush(AjPSeqBamBgzf fp)
+{
+    if(bamFlushBlocks(fp) != 0)
+        return -1;
+
+    return bamQueueWrite(fp);
+}
+
+
+
+
 /* @func ajSeqBamBgzfWrite ****************************************************
 **
 ** Write length bytes from data to the file.
@@ -1938,7 +2070,7 @@ int ajSeqBamBgzfWrite(AjPSeqBamBgzf fp, const void* data, int length)
 
         if(fp->block_offset == block_length)
         {
-            if(ajSeqBamBgzfFlush(fp) != 0)
+            if(bamFlushBlocks(fp) != 0)
                 break;
         }
     }
@@ -1970,11 +2102,17 @@ int ajSeqBamBgzfClose(AjPSeqBamBgzf fp)
 
     if(fp->open_mode == 'w')
     {
-        if(ajSeqBamBgzfFlush(fp) != 0)
+        if(bamFlushBlocks(fp) != 0)
             return -1;
+
         /* add an empty last block */
         block_length = bamDeflateBlock(fp, 0);
-        fwrite(fp->compressed_block, 1, block_length, fp->file);
+
+        if(block_length < 0 || bamQueueBlock(fp, block_length) != 0)
+            return -1;
+
+        if(bamQueueWrite(fp) != 0)
+            return -1;
 
         if(fflush(fp->file) != 0)
         {
@@ -1989,8 +2127,19 @@ int ajSeqBamBgzfClose(AjPSeqBamBgzf fp)
             return -1;
     }
 
+    if(fp->zstream)
+    {
+        if(fp->open_mode == 'w')
+            deflateEnd(fp->zstream);
+        else
+            inflateEnd(fp->zstream);
+
+        AJFREE(fp->zstream);
+    }
+
     free(fp->uncompressed_block);
     free(fp->compressed_block);
+    free(fp->queue);
     bamCacheFree(fp);
     free(fp);
 
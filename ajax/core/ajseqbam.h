@@ -213,6 +213,8 @@ extern const char* bam_nt16_rev_table;
 ** @attr uncompressed_block [void*] Uncompressed block data
 ** @attr compressed_block [void*] Compressed block data
 ** @attr error [const char*] Error description
+** @attr zstream [z_stream*] Zlib stream reused for each block
+** @attr queue [unsigned char*] Compressed blocks waiting to be written
 ** @attr block_address [ajlong] Block offset
 ** @attr file_descriptor [int] File descriptor
 ** @attr cache_size [int] Cache size
@@ -220,10 +222,11 @@ extern const char* bam_nt16_rev_table;
 ** @attr compressed_block_size [int] Compressed block size
 ** @attr block_length [int] Block length
 ** @attr block_offset [int] Block offset
+** @attr queue_length [int] Length of compressed blocks in the queue
 ** @attr open_mode [char] Open_mode 'r' or 'w'
 ** @attr owned_file [char] Boolean
 ** @attr is_uncompressed [char] Boolean
-** @attr Padding [char[5]] Padding
+** @attr Padding [char] Padding
 **
 ******************************************************************************/
 
@@ -234,6 +237,8 @@ typedef struct AjSSeqBamBgzf
     void* uncompressed_block;
     void* compressed_block;
     const char* error;
+    z_stream* zstream;
+    unsigned char* queue;
     ajlong block_address;
     int file_descriptor;
     int cache_size;
@@ -241,10 +246,11 @@ typedef struct AjSSeqBamBgzf
     int compressed_block_size;
     int block_length;
     int block_offset;
+    int queue_length;
     char open_mode;
     char owned_file;
     char is_uncompressed;
-    char Padding[5];
+    char Padding;
 } AjOSeqBamBgzf;
 
 #define AjPSeqBamBgzf AjOSeqBamBgzf*
@@ -476,6 +476,50 @@ typedef struct AjSSeq
 
 
 
+/* @data AjPSeqwin ************************************************************
+**
+** Ajax sequence window scanner
+**
+** Delivers the residues of a sequence region in fixed size uppercase
+** chunks for sliding window calculations. Successive chunks overlap by
+** the window size so every window, plus one following residue, can be
+** read from a single chunk without copying the whole region.
+**
+** @alias AjSSeqwin
+** @alias AjOSeqwin
+**
+** @attr Seq [const AjPSeq] Sequence being scanned
+** @attr Chunk [AjPStr] Current chunk of uppercase residues
+** @attr Begin [ajuint] Region start in the sequence (0-based)
+** @attr Length [ajuint] Region length
+** @attr Window [ajuint] Window size
+** @attr Size [ajuint] Maximum number of window starts in a chunk
+** @attr Start [ajuint] Region offset of the first window start in the chunk
+** @attr Count [ajuint] Number of window starts in the chunk
+** @attr Nwin [ajuint] Total number of window starts in the region
+** @attr Padding [char[4]] Padding to alignment boundary
+** @@
+******************************************************************************/
+
+typedef struct AjSSeqwin
+{
+    const AjPSeq Seq;
+    AjPStr Chunk;
+    ajuint Begin;
+    ajuint Length;
+    ajuint Window;
+    ajuint Size;
+    ajuint Start;
+    ajuint Count;
+    ajuint Nwin;
+    char Padding[4];
+} AjOSeqwin;
+
+#define AjPSeqwin AjOSeqwin*
+
+
+
+
 /* @data AjPSeqset ************************************************************
 **
 ** Ajax Sequence set object. A sequence set contains one or more
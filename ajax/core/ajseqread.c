@@ -45,6 +45,7 @@
 #include "ajnexus.h"
 #include "ajdom.h"
 #include "ajseqbam.h"
+#include "ajbamindex.h"
 #include "ajreg.h"
 #include "ajtext.h"
 #include "ajtextread.h"
@@ -132,6 +133,8 @@ static AjPStr seqSaveLine2    = NULL;
 static AjPStr seqAppendRestStr = NULL;
 static AjPStr seqAppendTmpSeq = NULL;
 static AjPStr seqQualStr      = NULL;
+static AjPStr seqSniffFirst   = NULL;
+static AjPStr seqSniffDots    = NULL;
 
 static AjPRegexp seqRegUsaAsis  = NULL;
 static AjPRegexp seqRegUsaDb    = NULL;
@@ -934,6 +937,10 @@ static const AjPStr seqAppendWarn(AjPStr* seq, const AjPStr line,
                                   ajuint informat);
 static ajuint     seqAppendCommented(AjPStr* seq, AjBool* incomment,
                                      const AjPStr line);
+static ajuint     seqBamQueryTargets(const AjPQuery qry,
+                                     const AjPSeqBamHeader header,
+                                     const AjPBamIndex idx,
+                                     ajint **Ptids);
 static AjBool     seqClustalReadseq(const AjPStr rdLine,
                                     const AjPTable msftable);
 static AjBool     seqDefine(AjPSeq thys, AjPSeqin seqin);
@@ -950,6 +957,8 @@ static AjBool     seqGcgMsfReadseq(const AjPStr rdline,
                                    const AjPTable msftable);
 static AjBool     seqHennig86Readseq(const AjPStr rdline,
                                      const AjPTable msftable);
+static AjBool     seqinSniff(AjPFilebuff buff);
+static AjBool     seqinSniffFormat(ajuint format);
 static AjBool     seqinUfoLocal(const AjPSeqin thys);
 static void       seqListNoComment(AjPStr* text);
 static AjBool     seqinListProcess(AjPSeqin seqin, AjPSeq thys,
@@ -2834,6 +2843,7 @@ static AjBool seqRead(AjPSeq thys, AjPSeqin seqin)
     AjPFilebuff buff = textin->Filebuff;
     AjPQuery qry = textin->Query;
     AjBool regfile = ajFalse;
+    AjBool sniffed = ajFalse;
     AjBool ok;
     AjPTextAccess textaccess = NULL;
     AjPSeqAccess  seqaccess  = NULL;
@@ -2907,6 +2917,12 @@ static AjBool seqRead(AjPSeq thys, AjPSeqin seqin)
 
         regfile = ajFileIsFile(ajFilebuffGetFile(textin->Filebuff));
 
+        /* look once at the start of the file to rule out formats */
+        sniffed = ajFalse;
+
+        if(!seqin->SeqData)
+            sniffed = seqinSniff(textin->Filebuff);
+
         for(i = 1; seqinFormatDef[i].Name; i++)
         {
             if(!seqinFormatDef[i].Try)  /* skip if Try is ajFalse */
@@ -2919,6 +2935,19 @@ static AjBool seqRead(AjPSeq thys, AjPSeqin seqin)
                 continue;
             }
 
+            /* a failed format may have changed the buffer */
+            if(sniffed &&
+               !ajStrMatchS(ajFilebuffGetFirst(textin->Filebuff),
+                            seqSniffFirst))
+                sniffed = ajFalse;
+
+            if(sniffed && !seqinSniffFormat(i))
+            {
+                ajDebug("seqRead: start of file rules out format %d (%s)\n",
+                        i, seqinFormatDef[i].Name);
+                continue;
+            }
+
             ajDebug("seqRead:try format %d (%s) records: %u (total %u) "
                     "seqdata: %p\n",
                     i, seqinFormatDef[i].Name,
@@ -2982,6 +3011,10 @@ static AjBool seqRead(AjPSeq thys, AjPSeqin seqin)
         ajDebug("seqRead: one format specified\n");
         ajFilebuffSetUnbuffered(textin->Filebuff);
 
+        /* text formats can read large files in blocks */
+        if(!seqinFormatDef[textin->Format].Binary)
+            ajFilebuffSetBlocked(textin->Filebuff);
+
         ajDebug("++seqRead known format %d\n", textin->Format);
         istat = seqReadFmt(thys, seqin, textin->Format);
 
@@ -10085,6 +10118,72 @@ static AjBool seqReadMase(AjPSeq thys, AjPSeqin seqin)
 
 
 
+/* @funcstatic seqBamQueryTargets *********************************************
+**
+** Finds the reference sequences in a BAM file header whose names match
+** the id fields of a query, and are covered by the index
+**
+** @param [r] qry [const AjPQuery] Query
+** @param [r] header [const AjPSeqBamHeader] BAM file header
+** @param [r] idx [const AjPBamIndex] BAM file index
+** @param [w] Ptids [ajint**] Array of matching reference sequence ids
+** @return [ajuint] Number of matching reference sequences
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static ajuint seqBamQueryTargets(const AjPQuery qry,
+                                 const AjPSeqBamHeader header,
+                                 const AjPBamIndex idx,
+                                 ajint **Ptids)
+{
+    AjIList iterfield = NULL;
+    const AjPQueryField field = NULL;
+    const char* targetname;
+    ajint tid;
+    ajuint ntids = 0;
+    AjBool ok;
+
+    *Ptids = NULL;
+
+    for(tid=0; tid < header->n_targets && tid < idx->n; tid++)
+    {
+        targetname = header->target_name[tid];
+        ok = ajFalse;
+
+        iterfield = ajListIterNewread(qry->QueryFields);
+
+        while(!ok && !ajListIterDone(iterfield))
+        {
+            field = ajListIterGet(iterfield);
+
+            if(!ajStrMatchC(field->Field, "id"))
+                continue;
+
+            if(qry->CaseId)
+                ok = ajCharMatchWildS(targetname, field->Wildquery);
+            else
+                ok = ajCharMatchWildCaseS(targetname, field->Wildquery);
+        }
+
+        ajListIterDel(&iterfield);
+
+        if(!ok)
+            continue;
+
+        if(!*Ptids)
+            AJCNEW0(*Ptids, header->n_targets);
+
+        (*Ptids)[ntids++] = tid;
+    }
+
+    return ntids;
+}
+
+
+
+
 /* @funcstatic seqReadBam *****************************************************
 **
 ** Given data in a sequence structure, tries to read everything needed
@@ -10112,6 +10211,14 @@ static AjBool seqReadBam(AjPSeq thys, AjPSeqin seqin)
         ajuint Nref;
         AjPSeqBamBgzf gzfile;
         AjPSeqBam bam;
+        AjPSeqBamHeader Header;
+        AjPBamIndex Index;
+        bam_iter_t Iter;
+        ajint *Tids;
+        ajuint Ntids;
+        ajuint Itid;
+        ajint Begin;
+        ajint End;
     } *bamdata = NULL;
     static AjBool called = ajFalse;
     static AjBool bigendian = ajFalse;
@@ -10128,6 +10235,11 @@ static AjBool seqReadBam(AjPSeq thys, AjPSeqin seqin)
     unsigned char dp;
     AjPSeqBamHeader header = NULL;
     ajint filestat;
+    AjPQuery qry;
+    ajint tid;
+    ajint ibegin;
+    ajint iend;
+    ajint ilen;
 
 
     if(!called)
@@ -10186,7 +10298,38 @@ static AjBool seqReadBam(AjPSeq thys, AjPSeqin seqin)
             return ajFalse;
         }
 
-        ajSeqBamHeaderDel(&header);
+        /*
+        ** If the file is indexed, an id query can name reference
+        ** sequences. The reads aligned to them are fetched using the
+        ** index, and any range is the region of the reference sequence
+        ** rather than a range of each read.
+        */
+
+        qry = seqin->Input->Query;
+
+        if(ajListGetLength(qry->QueryFields))
+            bamdata->Index = ajBamIndexLoad(ajFileGetNameC(infile));
+
+        if(bamdata->Index)
+            bamdata->Ntids = seqBamQueryTargets(qry, header, bamdata->Index,
+                                                &bamdata->Tids);
+
+        if(bamdata->Ntids)
+        {
+            ajDebug("seqReadBam region query %u references %d..%d\n",
+                    bamdata->Ntids, seqin->Begin, seqin->End);
+            bamdata->Header = header;
+            bamdata->Begin = seqin->Begin;
+            bamdata->End = seqin->End;
+            seqin->Begin = 0;
+            seqin->End = 0;
+            qry->QryDone = ajTrue;
+        }
+        else
+        {
+            ajBamIndexDel(&bamdata->Index);
+            ajSeqBamHeaderDel(&header);
+        }
 
         bamdata->bam = (AjPSeqBam)calloc(1, sizeof(AjOSeqBam));
         seqin->SeqData = bamdata;
@@ -10196,7 +10339,55 @@ static AjBool seqReadBam(AjPSeq thys, AjPSeqin seqin)
 
     bamdata = seqin->SeqData;
     b = bamdata->bam;
-    ret = ajSeqBamRead(bamdata->gzfile, b);
+
+    if(bamdata->Ntids)
+    {
+        ret = -1;
+
+        while(bamdata->Itid < bamdata->Ntids)
+        {
+            if(!bamdata->Iter)
+            {
+                tid = bamdata->Tids[bamdata->Itid];
+                ilen = (ajint) bamdata->Header->target_len[tid];
+                ibegin = bamdata->Begin;
+                iend = bamdata->End;
+
+                if(ibegin < 0)
+                    ibegin += ilen + 1;
+
+                if(ibegin < 1)
+                    ibegin = 1;
+
+                if(iend < 0)
+                    iend += ilen + 1;
+
+                if(!iend || iend > ilen)
+                    iend = ilen;
+
+                bamdata->Iter = ajBamIterQuery(bamdata->Index, tid,
+                                               ibegin-1, iend);
+            }
+
+            if(bamdata->Iter)
+            {
+                ret = ajBamIterRead(bamdata->gzfile, bamdata->Iter, b);
+
+                if(ret >= 0)
+                    break;
+
+                ajBamIterDel(&bamdata->Iter);
+
+                if(ret < -1)
+                    break;
+            }
+
+            bamdata->Itid++;
+        }
+    }
+    else
+        ret = ajSeqBamRead(bamdata->gzfile, b);
+
     if(ret < -1)
         ajErr("seqReadBam truncated file return %d\n", ret);
 
@@ -10206,6 +10397,10 @@ static AjBool seqReadBam(AjPSeq thys, AjPSeqin seqin)
         ajFilebuffClear(seqin->Input->Filebuff, 0);
         /*seqMsfDataDel((SeqPMsfData*)&seqin->SeqData);*/
         free(bamdata->bam->data); free(bamdata->bam);
+        ajBamIterDel(&bamdata->Iter);
+        ajBamIndexDel(&bamdata->Index);
+        ajSeqBamHeaderDel(&bamdata->Header);
+        AJFREE(bamdata->Tids);
 
         AJFREE(seqin->SeqData);
         return ajFalse;
@@ -17152,6 +17347,159 @@ static void seqGcgRegInit(void)
 
 
 
+/* @funcstatic seqinSniff *****************************************************
+**
+** Looks once at the start of a buffered input file of unknown format,
+** saving the first line and the first GCG ".." line within the number
+** of lines the GCG and MSF readers would test.
+**
+** The buffer is reset so the lines can be read again by each format.
+**
+** @param [u] buff [AjPFilebuff] Buffered input file
+** @return [AjBool] ajTrue if the start of the file was read
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static AjBool seqinSniff(AjPFilebuff buff)
+{
+    AjPStr line = NULL;
+    ajint nlines = 0;
+
+    ajStrAssignClear(&seqSniffFirst);
+    ajStrAssignClear(&seqSniffDots);
+
+    if(!ajFilebuffIsBuffered(buff) || !ajFilebuffGetFirst(buff))
+        return ajFalse;
+
+    ajFilebuffReset(buff);
+
+    while(nlines < seqMaxGcglines && ajBuffreadLine(buff, &line))
+    {
+        if(!nlines++)
+            ajStrAssignS(&seqSniffFirst, line);
+
+        if(strstr(MAJSTRGETPTR(line), ".."))
+        {
+            ajStrAssignS(&seqSniffDots, line);
+            break;
+        }
+    }
+
+    ajFilebuffReset(buff);
+    ajStrDel(&line);
+
+    ajDebug("seqinSniff lines:%d first: '%S' dots: '%S'\n",
+            nlines, seqSniffFirst, seqSniffDots);
+
+    return (nlines > 0);
+}
+
+
+
+
+/* @funcstatic seqinSniffFormat ***********************************************
+**
+** Tests whether the start of the file saved by seqinSniff could be read
+** in a given format.
+**
+** Only rules out a format when its reader would fail on the first line,
+** or would find no suitable GCG ".." line. Other formats are always
+** possible, so the formats left are tried in the usual order and the
+** result is the same as trying every format.
+**
+** @param [r] format [ajuint] Input format code
+** @return [AjBool] ajTrue if the format is still possible
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static AjBool seqinSniffFormat(ajuint format)
+{
+    AjBool (*readfunc) (AjPSeq thys, AjPSeqin seqin);
+    const char* cp;
+    const char* cq;
+
+    readfunc = seqinFormatDef[format].Read;
+    cp = MAJSTRGETPTR(seqSniffFirst);
+
+    /* leading white space is skipped by some readers */
+    cq = cp;
+
+    while(*cq == ' ' || *cq == '\t')
+        cq++;
+
+    if(readfunc == seqReadGcg || readfunc == seqReadMsf)
+    {
+        if(!ajStrGetLen(seqSniffDots))
+            return ajFalse;
+
+        seqGcgRegInit();
+
+        if(!ajRegExec(seqRegGcgChk, seqSniffDots))
+            return ajFalse;
+
+        if(readfunc == seqReadMsf)
+            return ajRegExec(seqRegGcgMsf, seqSniffDots);
+
+        return !ajRegExec(seqRegGcgMsf, seqSniffDots);
+    }
+
+    if(readfunc == seqReadEmbl || readfunc == seqReadSwiss)
+        return (!strncmp(cp, "ID", 2) || !strncmp(cp, "WP", 2));
+
+    if(readfunc == seqReadGenbank)
+        return (!strncmp(cp, "LOCUS", 5) || !strncmp(cp, "WPCOMMENT", 9) ||
+                strstr(cp, "Genetic Sequence Data Bank"));
+
+    if(readfunc == seqReadNcbi)
+        return (*cp == '>');
+
+    if(readfunc == seqReadNbrf)
+        return (*cp == '>' || !strncmp(cp, "C;", 2));
+
+    if(readfunc == seqReadFastq)
+        return (*cp == '@');
+
+    if(readfunc == seqReadSam)
+        return (*cp == '@' || ajStrCalcCountK(seqSniffFirst, '\t') >= 10);
+
+    if(readfunc == seqReadPdb)
+        return !strncmp(cp, "HEADER    ", 10);
+
+    if(readfunc == seqReadCodata)
+        return !strncmp(cp, "ENTRY ", 6);
+
+    if(readfunc == seqReadClustal)
+        return !strncmp(cp, "CLUSTAL", 7);
+
+    if(readfunc == seqReadNexus)
+        return ajStrPrefixCaseC(seqSniffFirst, "#NEXUS");
+
+    if(readfunc == seqReadStockholm)
+        return !strncmp(cp, "# STOCKHOLM 1.", 14);
+
+    if(readfunc == seqReadGff2)
+        return !strncmp(cp, "##gff-version ", 14);
+
+    if(readfunc == seqReadGff3)
+        return !strncmp(cq, "##gff-version", 13);
+
+    if(readfunc == seqReadAce)
+        return (toupper((ajint) cq[0]) == 'A' &&
+                toupper((ajint) cq[1]) == 'S');
+
+    if(readfunc == seqReadPhylip)
+        return isdigit((ajint) *cq);
+
+    return ajTrue;
+}
+
+
+
+
 /* @funcstatic seqGcgDots *****************************************************
 **
 ** Looks for the ".." line in the header of a GCG format sequence.
@@ -17619,7 +17967,10 @@ static AjBool seqinUsaProcess(AjPSeqin seqin, AjPSeq thys)
     ajDebug("seqinUsaProcess ... fmtstr '%S' '%S'\n", fmtstr, qrystr);
 
     /* (seq/feat) look for a [range] suffix */
-    ajQuerystrParseRange(&qrystr, &seqin->Begin, &seqin->End, &seqin->Rev);
+    if(!ajQuerystrParseRange(&qrystr, &seqin->Begin, &seqin->End,
+                             &seqin->Rev))
+        /* (bam) look for a :n-n region suffix */
+        ajQuerystrParseRegion(&qrystr, fmtstr, &seqin->Begin, &seqin->End);
     ajDebug("seqinUsaProcess ... range %d..%d rev:%B '%S'\n",
             seqin->Begin, seqin->End, seqin->Rev, qrystr);
 
@@ -19402,6 +19753,8 @@ void ajSeqReadExit(void)
     ajStrDel(&seqQualStr);
 
     ajStrDel(&seqReadLine);
+    ajStrDel(&seqSniffFirst);
+    ajStrDel(&seqSniffDots);
     ajStrDel(&seqSaveLine);
     ajStrDel(&seqSaveLine2);
 
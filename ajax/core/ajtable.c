@@ -65,6 +65,15 @@
 /* =========================== private constants =========================== */
 /* ========================================================================= */
 
+#define TABLEINLINE_MINBITS 4U
+#define TABLEINLINE_MINSIZE (1UL << TABLEINLINE_MINBITS)
+#define TABLEINLINE_MAXBITS 32U
+#define TABLEINLINE_BLOCK   1024UL
+
+#define TABLEINLINE_MIX      ((ajulong) 0x9E3779B97F4A7C15ULL)
+#define TABLEINLINE_FNVBASIS ((ajulong) 0xCBF29CE484222325ULL)
+#define TABLEINLINE_FNVPRIME ((ajulong) 0x100000001B3ULL)
+
 
 
 
@@ -105,6 +114,16 @@ static const char* tableType(const AjPTable table);
 static void   tableStrFromKey(const AjPTable table, const void* key,
                               AjPStr* Pstr);
 
+static AjPTableinline tableinlineNew(ajulong size, ajuint keylen,
+                                     AjBool nocase);
+static ajulong tableinlineAdd(AjPTableinline table, ajulong hash,
+                              ajulong islot);
+static ajulong tableinlineFind(const AjPTableinline table, ajulong hash,
+                               const char* key, ajulong* Pslot);
+static ajulong tableinlineHashC(const AjPTableinline table, const char* key);
+static void*   tableinlineRemove(AjPTableinline table, ajulong islot);
+static char*   tableinlineWord(const AjPTableinline table, ajulong ientry);
+
 
 
 
@@ -6030,6 +6049,997 @@ static void tableDelStr(void** Pstr)
 
 
 
+/* @datasection [AjPTableinline] Inline key hash tables ***********************
+**
+** Hash tables with unsigned long or fixed length word keys held in the
+** table itself
+**
+** @nam2rule Tableinline Inline key hash tables
+**
+******************************************************************************/
+
+
+
+
+/* @section Constructors ******************************************************
+**
+** Constructors for inline key hash tables
+**
+** @fdata [AjPTableinline]
+**
+** @fcategory new
+**
+** @nam3rule New Constructor
+** @nam4rule Ulong Unsigned long integer keys
+** @nam4rule Word Fixed length word keys
+** @suffix Case Case-insensitive word keys
+**
+** @argrule New size [ajulong] Number of key values
+** @argrule Word keylen [ajuint] Word key length
+**
+** @valrule * [AjPTableinline] New hash table
+**
+******************************************************************************/
+
+
+
+
+/* @func ajTableinlineNewUlong ************************************************
+**
+** Creates, initialises, and returns a new, empty table that can hold an
+** arbitrary number of unsigned long integer key-value pairs, with the
+** keys stored in the table.
+**
+** @param [r] size [ajulong] estimate of number of unique keys
+** @return [AjPTableinline] new table.
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjPTableinline ajTableinlineNewUlong(ajulong size)
+{
+    return tableinlineNew(size, 0U, ajFalse);
+}
+
+
+
+
+/* @func ajTableinlineNewWord *************************************************
+**
+** Creates, initialises, and returns a new, empty table that can hold an
+** arbitrary number of key-value pairs with words of a fixed length as keys,
+** with a copy of each key stored in the table.
+**
+** @param [r] size [ajulong] estimate of number of unique keys
+** @param [r] keylen [ajuint] word length
+** @return [AjPTableinline] new table.
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjPTableinline ajTableinlineNewWord(ajulong size, ajuint keylen)
+{
+    return tableinlineNew(size, keylen, ajFalse);
+}
+
+
+
+
+/* @func ajTableinlineNewWordCase *********************************************
+**
+** Creates, initialises, and returns a new, empty table that can hold an
+** arbitrary number of key-value pairs with case-insensitive words of a
+** fixed length as keys, with a copy of the first form of each key
+** stored in the table.
+**
+** @param [r] size [ajulong] estimate of number of unique keys
+** @param [r] keylen [ajuint] word length
+** @return [AjPTableinline] new table.
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjPTableinline ajTableinlineNewWordCase(ajulong size, ajuint keylen)
+{
+    return tableinlineNew(size, keylen, ajTrue);
+}
+
+
+
+
+/* @funcstatic tableinlineNew *************************************************
+**
+** Creates an empty inline key table with an index large enough for the
+** expected number of keys at no more than half full.
+**
+** @param [r] size [ajulong] estimate of number of unique keys
+** @param [r] keylen [ajuint] word length, or zero for unsigned long keys
+** @param [r] nocase [AjBool] True if word keys are case-insensitive
+** @return [AjPTableinline] new table.
+**
+** @release 6.6.0
+******************************************************************************/
+
+static AjPTableinline tableinlineNew(ajulong size, ajuint keylen,
+                                     AjBool nocase)
+{
+    AjPTableinline table = NULL;
+    ajulong nslots = TABLEINLINE_MINSIZE;
+    ajuint bits    = TABLEINLINE_MINBITS;
+
+    while(nslots < 2 * size && bits < TABLEINLINE_MAXBITS)
+    {
+        nslots <<= 1;
+        bits++;
+    }
+
+    AJNEW0(table);
+
+    table->Size   = nslots;
+    table->Shift  = (ajuint) (CHAR_BIT * sizeof(ajulong)) - bits;
+    table->Keylen = keylen;
+    table->Nocase = nocase;
+
+    AJCNEW0(table->Slots, nslots);
+
+    return table;
+}
+
+
+
+
+/* @section Destructors *******************************************************
+**
+** Destructors for inline key hash tables
+**
+** @fdata [AjPTableinline]
+**
+** @fcategory delete
+**
+** @nam3rule Del Delete table
+** @suffix Valdel Value destructor function
+**
+** @argrule * Ptable [AjPTableinline*] Table
+** @argrule Valdel valdel [void function] Value destructor function
+**
+** @valrule * [void]
+**
+******************************************************************************/
+
+
+
+
+/* @func ajTableinlineDel *****************************************************
+**
+** Deallocates an inline key hash table and its keys. Values are not
+** deleted.
+**
+** @param [d] Ptable [AjPTableinline*] Table (by reference)
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void ajTableinlineDel(AjPTableinline* Ptable)
+{
+    ajulong i;
+    ajulong nblocks;
+    AjPTableinline table;
+
+    if(!Ptable)
+        return;
+    if(!*Ptable)
+        return;
+
+    table = *Ptable;
+
+    if(table->Words)
+    {
+        nblocks = (table->Maxlength + TABLEINLINE_BLOCK - 1) /
+            TABLEINLINE_BLOCK;
+
+        for(i = 0UL; i < nblocks; i++)
+            AJFREE(table->Words[i]);
+
+        AJFREE(table->Words);
+    }
+
+    AJFREE(table->Slots);
+    AJFREE(table->Values);
+    AJFREE(table->Keys);
+    AJFREE(*Ptable);
+
+    return;
+}
+
+
+
+
+/* @func ajTableinlineDelValdel ***********************************************
+**
+** Deallocates an inline key hash table, its keys, and its values using
+** a destructor function.
+**
+** @param [d] Ptable [AjPTableinline*] Table (by reference)
+** @param [f] valdel [void function] value destructor function
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void ajTableinlineDelValdel(AjPTableinline* Ptable,
+                            void (*valdel)(void** Pvalue))
+{
+    ajulong i;
+    AjPTableinline table;
+
+    if(!Ptable)
+        return;
+    if(!*Ptable)
+        return;
+
+    table = *Ptable;
+
+    if(valdel)
+        for(i = 0UL; i < table->Length; i++)
+            (*valdel)(&table->Values[i]);
+
+    ajTableinlineDel(Ptable);
+
+    return;
+}
+
+
+
+
+/* @section Retrieval *********************************************************
+**
+** Retrieving data from an inline key hash table
+**
+** @fdata [AjPTableinline]
+**
+** @fcategory use
+**
+** @nam3rule Fetch Retrieval function
+** @nam3rule Get Return attribute
+** @nam4rule Fetchkey Return the stored key
+** @nam4rule Fetchmod Return modifiable value
+** @nam4rule Length Number of entries
+** @suffix C Word key
+** @suffix Ulong Unsigned long integer key
+**
+** @argrule * table [const AjPTableinline] Hash table
+** @argrule C key [const char*] Word key
+** @argrule Ulong key [ajulong] Unsigned long integer key
+**
+** @valrule Fetch [const void*] Value
+** @valrule Fetchkey [const char*] Stored key
+** @valrule Fetchmod [void*] Modifiable value
+** @valrule Length [ajulong] Number of entries
+**
+******************************************************************************/
+
+
+
+
+/* @func ajTableinlineFetchC **************************************************
+**
+** Returns the value associated with a word key in an inline key table.
+**
+** Only the first word length characters of the key are used.
+**
+** @param [r] table [const AjPTableinline] table to search
+** @param [r] key [const char*] key to find
+** @return [const void*] value associated with key, or NULL if not found
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+const void* ajTableinlineFetchC(const AjPTableinline table, const char* key)
+{
+    return ajTableinlineFetchmodC(table, key);
+}
+
+
+
+
+/* @func ajTableinlineFetchkeyC ***********************************************
+**
+** Returns the copy of a word key stored in an inline key table.
+**
+** For a case-insensitive table this is the key as first added. The
+** stored key can be moved by removing another entry.
+**
+** @param [r] table [const AjPTableinline] table to search
+** @param [r] key [const char*] key to find
+** @return [const char*] stored key, or NULL if not found
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+const char* ajTableinlineFetchkeyC(const AjPTableinline table,
+                                   const char* key)
+{
+    ajulong islot;
+    ajulong ientry;
+
+    if(!table || !table->Keylen)
+        return NULL;
+
+    ientry = tableinlineFind(table, tableinlineHashC(table, key), key, &islot);
+
+    if(!ientry)
+        return NULL;
+
+    return tableinlineWord(table, ientry-1);
+}
+
+
+
+
+/* @func ajTableinlineFetchmodC ***********************************************
+**
+** Returns the value associated with a word key in an inline key table.
+** The value can be modified by the caller.
+**
+** Only the first word length characters of the key are used.
+**
+** @param [r] table [const AjPTableinline] table to search
+** @param [r] key [const char*] key to find
+** @return [void*] value associated with key, or NULL if not found
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void* ajTableinlineFetchmodC(const AjPTableinline table, const char* key)
+{
+    ajulong islot;
+    ajulong ientry;
+
+    if(!table || !table->Keylen)
+        return NULL;
+
+    ientry = tableinlineFind(table, tableinlineHashC(table, key), key, &islot);
+
+    if(!ientry)
+        return NULL;
+
+    return table->Values[ientry-1];
+}
+
+
+
+
+/* @func ajTableinlineFetchUlong **********************************************
+**
+** Returns the value associated with an unsigned long key in an inline
+** key table.
+**
+** @param [r] table [const AjPTableinline] table to search
+** @param [r] key [ajulong] key to find
+** @return [const void*] value associated with key, or NULL if not found
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+const void* ajTableinlineFetchUlong(const AjPTableinline table, ajulong key)
+{
+    return ajTableinlineFetchmodUlong(table, key);
+}
+
+
+
+
+/* @func ajTableinlineFetchmodUlong *******************************************
+**
+** Returns the value associated with an unsigned long key in an inline
+** key table. The value can be modified by the caller.
+**
+** @param [r] table [const AjPTableinline] table to search
+** @param [r] key [ajulong] key to find
+** @return [void*] value associated with key, or NULL if not found
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void* ajTableinlineFetchmodUlong(const AjPTableinline table, ajulong key)
+{
+    ajulong islot;
+    ajulong ientry;
+
+    if(!table || table->Keylen)
+        return NULL;
+
+    ientry = tableinlineFind(table, key, NULL, &islot);
+
+    if(!ientry)
+        return NULL;
+
+    return table->Values[ientry-1];
+}
+
+
+
+
+/* @func ajTableinlineGetLength ***********************************************
+**
+** Returns the number of entries in an inline key table.
+**
+** @param [r] table [const AjPTableinline] Table
+** @return [ajulong] number of entries in table.
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+ajulong ajTableinlineGetLength(const AjPTableinline table)
+{
+    if(!table)
+        return 0UL;
+
+    return table->Length;
+}
+
+
+
+
+/* @section Modifiers *********************************************************
+**
+** Updating values in an inline key hash table
+**
+** @fdata [AjPTableinline]
+**
+** @fcategory modify
+**
+** @nam3rule Clear Remove all entries
+** @nam3rule Put Add or update a value
+** @nam3rule Remove Remove an entry
+** @suffix C Word key
+** @suffix Ulong Unsigned long integer key
+**
+** @argrule * table [AjPTableinline] Hash table
+** @argrule C key [const char*] Word key
+** @argrule Ulong key [ajulong] Unsigned long integer key
+** @argrule Put value [void*] New value
+**
+** @valrule * [void*] Previous value, or NULL
+** @valrule *Clear [void]
+**
+******************************************************************************/
+
+
+
+
+/* @func ajTableinlineClear ***************************************************
+**
+** Removes all entries from an inline key table, keeping the allocated
+** memory for reuse. Values are not deleted.
+**
+** @param [u] table [AjPTableinline] Table
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void ajTableinlineClear(AjPTableinline table)
+{
+    if(!table)
+        return;
+
+    AJCSET0(table->Slots, table->Size);
+    table->Length = 0UL;
+
+    return;
+}
+
+
+
+
+/* @func ajTableinlinePutC ****************************************************
+**
+** Adds a value for a word key to an inline key table, or replaces the
+** value for a key already in the table.
+**
+** Only the first word length characters of the key are used. A copy of
+** them is stored in the table.
+**
+** @param [u] table [AjPTableinline] Table
+** @param [r] key [const char*] key
+** @param [u] value [void*] value
+** @return [void*] previous value if key exists, NULL otherwise
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void* ajTableinlinePutC(AjPTableinline table, const char* key, void* value)
+{
+    ajulong hash;
+    ajulong islot;
+    ajulong ientry;
+    char* word;
+    void* ret;
+
+    if(!table)
+        return NULL;
+
+    if(!table->Keylen)
+    {
+        ajErr("ajTableinlinePutC called for a table with integer keys");
+        return NULL;
+    }
+
+    hash = tableinlineHashC(table, key);
+    ientry = tableinlineFind(table, hash, key, &islot);
+
+    if(ientry)
+    {
+        ret = table->Values[ientry-1];
+        table->Values[ientry-1] = value;
+
+        return ret;
+    }
+
+    ientry = tableinlineAdd(table, hash, islot);
+    table->Values[ientry] = value;
+
+    word = tableinlineWord(table, ientry);
+    memcpy(word, key, table->Keylen);
+    word[table->Keylen] = '\0';
+
+    return NULL;
+}
+
+
+
+
+/* @func ajTableinlinePutUlong ************************************************
+**
+** Adds a value for an unsigned long key to an inline key table, or
+** replaces the value for a key already in the table.
+**
+** @param [u] table [AjPTableinline] Table
+** @param [r] key [ajulong] key
+** @param [u] value [void*] value
+** @return [void*] previous value if key exists, NULL otherwise
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void* ajTableinlinePutUlong(AjPTableinline table, ajulong key, void* value)
+{
+    ajulong islot;
+    ajulong ientry;
+    void* ret;
+
+    if(!table)
+        return NULL;
+
+    if(table->Keylen)
+    {
+        ajErr("ajTableinlinePutUlong called for a table with word keys");
+        return NULL;
+    }
+
+    ientry = tableinlineFind(table, key, NULL, &islot);
+
+    if(ientry)
+    {
+        ret = table->Values[ientry-1];
+        table->Values[ientry-1] = value;
+
+        return ret;
+    }
+
+    ientry = tableinlineAdd(table, key, islot);
+    table->Values[ientry] = value;
+
+    return NULL;
+}
+
+
+
+
+/* @func ajTableinlineRemoveC *************************************************
+**
+** Removes a word key and its value from an inline key table.
+** The last entry added is moved to take its place.
+**
+** @param [u] table [AjPTableinline] Table
+** @param [r] key [const char*] key to remove
+** @return [void*] removed value, or NULL if key was not found
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void* ajTableinlineRemoveC(AjPTableinline table, const char* key)
+{
+    ajulong islot;
+
+    if(!table || !table->Keylen)
+        return NULL;
+
+    if(!tableinlineFind(table, tableinlineHashC(table, key), key, &islot))
+        return NULL;
+
+    return tableinlineRemove(table, islot);
+}
+
+
+
+
+/* @func ajTableinlineRemoveUlong *********************************************
+**
+** Removes an unsigned long key and its value from an inline key table.
+** The last entry added is moved to take its place.
+**
+** @param [u] table [AjPTableinline] Table
+** @param [r] key [ajulong] key to remove
+** @return [void*] removed value, or NULL if key was not found
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void* ajTableinlineRemoveUlong(AjPTableinline table, ajulong key)
+{
+    ajulong islot;
+
+    if(!table || table->Keylen)
+        return NULL;
+
+    if(!tableinlineFind(table, key, NULL, &islot))
+        return NULL;
+
+    return tableinlineRemove(table, islot);
+}
+
+
+
+
+/* @section Cast **************************************************************
+**
+** Converting inline key hash tables to other data types
+**
+** @fdata [AjPTableinline]
+**
+** @fcategory cast
+**
+** @nam3rule Toarray Return an array
+** @nam4rule Values Array of values
+**
+** @argrule * table [const AjPTableinline] Hash table
+** @argrule Values valarray [void***] Array of values
+**
+** @valrule * [ajulong] Number of values in the array
+**
+******************************************************************************/
+
+
+
+
+/* @func ajTableinlineToarrayValues *******************************************
+**
+** Creates an N+1 element array that holds the N values in an inline key
+** table, in the order they were added, and returns the number of
+** elements. The final element of the array is NULL.
+**
+** @param [r] table [const AjPTableinline] Table
+** @param [w] valarray [void***] NULL terminated array of values.
+** @return [ajulong] size of array returned
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+ajulong ajTableinlineToarrayValues(const AjPTableinline table,
+                                   void*** valarray)
+{
+    if(*valarray)
+        AJFREE(*valarray);
+
+    if(!table)
+        return 0UL;
+
+    AJCNEW(*valarray, table->Length + 1);
+
+    if(table->Length)
+        memcpy(*valarray, table->Values,
+               (size_t) table->Length * sizeof(void*));
+
+    (*valarray)[table->Length] = NULL;
+
+    return table->Length;
+}
+
+
+
+
+/* @funcstatic tableinlineHashC ***********************************************
+**
+** FNV-1a hash of the first word length characters of a key, in upper
+** case for a case-insensitive table.
+**
+** @param [r] table [const AjPTableinline] Table
+** @param [r] key [const char*] Word key
+** @return [ajulong] Hash value
+**
+** @release 6.6.0
+******************************************************************************/
+
+static ajulong tableinlineHashC(const AjPTableinline table, const char* key)
+{
+    ajulong hash = TABLEINLINE_FNVBASIS;
+    ajuint i;
+
+    if(table->Nocase)
+        for(i = 0U; i < table->Keylen; i++)
+        {
+            hash ^= (ajulong) toupper((int) (unsigned char) key[i]);
+            hash *= TABLEINLINE_FNVPRIME;
+        }
+    else
+        for(i = 0U; i < table->Keylen; i++)
+        {
+            hash ^= (ajulong) (unsigned char) key[i];
+            hash *= TABLEINLINE_FNVPRIME;
+        }
+
+    return hash;
+}
+
+
+
+
+/* @funcstatic tableinlineWord ************************************************
+**
+** Returns the stored word key of an entry
+**
+** @param [r] table [const AjPTableinline] Table
+** @param [r] ientry [ajulong] Entry number
+** @return [char*] Stored word key
+**
+** @release 6.6.0
+******************************************************************************/
+
+static char* tableinlineWord(const AjPTableinline table, ajulong ientry)
+{
+    return table->Words[ientry / TABLEINLINE_BLOCK] +
+        (ientry % TABLEINLINE_BLOCK) * (table->Keylen + 1);
+}
+
+
+
+
+/* @funcstatic tableinlineFind ************************************************
+**
+** Probes the index of an inline key table for a key, stopping at the
+** first empty slot.
+**
+** Entries match if their key (unsigned long tables) or key hash value
+** (word tables) is equal to the hash value and, for word tables, the
+** stored word matches the key.
+**
+** @param [r] table [const AjPTableinline] Table
+** @param [r] hash [ajulong] Unsigned long key, or word key hash value
+** @param [r] key [const char*] Word key, or NULL for an unsigned long key
+** @param [w] Pslot [ajulong*] Index slot of the entry if found,
+**                             otherwise the empty slot for a new entry
+** @return [ajulong] Entry number plus one, or zero if not found
+**
+** @release 6.6.0
+******************************************************************************/
+
+static ajulong tableinlineFind(const AjPTableinline table, ajulong hash,
+                               const char* key, ajulong* Pslot)
+{
+    ajulong mask  = table->Size - 1;
+    ajulong islot = (hash * TABLEINLINE_MIX) >> table->Shift;
+    ajuint ientry;
+    const char* word;
+
+    while((ientry = table->Slots[islot]))
+    {
+        if(table->Keys[ientry-1] == hash)
+        {
+            if(!key)
+                break;
+
+            word = tableinlineWord(table, ientry-1);
+
+            if(table->Nocase)
+            {
+                if(!ajCharCmpCaseLen(word, key, table->Keylen))
+                    break;
+            }
+            else if(!memcmp(word, key, table->Keylen))
+                break;
+        }
+
+        islot = (islot + 1) & mask;
+    }
+
+    *Pslot = islot;
+
+    return ientry;
+}
+
+
+
+
+/* @funcstatic tableinlineAdd *************************************************
+**
+** Adds a new entry to an inline key table, doubling the index when it
+** would be more than half full, and extending the entry arrays as needed.
+**
+** @param [u] table [AjPTableinline] Table
+** @param [r] hash [ajulong] Unsigned long key, or word key hash value
+** @param [r] islot [ajulong] Empty index slot found by tableinlineFind
+** @return [ajulong] New entry number
+**
+** @release 6.6.0
+******************************************************************************/
+
+static ajulong tableinlineAdd(AjPTableinline table, ajulong hash,
+                              ajulong islot)
+{
+    ajulong i;
+    ajulong ientry;
+    ajulong mask;
+    ajulong maxlength;
+    ajulong oldblocks;
+    ajulong newblocks;
+
+    if(table->Length >= UINT_MAX - 1)
+        ajFatal("Inline key table full with %Lu entries", table->Length);
+
+    if(2 * (table->Length + 1) > table->Size)
+    {
+        AJFREE(table->Slots);
+
+        table->Size <<= 1;
+        table->Shift--;
+        mask = table->Size - 1;
+
+        AJCNEW0(table->Slots, table->Size);
+
+        for(i = 0UL; i < table->Length; i++)
+        {
+            islot = (table->Keys[i] * TABLEINLINE_MIX) >> table->Shift;
+
+            while(table->Slots[islot])
+                islot = (islot + 1) & mask;
+
+            table->Slots[islot] = (ajuint) (i + 1);
+        }
+
+        islot = (hash * TABLEINLINE_MIX) >> table->Shift;
+
+        while(table->Slots[islot])
+            islot = (islot + 1) & mask;
+    }
+
+    if(table->Length == table->Maxlength)
+    {
+        maxlength = table->Maxlength ? 2 * table->Maxlength :
+            TABLEINLINE_MINSIZE;
+
+        AJCRESIZE(table->Values, maxlength);
+        AJCRESIZE(table->Keys, maxlength);
+
+        if(table->Keylen)
+        {
+            oldblocks = (table->Maxlength + TABLEINLINE_BLOCK - 1) /
+                TABLEINLINE_BLOCK;
+            newblocks = (maxlength + TABLEINLINE_BLOCK - 1) /
+                TABLEINLINE_BLOCK;
+
+            if(newblocks > oldblocks)
+            {
+                AJCRESIZE(table->Words, newblocks);
+
+                for(i = oldblocks; i < newblocks; i++)
+                    AJCNEW(table->Words[i],
+                           TABLEINLINE_BLOCK * (table->Keylen + 1));
+            }
+        }
+
+        table->Maxlength = maxlength;
+    }
+
+    ientry = table->Length++;
+
+    table->Keys[ientry] = hash;
+    table->Slots[islot] = (ajuint) (ientry + 1);
+
+    return ientry;
+}
+
+
+
+
+/* @funcstatic tableinlineRemove **********************************************
+**
+** Removes the entry in an index slot of an inline key table.
+**
+** Later entries in the same run of occupied slots are shifted back so no
+** deleted markers are needed, and the last entry is moved into the place
+** of the removed entry so entries stay contiguous.
+**
+** @param [u] table [AjPTableinline] Table
+** @param [r] islot [ajulong] Index slot of the entry
+** @return [void*] Removed value
+**
+** @release 6.6.0
+******************************************************************************/
+
+static void* tableinlineRemove(AjPTableinline table, ajulong islot)
+{
+    ajulong mask   = table->Size - 1;
+    ajulong ientry = table->Slots[islot] - 1;
+    ajulong ilast  = table->Length - 1;
+    ajulong jslot;
+    ajulong home;
+    void* ret = table->Values[ientry];
+
+    jslot = islot;
+
+    for(;;)
+    {
+        jslot = (jslot + 1) & mask;
+
+        if(!table->Slots[jslot])
+            break;
+
+        home = (table->Keys[table->Slots[jslot] - 1] * TABLEINLINE_MIX) >>
+            table->Shift;
+
+        if(((jslot - home) & mask) >= ((jslot - islot) & mask))
+        {
+            table->Slots[islot] = table->Slots[jslot];
+            islot = jslot;
+        }
+    }
+
+    table->Slots[islot] = 0U;
+
+    if(ientry != ilast)
+    {
+        jslot = (table->Keys[ilast] * TABLEINLINE_MIX) >> table->Shift;
+
+        while(table->Slots[jslot] != ilast + 1)
+            jslot = (jslot + 1) & mask;
+
+        table->Slots[jslot]    = (ajuint) (ientry + 1);
+        table->Keys[ientry]    = table->Keys[ilast];
+        table->Values[ientry]  = table->Values[ilast];
+
+        if(table->Keylen)
+            memcpy(tableinlineWord(table, ientry),
+                   tableinlineWord(table, ilast), table->Keylen);
+    }
+
+    table->Length--;
+
+    return ret;
+}
+
+
+
+
 #ifdef AJ_COMPILE_DEPRECATED_BOOK
 #endif
 
@@ -170,6 +170,75 @@ typedef struct AjSTable
 
 
 
+/* @data AjPTableinline *******************************************************
+**
+** Hash table object with the keys held inside the table.
+**
+** Keys are unsigned long integers, or words of a fixed length, and are
+** copied into arrays owned by the table rather than stored as pointers
+** to caller data. Entries are found by linear probing of an open
+** addressing index, so there are no calls to comparison or hash
+** functions and no memory is allocated for each new entry.
+**
+** Entries are kept in the order they were added, which is the order
+** returned by ajTableinlineToarrayValues. Removing an entry moves the
+** last entry into its place.
+**
+** @new ajTableinlineNewUlong Creates a table with unsigned long keys.
+** @new ajTableinlineNewWord Creates a table with fixed length word keys.
+** @new ajTableinlineNewWordCase Creates a table with case-insensitive
+**                               fixed length word keys.
+** @delete ajTableinlineDel Deallocates a table.
+** @delete ajTableinlineDelValdel Deallocates a table and its values.
+** @modify ajTableinlinePutUlong Adds or updates a value for a given key.
+** @modify ajTableinlinePutC Adds or updates a value for a given key.
+** @modify ajTableinlineRemoveUlong Removes a key/value pair from a table,
+**                                  and returns the value.
+** @modify ajTableinlineRemoveC Removes a key/value pair from a table,
+**                              and returns the value.
+** @cast ajTableinlineFetchUlong Returns the value for a given key.
+** @cast ajTableinlineFetchC Returns the value for a given key.
+** @cast ajTableinlineFetchkeyC Returns the stored copy of a key.
+** @cast ajTableinlineGetLength Returns the number of keys in a table.
+** @cast ajTableinlineToarrayValues Creates an array of values in the
+**                                  order they were added.
+**
+** @attr Slots [ajuint*] Open addressing index of entry numbers plus one,
+**                       zero for an empty slot
+** @attr Values [void**] Entry values
+** @attr Keys [ajulong*] Entry unsigned long keys, or word key hash values
+** @attr Words [char**] Blocks of entry word keys, each word followed
+**                      by a NULL character
+** @attr Size [ajulong] Number of index slots, a power of 2
+** @attr Length [ajulong] Number of entries
+** @attr Maxlength [ajulong] Number of entries allocated
+** @attr Keylen [ajuint] Word key length, zero for unsigned long keys
+** @attr Shift [ajuint] Bit shift from a hash value to an index slot
+** @attr Nocase [AjBool] True if word keys are case-insensitive
+** @attr Padding [ajuint] Padding to alignment boundary
+** @@
+******************************************************************************/
+
+typedef struct AjSTableinline
+{
+    ajuint* Slots;
+    void** Values;
+    ajulong* Keys;
+    char** Words;
+    ajulong Size;
+    ajulong Length;
+    ajulong Maxlength;
+    ajuint Keylen;
+    ajuint Shift;
+    AjBool Nocase;
+    ajuint Padding;
+} AjOTableinline;
+
+#define AjPTableinline AjOTableinline*
+
+
+
+
 /* ========================================================================= */
 /* =========================== public functions ============================ */
 /* ========================================================================= */
@@ -348,6 +417,33 @@ void*          ajTablestrFetchC(const AjPTable table, const char* txtkey);
 void*          ajTablestrFetchS(const AjPTable table, const AjPStr key);
 AjPStr*        ajTablestrFetchmod(AjPTable table, const AjPStr key);
 
+AjPTableinline ajTableinlineNewUlong(ajulong size);
+AjPTableinline ajTableinlineNewWord(ajulong size, ajuint keylen);
+AjPTableinline ajTableinlineNewWordCase(ajulong size, ajuint keylen);
+void           ajTableinlineClear(AjPTableinline table);
+void           ajTableinlineDel(AjPTableinline* Ptable);
+void           ajTableinlineDelValdel(AjPTableinline* Ptable,
+                                      void (*valdel)(void** Pvalue));
+const void*    ajTableinlineFetchC(const AjPTableinline table,
+                                   const char* key);
+const char*    ajTableinlineFetchkeyC(const AjPTableinline table,
+                                      const char* key);
+void*          ajTableinlineFetchmodC(const AjPTableinline table,
+                                      const char* key);
+const void*    ajTableinlineFetchUlong(const AjPTableinline table,
+                                       ajulong key);
+void*          ajTableinlineFetchmodUlong(const AjPTableinline table,
+                                          ajulong key);
+ajulong        ajTableinlineGetLength(const AjPTableinline table);
+void*          ajTableinlinePutC(AjPTableinline table, const char* key,
+                                 void* value);
+void*          ajTableinlinePutUlong(AjPTableinline table, ajulong key,
+                                     void* value);
+void*          ajTableinlineRemoveC(AjPTableinline table, const char* key);
+void*          ajTableinlineRemoveUlong(AjPTableinline table, ajulong key);
+ajulong        ajTableinlineToarrayValues(const AjPTableinline table,
+                                          void*** valarray);
+
 /*
 ** End of prototype definitions
 */
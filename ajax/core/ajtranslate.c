@@ -210,6 +210,9 @@ static void trnNoComment(AjPStr* text);
 
 static AjBool trnComplete(AjPTrn thys);
 
+static ajint trnSeqDangle(const AjPTrn trnObj, const char *seq, ajuint len,
+                          ajint frame, AjPStr *pep);
+
 
 
 
@@ -1793,39 +1796,7 @@ AjPSeq ajTrnSeqFramePep(const AjPTrn trnObj, const AjPSeq seq, ajint frame)
 ajint ajTrnSeqDangleC(const AjPTrn trnObj, const char *seq,
                       ajint frame, AjPStr *pep)
 {
-    ajint end = 0; 	          /* end base of last complete forward codon */
-    ajint dangle;		  /* number of bases at the end              */
-    ajuint len = strlen(seq);
-
-    if(frame > 3)			/* convert frames 4,5,6 to -1,-2,-3 */
-	frame = -frame + 3;
-
-    if(frame > 0)
-    {					/* forward 3 frames */
-	end = frame + ((len-frame+1)/3)*3 - 1;
-	dangle = len - end;
-    }
-    else if(frame <= -4)		/* alternative reverse frames */
-	dangle = (len+frame+4)%3;
-    else				/* standard reverse frames */
-	dangle = -frame-1;
-
-    /* translate any dangling pair of bases at the end */
-    if(dangle == 2)
-    {
-	if(frame >= 1 && frame <= 3)
-	    ajStrAppendK(pep, trnObj->GC[trnconv[(ajint)seq[end]]]
-		                        [trnconv[(ajint)seq[end+1]]]
-		                        [trnconv[0]]);
-	else	/* reverse sense */
-	    ajStrAppendK(pep, trnObj->GC[trncomp[(ajint)seq[1]]]
-		                        [trncomp[(ajint)seq[0]]]
-		                        [trncomp[0]]);
-    }
-    else if(dangle == 1) /* Make up single base translation */
-	ajStrAppendK(pep, 'X');
-
-    return dangle;
+    return trnSeqDangle(trnObj, seq, strlen(seq), frame, pep);
 }
 
 
@@ -1856,40 +1827,8 @@ ajint ajTrnSeqDangleC(const AjPTrn trnObj, const char *seq,
 ajint ajTrnSeqDangleS(const AjPTrn trnObj, const AjPStr seq, ajint frame,
                       AjPStr *pep)
 {
-    ajint end = 0; 	          /* end base of last complete forward codon */
-    ajint dangle;		  /* number of bases at the end              */
-    ajuint len = ajStrGetLen(seq);
-    const char* cp = ajStrGetPtr(seq);
-
-    if(frame > 3)			/* convert frames 4,5,6 to -1,-2,-3 */
-	frame = -frame + 3;
-
-    if(frame > 0)
-    {					/* forward 3 frames */
-	end = frame + ((len-frame+1)/3)*3 - 1;
-	dangle = len - end;
-    }
-    else if(frame <= -4)		/* alternative reverse frames */
-	dangle = (len+frame+4)%3;
-    else				/* standard reverse frames */
-	dangle = -frame-1;
-
-    /* translate any dangling pair of bases at the end */
-    if(dangle == 2)
-    {
-	if(frame >= 1 && frame <= 3)
-	    ajStrAppendK(pep, trnObj->GC[trnconv[(ajint)cp[end]]]
-		                        [trnconv[(ajint)cp[end+1]]]
-		                        [trnconv[0]]);
-	else	/* reverse sense */
-	    ajStrAppendK(pep, trnObj->GC[trncomp[(ajint)cp[1]]]
-		                        [trncomp[(ajint)cp[0]]]
-		                        [trncomp[0]]);
-    }
-    else if(dangle == 1) /* Make up single base translation */
-	ajStrAppendK(pep, 'X');
-
-    return dangle;
+    return trnSeqDangle(trnObj, ajStrGetPtr(seq), ajStrGetLen(seq),
+                        frame, pep);
 }
 
 
@@ -2051,6 +1990,249 @@ AjPSeq ajTrnSeqOrig(const AjPTrn trnObj, const AjPSeq seq, ajint frame)
 
 
 
+/* @func ajTrnSeqSixC *********************************************************
+**
+** Translates a sequence in a char * in up to six frames in a single pass.
+** The translations are APPENDED to the input peptides.
+**
+** The frames array selects frames 1, 2, 3, -1, -2 and -3 in that order.
+** If alternate is true the reverse frames are instead the alternative
+** frames -4, -5 and -6.
+**
+** Each base is converted once, and the forward and reverse complement
+** codon indexes are rolled along the sequence so that every codon is
+** looked up directly in the genetic code table. Each peptide is the same
+** as ajTrnSeqFrameC (or ajTrnSeqFrameInitC if init is true) followed by
+** ajTrnSeqDangleC for that frame.
+**
+** @param [r] trnObj [const AjPTrn] Translation tables
+** @param [r] seq [const char *] sequence string to translate
+** @param [r] len [ajint] length of sequence string to translate
+** @param [r] frames [const AjBool*] Array of six frame selections
+** @param [r] alternate [AjBool] Use alternative reverse frames -4 to -6
+** @param [r] init [AjBool] Replace an initial alternative start codon
+**                          with Methionine
+** @param [u] peps [AjPStr*] Array of six returned peptide translations
+**                           (APPENDED TO INPUT)
+**
+** @return [void]
+** @category use [AjPTrn] Translating a sequence from a char* in up to
+**                six frames
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void ajTrnSeqSixC(const AjPTrn trnObj, const char *seq, ajint len,
+                  const AjBool *frames, AjBool alternate, AjBool init,
+                  AjPStr *peps)
+{
+    const char *gc = &trnObj->GC[0][0][0];
+    const char *starts = &trnObj->Starts[0][0][0];
+    AjPStr scratch[6];
+    char *cq[6];
+    char *fq[3];
+    char *rq[3];
+    ajint trnlen;
+    ajint pepstart[6];
+    ajint first;
+    ajuint fwd = 0;
+    ajuint rev = 0;
+    ajint i;
+    ajint j;
+    ajint frame;
+
+    /*
+    ** All six frames are filled so the scan has no tests for selected
+    ** frames. Unselected frames go to scratch strings. Reverse frames
+    ** are filled from their last residue backwards.
+    */
+
+    for(i=0; i < 6; i++)
+    {
+        scratch[i] = NULL;
+        trnlen = (len - i%3)/3;
+
+        if(frames[i])
+        {
+            pepstart[i] = ajStrGetLen(peps[i]);
+            ajStrSetRes(&peps[i], pepstart[i]+trnlen+3);
+            cq[i] = ajStrGetuniquePtr(&peps[i]) + pepstart[i];
+        }
+        else
+        {
+            pepstart[i] = 0;
+            scratch[i] = ajStrNewRes(trnlen+1);
+            cq[i] = ajStrGetuniquePtr(&scratch[i]);
+        }
+
+        if(i >= 3 && trnlen)
+            cq[i] += trnlen - 1;
+    }
+
+    /*
+    ** The codon starting at base j is complete once base j+2 is read.
+    ** Its forward frame is j%3. The standard reverse frame uses the same
+    ** codons, the alternative reverse frame counts from the end of the
+    ** sequence so each forward frame maps to a fixed alternative frame.
+    */
+
+    for(i=0; i < 3; i++)
+    {
+        fq[i] = cq[i];
+
+        if(alternate)
+            rq[i] = cq[3 + ((len-3-i) % 3 + 3) % 3];
+        else
+            rq[i] = cq[3 + i];
+    }
+
+    frame = 0;
+
+    for(i=0; i < len; i++)
+    {
+        fwd = ((fwd << 4) | trnconv[(ajint)seq[i]]) & 0xfff;
+        rev = (rev >> 4) | (trncomp[(ajint)seq[i]] << 8);
+
+        if(i < 2)
+            continue;
+
+        *fq[frame]++ = gc[fwd];
+        *rq[frame]-- = gc[rev];
+
+        if(++frame == 3)
+            frame = 0;
+    }
+
+    for(i=0; i < 6; i++)
+    {
+        if(!frames[i])
+        {
+            ajStrDel(&scratch[i]);
+            continue;
+        }
+
+        trnlen = (len - i%3)/3;
+
+        /*
+        ** first is the base starting the first codon translated in
+        ** the frame, for initiation codons. The reverse frames need
+        ** the same minimum lengths as ajTrnSeqRevinitC and
+        ** ajTrnSeqAltRevinitC
+        */
+
+        if(!trnlen)
+            first = -1;
+        else if(i < 3)
+            first = i;
+        else if(alternate)
+            first = len - i;
+        else if(trnlen > 1)
+            first = i - 3 + 3*(trnlen-1);
+        else
+            first = -1;
+
+        if(init && first >= 0)
+        {
+            j = first;
+
+            if(i < 3)
+            {
+                if('M' == starts[(trnconv[(ajint)seq[j]] << 8) |
+                                 (trnconv[(ajint)seq[j+1]] << 4) |
+                                 trnconv[(ajint)seq[j+2]]])
+                    ajStrGetuniquePtr(&peps[i])[pepstart[i]] = 'M';
+            }
+            else
+            {
+                if('M' == starts[(trncomp[(ajint)seq[j+2]] << 8) |
+                                 (trncomp[(ajint)seq[j+1]] << 4) |
+                                 trncomp[(ajint)seq[j]]])
+                    ajStrGetuniquePtr(&peps[i])[pepstart[i]] = 'M';
+            }
+        }
+
+        ajStrSetValidLen(&peps[i], pepstart[i]+trnlen);
+
+        if(i < 3)
+            trnSeqDangle(trnObj, seq, len, i+1, &peps[i]);
+        else if(alternate)
+            trnSeqDangle(trnObj, seq, len, -i-1, &peps[i]);
+        else
+            trnSeqDangle(trnObj, seq, len, 2-i, &peps[i]);
+    }
+
+    return;
+}
+
+
+
+
+/* @func ajTrnSeqSix **********************************************************
+**
+** Translates a sequence in up to six frames in a single pass, returning
+** a new peptide for each selected frame and NULL for the others.
+**
+** The frames array selects frames 1, 2, 3, -1, -2 and -3 in that order.
+** If alternate is true the reverse frames are instead the alternative
+** frames -4, -5 and -6.
+**
+** Each peptide is the same as ajTrnSeqOrig (or ajTrnSeqInit if init is
+** true) would return for that frame.
+**
+** @param [r] trnObj [const AjPTrn] Translation tables
+** @param [r] seq [const AjPSeq] sequence to translate
+** @param [r] frames [const AjBool*] Array of six frame selections
+** @param [r] alternate [AjBool] Use alternative reverse frames -4 to -6
+** @param [r] init [AjBool] Replace an initial alternative start codon
+**                          with Methionine
+** @param [w] peps [AjPSeq*] Array of six returned peptide translations
+**
+** @return [void]
+** @category use [AjPTrn] Translating a sequence in up to six frames
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void ajTrnSeqSix(const AjPTrn trnObj, const AjPSeq seq,
+                 const AjBool *frames, AjBool alternate, AjBool init,
+                 AjPSeq *peps)
+{
+    AjPStr trn[6];
+    ajint i;
+    ajint frame;
+
+    for(i=0; i < 6; i++)
+        trn[i] = NULL;
+
+    ajTrnSeqSixC(trnObj, ajSeqGetSeqC(seq), ajSeqGetLen(seq),
+                 frames, alternate, init, trn);
+
+    for(i=0; i < 6; i++)
+    {
+        peps[i] = NULL;
+
+        if(!frames[i])
+            continue;
+
+        if(i < 3)
+            frame = i+1;
+        else if(alternate)
+            frame = -i-1;
+        else
+            frame = 2-i;
+
+        peps[i] = ajTrnNewPep(seq, frame);
+        ajSeqAssignSeqS(peps[i], trn[i]);
+        ajStrDel(&trn[i]);
+    }
+
+    return;
+}
+
+
+
 
 /* @func ajTrnCodonstrTypeC ***************************************************
 **
@@ -2411,6 +2593,64 @@ static AjBool trnComplete(AjPTrn thys)
 
 
 
+/* @funcstatic trnSeqDangle ***************************************************
+**
+** Translates the last 1 or two bases of a sequence of known length
+** that would not be translated if just translating complete codons
+** in the specified frame.
+** The translation is APPENDED to the input peptide.
+**
+** @param [r] trnObj [const AjPTrn] Translation tables
+** @param [r] seq [const char *] sequence string to translate
+** @param [r] len [ajuint] length of sequence string
+** @param [r] frame [ajint] frame to translate in
+** @param [u] pep [AjPStr *] returned peptide translation (APPENDED TO INPUT)
+**
+** @return [ajint] Number of dangling bases (0,1 or 2)
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static ajint trnSeqDangle(const AjPTrn trnObj, const char *seq, ajuint len,
+                          ajint frame, AjPStr *pep)
+{
+    ajint end = 0; 	          /* end base of last complete forward codon */
+    ajint dangle;		  /* number of bases at the end              */
+
+    if(frame > 3)			/* convert frames 4,5,6 to -1,-2,-3 */
+	frame = -frame + 3;
+
+    if(frame > 0)
+    {					/* forward 3 frames */
+	end = frame + ((len-frame+1)/3)*3 - 1;
+	dangle = len - end;
+    }
+    else if(frame <= -4)		/* alternative reverse frames */
+	dangle = (len+frame+4)%3;
+    else				/* standard reverse frames */
+	dangle = -frame-1;
+
+    /* translate any dangling pair of bases at the end */
+    if(dangle == 2)
+    {
+	if(frame >= 1 && frame <= 3)
+	    ajStrAppendK(pep, trnObj->GC[trnconv[(ajint)seq[end]]]
+		                        [trnconv[(ajint)seq[end+1]]]
+		                        [trnconv[0]]);
+	else	/* reverse sense */
+	    ajStrAppendK(pep, trnObj->GC[trncomp[(ajint)seq[1]]]
+		                        [trncomp[(ajint)seq[0]]]
+		                        [trncomp[0]]);
+    }
+    else if(dangle == 1) /* Make up single base translation */
+	ajStrAppendK(pep, 'X');
+
+    return dangle;
+}
+
+
+
 
 /* @func ajTrnExit ************************************************************
 **
@@ -114,6 +114,8 @@ AJ_BEGIN_DECLS
 ** @use ajTrnDangleS Translates the last 1 or two bases of a sequence
 **                     in a AjStr
 ** @use ajTrnSeqOrig Translating a sequence
+** @use ajTrnSeqSixC Translating a sequence from a char* in up to six frames
+** @use ajTrnSeqSix Translating a sequence in up to six frames
 ** @cast ajTrnGetTitle Returns description of the translation table
 ** @cast ajTrnGetFilename Returns file name the translation table was read from
 ** @use ajTrnCodonstrTypeS Checks whether the input codon is a Start codon,
@@ -221,6 +223,12 @@ AjPSeq        ajTrnSeqInit(const AjPTrn trnObj, const AjPSeq seq,
                            ajint frame);
 AjPSeq        ajTrnSeqOrig(const AjPTrn trnObj, const AjPSeq seq,
                            ajint frame);
+void          ajTrnSeqSixC(const AjPTrn trnObj, const char *seq, ajint len,
+                           const AjBool *frames, AjBool alternate,
+                           AjBool init, AjPStr *peps);
+void          ajTrnSeqSix(const AjPTrn trnObj, const AjPSeq seq,
+                          const AjBool *frames, AjBool alternate,
+                          AjBool init, AjPSeq *peps);
 
 /*
 ** End of prototype definitions
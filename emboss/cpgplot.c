@@ -27,7 +27,7 @@
 
 
 
-static void cpgplot_findbases(const AjPStr substr, ajint len,
+static void cpgplot_findbases(AjPSeqwin seqwin,
 			      ajint window, ajint shift, float *obsexp,
 			      float *xypc, const AjPStr bases,
 			      float *obsexpmax,
@@ -72,9 +72,8 @@ int main(int argc, char **argv)
 {
     AjPSeqall seqall;
     AjPSeq seq    = NULL;
+    AjPSeqwin seqwin = NULL;
     AjPFile outf  = NULL;
-    AjPStr strand = NULL;
-    AjPStr substr = NULL;
     AjPStr bases  = NULL;
     AjPGraph mult;
     AjBool doobsexp;
@@ -123,7 +122,6 @@ int main(int argc, char **argv)
 
 
 
-    substr = ajStrNew();
     bases  = ajStrNewC("CG");
 
 
@@ -133,17 +131,17 @@ int main(int argc, char **argv)
     {
 	begin = ajSeqallGetseqBegin(seqall);
 	end   = ajSeqallGetseqEnd(seqall);
-	strand = ajSeqGetSeqCopyS(seq);
-	ajStrFmtUpper(&strand);
-
-	ajStrAssignSubC(&substr,ajStrGetPtr(strand),--begin,--end);
-	len = ajStrGetLen(substr);
+	seqwin = ajSeqwinNew(seq, begin, end, window, 0);
+	len = end - begin + 1;
+	--begin;
+	--end;
 
 	if(len > maxarr)
 	{
 	  AJCRESIZE(obsexp,len);
 	  AJCRESIZE(thresh,len);
 	  AJCRESIZE(xypc,len);
+	  maxarr = len;
 	}
 
 	for(i=0;i<len;++i)
@@ -154,7 +152,7 @@ int main(int argc, char **argv)
 
 
 
-	cpgplot_findbases(substr, len, window, shift, obsexp, xypc,
+	cpgplot_findbases(seqwin, window, shift, obsexp, xypc,
 			  bases, &obsexpmax, &plotstart, &plotend);
 
 
@@ -171,7 +169,7 @@ int main(int argc, char **argv)
 			   obsexpmax, doobsexp, docg, dopc, mult);
         }
 
-	ajStrDel(&strand);
+	ajSeqwinDel(&seqwin);
     }
 
     if(mult)
@@ -181,7 +179,6 @@ int main(int argc, char **argv)
     }
 
     ajSeqDel(&seq);
-    ajStrDel(&substr);
     ajStrDel(&bases);
 
     ajFileClose(&outf);
@@ -204,8 +201,7 @@ int main(int argc, char **argv)
 **
 ** Undocumented.
 **
-** @param [r] substr [const AjPStr] Undocumented
-** @param [r] len [ajint] Undocumented
+** @param [u] seqwin [AjPSeqwin] Window scanner
 ** @param [r] window [ajint] Undocumented
 ** @param [r] shift [ajint] Undocumented
 ** @param [w] obsexp [float*] Undocumented
@@ -217,7 +213,7 @@ int main(int argc, char **argv)
 ** @@
 ******************************************************************************/
 
-static void cpgplot_findbases(const AjPStr substr, ajint len,
+static void cpgplot_findbases(AjPSeqwin seqwin,
 			      ajint window, ajint shift, float *obsexp,
 			      float *xypc, const AjPStr bases,
 			      float *obsexpmax,
@@ -231,9 +227,11 @@ static void cpgplot_findbases(const AjPStr substr, ajint len,
 
     float obs;
     float expect;
-    ajint i;
+    ajint i = 0;
     ajint j = 0;
     ajint offset;
+    ajint start;
+    ajint count;
 
     const char *p;
     const char *q;
@@ -244,22 +242,30 @@ static void cpgplot_findbases(const AjPStr substr, ajint len,
     *plotstart   = offset;
     q          = ajStrGetPtr(bases);
 
-    for(i=0; i<(len-window+1);i+=shift)
+    while(ajSeqwinNext(seqwin))
     {
-	j = i+offset;
-	p = ajStrGetPtr(substr) + i;
-	cpgplot_countbases(p, q, window, &cxf, &cyf, &cxpy);
-
-	obs = cxpy;
-	expect = (cxf*cyf)/windowf;
-	if(!expect)
-	    obsexp[j]=0.0;
-	else
+	p     = ajSeqwinGetPtr(seqwin);
+	start = ajSeqwinGetStart(seqwin);
+	count = ajSeqwinGetCount(seqwin);
+
+	for(; i<start+count; i+=shift)
 	{
-	    obsexp[j] = obs/expect;
-	    *obsexpmax = (*obsexpmax > obsexp[j]) ? *obsexpmax : obsexp[j];
+	    j = i+offset;
+	    cpgplot_countbases(p+i-start, q, window, &cxf, &cyf, &cxpy);
+
+	    obs = cxpy;
+	    expect = (cxf*cyf)/windowf;
+	    if(!expect)
+		obsexp[j]=0.0;
+	    else
+	    {
+		obsexp[j] = obs/expect;
+		*obsexpmax = (*obsexpmax > obsexp[j]) ?
+		    *obsexpmax : obsexp[j];
+	    }
+	    xypc[j] = (cxf/windowf)*(float)100.0 +
+		(cyf/windowf)*(float)100.0;
 	}
-	xypc[j] = (cxf/windowf)*(float)100.0 + (cyf/windowf)*(float)100.0;
     }
 
     *plotend = j;
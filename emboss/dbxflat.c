@@ -107,6 +107,10 @@ int main(int argc, char **argv)
     AjPStr datestr  = NULL;
     AjBool statistics;
     AjBool compressed;
+    AjBool bulk;
+    ajuint bulksize;
+    ajuint threads;
+    AjPList jobfiles = NULL;
 
     AjPStr directory;
     AjPStr indexdir;
@@ -175,8 +179,21 @@ int main(int argc, char **argv)
     datestr    = ajAcdGetString("date");
     statistics = ajAcdGetBoolean("statistics");
     compressed = ajAcdGetBoolean("compressed");
+    bulk       = ajAcdGetBoolean("bulk");
+    bulksize   = ajAcdGetInt("runsize");
+    threads    = ajAcdGetInt("threads");
 
     entry = embBtreeEntryNew(0);
+    if(bulk)
+        embBtreeEntrySetBulk(entry);
+    embBtreeEntrySetBulksize(entry, bulksize);
+    if(threads > 1)
+    {
+        /* parallel processes cannot share the output file */
+        embBtreeEntrySetJobs(entry, threads);
+        statistics = ajFalse;
+        jobfiles = ajListstrNew();
+    }
     if(compressed)
         embBtreeEntrySetCompressed(entry);
 
@@ -245,6 +262,15 @@ int main(int argc, char **argv)
 	ajListPop(entry->files,(void **)&thysfile);
 	ajListPushAppend(entry->files,(void *)thysfile);
 	ajFmtPrintS(&tmpstr,"%S%S",entry->directory,thysfile);
+
+        if(!embBtreeJobStart(entry, i))
+        {
+            ajFilenameTrimPath(&tmpstr);
+            ajListstrPushAppend(jobfiles, ajStrNewS(tmpstr));
+            ajTimeDel(&begintime);
+            continue;
+        }
+
 	if(!(inf=ajFileNewInNameS(tmpstr)))
 	    ajFatal("Cannot open input file %S\n",tmpstr);
 	ajFilenameTrimPath(&tmpstr);
@@ -289,6 +315,8 @@ int main(int argc, char **argv)
 	}
 	
 	ajFileClose(&inf);
+        embBtreeJobEnd(entry, ientries);
+
 	nentries += ientries;
 	nowtime = ajTimeNewToday();
         nowclock = ajClockNow();
@@ -299,7 +327,7 @@ int main(int argc, char **argv)
 		    ajClockDiff(beginclock,nowclock),
                     ajTimeDiff(begintime, nowtime));
 
-        if(statistics)
+        if(statistics && !bulk)
         {
             ajBtreeStatsOut(outf,
                             &splitrootid, &splitrootnum,
@@ -351,7 +379,70 @@ int main(int argc, char **argv)
 	ajTimeDel(&nowtime);
     }
     
+    while(embBtreeJobWait(entry, &ientries))
+    {
+        ajListstrPop(jobfiles, &tmpstr);
+	ajFmtPrintF(outf,"Processing file: %S\n",tmpstr);
+
+	nentries += ientries;
+	nowtime = ajTimeNewToday();
+        nowclock = ajClockNow();
+	ajFmtPrintF(outf, "entries: %Lu (%Lu) time: %.1f/%.1fs\n",
+		    nentries, ientries,
+		    ajClockDiff(startclock,nowclock),
+                    ajTimeDiff(starttime, nowtime));
+	ajTimeDel(&nowtime);
+    }
+
+    embBtreeBulkLoad(entry);
 
+    if(statistics && bulk)
+    {
+        ajBtreeStatsOut(outf,
+                        &splitrootid, &splitrootnum,
+                        &splitrootkey, &splitrootsec,
+                        &splitleafid, &splitleafnum,
+                        &splitleafkey, &splitleafsec,
+                        &reorderid, &reordernum,
+                        &reorderkey, &reordersec);
+
+        if(entry->do_id)
+            ajBtreeCacheStatsOut(outf, entry->idcache,
+                                 &idpricache, &idseccache,
+                                 &idpriread, &idsecread,
+                                 &idpriwrite, &idsecwrite,
+                                 &idprisize, &idsecsize);
+        if(accfield)
+            ajBtreeCacheStatsOut(outf, accfield->cache,
+                                 &acpricache, &acseccache,
+                                 &acpriread,  &acsecread,
+                                 &acpriwrite, &acsecwrite,
+                                 &acprisize, &acsecsize);
+        if(svfield)
+            ajBtreeCacheStatsOut(outf, svfield->cache,
+                                 &svpricache, &svseccache,
+                                 &svpriread, &svsecread,
+                                 &svpriwrite, &svsecwrite,
+                                 &svprisize, &svsecsize);
+        if(keyfield)
+            ajBtreeCacheStatsOut(outf, keyfield->cache,
+                                 &kwpricache, &kwseccache,
+                                 &kwpriread, &kwsecread,
+                                 &kwpriwrite, &kwsecwrite,
+                                 &kwprisize, &kwsecsize);
+        if(desfield)
+            ajBtreeCacheStatsOut(outf, desfield->cache,
+                                 &depricache, &deseccache,
+                                 &depriread, &desecread,
+                                 &depriwrite, &desecwrite,
+                                 &deprisize, &desecsize);
+        if(orgfield)
+            ajBtreeCacheStatsOut(outf, orgfield->cache,
+                                 &txpricache, &txseccache,
+                                 &txpriread, &txsecread,
+                                 &txpriwrite, &txsecwrite,
+                                 &txprisize, &txsecsize);
+    }
 
     embBtreeDumpParameters(entry);
     embBtreeCloseCaches(entry);
@@ -391,6 +482,7 @@ int main(int argc, char **argv)
         embBtreeReportField(outf, keyfield);
 
     ajFileClose(&outf);
+    ajListstrFree(&jobfiles);
     embBtreeEntryDel(&entry);
     ajStrDel(&tmpstr);
     ajStrDel(&filename);
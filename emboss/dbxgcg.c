@@ -153,6 +153,10 @@ int main(int argc, char **argv)
     AjPStr datestr  = NULL;
     AjBool statistics;
     AjBool compressed;
+    AjBool bulk;
+    ajuint bulksize;
+    ajuint threads;
+    AjPList jobfiles = NULL;
 
     AjPStr directory;
     AjPStr indexdir;
@@ -208,8 +212,21 @@ int main(int argc, char **argv)
     datestr    = ajAcdGetString("date");
     statistics = ajAcdGetBoolean("statistics");
     compressed = ajAcdGetBoolean("compressed");
+    bulk       = ajAcdGetBoolean("bulk");
+    bulksize   = ajAcdGetInt("runsize");
+    threads    = ajAcdGetInt("threads");
 
     entry = embBtreeEntryNew(1);
+    if(bulk)
+        embBtreeEntrySetBulk(entry);
+    embBtreeEntrySetBulksize(entry, bulksize);
+    if(threads > 1)
+    {
+        /* parallel processes cannot share the output file */
+        embBtreeEntrySetJobs(entry, threads);
+        statistics = ajFalse;
+        jobfiles = ajListstrNew();
+    }
     if(compressed)
         embBtreeEntrySetCompressed(entry);
     
@@ -294,6 +311,16 @@ int main(int argc, char **argv)
 	ajListPop(entry->files,(void **)&thysfile);
 	ajListstrPushAppend(entry->files, thysfile);
 	ajFmtPrintS(&dbxgcgTmpstr,"%S%S",entry->directory,thysfile);
+
+        if(!embBtreeJobStart(entry, i))
+        {
+            ajFileClose(&infr);
+            ajFilenameTrimPath(&dbxgcgTmpstr);
+            ajListstrPushAppend(jobfiles, ajStrNewS(dbxgcgTmpstr));
+            ajTimeDel(&begintime);
+            continue;
+        }
+
 	if(!(infs=ajFileNewInNameS(dbxgcgTmpstr)))
 	    ajFatal("Cannot open input file %S\n",dbxgcgTmpstr);
 
@@ -327,6 +354,8 @@ int main(int argc, char **argv)
 	
 	ajFileClose(&infs);
 	ajFileClose(&infr);
+        embBtreeJobEnd(entry, ientries);
+
 	nentries += ientries;
 	nowtime = ajTimeNewToday();
 	ajFmtPrintF(outf, "entries: %Lu (%Lu) time: %.1fs (%.1fs)\n",
@@ -334,7 +363,7 @@ int main(int argc, char **argv)
 		    ajTimeDiff(starttime, nowtime),
 		    ajTimeDiff(begintime, nowtime));
 
-        if(statistics)
+        if(statistics && !bulk)
         {
             if(entry->do_id)
                 ajBtreeCacheStatsOut(outf, entry->idcache,
@@ -377,7 +406,19 @@ int main(int argc, char **argv)
 	ajTimeDel(&begintime);
 	ajTimeDel(&nowtime);
     }
-    
+
+    while(embBtreeJobWait(entry, &ientries))
+    {
+        ajListstrPop(jobfiles, &dbxgcgTmpstr);
+	ajFmtPrintF(outf,"Processing file: %S\n",dbxgcgTmpstr);
+
+	nentries += ientries;
+	nowtime = ajTimeNewToday();
+	ajFmtPrintF(outf, "entries: %Lu (%Lu) time: %.1fs\n",
+		    nentries, ientries,
+		    ajTimeDiff(starttime, nowtime));
+	ajTimeDel(&nowtime);
+    }
 
     nowtime = ajTimeNewToday();
     ajFmtPrintF(outf, "Total time: %.1fs\n", ajTimeDiff(starttime, nowtime));
@@ -397,10 +438,53 @@ int main(int argc, char **argv)
     if(keyfield)
         embBtreeReportField(outf, keyfield);
 
+    embBtreeBulkLoad(entry);
+
+    if(statistics && bulk)
+    {
+        if(entry->do_id)
+            ajBtreeCacheStatsOut(outf, entry->idcache,
+                                 &idpricache, &idseccache,
+                                 &idpriread, &idsecread,
+                                 &idpriwrite, &idsecwrite,
+                                 &idprisize, &idsecsize);
+        if(accfield)
+            ajBtreeCacheStatsOut(outf, accfield->cache,
+                                 &acpricache, &acseccache,
+                                 &acpriread, &acsecread,
+                                 &acpriwrite, &acsecwrite,
+                                 &acprisize, &acsecsize);
+        if(svfield)
+            ajBtreeCacheStatsOut(outf, svfield->cache,
+                                 &svpricache, &svseccache,
+                                 &svpriread, &svsecread,
+                                 &svpriwrite, &svsecwrite,
+                                 &svprisize, &svsecsize);
+        if(keyfield)
+            ajBtreeCacheStatsOut(outf, keyfield->cache,
+                                 &kwpricache, &kwseccache,
+                                 &kwpriread, &kwsecread,
+                                 &kwpriwrite, &kwsecwrite,
+                                 &kwprisize, &kwsecsize);
+        if(desfield)
+            ajBtreeCacheStatsOut(outf, desfield->cache,
+                                 &depricache, &deseccache,
+                                 &depriread, &desecread,
+                                 &depriwrite, &desecwrite,
+                                 &deprisize, &desecsize);
+        if(orgfield)
+            ajBtreeCacheStatsOut(outf, orgfield->cache,
+                                 &txpricache, &txseccache,
+                                 &txpriread, &txsecread,
+                                 &txpriwrite, &txsecwrite,
+                                 &txprisize, &txsecsize);
+    }
+
     embBtreeDumpParameters(entry);
     embBtreeCloseCaches(entry);
     
     ajFileClose(&outf);
+    ajListstrFree(&jobfiles);
     embBtreeEntryDel(&entry);
 
     ajStrDel(&filename);
@@ -171,7 +171,7 @@ int main(int argc, char **argv)
     AjPStrTok handle = NULL;
     ajulong *pagepos = NULL;
     ajulong *pageindex = NULL;
-    AjPTable newpostable;
+    AjPTableinline newpostable;
     ajuint pagesize = 0;
     ajuint pripagesize;
     ajuint secpagesize;
@@ -297,7 +297,7 @@ int main(int argc, char **argv)
         AJCNEW0(pagepos,pagecount);
         AJCNEW0(pageindex,pagecount);
 
-        newpostable = ajTableulongNewConst((ajuint)pagecount);
+        newpostable = ajTableinlineNewUlong(pagecount);
         ++dbxdata[i].refs[0];
 
         pageoffset = 0L;
@@ -307,8 +307,8 @@ int main(int argc, char **argv)
             pageindex[ipage] = ipage;
             page = ajBtreeCacheRead(dbxdata[i].cache, pagepos[ipage]);
             nodetype = ajBtreePageGetTypename(page);
-            ajTablePut(newpostable, &pagepos[ipage],
-                       &pageindex[ipage]);
+            ajTableinlinePutUlong(newpostable, pagepos[ipage],
+                                  &pageindex[ipage]);
             if(compressed)
                 pageoffset += ajBtreePageGetSize(page, refcount);
             else if(ajBtreePageIsPrimary(page))
@@ -706,7 +706,7 @@ int main(int argc, char **argv)
         ajFmtPrintF(outf, "      FOUND: %Lu\n", nfound);
         ajFmtPrintF(outf, "   FOUNDALL: %Lu\n", nfoundall);
 
-        ajTableFree(&newpostable);
+        ajTableinlineDel(&newpostable);
         AJFREE(pagepos);
         AJFREE(pageindex);
    }
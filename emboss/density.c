@@ -83,7 +83,7 @@ int main(int argc, char **argv)
 
     AjPSeqall  seqall;
     AjPSeq     seq;
-    AjPStr     str;
+    AjPSeqwin  seqwin = NULL;
     AjPStr     hdr;
     
     AjPReport report = NULL;
@@ -100,11 +100,13 @@ int main(int argc, char **argv)
     ajint limit;
     
     const char *p;
+    ajint start;
+    ajint count;
 
-    float asum;
-    float csum;
-    float gsum;
-    float tsum;
+    ajint acnt = 0;
+    ajint ccnt = 0;
+    ajint gcnt = 0;
+    ajint tcnt = 0;
 
     float ymin;
     float ymax;
@@ -129,7 +131,6 @@ int main(int argc, char **argv)
     if(ajStrGetCharFirst(display) == 'Q')
         quad = ajTrue;
 
-    str = ajStrNew();
     hdr = ajStrNew();
 
     if(report)
@@ -154,9 +155,9 @@ int main(int argc, char **argv)
 	if(!ftable)
 	    ftable = ajFeattableNewSeq(seq);
 
-	ajStrAssignSubC(&str,ajSeqGetSeqC(seq),--beg,--end);
-	ajStrFmtUpper(&str);
-	p = ajStrGetPtr(str);
+	seqwin = ajSeqwinNew(seq, beg, end, window, 0);
+	--beg;
+	--end;
 
 	if(limit>0)
 	{
@@ -169,36 +170,75 @@ int main(int argc, char **argv)
 	    AJCNEW0(density->gc,limit);
 	}
 
-	for(i=0;i<limit;++i)
+	/*
+	** Base counts are carried from one window to the next, and
+	** counted afresh at the start of each chunk
+	*/
+
+	while(ajSeqwinNext(seqwin))
 	{
-	    density->pos[i] = (float)i+1+beg;
-	    asum=0.;
-	    csum=0.;
-	    gsum=0.;
-	    tsum=0.;
+	    p     = ajSeqwinGetPtr(seqwin);
+	    start = ajSeqwinGetStart(seqwin);
+	    count = ajSeqwinGetCount(seqwin);
+
+	    acnt = ccnt = gcnt = tcnt = 0;
+
 	    for(j=0;j < window; ++j)
 	    {
-		c = p[i+j];
-		
+		c = p[j];
+
 		if(c == 'A')
-		    ++asum;
+		    ++acnt;
 		else if(c == 'C')
-		    ++csum;
+		    ++ccnt;
 		else if(c == 'G')
-		    ++gsum;
+		    ++gcnt;
 		else if(c == 'T')
-		    ++tsum;
+		    ++tcnt;
 	    }
 
-	    density->a[i] = asum / (float) window;
-	    density->c[i] = csum / (float) window;
-	    density->g[i] = gsum / (float) window;
-	    density->t[i] = tsum / (float) window;
-	    
-	    density->at[i] = density->a[i] + density->t[i];
-	    density->gc[i] = density->g[i] + density->c[i];
+	    for(j=0;j < count; ++j)
+	    {
+		if(j)
+		{
+		    c = p[j-1];
+
+		    if(c == 'A')
+			--acnt;
+		    else if(c == 'C')
+			--ccnt;
+		    else if(c == 'G')
+			--gcnt;
+		    else if(c == 'T')
+			--tcnt;
+
+		    c = p[j+window-1];
+
+		    if(c == 'A')
+			++acnt;
+		    else if(c == 'C')
+			++ccnt;
+		    else if(c == 'G')
+			++gcnt;
+		    else if(c == 'T')
+			++tcnt;
+		}
+
+		i = start + j;
+		density->pos[i] = (float)i+1+beg;
+
+		density->a[i] = (float) acnt / (float) window;
+		density->c[i] = (float) ccnt / (float) window;
+		density->g[i] = (float) gcnt / (float) window;
+		density->t[i] = (float) tcnt / (float) window;
+
+		density->at[i] = density->a[i] + density->t[i];
+		density->gc[i] = density->g[i] + density->c[i];
+	    }
 	}
 
+	ajSeqwinDel(&seqwin);
+
 
 
 	ymin = 0.;
@@ -286,7 +326,6 @@ int main(int argc, char **argv)
     
     ajFeattableDel(&ftable);
 
-    ajStrDel(&str);
     ajStrDel(&hdr);
     ajStrDel(&display);
     
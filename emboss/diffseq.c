@@ -143,7 +143,7 @@ int main(int argc, char **argv)
     AjPSeq seq1;
     AjPSeq seq2;
     ajint wordlen;
-    AjPTable seq1MatchTable = 0;
+    EmbPWordIndex seq1MatchIndex = 0;
     AjPList matchlist = NULL;
     AjPList difflist = NULL;
     AjPReport report;
@@ -178,9 +178,9 @@ int main(int argc, char **argv)
     TabRpt = ajFeattableNewSeq(seq1);
 
     embWordLength(wordlen);
-    if(embWordGetTable(&seq1MatchTable, seq1))
-	/* get table of words */
-	matchlist = embWordBuildMatchTable(seq1MatchTable, seq2, ajTrue);
+    if(embWordGetIndex(&seq1MatchIndex, seq1))
+	/* get index of words */
+	matchlist = embWordBuildMatchIndex(seq1MatchIndex, seq2, ajTrue);
 
 
     /* get the minimal set of overlapping matches */
@@ -232,7 +232,7 @@ int main(int argc, char **argv)
     ajSeqDel(&seq1);
     ajSeqDel(&seq2);
 
-    embWordFreeTable(&seq1MatchTable);
+    embWordFreeIndex(&seq1MatchIndex);
 
     ajReportDel(&report);
 
@@ -37,7 +37,70 @@
 
 
 
+/* @datastatic DistmatPBits ***************************************************
+**
+** Bit-sliced copy of the alignment used to count matches, gaps and
+** residue pair frequencies for each pair of sequences 64 columns at a time
+**
+** @alias DistmatSBits
+** @alias DistmatOBits
+**
+** @attr Planes [ajulong**] Bit planes of the residue code of each column
+**                          for each sequence
+** @attr Gaps [ajulong**] Gap columns for each sequence
+** @attr Bits [ajulong***] Columns holding each residue code for each
+**                         sequence, or NULL if pair tables are not needed
+** @attr Count [ajuint**] Number of columns holding each residue code
+**                        for each sequence
+** @attr Table [ajuint*] Residue pair frequencies for the last pair
+** @attr Index [ajuint[256]] Residue code of each alignment character
+** @attr Codes [char[256]] Alignment character of each residue code
+** @attr Nwords [ajuint] Number of bit words for each sequence
+** @attr Ncodes [ajuint] Number of residue codes
+** @attr Nplanes [ajuint] Number of bit planes
+** @attr Nseqs [ajuint] Number of sequences
+** @attr Tailmask [ajulong] Mask of the columns used in the last word
+** @@
+******************************************************************************/
+
+typedef struct DistmatSBits
+{
+    ajulong **Planes;
+    ajulong **Gaps;
+    ajulong ***Bits;
+    ajuint **Count;
+    ajuint *Table;
+    ajuint Index[256];
+    char Codes[256];
+    ajuint Nwords;
+    ajuint Ncodes;
+    ajuint Nplanes;
+    ajuint Nseqs;
+    ajulong Tailmask;
+} DistmatOBits;
+
+#define DistmatPBits DistmatOBits*
+
+#define DISTMAT_WORDBITS 64
+
+
+
+
+static DistmatPBits distmat_bitsNew(char* const * seqcharptr,
+				    ajint len, ajint nseqs, AjBool table);
+static void distmat_bitsDel(DistmatPBits* Pbits);
+static void distmat_bitsMatch(const DistmatPBits bits, ajint i, ajint j,
+			      ajint* match, ajint* gap);
+static const ajuint* distmat_bitsTable(DistmatPBits bits, ajint i, ajint j);
+static void distmat_bitsSubs(const DistmatPBits bits, AjBool ry,
+			     ajint* trans, ajint* tranv, AjBool* scored);
+static ajuint distmat_popcount(ajulong word);
+
+
+
+
 static AjPFloat2d distmat_calc_match(char* const * seqcharptr,
+				     const DistmatPBits bits,
 				     ajint len, ajint nseqs,
 				     AjBool ambig, AjBool nuc,
 				     AjPFloat2d* gap);
@@ -50,17 +113,17 @@ static AjPFloat2d distmat_JukesCantor(const AjPFloat2d match,
 				      const AjPFloat2d gap,
 				      float gapwt, ajint mlen, ajint nseqs,
 				      AjBool nuc);
-static AjPFloat2d distmat_Kimura(char* const * seqcharptr,
-				 ajint len, ajint nseqs);
+static AjPFloat2d distmat_Kimura(DistmatPBits bits, ajint nseqs);
 static AjPFloat2d distmat_KimuraProt(char* const * seqcharptr,
-				     ajint mlen,
-				     ajint nseqs);
-static AjPFloat2d distmat_Tamura(char* const * seqcharptr,
+				     const DistmatPBits bits,
+				     ajint len, ajint nseqs);
+static AjPFloat2d distmat_Tamura(DistmatPBits bits,
 				 ajint len, ajint nseqs);
-static AjPFloat2d distmat_TajimaNei(char* const * seqcharptr,
+static AjPFloat2d distmat_TajimaNei(DistmatPBits bits,
 				    const AjPFloat2d match,
-				    ajint mlen, ajint nseqs);
+				    ajint nseqs);
 static AjPFloat2d distmat_JinNei(char* const * seqcharptr,
+				 DistmatPBits bits,
 				 ajint len, ajint nseqs,
 				 AjBool calc_a, float var_a);
 
@@ -94,6 +157,7 @@ int main (int argc, char * argv[])
 
     const char  *p;
     char **seqcharptr;
+    DistmatPBits bits = NULL;
 
     AjPSeqset seqset = NULL;
     AjPFloat2d match = NULL;
@@ -166,9 +230,13 @@ int main (int argc, char * argv[])
 
     seqcharptr = distmat_getSeq(seqset,nseqs,mlen,incr,posn,&len);
 
+    /* residue pair tables are only needed by the nucleotide corrections */
+    bits = distmat_bitsNew(seqcharptr,len,nseqs,
+			   (method > 2 || (method == 2 && nuc)));
+
     /* look at pairs of seqs for matches */
     if(method == 0 || method == 1 || method == 4 )
-	match = distmat_calc_match(seqcharptr,len,nseqs,ambig,nuc,
+	match = distmat_calc_match(seqcharptr,bits,len,nseqs,ambig,nuc,
 				   &gap);
 
 
@@ -181,15 +249,15 @@ int main (int argc, char * argv[])
 	matchDist = distmat_JukesCantor(match,gap,gapwt,len,nseqs,nuc);
     else if(method == 2)
 	if(nuc)
-	    matchDist = distmat_Kimura(seqcharptr,len,nseqs);
+	    matchDist = distmat_Kimura(bits,nseqs);
 	else
-	    matchDist = distmat_KimuraProt(seqcharptr,mlen,nseqs);
+	    matchDist = distmat_KimuraProt(seqcharptr,bits,len,nseqs);
     else if(method == 3)		/* for nucl. */
-	matchDist = distmat_Tamura(seqcharptr,len,nseqs);
+	matchDist = distmat_Tamura(bits,len,nseqs);
     else if(method == 4)
-	matchDist = distmat_TajimaNei(seqcharptr,match,mlen,nseqs);
+	matchDist = distmat_TajimaNei(bits,match,nseqs);
     else if(method == 5)
-	matchDist = distmat_JinNei(seqcharptr,len,nseqs,calc_a,var_a);
+	matchDist = distmat_JinNei(seqcharptr,bits,len,nseqs,calc_a,var_a);
 
     distmat_outputDist(outf,nseqs,seqset,matchDist,gapwt,
 		       method,ambig,nuc,posn,incr);
@@ -198,6 +266,7 @@ int main (int argc, char * argv[])
     for(i=0;i<nseqs;i++)
 	ajCharDel(&seqcharptr[i]);
     AJFREE(seqcharptr);
+    distmat_bitsDel(&bits);
 
     ajFloat2dDel(&gap);
     ajFloat2dDel(&match);
@@ -222,148 +291,124 @@ int main (int argc, char * argv[])
 **
 ** K Tamura, Mol. Biol. Evol. 1992, 9, 678.
 **
-** @param [r] seqcharptr [char* const *] Array of sequences as C strings
+** @param [u] bits [DistmatPBits] Bit-sliced alignment
 ** @param [r] len [ajint] Length
 ** @param [r] nseqs [ajint] Number of sequences
 ** @return [AjPFloat2d] corrected distance matrix
 **
 ******************************************************************************/
 
-static AjPFloat2d distmat_Tamura(char* const * seqcharptr,
+static AjPFloat2d distmat_Tamura(DistmatPBits bits,
 				 ajint len, ajint nseqs)
 {
     ajint i;
     ajint j;
-    ajint k;
+    ajuint a;
+    ajuint b;
+    ajuint ab;
+    ajuint n;
+    ajuint ncodes;
 
-    ajint t1;
-    ajint t2;
     ajint m;
     ajint trans;
     ajint tranv;
-    ajint ival;
-    
+    ajint ijgap;
+    ajint ijgc;
+    ajint jigc;
+
     float P;
     float Q;
     float D;
     float C;
-    float geecee;
-    float cgap;
     float X1;
     float X2;
+    float GCij;
+    float GCji;
 
-    AjPInt2d Ptrans = NULL;
-    AjPInt2d Qtranv = NULL;
-    AjPInt2d score  = NULL;
+    AjBool* bad    = NULL;
+    AjBool* gcs    = NULL;
+    ajint* subtr   = NULL;
+    ajint* subtv   = NULL;
+    AjBool* scored = NULL;
+    const ajuint* tab;
 
     AjPFloat2d matDist = NULL;
-    AjPFloat2d gap     = NULL;
-    AjPFloat2d GC      = NULL;
-
-    Ptrans  = ajInt2dNew();
-    Qtranv  = ajInt2dNew();
-    score   = ajInt2dNew();
 
     matDist = ajFloat2dNew();
-    GC      = ajFloat2dNew();
-    gap     = ajFloat2dNew();
-
 
     /* initialise array */
     for(i=0;i<nseqs;++i)
-    {
 	for(j=0;j<nseqs;++j)
-	{
 	    ajFloat2dPut(&matDist,i,j,0.);
-	    ajFloat2dPut(&GC,i,j,0.);
-	    ajFloat2dPut(&gap,i,j,0.);
-	    ajInt2dPut(&Ptrans,i,j,0);
-	    ajInt2dPut(&Qtranv,i,j,0);
-	    ajInt2dPut(&score,i,j,0);
-	}
-    }
 
-    /*
-    ** calc GC content for each seq for each pair
-    ** of seq - ignoring gap posns in both seqs
-    */
-    for(i=0;i<nseqs;++i)
-    {
-	for(j=0; j<nseqs; j++)
-	{
-	    for(k=0;k<len;++k)
-	    {
-		cgap = ajFloat2dGet(gap,i,j);
-		geecee = ajFloat2dGet(GC,i,j);
-
-		t1 = toupper((int) seqcharptr[j][k]);
-		t2 = toupper((int) seqcharptr[i][k]);
-
-
-		if(strchr("-NXWRYMKBVDH",t1) || strchr("-NXWRYMKBVDH",t2))
-		    ++cgap;
-		else if(strchr("GCS",t2))
-		    ++geecee;
-
-		ajFloat2dPut(&GC,i,j,geecee);
-		ajFloat2dPut(&gap,i,j,cgap);
-	    }
-	}
-    }
+    ncodes = bits->Ncodes;
+    AJCNEW0(bad, ncodes);
+    AJCNEW0(gcs, ncodes);
+    AJCNEW0(subtr, ncodes*ncodes);
+    AJCNEW0(subtv, ncodes*ncodes);
+    AJCNEW0(scored, ncodes*ncodes);
 
-    /* fraction GC content */
-    for(i=0;i<nseqs;++i)
+    for(a=0;a<ncodes;a++)
     {
-	for(j=0; j<nseqs; j++)
-	{
-	    cgap = ajFloat2dGet(gap,i,j);
-	    geecee = ajFloat2dGet(GC,i,j)/((float)len-cgap);
-	    ajFloat2dPut(&GC,i,j,geecee);
-	}
+	if(strchr("-NXWRYMKBVDH",toupper((int) bits->Codes[a])))
+	    bad[a] = ajTrue;
+	if(strchr("GCS",toupper((int) bits->Codes[a])))
+	    gcs[a] = ajTrue;
     }
 
-    /* calc transition & transversion subst.'s */
+    distmat_bitsSubs(bits,ajFalse,subtr,subtv,scored);
+
+    /*
+    ** calc GC content for each seq for each pair
+    ** of seq - ignoring gap posns in both seqs -
+    ** and transition & transversion subst.'s
+    */
     for(i=0;i<nseqs;i++)
     {
 	for(j=i+1;j<nseqs;j++)
 	{
-	    for(k=0; k< len; k++)
-	    {
-		t1 = toupper((int) seqcharptr[i][k]);
-		t2 = toupper((int) seqcharptr[j][k]);
-		if(!strchr("-",t2) && !strchr("-",t1))
+	    tab = distmat_bitsTable(bits,i,j);
+	    ijgap = ijgc = jigc = 0;
+	    trans = tranv = m = 0;
+
+	    for(a=0;a<ncodes;a++)
+		for(b=0;b<ncodes;b++)
 		{
-		    trans = ajInt2dGet(Ptrans,i,j);
-		    tranv = ajInt2dGet(Qtranv,i,j);
-
-		    distmat_checkSubs(t1,t2,&trans,&tranv);
-		    ajInt2dPut(&Ptrans,i,j,trans);
-		    ajInt2dPut(&Qtranv,i,j,tranv);
-		    m = ajInt2dGet(score,i,j)+1;
-		    ajInt2dPut(&score,i,j,m);
+		    ab = a*ncodes+b;
+		    n = tab[ab];
+		    if(!n)
+			continue;
+
+		    if(bad[a] || bad[b])
+			ijgap += n;
+		    else
+		    {
+			if(gcs[a])
+			    ijgc += n;
+			if(gcs[b])
+			    jigc += n;
+		    }
+
+		    if(scored[ab])
+		    {
+			trans += n*subtr[ab];
+			tranv += n*subtv[ab];
+			m += n;
+		    }
 		}
-	    }
-	}
-    }
 
+	    /* fraction GC content */
+	    GCij = (float) ijgc/((float)len-(float) ijgap);
+	    GCji = (float) jigc/((float)len-(float) ijgap);
 
-    /* calc distance matrix */
-    for(i=0;i<nseqs;i++)
-    {
-	for(j=i+1;j<nseqs;j++)
-	{
-	    C = ajFloat2dGet(GC,j,i)+ajFloat2dGet(GC,i,j);
-	    C = C - (2*ajFloat2dGet(GC,j,i)*ajFloat2dGet(GC,i,j));
-            ival = ajInt2dGet(Ptrans,i,j);
-	    X1 = (float) ival;
-            ival = ajInt2dGet(score,i,j);
-	    X2 = (float) ival;
+	    /* calc distance */
+	    C = GCji+GCij;
+	    C = C - (2*GCji*GCij);
+	    X1 = (float) trans;
+	    X2 = (float) m;
 	    P = X1/X2;
-	    
-            ival = ajInt2dGet(Qtranv,i,j);
-	    X1= (float) ival;
-            ival = ajInt2dGet(score,i,j);
-	    X2 = (float) ival;
+
+	    X1= (float) tranv;
 	    Q = X1/X2;
 
 	    if(P != 0.)
@@ -373,11 +418,11 @@ static AjPFloat2d distmat_Tamura(char* const * seqcharptr,
 	}
     }
 
-    ajInt2dDel(&Ptrans);
-    ajInt2dDel(&Qtranv);
-    ajInt2dDel(&score);
-    ajFloat2dDel(&GC);
-    ajFloat2dDel(&gap);
+    AJFREE(bad);
+    AJFREE(gcs);
+    AJFREE(subtr);
+    AJFREE(subtv);
+    AJFREE(scored);
 
     return matDist;
 }
@@ -391,22 +436,19 @@ static AjPFloat2d distmat_Tamura(char* const * seqcharptr,
 **
 ** M Kimura, J. Mol. Evol., 1980, 16, 111.
 **
-** @param [r] seqcharptr [char* const *] Array of sequences as C strings
-** @param [r] len [ajint] Length
+** @param [u] bits [DistmatPBits] Bit-sliced alignment
 ** @param [r] nseqs [ajint] Number of sequences
 ** @return [AjPFloat2d] corrected distance matrix
 **
 ******************************************************************************/
 
-static AjPFloat2d distmat_Kimura(char* const * seqcharptr,
-				 ajint len, ajint nseqs)
+static AjPFloat2d distmat_Kimura(DistmatPBits bits, ajint nseqs)
 {
     ajint i;
     ajint j;
-    ajint k;
-
-    ajint t1;
-    ajint t2;
+    ajuint ab;
+    ajuint n;
+    ajuint ncodes;
 
     float P;
     float Q;
@@ -418,75 +460,55 @@ static AjPFloat2d distmat_Kimura(char* const * seqcharptr,
     ajint m;
     ajint trans;
     ajint tranv;
-    ajint ival;
-    
+
+    ajint* subtr   = NULL;
+    ajint* subtv   = NULL;
+    AjBool* scored = NULL;
+    const ajuint* tab;
+
     AjPFloat2d matDist = NULL;
-    AjPInt2d Ptrans    = NULL;
-    AjPInt2d Qtranv    = NULL;
-    AjPInt2d match     = NULL;
 
 
 
     matDist = ajFloat2dNew();
-    Ptrans  = ajInt2dNew();
-    Qtranv  = ajInt2dNew();
-    match   = ajInt2dNew();
 
 
     /* initialise array */
     for(i=0;i<nseqs;++i)
-    {
 	for(j=i+1;j<nseqs;++j)
-	{
 	    ajFloat2dPut(&matDist,i,j,0.);
-	    ajInt2dPut(&Ptrans,i,j,0);
-	    ajInt2dPut(&Qtranv,i,j,0);
-	    ajInt2dPut(&match,i,j,0);
-	}
-    }
 
-    /* calc transition & transversion subst.'s */
+    ncodes = bits->Ncodes;
+    AJCNEW0(subtr, ncodes*ncodes);
+    AJCNEW0(subtv, ncodes*ncodes);
+    AJCNEW0(scored, ncodes*ncodes);
+
+    distmat_bitsSubs(bits,ajTrue,subtr,subtv,scored);
+
+    /* calc transition & transversion subst.'s and distance matrix */
     for(i=0;i<nseqs;i++)
     {
 	for(j=i+1;j<nseqs;j++)
 	{
-	    for(k=0; k< len; k++)
-	    {
-		t1 = toupper((int) seqcharptr[i][k]);
-		t2 = toupper((int) seqcharptr[j][k]);
+	    tab = distmat_bitsTable(bits,i,j);
+	    trans = tranv = m = 0;
 
-		if(!strchr("-",t2) && !strchr("-",t1))
+	    for(ab=0;ab<ncodes*ncodes;ab++)
+	    {
+		n = tab[ab];
+		if(n && scored[ab])
 		{
-		    trans = ajInt2dGet(Ptrans,i,j);
-		    tranv = ajInt2dGet(Qtranv,i,j);
-
-		    distmat_checkSubs(t1,t2,&trans,&tranv);
-		    distmat_checkRY(t1,t2,&trans,&tranv);
-		    ajInt2dPut(&Ptrans,i,j,trans);
-		    ajInt2dPut(&Qtranv,i,j,tranv);
-		    m = ajInt2dGet(match,i,j)+1;
-		    ajInt2dPut(&match,i,j,m);
+		    trans += n*subtr[ab];
+		    tranv += n*subtv[ab];
+		    m += n;
 		}
 	    }
-	}
-    }
-
 
-    /* calc distance matrix */
-    for(i=0;i<nseqs;i++)
-    {
-	for(j=i+1;j<nseqs;j++)
-	{
-            ival = ajInt2dGet(Ptrans,i,j);
-	    X1 = (float) ival;
-            ival = ajInt2dGet(match,i,j);
-	    X2 = (float) ival;
+	    X1 = (float) trans;
+	    X2 = (float) m;
 	    P = X1/X2;
 
-            ival = ajInt2dGet(Qtranv,i,j);
-	    X1 = (float) ival;
-            ival = ajInt2dGet(match,i,j);
-	    X2 = (float) ival;
+	    X1 = (float) tranv;
 	    Q = X1/X2;
 
 	    D = (float) (-0.5*log((1-(2*P)-Q)*sqrt(1-(2*Q))));
@@ -495,9 +517,9 @@ static AjPFloat2d distmat_Kimura(char* const * seqcharptr,
 	}
     }
 
-    ajInt2dDel(&Ptrans);
-    ajInt2dDel(&Qtranv);
-    ajInt2dDel(&match);
+    AJFREE(subtr);
+    AJFREE(subtv);
+    AJFREE(scored);
 
     return matDist;
 }
@@ -510,21 +532,26 @@ static AjPFloat2d distmat_Kimura(char* const * seqcharptr,
 ** Kimura protein distance
 **
 ** @param [r] seqcharptr [char* const *] Array of sequences as C strings
-** @param [r] mlen [ajint] Length
+** @param [r] bits [const DistmatPBits] Bit-sliced alignment
+** @param [r] len [ajint] Length
 ** @param [r] nseqs [ajint] Number of sequences
 ** @return [AjPFloat2d] corrected distance matrix
 **
 ******************************************************************************/
 
-static AjPFloat2d distmat_KimuraProt(char* const * seqcharptr, ajint mlen,
-				     ajint nseqs)
+static AjPFloat2d distmat_KimuraProt(char* const * seqcharptr,
+				     const DistmatPBits bits,
+				     ajint len, ajint nseqs)
 {
     ajint i;
     ajint j;
     ajint k;
-    ajint mi;
     ajint ival;
-    
+    ajint gap;
+    ajuint a;
+    ajuint b;
+    ajuint ncodes;
+
     char m1;
     char m2;
 
@@ -533,67 +560,66 @@ static AjPFloat2d distmat_KimuraProt(char* const * seqcharptr, ajint mlen,
 
     float X2;
 
+    float* score   = NULL;
+    AjBool* scored = NULL;
+    const ajuint* index = bits->Index;
+
     AjPFloat2d matDist = NULL;
-    AjPFloat2d match   = NULL;
-    AjPInt2d scored    = NULL;
 
 
 
     matDist = ajFloat2dNew();
-    match   = ajFloat2dNew();
-    scored  = ajInt2dNew();
 
 
     /* initialise array */
     for(i=0;i<nseqs;++i)
-    {
 	for(j=i+1;j<nseqs;++j)
-	{
 	    ajFloat2dPut(&matDist,i,j,0.);
-	    ajFloat2dPut(&match,i,j,0);
-	    ajInt2dPut(&scored,i,j,0);
-	}
-    }
 
-    /* calc matches */
-    for(i=0;i<nseqs;i++)
-    {
-	for(j=i+1;j<nseqs;j++)
+    ncodes = bits->Ncodes;
+    AJCNEW0(score, ncodes*ncodes);
+    AJCNEW0(scored, ncodes*ncodes);
+
+    for(a=0;a<ncodes;a++)
+	for(b=0;b<ncodes;b++)
 	{
-	    for(k=0; k< mlen; k++)
+	    m1 = bits->Codes[a];
+	    m2 = bits->Codes[b];
+	    if(m1 != '-' && m2 != '-')
 	    {
-		m1 = seqcharptr[i][k];
-		m2 = seqcharptr[j][k];
-		if(m1 != '-' && m2 != '-')
-		{
-
-		    m = ajFloat2dGet(match,i,j)+
-			distmat_checkambigProt(toupper((int) m1),
-					       toupper((int) m2));
-		    ajFloat2dPut(&match,i,j,m);
-		    mi = ajInt2dGet(scored,i,j)+1;
-		    ajInt2dPut(&scored,i,j,mi);
-		}
+		score[a*ncodes+b] =
+		    distmat_checkambigProt(toupper((int) m1),
+					   toupper((int) m2));
+		scored[a*ncodes+b] = ajTrue;
 	    }
 	}
-    }
-
 
-    /* calc distance matrix */
+    /* calc matches and distance matrix */
     for(i=0;i<nseqs;i++)
     {
 	for(j=i+1;j<nseqs;j++)
 	{
-            ival = ajInt2dGet(scored,i,j);
+	    /* summed in column order to keep the float total unchanged */
+	    m = 0.;
+	    for(k=0; k< len; k++)
+	    {
+		a = index[(unsigned char) seqcharptr[i][k]]*ncodes +
+		    index[(unsigned char) seqcharptr[j][k]];
+		if(scored[a])
+		    m = m + score[a];
+	    }
+
+	    distmat_bitsMatch(bits,i,j,&ival,&gap);
+	    ival = len - gap;
 	    X2 = (float) ival;
-	    D = (float) (1.-(ajFloat2dGet(match,i,j)/X2));
+	    D = (float) (1.-(m/X2));
 	    D = (float) (-log(1-D-(0.2*D*D)));
 	    ajFloat2dPut(&matDist,i,j,D);
 	}
     }
 
-    ajInt2dDel(&scored);
-    ajFloat2dDel(&match);
+    AJFREE(score);
+    AJFREE(scored);
 
     return matDist;
 }
@@ -607,6 +633,7 @@ static AjPFloat2d distmat_KimuraProt(char* const * seqcharptr, ajint mlen,
 ** alignment.
 **
 ** @param [r] seqcharptr [char* const *] Array of sequences as C strings
+** @param [r] bits [const DistmatPBits] Bit-sliced alignment
 ** @param [r] len [ajint] Length
 ** @param [r] nseqs [ajint] Number of sequences
 ** @param [r] ambig [AjBool] Ambiguity codes
@@ -617,6 +644,7 @@ static AjPFloat2d distmat_KimuraProt(char* const * seqcharptr, ajint mlen,
 ******************************************************************************/
 
 static AjPFloat2d distmat_calc_match(char* const * seqcharptr,
+				     const DistmatPBits bits,
 				     ajint len, ajint nseqs,
 				     AjBool ambig, AjBool nuc, AjPFloat2d* gap)
 {
@@ -624,11 +652,19 @@ static AjPFloat2d distmat_calc_match(char* const * seqcharptr,
     ajint i;
     ajint j;
     ajint k;
+    ajint imatch;
+    ajint igap;
+    ajuint a;
+    ajuint b;
+    ajuint ncodes;
 
     char m1;
     char m2;
 
     float m;
+    float* score = NULL;
+    AjBool* known = NULL;
+    const ajuint* index = bits->Index;
     AjPFloat2d match = NULL;
 
 
@@ -647,38 +683,58 @@ static AjPFloat2d distmat_calc_match(char* const * seqcharptr,
 	}
     }
 
+    ncodes = bits->Ncodes;
+
+    /*
+    ** ambiguity scores are looked up once for each pair of residue codes,
+    ** the first time that pair is seen in a column
+    */
+    if(ambig)
+    {
+	AJCNEW0(score, ncodes*ncodes);
+	AJCNEW0(known, ncodes*ncodes);
+    }
+
 
     for(i=0;i<nseqs;i++)
 	for(j=i+1;j<nseqs;j++)
-	    for(k=0; k< len; k++)
+	{
+	    distmat_bitsMatch(bits,i,j,&imatch,&igap);
+
+	    if(ambig)
 	    {
-		m1 = seqcharptr[i][k];
-		m2 = seqcharptr[j][k];
-		if(ambig && nuc)	/* using -ambiguous */
-		{
-		    m = ajBaseAlphacharCompare(m1,m2);
-		    m = ajFloat2dGet(match,i,j)+m;
-		    ajFloat2dPut(&match,i,j,m);
-		}
-		else if( ambig && !nuc && m1 != '-' && m2 != '-')
+		/* summed in column order to keep the float total unchanged */
+		m = 0.;
+		for(k=0; k< len; k++)
 		{
-		    m = distmat_checkambigProt(toupper((int) m1),
-					       toupper((int) m2));
-		    m = ajFloat2dGet(match,i,j)+m;
-		    ajFloat2dPut(&match,i,j,m);
-		}
-		else if( m2 == m1 && m1 != '-' )
-		{
-		    m = ajFloat2dGet(match,i,j)+1;
-		    ajFloat2dPut(&match,i,j,m);
-		}
+		    a = index[(unsigned char) seqcharptr[i][k]];
+		    b = index[(unsigned char) seqcharptr[j][k]];
 
-		if( m1 == '-' || m2 == '-' ) /* gap in seq */
-		{
-		    m = ajFloat2dGet(*gap,i,j)+1;
-		    ajFloat2dPut(gap,i,j,m);
+		    if(!known[a*ncodes+b])
+		    {
+			m1 = bits->Codes[a];
+			m2 = bits->Codes[b];
+			if(nuc)		/* using -ambiguous */
+			    score[a*ncodes+b] = ajBaseAlphacharCompare(m1,m2);
+			else if(m1 != '-' && m2 != '-')
+			    score[a*ncodes+b] =
+				distmat_checkambigProt(toupper((int) m1),
+						       toupper((int) m2));
+			known[a*ncodes+b] = ajTrue;
+		    }
+
+		    m = m + score[a*ncodes+b];
 		}
+		ajFloat2dPut(&match,i,j,m);
 	    }
+	    else
+		ajFloat2dPut(&match,i,j,(float) imatch);
+
+	    ajFloat2dPut(gap,i,j,(float) igap);
+	}
+
+    AJFREE(score);
+    AJFREE(known);
 
     return match;
 }
@@ -749,34 +805,42 @@ static AjPFloat2d distmat_uncorrected(const AjPFloat2d match,
 **
 ** Tajima and Nei, Mol. Biol. Evol. 1984, 1, 269.
 **
-** @param [r] seqcharptr [char* const *] Array of sequences as C strings
+** @param [u] bits [DistmatPBits] Bit-sliced alignment
 ** @param [r] match [const AjPFloat2d] Matches
-** @param [r] mlen [ajint] Length
 ** @param [r] nseqs [ajint] Number of sequences
 ** @return [AjPFloat2d] corrected distance matrix
 **
 ******************************************************************************/
 
-static AjPFloat2d distmat_TajimaNei(char* const * seqcharptr,
+static AjPFloat2d distmat_TajimaNei(DistmatPBits bits,
 				    const AjPFloat2d match,
-				    ajint mlen, ajint nseqs)
+				    ajint nseqs)
 {
 
     ajint i;
     ajint j;
-    ajint l;
     ajint ti;
     ajint tj;
+    ajuint ca;
+    ajuint cb;
+    ajuint cc;
+    ajuint n;
+    ajuint ncodes;
 
     ajint bs;
     ajint bs1;
     ajint pair;
-    ajint val;
     ajint ival;
-    
-    AjPInt2d len   = NULL;
-    AjPInt3d pfreq = NULL;
-    AjPInt3d cbase = NULL;
+
+    ajint len;
+    ajint pfreq[6];
+    ajint cbaseij[4];
+    ajint cbaseji[4];
+
+    AjBool* valid = NULL;
+    ajint* base   = NULL;
+    ajint* pclass = NULL;
+    const ajuint* tab;
 
     float fi;
     float fj;
@@ -797,120 +861,109 @@ static AjPFloat2d distmat_TajimaNei(char* const * seqcharptr,
     AjPFloat2d matchTN = NULL;
 
 
-    len   = ajInt2dNew();		/* scored length for pairs */
-    pfreq = ajInt3dNew();		/* pair freq between seq's */
-    cbase = ajInt3dNew();		/* no. of bases */
     matchTN = ajFloat2dNew();
 
-
-
     for(i=0;i<nseqs;++i)
 	for(j=0;j<nseqs;++j)
-	{
 	    ajFloat2dPut(&matchTN,i,j,0);
-	    ajInt2dPut(&len,i,j,0);
-	    for(pair=0;pair<6;pair++)
-		ajInt3dPut(&pfreq,i,j,pair,0);
 
-	    for(bs=0;bs<4;bs++)
-		ajInt3dPut(&cbase,i,j,bs,0);
+    ncodes = bits->Ncodes;
+    AJCNEW0(valid, ncodes);
+    AJCNEW0(base, ncodes);
+    AJCNEW0(pclass, ncodes*ncodes);
+
+    /* classify each residue code and each pair of codes */
+    for(ca=0;ca<ncodes;ca++)
+    {
+	ti = toupper((int) bits->Codes[ca]);
+	base[ca] = -1;
+
+	if(!strchr("-NXWMKBVDH",ti) )
+	{
+	    valid[ca] = ajTrue;
+	    if(strchr("G",ti))
+		base[ca] = 3;
+	    else if(strchr("C",ti))
+		base[ca] = 2;
+	    else if(strchr("T",ti))
+		base[ca] = 1;
+	    else if(strchr("A",ti))
+		base[ca] = 0;
 	}
 
-    /* calc content of each seq  - ignoring gaps */
-    for(i=0;i<nseqs;i++)
-	for(j=0;j<nseqs;j++)
-	    for(l=0; l< mlen; l++)
+	for(cb=0;cb<ncodes;cb++)
+	{
+	    tj = toupper((int) bits->Codes[cb]);
+	    pair = -1;
+
+	    if(valid[ca] && ti != tj)
 	    {
-		ti = toupper((int) seqcharptr[i][l]);
+		if((strchr("A",ti) && strchr("T",tj)) ||
+		   (strchr("T",ti) && strchr("A",tj)) )
+		    pair = 0;		/* AT pair */
+		else if((strchr("A",ti) && strchr("C",tj)) ||
+			(strchr("C",ti) && strchr("A",tj)) )
+		    pair = 1;		/* AC pair */
+		else if((strchr("A",ti) && strchr("G",tj)) ||
+			(strchr("G",ti) && strchr("A",tj)) )
+		    pair = 2;		/* AG pair */
+		else if((strchr("T",ti) && strchr("C",tj)) ||
+			(strchr("C",ti) && strchr("T",tj)) )
+		    pair = 3;		/* TC pair */
+		else if((strchr("T",ti) && strchr("G",tj)) ||
+			(strchr("G",ti) && strchr("T",tj)) )
+		    pair = 4;		/* TG pair */
+		else if((strchr("C",ti) && strchr("G",tj)) ||
+			(strchr("G",ti) && strchr("C",tj)) )
+		    pair = 5;		/* CG pair */
+	    }
+
+	    pclass[ca*ncodes+cb] = pair;
+	}
+    }
+
 
-		if(!strchr("-NXWMKBVDH",ti) )
+    /* calc content of each seq - ignoring gaps - and distance matrix */
+    for(i=0;i<nseqs;i++)
+	for(j=i+1;j<nseqs;j++)
+	{
+	    tab = distmat_bitsTable(bits,i,j);
+
+	    len = 0;
+	    for(pair=0;pair<6;pair++)
+		pfreq[pair] = 0;
+	    for(bs=0;bs<4;bs++)
+		cbaseij[bs] = cbaseji[bs] = 0;
+
+	    for(ca=0;ca<ncodes;ca++)
+		for(cb=0;cb<ncodes;cb++)
 		{
-		    tj = toupper((int) seqcharptr[j][l]);
+		    cc = ca*ncodes+cb;
+		    n = tab[cc];
+		    if(!n)
+			continue;
 
-		    if(!strchr("-NXWMKBVDH",tj))
+		    if(valid[ca] && valid[cb])
 		    {
-                        ival = ajInt2dGet(len,i,j)+1;
-			slen = (float) ival;
-			ajInt2dPut(&len,i,j,(ajint)slen);
-			if(strchr("G",ti))
-			{
-			    val = ajInt3dGet(cbase,i,j,3)+1;
-			    ajInt3dPut(&cbase,i,j,3,val);
-			}
-			else if(strchr("C",ti))
-			{
-			    val = ajInt3dGet(cbase,i,j,2)+1;
-			    ajInt3dPut(&cbase,i,j,2,val);
-			}
-			else if(strchr("T",ti))
-			{
-			    val = ajInt3dGet(cbase,i,j,1)+1;
-			    ajInt3dPut(&cbase,i,j,1,val);
-			}
-			else if(strchr("A",ti))
-			{
-			    val = ajInt3dGet(cbase,i,j,0)+1;
-			    ajInt3dPut(&cbase,i,j,0,val);
-			}
+			len += n;
+			if(base[ca] >= 0)
+			    cbaseij[base[ca]] += n;
+			if(base[cb] >= 0)
+			    cbaseji[base[cb]] += n;
 		    }
 
-		    if(ti != tj)
-		    {
-
-			if((strchr("A",ti) && strchr("T",tj)) ||
-			   (strchr("T",ti) && strchr("A",tj)) )
-			{		/* AT pair */
-			    val = ajInt3dGet(pfreq,i,j,0)+1;
-			    ajInt3dPut(&pfreq,i,j,0,val);
-			}
-			else if((strchr("A",ti) && strchr("C",tj)) ||
-				(strchr("C",ti) && strchr("A",tj)) )
-			{		/* AC pair */
-			    val = ajInt3dGet(pfreq,i,j,1)+1;
-			    ajInt3dPut(&pfreq,i,j,1,val);
-			}
-			else if((strchr("A",ti) && strchr("G",tj)) ||
-				(strchr("G",ti) && strchr("A",tj)) )
-			{		/* AG pair */
-			    val = ajInt3dGet(pfreq,i,j,2)+1;
-			    ajInt3dPut(&pfreq,i,j,2,val);
-			}
-			else if((strchr("T",ti) && strchr("C",tj)) ||
-				(strchr("C",ti) && strchr("T",tj)) )
-			{		/* TC pair */
-			    val = ajInt3dGet(pfreq,i,j,3)+1;
-			    ajInt3dPut(&pfreq,i,j,3,val);
-			}
-			else if((strchr("T",ti) && strchr("G",tj)) ||
-				(strchr("G",ti) && strchr("T",tj)) )
-			{		/* TG pair */
-			    val = ajInt3dGet(pfreq,i,j,4)+1;
-			    ajInt3dPut(&pfreq,i,j,4,val);
-			}
-			else if((strchr("C",ti) && strchr("G",tj)) ||
-				(strchr("G",ti) && strchr("C",tj)) )
-			{		/* CG pair */
-			    val = ajInt3dGet(pfreq,i,j,5)+1;
-			    ajInt3dPut(&pfreq,i,j,5,val);
-			}
-		    }
+		    if(pclass[cc] >= 0)
+			pfreq[pclass[cc]] += n;
 		}
-	    }
-    
 
-    /* calc distance matrix */
-    for(i=0;i<nseqs;i++)
-	for(j=i+1;j<nseqs;j++)
-	{
-            ival = ajInt2dGet(len,i,j);
-	    slen = (float) ival;
+	    slen = (float) len;
 
 	    fij2 = 0.;
 	    for(bs=0;bs<4;bs++)
 	    {
-                ival = ajInt3dGet(cbase,i,j,bs);
+                ival = cbaseij[bs];
 		fi  = (float) ival;
-                ival = ajInt3dGet(cbase,j,i,bs);
+                ival = cbaseji[bs];
 		fj  = (float) ival;
 		fij = 0.;
 		if(fi != 0. && fj != 0.)
@@ -924,16 +977,16 @@ static AjPFloat2d distmat_TajimaNei(char* const * seqcharptr,
 	    {
 		for(bs1=bs+1;bs1<4;bs1++)
 		{
-                    ival = ajInt3dGet(pfreq,i,j,pair);
+                    ival = pfreq[pair];
 		    X1 = (float) ival;
 		    fij = X1/slen;
-                    ival = ajInt3dGet(cbase,j,i,bs);
+                    ival = cbaseji[bs];
 		    ci1 = (float) ival;
-                    ival = ajInt3dGet(cbase,i,j,bs);
+                    ival = cbaseij[bs];
 		    cj1 = (float) ival;
-                    ival = ajInt3dGet(cbase,j,i,bs1);
+                    ival = cbaseji[bs1];
 		    ci2 = (float) ival;
-                    ival = ajInt3dGet(cbase,i,j,bs1);
+                    ival = cbaseij[bs1];
 		    cj2 = (float) ival;
 
 		    if(fij !=0.)
@@ -952,9 +1005,9 @@ static AjPFloat2d distmat_TajimaNei(char* const * seqcharptr,
 	}
 
 
-    ajInt2dDel(&len);
-    ajInt3dDel(&cbase);
-    ajInt3dDel(&pfreq);
+    AJFREE(valid);
+    AJFREE(base);
+    AJFREE(pclass);
 
     return matchTN;
 }
@@ -969,6 +1022,7 @@ static AjPFloat2d distmat_TajimaNei(char* const * seqcharptr,
 **  Jin and Nei, Mol. Biol. Evol. 82, 7, 1990.
 **
 ** @param [r] seqcharptr [char* const *] Array of sequences as C strings
+** @param [u] bits [DistmatPBits] Bit-sliced alignment
 ** @param [r] mlen [ajint] Length
 ** @param [r] nseqs [ajint] Number of sequences
 ** @param [r] calc_a [AjBool] Calculation
@@ -977,17 +1031,21 @@ static AjPFloat2d distmat_TajimaNei(char* const * seqcharptr,
 ******************************************************************************/
 
 static AjPFloat2d distmat_JinNei(char* const * seqcharptr,
+				 DistmatPBits bits,
 				 ajint mlen, ajint nseqs,
 				 AjBool calc_a, float var_a)
 {
     ajint i;
     ajint j;
     ajint k;
+    ajuint ab;
+    ajuint n;
+    ajuint ncodes;
 
-    ajint t1;
-    ajint t2;
     ajint trans;
     ajint tranv;
+    ajint subst;
+    ajint len;
     ajint slen = 0;
 
     float xlen = 0.0;
@@ -998,126 +1056,87 @@ static AjPFloat2d distmat_JinNei(char* const * seqcharptr,
     float Q;
 
     float X1;
-    ajint ti;
-    
-    AjPFloat2d matDist = NULL;
-    AjPFloat2d cval    = NULL;
-    AjPFloat2d avL     = NULL;
 
-    AjPInt2d Ptrans = NULL;
-    AjPInt2d Qtranv = NULL;
-    AjPInt2d len    = NULL;
+    ajint* subtr   = NULL;
+    ajint* subtv   = NULL;
+    AjBool* scored = NULL;
+    const ajuint* index = bits->Index;
+    const ajuint* tab;
+
+    AjPFloat2d matDist = NULL;
 
 
     matDist = ajFloat2dNew();
-    cval    = ajFloat2dNew();
-    avL     = ajFloat2dNew();
-    Ptrans  = ajInt2dNew();
-    Qtranv  = ajInt2dNew();
-    len     = ajInt2dNew();
 
     /* initialise array */
     for(i=0;i<nseqs;++i)
 	for(j=i+1;j<nseqs;++j)
-	{
 	    ajFloat2dPut(&matDist,i,j,0.);
-	    ajInt2dPut(&Ptrans,i,j,0);
-	    ajInt2dPut(&Qtranv,i,j,0);
-	    ajInt2dPut(&len,i,j,0);
-	    ajFloat2dPut(&avL,i,j,0);
-	}
 
+    ncodes = bits->Ncodes;
+    AJCNEW0(subtr, ncodes*ncodes);
+    AJCNEW0(subtv, ncodes*ncodes);
+    AJCNEW0(scored, ncodes*ncodes);
+
+    distmat_bitsSubs(bits,ajTrue,subtr,subtv,scored);
 
-    /* calc transition & transversion subst.'s */
     for(i=0;i<nseqs;i++)
 	for(j=i+1;j<nseqs;j++)
 	{
-	    av = ajFloat2dGet(avL,i,j);
-	    for(k=0; k< mlen; k++)
+	    /* calc transition & transversion subst.'s */
+	    tab = distmat_bitsTable(bits,i,j);
+	    trans = tranv = len = 0;
+
+	    for(ab=0;ab<ncodes*ncodes;ab++)
 	    {
-		t1 = toupper((int) seqcharptr[i][k]);
-		t2 = toupper((int) seqcharptr[j][k]);
-		if(!strchr("-",t1) && !strchr("-",t2))
+		n = tab[ab];
+		if(n && scored[ab])
 		{
-		    slen = ajInt2dGet(len,i,j)+1;
-		    ajInt2dPut(&len,i,j,slen);
-
-		    trans = 0;
-		    tranv = 0;
-		    distmat_checkSubs(t1,t2,&trans,&tranv);
-		    distmat_checkRY(t1,t2,&trans,&tranv);
-		    av+= ((float)trans + ((float)2.*(float)tranv));
-
-		    trans+= ajInt2dGet(Ptrans,i,j);
-		    tranv+= ajInt2dGet(Qtranv,i,j);
-
-		    ajInt2dPut(&Ptrans,i,j,trans);
-		    ajInt2dPut(&Qtranv,i,j,tranv);
+		    len += n;
+		    trans += n*subtr[ab];
+		    tranv += n*subtv[ab];
 		}
 	    }
-	    xlen = (float) slen;
-	    ajFloat2dPut(&avL,i,j,av/xlen);
-	}
 
+	    /* the averaging length is kept from the last scored pair */
+	    if(len)
+		slen = len;
 
-    if(calc_a)		/* calc inverse of coeff of variance */
-	for(i=0;i<nseqs;i++)
-	    for(j=i+1;j<nseqs;j++)
-	    {
-		ti = ajInt2dGet(len,i,j);
-		xlen = (float) ti;
+	    /* exact: each column adds a small whole number */
+	    av = (float) (trans + (2*tranv));
+	    xlen = (float) slen;
+	    av = av/xlen;
 
-/* This makes no sense - av gets overwritten */
-/*
-		av = (float)( ajInt2dGet(Ptrans,i,j)+
-			     (2*ajInt2dGet(Qtranv,i,j)) )/xlen;
-*/
+	    xlen = (float) len;
 
-		av = ajFloat2dGet(avL,i,j);
+	    if(calc_a)		/* calc inverse of coeff of variance */
+	    {
+		/* summed in column order to keep the float total unchanged */
 		var = 0.;
 
 		for(k=0; k< mlen; k++)
 		{
-		    t1 = toupper((int) seqcharptr[i][k]);
-		    t2 = toupper((int) seqcharptr[j][k]);
-		    if(!strchr("-",t1) && !strchr("-",t2))
+		    ab = index[(unsigned char) seqcharptr[i][k]]*ncodes +
+			index[(unsigned char) seqcharptr[j][k]];
+		    if(scored[ab])
 		    {
-			trans = 0;
-			tranv = 0;
-			distmat_checkSubs(t1,t2,&trans,&tranv);
-			distmat_checkRY(t1,t2,&trans,&tranv);
-
-			var+= (av-(float)(trans+(2*tranv)))*
-			    (av-(float)(trans+(2*tranv)));
+			subst = subtr[ab]+(2*subtv[ab]);
+			var+= (av-(float)subst)*(av-(float)subst);
 		    }
 		}
 		var = var/xlen;
-		ajFloat2dPut(&cval,i,j,(av*av)/var);
+		var = (av*av)/var;
 	    }
+	    else
+		var = var_a;
 
-
-    /* calc the dist matrix */
-    for(i=0;i<nseqs;i++)
-	for(j=i+1;j<nseqs;j++)
-	{
-	    ti = ajInt2dGet(len,i,j);
-	    xlen = (float) ti;
-	    
-	    ti = ajInt2dGet(Ptrans,i,j);
-	    X1 = (float) ti;
-	    
+	    /* calc the dist matrix */
+	    X1 = (float) trans;
 	    P = X1/xlen;
 
-	    ti = ajInt2dGet(Qtranv,i,j);
-	    X1 = (float) ti;
-	    
+	    X1 = (float) tranv;
 	    Q = X1/xlen;
 
-	    if(calc_a)
-		var = ajFloat2dGet(cval,i,j);
-	    else
-		var = var_a;
-
 	    dist = (float) (0.5*var*
                             (pow(1.-(2*P)-Q,-1./var) +
                              (0.5*pow(1.-(2*Q),-1./var)) - 1.5 ));
@@ -1125,11 +1144,9 @@ static AjPFloat2d distmat_JinNei(char* const * seqcharptr,
 	    ajFloat2dPut(&matDist,i,j,dist);
 	}
 
-    ajFloat2dDel(&cval);
-    ajFloat2dDel(&avL);
-    ajInt2dDel(&Ptrans);
-    ajInt2dDel(&Qtranv);
-    ajInt2dDel(&len);
+    AJFREE(subtr);
+    AJFREE(subtv);
+    AJFREE(scored);
 
     return matDist;
 }
@@ -1424,6 +1441,342 @@ static char** distmat_getSeq(const AjPSeqset seqset, ajint nseqs, ajint mlen,
 
 
 
+/* @funcstatic distmat_bitsNew ************************************************
+**
+** Build the bit-sliced copy of the alignment columns. Each distinct
+** character is given a residue code, stored one bit plane per code bit
+** so that a pair of sequences can be compared 64 columns at a time.
+**
+** @param [r] seqcharptr [char* const *] Array of sequences as C strings
+** @param [r] len [ajint] Length
+** @param [r] nseqs [ajint] Number of sequences
+** @param [r] table [AjBool] Keep per-code bitsets for residue pair tables
+** @return [DistmatPBits] Bit-sliced alignment
+**
+******************************************************************************/
+
+static DistmatPBits distmat_bitsNew(char* const * seqcharptr,
+				    ajint len, ajint nseqs, AjBool table)
+{
+    DistmatPBits ret = NULL;
+    ajint i;
+    ajint k;
+    ajuint c;
+    ajuint p;
+    ajuint w;
+    ajulong bit;
+    AjBool used[256];
+
+    AJNEW0(ret);
+
+    for(c=0;c<256;c++)
+	used[c] = ajFalse;
+
+    for(i=0;i<nseqs;i++)
+	for(k=0;k<len;k++)
+	{
+	    c = (ajuint) (unsigned char) seqcharptr[i][k];
+
+	    if(!used[c])
+	    {
+		used[c] = ajTrue;
+		ret->Index[c] = ret->Ncodes;
+		ret->Codes[ret->Ncodes++] = (char) c;
+	    }
+	}
+
+    ret->Nseqs = nseqs;
+    ret->Nplanes = 1;
+
+    while(((ajuint) 1 << ret->Nplanes) < ret->Ncodes)
+	ret->Nplanes++;
+
+    ret->Nwords = (len + DISTMAT_WORDBITS - 1) / DISTMAT_WORDBITS;
+    ret->Tailmask = ~(ajulong) 0;
+
+    if(len % DISTMAT_WORDBITS)
+	ret->Tailmask = ((ajulong) 1 << (len % DISTMAT_WORDBITS)) - 1;
+
+    if(!ret->Nwords)
+    {
+	ret->Nwords = 1;
+	ret->Tailmask = 0;
+    }
+
+    AJCNEW0(ret->Planes, nseqs);
+    AJCNEW0(ret->Gaps, nseqs);
+    AJCNEW0(ret->Count, nseqs);
+
+    if(table)
+    {
+	AJCNEW0(ret->Bits, nseqs);
+	AJCNEW0(ret->Table, ret->Ncodes * ret->Ncodes + 1);
+    }
+
+    for(i=0;i<nseqs;i++)
+    {
+	AJCNEW0(ret->Planes[i], ret->Nplanes * ret->Nwords);
+	AJCNEW0(ret->Gaps[i], ret->Nwords);
+	AJCNEW0(ret->Count[i], ret->Ncodes + 1);
+
+	for(k=0;k<len;k++)
+	    ret->Count[i][ret->Index[(unsigned char) seqcharptr[i][k]]]++;
+
+	if(table)
+	{
+	    AJCNEW0(ret->Bits[i], ret->Ncodes + 1);
+
+	    for(c=0;c<ret->Ncodes;c++)
+		if(ret->Count[i][c])
+		    AJCNEW0(ret->Bits[i][c], ret->Nwords);
+	}
+
+	for(k=0;k<len;k++)
+	{
+	    c = ret->Index[(unsigned char) seqcharptr[i][k]];
+	    w = k / DISTMAT_WORDBITS;
+	    bit = (ajulong) 1 << (k % DISTMAT_WORDBITS);
+
+	    for(p=0;p<ret->Nplanes;p++)
+		if((c >> p) & 1)
+		    ret->Planes[i][p * ret->Nwords + w] |= bit;
+
+	    if(seqcharptr[i][k] == '-')
+		ret->Gaps[i][w] |= bit;
+
+	    if(table)
+		ret->Bits[i][c][w] |= bit;
+	}
+    }
+
+    return ret;
+}
+
+
+
+
+/* @funcstatic distmat_bitsDel ************************************************
+**
+** Delete a bit-sliced alignment
+**
+** @param [d] Pbits [DistmatPBits*] Bit-sliced alignment
+** @return [void]
+**
+******************************************************************************/
+
+static void distmat_bitsDel(DistmatPBits* Pbits)
+{
+    DistmatPBits bits;
+    ajuint i;
+    ajuint c;
+
+    if(!Pbits || !*Pbits)
+	return;
+
+    bits = *Pbits;
+
+    for(i=0;i<bits->Nseqs;i++)
+    {
+	AJFREE(bits->Planes[i]);
+	AJFREE(bits->Gaps[i]);
+	AJFREE(bits->Count[i]);
+
+	if(bits->Bits)
+	{
+	    for(c=0;c<bits->Ncodes;c++)
+		AJFREE(bits->Bits[i][c]);
+
+	    AJFREE(bits->Bits[i]);
+	}
+    }
+
+    AJFREE(bits->Planes);
+    AJFREE(bits->Gaps);
+    AJFREE(bits->Count);
+    AJFREE(bits->Bits);
+    AJFREE(bits->Table);
+    AJFREE(*Pbits);
+
+    return;
+}
+
+
+
+
+/* @funcstatic distmat_bitsMatch **********************************************
+**
+** Count identical non-gap columns and columns with a gap in either
+** sequence for a pair of sequences
+**
+** @param [r] bits [const DistmatPBits] Bit-sliced alignment
+** @param [r] i [ajint] First sequence
+** @param [r] j [ajint] Second sequence
+** @param [w] match [ajint*] Identical columns
+** @param [w] gap [ajint*] Gap columns
+** @return [void]
+**
+******************************************************************************/
+
+static void distmat_bitsMatch(const DistmatPBits bits, ajint i, ajint j,
+			      ajint* match, ajint* gap)
+{
+    const ajulong* pi = bits->Planes[i];
+    const ajulong* pj = bits->Planes[j];
+    ajuint nwords = bits->Nwords;
+    ajuint p;
+    ajuint w;
+    ajulong eq;
+    ajulong gaps;
+
+    *match = 0;
+    *gap = 0;
+
+    for(w=0;w<nwords;w++)
+    {
+	eq = (w + 1 == nwords) ? bits->Tailmask : ~(ajulong) 0;
+
+	for(p=0;p<bits->Nplanes;p++)
+	    eq &= ~(pi[p * nwords + w] ^ pj[p * nwords + w]);
+
+	gaps = bits->Gaps[i][w] | bits->Gaps[j][w];
+
+	*match += distmat_popcount(eq & ~gaps);
+	*gap += distmat_popcount(gaps);
+    }
+
+    return;
+}
+
+
+
+
+/* @funcstatic distmat_bitsTable **********************************************
+**
+** Count the columns holding each pair of residue codes for a pair of
+** sequences. Codes absent from either sequence are skipped, and each row
+** stops as soon as all columns for its code in the first sequence are
+** accounted for.
+**
+** @param [u] bits [DistmatPBits] Bit-sliced alignment
+** @param [r] i [ajint] First sequence, giving the table row
+** @param [r] j [ajint] Second sequence, giving the table column
+** @return [const ajuint*] Pair frequencies indexed by row*ncodes+column
+**
+******************************************************************************/
+
+static const ajuint* distmat_bitsTable(DistmatPBits bits, ajint i, ajint j)
+{
+    ajuint ncodes = bits->Ncodes;
+    ajuint a;
+    ajuint b;
+    ajuint w;
+    ajuint sum;
+    ajuint rest;
+    const ajulong* ba;
+    const ajulong* bb;
+
+    for(a=0;a<ncodes*ncodes;a++)
+	bits->Table[a] = 0;
+
+    for(a=0;a<ncodes;a++)
+    {
+	rest = bits->Count[i][a];
+	ba = bits->Bits[i][a];
+
+	for(b=0;b<ncodes && rest;b++)
+	{
+	    if(!bits->Count[j][b])
+		continue;
+
+	    bb = bits->Bits[j][b];
+	    sum = 0;
+
+	    for(w=0;w<bits->Nwords;w++)
+		sum += distmat_popcount(ba[w] & bb[w]);
+
+	    bits->Table[a * ncodes + b] = sum;
+	    rest -= sum;
+	}
+    }
+
+    return bits->Table;
+}
+
+
+
+
+/* @funcstatic distmat_bitsSubs ***********************************************
+**
+** Tabulate transitions and transversions for each pair of residue codes
+** in a bit-sliced alignment.
+**
+** @param [r] bits [const DistmatPBits] Bit-sliced alignment
+** @param [r] ry [AjBool] Also count R and Y ambiguity codes
+** @param [w] trans [ajint*] Transitions for each code pair
+** @param [w] tranv [ajint*] Transversions for each code pair
+** @param [w] scored [AjBool*] True for code pairs without a gap
+** @return [void]
+**
+******************************************************************************/
+
+static void distmat_bitsSubs(const DistmatPBits bits, AjBool ry,
+			     ajint* trans, ajint* tranv, AjBool* scored)
+{
+    ajuint ncodes = bits->Ncodes;
+    ajuint a;
+    ajuint b;
+    ajint t1;
+    ajint t2;
+
+    for(a=0;a<ncodes;a++)
+	for(b=0;b<ncodes;b++)
+	{
+	    t1 = toupper((int) bits->Codes[a]);
+	    t2 = toupper((int) bits->Codes[b]);
+
+	    trans[a * ncodes + b] = 0;
+	    tranv[a * ncodes + b] = 0;
+	    scored[a * ncodes + b] = ajFalse;
+
+	    if(!strchr("-",t2) && !strchr("-",t1))
+	    {
+		scored[a * ncodes + b] = ajTrue;
+		distmat_checkSubs(t1,t2,&trans[a * ncodes + b],
+				  &tranv[a * ncodes + b]);
+		if(ry)
+		    distmat_checkRY(t1,t2,&trans[a * ncodes + b],
+				    &tranv[a * ncodes + b]);
+	    }
+	}
+
+    return;
+}
+
+
+
+
+/* @funcstatic distmat_popcount ***********************************************
+**
+** Count the bits set in a 64-bit word
+**
+** @param [r] word [ajulong] Word
+** @return [ajuint] Number of bits set
+**
+******************************************************************************/
+
+static ajuint distmat_popcount(ajulong word)
+{
+    word = word - ((word >> 1) & (ajulong) 0x5555555555555555ULL);
+    word = (word & (ajulong) 0x3333333333333333ULL) +
+	((word >> 2) & (ajulong) 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & (ajulong) 0x0F0F0F0F0F0F0F0FULL;
+
+    return (ajuint) ((word * (ajulong) 0x0101010101010101ULL) >> 56);
+}
+
+
+
+
 /* @funcstatic distmat_outputDist *********************************************
 **
 ** Output the distance matrix
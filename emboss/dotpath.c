@@ -44,7 +44,7 @@ int main(int argc, char **argv)
     AjPSeq seq1;
     AjPSeq seq2;
     ajint wordlen;
-    AjPTable seq1MatchTable = 0;
+    EmbPWordIndex seq1MatchIndex = 0;
     AjPList matchlist = NULL;
     AjPGraph graph = 0;
     AjBool boxit;
@@ -102,9 +102,9 @@ int main(int argc, char **argv)
     
     
     embWordLength(wordlen);
-    if(embWordGetTable(&seq1MatchTable, seq1))
-    {					/* get table of words */
-	matchlist = embWordBuildMatchTable(seq1MatchTable, seq2, ajTrue);
+    if(embWordGetIndex(&seq1MatchIndex, seq1))
+    {					/* get index of words */
+	matchlist = embWordBuildMatchIndex(seq1MatchIndex, seq2, ajTrue);
     }
     
     max = flen1;
@@ -212,7 +212,7 @@ int main(int argc, char **argv)
 
     ajGraphicsClose();
 
-    embWordFreeTable(&seq1MatchTable);
+    embWordFreeIndex(&seq1MatchIndex);
     if(matchlist)
 	embWordMatchListDelete(&matchlist);
 
@@ -50,7 +50,7 @@ int main(int argc, char **argv)
     AjPSeq seq1;
     AjPSeq seq2;
     ajint wordlen;
-    AjPTable seq1MatchTable = 0;
+    EmbPWordIndex seq1MatchIndex = 0;
     AjPList matchlist = NULL;
     AjPGraph graph    = NULL;
     AjPGraph xygraph  = NULL;
@@ -124,8 +124,8 @@ int main(int argc, char **argv)
     ajSeqTrim(seq2);
 
     embWordLength(wordlen);
-    if(embWordGetTable(&seq1MatchTable, seq1))
-	matchlist = embWordBuildMatchTable(seq1MatchTable, seq2, ajTrue);
+    if(embWordGetIndex(&seq1MatchIndex, seq1))
+	matchlist = embWordBuildMatchIndex(seq1MatchIndex, seq2, ajTrue);
 
 
     if(stretch)
@@ -236,7 +236,7 @@ int main(int argc, char **argv)
     ajGraphxyDel(&graph);
     ajGraphxyDel(&xygraph);
 
-    embWordFreeTable(&seq1MatchTable);
+    embWordFreeIndex(&seq1MatchIndex);
 
     if(matchlist)
 	embWordMatchListDelete(&matchlist); /* free the match structures */
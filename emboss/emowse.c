@@ -117,6 +117,13 @@ static ajint emowse_get_orc(AjPStr *orc, const char *s, ajint pos);
 static AjBool emowse_comp_search(const AjPStr substr, const char *s);
 static void emowse_print_hits(AjPFile outf, AjPList hlist, ajint dno,
 			      EmbPMdata const * data);
+static AjBool* emowse_index_search(EmbPMolIndex molindex,
+				   EmbPMdata const * data, ajint dno,
+				   double tol);
+static AjBool emowse_next_seq(AjPSeqall seqall, EmbPMolIndex molindex,
+			      const AjBool *found, ajuint *iprot,
+			      AjPSeq *seq, double *smw,
+			      EmbPPropMolwt const *mwdata, AjBool mono);
 
 
 
@@ -140,8 +147,6 @@ int main(int argc, char **argv)
     float tol;
     float partials;
     AjPDouble freqs = NULL;
-    ajint begin;
-    ajint end;
     double smw;
     ajint rno;
     ajint i;
@@ -152,6 +157,10 @@ int main(int argc, char **argv)
     ajint nfrags;
     AjPList hlist = NULL;
     AjPFile mfptr = NULL;
+    AjPFile molinf = NULL;
+    EmbPMolIndex molindex = NULL;
+    AjBool *found = NULL;
+    ajuint iprot = 0;
 
     EmbPPropMolwt *mwdata = NULL;
     AjBool mono;
@@ -169,6 +178,7 @@ int main(int argc, char **argv)
     outf     = ajAcdGetOutfile("outfile");
     mfptr    = ajAcdGetDatafile("mwdata");
     mono     = ajAcdGetBoolean("mono");
+    molinf   = ajAcdGetInfile("indexfile");
     
     mwdata = embPropEmolwtRead(mfptr);
 
@@ -184,17 +194,39 @@ int main(int argc, char **argv)
 	ajFatal("No molecular weights in the file");
     ajFileClose(&mwinf);
 
+    /*
+    ** With an index from emowseindex only the proteins with a fragment
+    ** in the tolerance of some data weight are read and scored. Other
+    ** proteins could not score, so the hits are unchanged.
+    */
 
-    hlist = ajListNew();
+    if(molinf)
+    {
+	molindex = embMolIndexRead(molinf);
 
+	if(!molindex)
+	    ajFatal("Bad fragment molecular weight index file '%F'", molinf);
+
+	if(molindex->Enzyme != (ajuint) rno || !molindex->Mono != !mono)
+	    ajFatal("Index file '%F' is for enzyme %u%s, not enzyme %d%s",
+		    molinf, molindex->Enzyme,
+		    molindex->Mono ? " (monoisotopic)" : "",
+		    rno, mono ? " (monoisotopic)" : "");
+
+	if(seqall)
+	    ajWarn("Input sequences ignored, searching index file '%F'",
+		   molinf);
+
+	found = emowse_index_search(molindex, data, dno, (double)tol);
+    }
 
-    while(ajSeqallNext(seqall,&seq))
-    {
-	begin = ajSeqallGetseqBegin(seqall);
-	end   = ajSeqallGetseqEnd(seqall);
 
+    hlist = ajListNew();
 
-	smw = embPropCalcMolwt(ajSeqGetSeqC(seq),--begin,--end,mwdata,mono);
+
+    while(emowse_next_seq(seqall,molindex,found,&iprot,&seq,&smw,
+			  mwdata,mono))
+    {
 	if(smolwt)
 	    if(emowse_molwt_outofrange(smw,(double)smolwt,(double)range))
 		continue;
@@ -232,6 +264,10 @@ int main(int argc, char **argv)
 
     embPropMolwtDel(&mwdata);
 
+    embMolIndexDel(&molindex);
+    ajFileClose(&molinf);
+    AJFREE(found);
+
     embExit();
 
     return 0;
@@ -1317,3 +1353,101 @@ static void emowse_print_hits(AjPFile outf, AjPList hlist, ajint dno,
 
     return;
 }
+
+
+
+
+/* @funcstatic emowse_index_search ********************************************
+**
+** Finds the proteins in a fragment molecular weight index with a fragment
+** within the tolerance of any data molecular weight, using the same
+** tolerance as emowse_match.
+**
+** @param [u] molindex [EmbPMolIndex] Fragment molecular weight index
+** @param [r] data [EmbPMdata const *] Data molecular weights
+** @param [r] dno [ajint] Number of data molecular weights
+** @param [r] tol [double] Tolerance
+** @return [AjBool*] True for each protein found
+** @@
+******************************************************************************/
+
+static AjBool* emowse_index_search(EmbPMolIndex molindex,
+				   EmbPMdata const * data, ajint dno,
+				   double tol)
+{
+    AjBool *found = NULL;
+    double actmw;
+    double minmw;
+    double maxmw;
+    double qtol;
+    ajint i;
+
+    if(!molindex->Nprots)
+	return NULL;
+
+    AJCNEW0(found, molindex->Nprots);
+
+    for(i=0;i<dno;++i)
+    {
+	actmw = data[i]->mwt;
+	qtol  = actmw / (double)100.;
+	minmw = actmw - (tol*qtol);
+	if(minmw<(double)0.)
+	    minmw = (double)0.;
+	maxmw = actmw + (tol*qtol);
+
+	embMolIndexSearch(molindex, minmw, maxmw, found);
+    }
+
+    return found;
+}
+
+
+
+
+/* @funcstatic emowse_next_seq ************************************************
+**
+** Reads the next protein to score, from the input sequences or, with an
+** index, the next protein found in the index.
+**
+** @param [u] seqall [AjPSeqall] Input sequences
+** @param [u] molindex [EmbPMolIndex] Fragment molecular weight index
+** @param [r] found [const AjBool*] True for each protein found in the index
+** @param [u] iprot [ajuint*] Next protein number in the index
+** @param [u] seq [AjPSeq*] Sequence
+** @param [w] smw [double*] Sequence molecular weight
+** @param [r] mwdata [EmbPPropMolwt const *] Molecular weight data
+** @param [r] mono [AjBool] True for monoisotopic weights
+** @return [AjBool] True if a protein was read
+** @@
+******************************************************************************/
+
+static AjBool emowse_next_seq(AjPSeqall seqall, EmbPMolIndex molindex,
+			      const AjBool *found, ajuint *iprot,
+			      AjPSeq *seq, double *smw,
+			      EmbPPropMolwt const *mwdata, AjBool mono)
+{
+    ajint begin;
+    ajint end;
+
+    if(molindex)
+    {
+	while(*iprot < molindex->Nprots && !found[*iprot])
+	    ++*iprot;
+
+	if(*iprot >= molindex->Nprots)
+	    return ajFalse;
+
+	return embMolIndexGetSeq(molindex, (*iprot)++, seq, smw);
+    }
+
+    if(!ajSeqallNext(seqall,seq))
+	return ajFalse;
+
+    begin = ajSeqallGetseqBegin(seqall);
+    end   = ajSeqallGetseqEnd(seqall);
+
+    *smw = embPropCalcMolwt(ajSeqGetSeqC(*seq),--begin,--end,mwdata,mono);
+
+    return ajTrue;
+}
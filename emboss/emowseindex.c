@@ -0,0 +1,96 @@
+/* @source emowseindex application
+**
+** Indexes protein digest fragment molecular weights for emowse
+**
+** @author Copyright (C) Alan Bleasby (ableasby@hgmp.mrc.ac.uk)
+** @@
+**
+** This program is free software; you can redistribute it and/or
+** modify it under the terms of the GNU General Public License
+** as published by the Free Software Foundation; either version 2
+** of the License, or (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+******************************************************************************/
+
+#include "emboss.h"
+
+
+
+
+/* @prog emowseindex **********************************************************
+**
+** Index protein digest fragment molecular weights for emowse
+**
+******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    AjPSeq seq = NULL;
+    AjPSeqall seqall = NULL;
+    AjPFile outf = NULL;
+    AjPFile mfptr = NULL;
+    AjPStr enzyme = NULL;
+    ajint begin;
+    ajint end;
+    double smw;
+    ajint rno;
+
+    EmbPMolIndex molindex = NULL;
+    EmbPPropMolwt *mwdata = NULL;
+    AjBool mono;
+
+    embInit("emowseindex", argc, argv);
+
+    seqall   = ajAcdGetSeqall("sequence");
+    enzyme   = ajAcdGetListSingle("enzyme");
+    outf     = ajAcdGetOutfile("outfile");
+    mfptr    = ajAcdGetDatafile("mwdata");
+    mono     = ajAcdGetBoolean("mono");
+
+    mwdata = embPropEmolwtRead(mfptr);
+
+    if(ajFmtScanS(enzyme,"%d",&rno)!=1)
+	ajFatal("Illegal enzyme entry [%S]",enzyme);
+
+    molindex = embMolIndexNewFile(outf,rno,mono);
+
+    /* sequence weights as calculated by emowse */
+
+    while(ajSeqallNext(seqall,&seq))
+    {
+	begin = ajSeqallGetseqBegin(seqall);
+	end   = ajSeqallGetseqEnd(seqall);
+
+	smw = embPropCalcMolwt(ajSeqGetSeqC(seq),--begin,--end,mwdata,mono);
+
+	embMolIndexAddSeq(molindex,seq,smw,mwdata);
+    }
+
+    embMolIndexWrite(molindex);
+
+    ajDebug("emowseindex proteins: %u fragments: %Lu\n",
+	    molindex->Nprots, molindex->Nfrags);
+
+    embMolIndexDel(&molindex);
+
+    ajFileClose(&mfptr);
+
+    ajSeqallDel(&seqall);
+    ajSeqDel(&seq);
+    ajFileClose(&outf);
+    ajStrDel(&enzyme);
+
+    embPropMolwtDel(&mwdata);
+
+    embExit();
+
+    return 0;
+}
@@ -30,9 +30,11 @@ static void getorf_WriteORF(const AjPSeq seq, ajint len, ajint seqlen,
 			    ajint start, ajint pos, const AjPStr str,
 			    AjPSeqout seqout, ajint around);
 
-static void getorf_AppORF(ajint find, AjPStr *str,
-			  const char *chrseq, ajint pos,
-			  char aa);
+static void getorf_MakeORF(ajint find, AjPStr *str,
+			   const char *chrseq, ajint start, ajint ncodon,
+			   const AjPTrn trnTable, AjBool methionine);
+
+static ajint getorf_ORFLen(ajint find, ajint ncodon);
 
 static void getorf_FindORFs(const AjPSeq seq, ajint len, const AjPTrn trnTable,
 			    ajuint minsize, ajuint maxsize, AjPSeqout seqout, 
@@ -182,6 +184,10 @@ int main(int argc, char **argv)
 **
 ** finds all orfs in the current sense and writes them out
 **
+** Each frame only keeps the start position and the number of codons of
+** the ORF it is growing. The ORF sequence is made only when it is long
+** enough to be written out.
+**
 ** @param [r] seq [const AjPSeq] Nucleotide sequence
 ** @param [r] len [ajint] Sequence length
 ** @param [r] trnTable [const AjPTrn] Translation table
@@ -212,14 +218,15 @@ static void getorf_FindORFs(const AjPSeq seq, ajint len, const AjPTrn trnTable,
 				    N_STOP2STOP */
     ajint start[3];		  /* possible starting position of the
 				     three frames */
+    ajint ncodon[3];		 /* number of codons in the ORFs of the
+				    three frames that we are growing */
     ajint pos;
     ajint codon;
     char aa;
     ajint frame;
-    AjPStr newstr[3];		 /* strings of the three frames of ORF
-				    sequences that we are growing */
+    ajuint orflen;
+    AjPStr orfstr = NULL;	 /* sequence of an ORF to be written */
     AjPSeq pep = NULL;
-    ajint i;
 
     ajint seqlen;
     const char *chrseq;
@@ -227,10 +234,10 @@ static void getorf_FindORFs(const AjPSeq seq, ajint len, const AjPTrn trnTable,
     seqlen = ajSeqGetLen(seq);
     chrseq = ajSeqGetSeqC(seq);
 
-    /* initialise the ORF sequences */
-    newstr[0] = NULL;
-    newstr[1] = NULL;
-    newstr[2] = NULL;
+    /* initialise the ORF lengths */
+    ncodon[0] = 0;
+    ncodon[1] = 0;
+    ncodon[2] = 0;
 
     /*
     ** initialise flags for found the last ORF past the end of a circular
@@ -261,19 +268,18 @@ static void getorf_FindORFs(const AjPSeq seq, ajint len, const AjPTrn trnTable,
 	ORF[0] = ajTrue;
 	ORF[1] = ajTrue;
 	ORF[2] = ajTrue;
-	start[0] = 0;
-	start[1] = 1;
-	start[2] = 2;
     }
 
-    for(pos=0; pos<seqlen-2; pos++)
+    start[0] = 0;
+    start[1] = 1;
+    start[2] = 2;
+
+    frame = 0;
+
+    for(pos=0; pos<seqlen-2; pos++, frame = (frame == 2) ? 0 : frame+1)
     {
 	codon = ajTrnCodonstrTypeC(trnTable, &chrseq[pos], &aa);
-	frame = pos % 3;
-	ajDebug("len=%d, Pos=%d, Frame=%d start/stop=%d, aa=%c '%c%c%c'\n",
-		len, pos, frame, codon, aa,
-                chrseq[pos], chrseq[pos+1], chrseq[pos+2]);
-	
+
 	/* don't want to find extra ORFs when already been round circ */
 	if(LASTORF[frame])
 	    continue;
@@ -297,29 +303,32 @@ static void getorf_FindORFs(const AjPSeq seq, ajint len, const AjPTrn trnTable,
 		** codon
 		*/
 		if(codon != STOP)
-		    getorf_AppORF(find, &newstr[frame], chrseq, pos,
-				  aa);
+		    ncodon[frame]++;
 
 		/* Already have a sequence to write out? */
 		if(ORF[frame])
 		{
-		    if(ajStrGetLen(newstr[frame]) >= minsize && 
-		       ajStrGetLen(newstr[frame]) <= maxsize)
+		    orflen = getorf_ORFLen(find, ncodon[frame]);
+
+		    if(orflen >= minsize && orflen <= maxsize)
 		    {
 			/* create a new sequence */
+			getorf_MakeORF(find, &orfstr, chrseq, start[frame],
+				       ncodon[frame], trnTable, ajFalse);
+
 			if(codon == STOP)
 			    getorf_WriteORF(seq, len, seqlen, sense,
 					    find, orf_no, start[frame],
-					    pos-1, newstr[frame],
+					    pos-1, orfstr,
 					    seqout, around);
 			else
 			    getorf_WriteORF(seq, len, seqlen, sense,
 					    find, orf_no, start[frame],
-					    pos+2, newstr[frame],
+					    pos+2, orfstr,
 					    seqout, around);
 		    }
 
-		    ajStrSetClear(&newstr[frame]);
+		    ncodon[frame] = 0;
 		}
 
 		/*
@@ -341,12 +350,13 @@ static void getorf_FindORFs(const AjPSeq seq, ajint len, const AjPTrn trnTable,
 		    */
 		    ORF[frame]   = ajTrue;
 		    start[frame] = pos+3; /* next start of the ORF */
+		    ncodon[frame] = 0;
 		}
 
 	    }
 	    else if(ORF[frame])
-		/* append sequence to newstr if in an ORF */
-		getorf_AppORF(find, &newstr[frame], chrseq, pos, aa);
+		/* extend the ORF if in an ORF */
+		ncodon[frame]++;
 	}
 	else /* Look for start: P_START2STOP N_START2STOP AROUND_START */
 	{
@@ -356,19 +366,9 @@ static void getorf_FindORFs(const AjPSeq seq, ajint len, const AjPTrn trnTable,
 		/* not in a ORF already and found a START */
 		if(pos < len)
 		{
-		    /*
-		    **  reset the newstr to zero length to enable
-		    **  storing the ORF for this
-		    */
-		    ajStrSetClear(&newstr[frame]);
 		    ORF[frame] = ajTrue; /* now in an ORF */
 		    start[frame] = pos;	/* start of the ORF for this frame */
-		    if(methionine)
-			getorf_AppORF(find, &newstr[frame], chrseq,
-				      pos, 'M');
-		    else
-			getorf_AppORF(find, &newstr[frame], chrseq,
-				      pos, aa);
+		    ncodon[frame] = 1;
 		}
 	    }
 	    else if(codon == STOP)
@@ -379,14 +379,16 @@ static void getorf_FindORFs(const AjPSeq seq, ajint len, const AjPTrn trnTable,
 		if(ORF[frame])
 		{
 		    ORF[frame] = ajFalse; /* not in an ORF */
+		    orflen = getorf_ORFLen(find, ncodon[frame]);
 
-		    if(ajStrGetLen(newstr[frame]) >= minsize &&
-		       ajStrGetLen(newstr[frame]) <= maxsize)
+		    if(orflen >= minsize && orflen <= maxsize)
 		    {
 			/* create a new sequence */
+			getorf_MakeORF(find, &orfstr, chrseq, start[frame],
+				       ncodon[frame], trnTable, methionine);
 			getorf_WriteORF(seq, len, seqlen, sense,
 					    find, orf_no, start[frame],
-					    pos-1, newstr[frame],
+					    pos-1, orfstr,
 					    seqout, around);
 		    }
 		}
@@ -401,7 +403,7 @@ static void getorf_FindORFs(const AjPSeq seq, ajint len, const AjPTrn trnTable,
 		    if(LASTORF[0] && LASTORF[1] && LASTORF[2]) break;
 		}
 
-		ajStrSetClear(&newstr[frame]);
+		ncodon[frame] = 0;
             }
             else if(pos >= seqlen-5)
             {
@@ -417,17 +419,17 @@ static void getorf_FindORFs(const AjPSeq seq, ajint len, const AjPTrn trnTable,
 		    ** last codon to the sequence - otherwise, ignore the
 		    ** STOP codon
 		    */
-		    if(pos >= seqlen-5 && pos < seqlen-2)
-			getorf_AppORF(find, &newstr[frame], chrseq,
-				      pos, aa);
+		    ncodon[frame]++;
+		    orflen = getorf_ORFLen(find, ncodon[frame]);
 
-		    if(ajStrGetLen(newstr[frame]) >= minsize &&
-		       ajStrGetLen(newstr[frame]) <= maxsize)
+		    if(orflen >= minsize && orflen <= maxsize)
 		    {
 			/* create a new sequence */
+			getorf_MakeORF(find, &orfstr, chrseq, start[frame],
+				       ncodon[frame], trnTable, methionine);
 			getorf_WriteORF(seq, len, seqlen, sense,
                                         find, orf_no, start[frame],
-                                        pos+2, newstr[frame],
+                                        pos+2, orfstr,
                                         seqout, around);
 		    }
 		}
@@ -442,12 +444,11 @@ static void getorf_FindORFs(const AjPSeq seq, ajint len, const AjPTrn trnTable,
 		    if(LASTORF[0] && LASTORF[1] && LASTORF[2]) break;
 		}
 
-		ajStrSetClear(&newstr[frame]);
+		ncodon[frame] = 0;
 	    }
 	    else
 		if(ORF[frame])
-		    getorf_AppORF(find, &newstr[frame], chrseq, pos,
-				  aa);
+		    ncodon[frame]++;
 
 	}
     }
@@ -496,8 +497,7 @@ static void getorf_FindORFs(const AjPSeq seq, ajint len, const AjPTrn trnTable,
 	}
     }
 
-    for(i=0;i<3;++i)
-	ajStrDel(&newstr[i]);
+    ajStrDel(&orfstr);
 
     return;
 }
@@ -702,33 +702,60 @@ static void getorf_WriteORF(const AjPSeq seq,
 
 
 
-/* @funcstatic getorf_AppORF **************************************************
+/* @funcstatic getorf_ORFLen **************************************************
 **
-** append aa to ORF sequence string
+** Returns the length of an ORF sequence as it would be written out
 **
 ** @param [r] find [ajint] Find code
-** @param [u] str [AjPStr*] Sequence string
-** @param [r] chrseq [const char*] Undocumented
-** @param [r] pos [ajint] Codon triplet position in chrseq
-** @param [r] aa [char] Undocumented
+** @param [r] ncodon [ajint] Number of codons in the ORF
+** @return [ajint] Length in bases or residues
 ** @@
 ******************************************************************************/
 
-static void getorf_AppORF(ajint find, AjPStr *str,
-			  const char *chrseq, ajint pos,
-			  char aa)
+static ajint getorf_ORFLen(ajint find, ajint ncodon)
 {
-
     if(find == N_STOP2STOP || find == N_START2STOP ||
 	find == AROUND_INIT_STOP || find == AROUND_END_STOP)
+	return 3*ncodon;
+
+    return ncodon;
+}
+
+
+
+
+/* @funcstatic getorf_MakeORF *************************************************
+**
+** Makes the sequence of an ORF from its codons
+**
+** @param [r] find [ajint] Find code
+** @param [w] str [AjPStr*] Sequence string
+** @param [r] chrseq [const char*] Nucleotide sequence
+** @param [r] start [ajint] Start position of the first codon in chrseq
+** @param [r] ncodon [ajint] Number of codons in the ORF
+** @param [r] trnTable [const AjPTrn] Translation table
+** @param [r] methionine [AjBool] If true report the start codon as 'M'
+** @@
+******************************************************************************/
+
+static void getorf_MakeORF(ajint find, AjPStr *str,
+			   const char *chrseq, ajint start, ajint ncodon,
+			   const AjPTrn trnTable, AjBool methionine)
+{
+    ajStrAssignClear(str);
+
+    if(!ncodon)
+	return;
+
+    if(find == N_STOP2STOP || find == N_START2STOP)
+	ajStrAssignLenC(str, &chrseq[start], 3*ncodon);
+    else if(find == P_STOP2STOP || find == P_START2STOP)
     {
-	ajStrAppendK(str, chrseq[pos]);
-	ajStrAppendK(str, chrseq[pos+1]);
-	ajStrAppendK(str, chrseq[pos+2]);
+	ajTrnSeqC(trnTable, &chrseq[start], 3*ncodon, str);
+
+	if(methionine && find == P_START2STOP)
+	    ajStrPasteCountK(str, 0, 'M', 1);
     }
-    else if(find == P_STOP2STOP || find == P_START2STOP ||
-	    find == AROUND_START)
-	ajStrAppendK(str, aa);
 
     return;
 }
@@ -142,21 +142,61 @@ typedef struct SJspmat {
 
 
 
+/* @datastatic PJspprofile ****************************************************
+**
+** Jaspar matrix scoring profile
+**
+** Holds a matrix converted for scanning, so that each matrix file is
+** read only once however many sequences are scanned.
+**
+** PJspprofile is implemented as a pointer to a C data structure.
+**
+** @alias SJspprofile
+** @alias OJspprofile
+**
+** @attr matname [AjPStr] matrix name
+** @attr fwd [float*] forward strand scores, five per column
+** @attr rev [float*] reverse strand scores, five per column
+** @attr fwdbound [float*] best forward score of columns from n to the end
+** @attr revbound [float*] best reverse score of columns from n to the end
+** @attr maxscore [float] maximum score for the matrix
+** @attr cols [ajuint] number of columns
+** @@
+******************************************************************************/
+
+typedef struct SJspprofile {
+    AjPStr matname;
+    float *fwd;
+    float *rev;
+    float *fwdbound;
+    float *revbound;
+    float maxscore;
+    ajuint cols;
+} OJspprofile;
+#define PJspprofile OJspprofile*
+
+
+
+
 static void    jaspscan_ParseInput(const AjPStr dir, const AjPStr jaspdir,
 				   const AjPStr mats, const AjPStr excl,
 				   ajuint *recurs, AjPList ret);
 static void    jaspscan_GetFileList(const AjPStr dir, const AjPStr jaspdir,
 				    const char *wild, AjPList list);
 static void    jaspscan_strdel(void** str, void* cl);
-static void    jaspscan_scan(const AjPStr seq, const ajuint begin,
-			     const AjPStr mfname, const char type,
-			     const float threshold,
+static void    jaspscan_scan(const ajuint *codes, ajuint slen,
+			     const ajuint begin, const PJspprofile prof,
+			     const char type, const float threshold,
 			     const AjBool both, AjPList hits);
+static void    jaspscan_encode(const AjPStr seq, ajuint **codes);
 
 
 static PJsphits jaspscan_hitsnew(void);
 static void       jaspscan_hitsdel(PJsphits *thys);
 
+static PJspprofile jaspscan_profilenew(const AjPStr mfname);
+static void        jaspscan_profiledel(PJspprofile *thys);
+
 static PJspmat  jaspscan_infonew(void);
 static void       jaspscan_infodel(PJspmat *thys);
 
@@ -203,6 +243,9 @@ int main(int argc, char **argv)
     AjPList flist = NULL;
     AjPList hits  = NULL;
 
+    PJspprofile *profiles = NULL;
+    ajuint *codes = NULL;
+
     AjPStr head   = NULL;
     
     
@@ -261,6 +304,16 @@ int main(int argc, char **argv)
     jaspscan_ParseInput(dir, jaspdir, mats, excl, &recurs, flist);
     mno = (ajuint) ajListGetLength(flist);
 
+    if(mno)
+	AJCNEW0(profiles, mno);
+
+    for(i=0; i < mno; ++i)
+    {
+	ajListPop(flist,(void **)&mfname);
+	profiles[i] = jaspscan_profilenew(mfname);
+	ajListPushAppend(flist, (void **)mfname);
+    }
+
 
     if(cp == 'C')
 	mattab = jaspscan_ReadCoreList(jaspdir);
@@ -288,15 +341,11 @@ int main(int argc, char **argv)
 
 	TabRpt = ajFeattableNewSeq(seq);
 
+	jaspscan_encode(substr, &codes);
 
 	for(i=0; i < mno; ++i)
-	{
-	    ajListPop(flist,(void **)&mfname);
-
-	    jaspscan_scan(substr,begin,mfname, cp, thresh, both, hits);
-
-            ajListPushAppend(flist, (void **)mfname);
-	}
+	    jaspscan_scan(codes, ajStrGetLen(substr), begin, profiles[i],
+			  cp, thresh, both, hits);
 
 	jaspscan_ReportHits(TabRpt,mattab,hits);
 
@@ -308,6 +357,11 @@ int main(int argc, char **argv)
     while(ajListPop(flist,(void **)&mfname))
         ajStrDel(&mfname);
 
+    for(i=0; i < mno; ++i)
+	jaspscan_profiledel(&profiles[i]);
+    AJFREE(profiles);
+    AJFREE(codes);
+
     
     ajStrDel(&dir);
     ajStrDel(&menu);
@@ -575,147 +629,278 @@ static void jaspscan_strdel(void** str, void* cl)
 
 
 
-/* @funcstatic jaspscan_scan *********************************************
+/* @funcstatic jaspscan_profilenew ********************************************
 **
-** Scans a sequence with a matrix
+** Read a Jaspar matrix file and convert it into a scoring profile
+**
+** The scores for each column are held in one row of five values
+** indexed by jaspscan_encode base codes, the fifth being zero for bases
+** other than A, C, G or T. A reverse strand profile is made from the
+** complemented matrix, and for each strand the best possible score of
+** the remaining columns is saved so that hopeless windows can be
+** abandoned early.
 **
-** @param [r] seq [const AjPStr] sequence
-** @param [r] begin [const ajuint] start position
 ** @param [r] mfname [const AjPStr] matrix file name
-** @param [r] type [const char] Jaspar database type (C,F or P)
-** @param [r] threshold [const float] scoring threshold
-** @param [r] both [const AjBool] scan reverse strand too
-** @param [u] hits [AjPList] hit list
 **
-** @return [void]
+** @return [PJspprofile] scoring profile
 ** @@
 ******************************************************************************/
 
-static void jaspscan_scan(const AjPStr seq, const ajuint begin,
-			  const AjPStr mfname, const char type,
-			  const float threshold,
-			  const AjBool both, AjPList hits)
+static PJspprofile jaspscan_profilenew(const AjPStr mfname)
 {
-    PJsphits val = NULL;
-    AjPStr mname   = NULL;
+    PJspprofile thys = NULL;
     float **matrix = NULL;
+    float rmax = 0.;
     ajuint cols;
-
-    ajuint i;
-    ajuint rc;
     ajuint cc;
-    ajuint limit;
-    
-    ajuint slen;
-    const char *p;
+    ajuint rc;
 
-    char schar;
-    float sum  = 0.;
-    float rmax = 0.;
+    AJNEW0(thys);
 
-    float scorepc  = 0.;
-    float maxscore = 0.;
+    thys->matname = ajStrNewS(mfname);
+    ajFilenameTrimPath(&thys->matname);
+    ajFilenameTrimExt(&thys->matname);
 
-    
     cols = jaspscan_readmatrix(mfname, &matrix);
+    thys->cols = cols;
+
+    AJCNEW0(thys->fwd, 5*cols);
+    AJCNEW0(thys->rev, 5*cols);
+    AJCNEW0(thys->fwdbound, cols+1);
+    AJCNEW0(thys->revbound, cols+1);
 
-    maxscore = 0.;
+    thys->maxscore = 0.;
     for(cc = 0; cc < cols; ++cc)
     {
 	rmax = 0.;
 	for(rc = 0; rc < 4; ++rc)
+	{
 	    rmax = (rmax > matrix[rc][cc]) ? rmax : matrix[rc][cc];
-	maxscore += rmax;
+	    thys->fwd[5*cc+rc] = matrix[rc][cc];
+	}
+	thys->maxscore += rmax;
     }
-    
 
- 
-    slen = ajStrGetLen(seq);
+    jaspscan_CompMat(matrix, cols);
 
-    limit = (slen - cols) + 1;
-    if(limit <= 0)
-	return;
+    for(cc = 0; cc < cols; ++cc)
+	for(rc = 0; rc < 4; ++rc)
+	    thys->rev[5*cc+rc] = matrix[rc][cc];
 
-    mname = ajStrNew();
+    for(cc = cols; cc > 0; --cc)
+    {
+	rmax = 0.;
+	for(rc = 0; rc < 4; ++rc)
+	    rmax = (rmax > thys->fwd[5*(cc-1)+rc]) ?
+		rmax : thys->fwd[5*(cc-1)+rc];
+	thys->fwdbound[cc-1] = thys->fwdbound[cc] + rmax;
 
-    ajStrAssignS(&mname,mfname);
-    ajFilenameTrimPath(&mname);
-    ajFilenameTrimExt(&mname);
+	rmax = 0.;
+	for(rc = 0; rc < 4; ++rc)
+	    rmax = (rmax > thys->rev[5*(cc-1)+rc]) ?
+		rmax : thys->rev[5*(cc-1)+rc];
+	thys->revbound[cc-1] = thys->revbound[cc] + rmax;
+    }
+
+    for(rc = 0; rc < 4; ++rc)
+	AJFREE(matrix[rc]);
+    AJFREE(matrix);
+
+    return thys;
+}
+
+
+
+
+/* @funcstatic jaspscan_profiledel ********************************************
+**
+** Delete a Jaspar scoring profile
+**
+** @param [d] thys [PJspprofile*] Jaspar scoring profile
+**
+** @return [void]
+** @@
+******************************************************************************/
+
+static void jaspscan_profiledel(PJspprofile *thys)
+{
+    PJspprofile pthis;
+
+    pthis = *thys;
+
+    ajStrDel(&pthis->matname);
+    AJFREE(pthis->fwd);
+    AJFREE(pthis->rev);
+    AJFREE(pthis->fwdbound);
+    AJFREE(pthis->revbound);
+    AJFREE(pthis);
+
+    *thys = NULL;
+
+    return;
+}
+
+
+
+
+/* @funcstatic jaspscan_encode ************************************************
+**
+** Convert an upper case sequence to profile row offsets
+**
+** @param [r] seq [const AjPStr] sequence
+** @param [w] codes [ajuint **] row offsets, 0 to 4 for A, C, G, T
+**                              and anything else
+**
+** @return [void]
+** @@
+******************************************************************************/
+
+static void jaspscan_encode(const AjPStr seq, ajuint **codes)
+{
+    const char *p;
+    ajuint slen;
+    ajuint i;
+
+    slen = ajStrGetLen(seq);
+    AJCRESIZE(*codes, slen+1);
 
     p = ajStrGetPtr(seq);
 
-    for(i=0; i < limit; ++i)
+    for(i=0; i < slen; ++i)
     {
-	sum = 0.;
-	schar = p[i];
-	for(cc = 0; cc < cols; ++cc)
+	switch(p[i])
 	{
-	    schar = p[i+cc];
-	    if(schar == 'A')
-		sum += matrix[0][cc];
-	    else if(schar == 'C')
-		sum += matrix[1][cc];
-	    else if(schar == 'G')
-		sum += matrix[2][cc];
-	    else if(schar == 'T')
-		sum += matrix[3][cc];
+	    case 'A':
+		(*codes)[i] = 0;
+		break;
+	    case 'C':
+		(*codes)[i] = 1;
+		break;
+	    case 'G':
+		(*codes)[i] = 2;
+		break;
+	    case 'T':
+		(*codes)[i] = 3;
+		break;
+	    default:
+		(*codes)[i] = 4;
+		break;
 	}
+    }
 
+    return;
+}
 
-	scorepc = (sum * (float)100.) / maxscore;
 
 
-	if(scorepc >= threshold)
-	{
-	    val = jaspscan_hitsnew();
-	    val->type = type;
-	    ajStrAssignS(&val->matname,mname);
-	    val->start = i + begin;
-	    val->end = val->start + cols - 1;
-	    val->score = sum;
-	    val->threshold = threshold;
-	    val->scorepc  = scorepc;
-	    val->maxscore = maxscore;
-
-	    ajListPushAppend(hits,(void *)val);
-	}
-    }
-    
 
-    if(both)
+/* @funcstatic jaspscan_scan *********************************************
+**
+** Scans a sequence with a matrix profile
+**
+** Window scores are summed over the columns in the same order as the
+** matrix is read, so they are unchanged by the early cut-off which
+** only drops windows that cannot reach the threshold.
+**
+** @param [r] codes [const ajuint*] sequence as jaspscan_encode codes
+** @param [r] slen [ajuint] sequence length
+** @param [r] begin [const ajuint] start position
+** @param [r] prof [const PJspprofile] matrix profile
+** @param [r] type [const char] Jaspar database type (C,F or P)
+** @param [r] threshold [const float] scoring threshold
+** @param [r] both [const AjBool] scan reverse strand too
+** @param [u] hits [AjPList] hit list
+**
+** @return [void]
+** @@
+******************************************************************************/
+
+static void jaspscan_scan(const ajuint *codes, ajuint slen,
+			  const ajuint begin, const PJspprofile prof,
+			  const char type, const float threshold,
+			  const AjBool both, AjPList hits)
+{
+    PJsphits val = NULL;
+    const float *matrix;
+    const float *bound;
+    ajuint cols;
+    ajuint strand;
+
+    ajuint i;
+    ajuint cc;
+    ajuint limit;
+
+    float sum  = 0.;
+    float scorepc  = 0.;
+    float maxscore = 0.;
+    double needed = 0.;
+
+    cols = prof->cols;
+    maxscore = prof->maxscore;
+
+    if(!cols || slen < cols)
+	return;
+
+    limit = (slen - cols) + 1;
+
+    /*
+    ** A window is abandoned when even the best scores for its remaining
+    ** columns cannot bring it up to the threshold. The margin keeps
+    ** float rounding from dropping a window at the boundary.
+    */
+
+    needed = ((double) threshold * (double) maxscore) / 100.0;
+    needed -= (double) maxscore * 1.0e-4 + 1.0e-3;
+
+    for(strand = 0; strand < 2; ++strand)
     {
-	jaspscan_CompMat(matrix, cols);
+	if(strand && !both)
+	    break;
 
-	p = ajStrGetPtr(seq);
+	if(strand)
+	{
+	    matrix = prof->rev;
+	    bound  = prof->revbound;
+	}
+	else
+	{
+	    matrix = prof->fwd;
+	    bound  = prof->fwdbound;
+	}
 
 	for(i=0; i < limit; ++i)
 	{
 	    sum = 0.;
-	    schar = p[i];
 	    for(cc = 0; cc < cols; ++cc)
 	    {
-		schar = p[i+cc];
-		if(schar == 'A')
-		    sum += matrix[0][cc];
-		else if(schar == 'C')
-		    sum += matrix[1][cc];
-		else if(schar == 'G')
-		    sum += matrix[2][cc];
-		else if(schar == 'T')
-		    sum += matrix[3][cc];
+		sum += matrix[5*cc + codes[i+cc]];
+
+		if(maxscore > 0. && (double) sum + bound[cc+1] < needed)
+		    break;
 	    }
 
+	    if(cc < cols)
+		continue;
 
 	    scorepc = (sum * (float)100.) / maxscore;
 
-
 	    if(scorepc >= threshold)
 	    {
 		val = jaspscan_hitsnew();
 		val->type = type;
-		ajStrAssignS(&val->matname,mname);
-		val->end = i + begin;
-		val->start = val->end + cols - 1;
+		ajStrAssignS(&val->matname,prof->matname);
+
+		if(strand)
+		{
+		    val->end = i + begin;
+		    val->start = val->end + cols - 1;
+		}
+		else
+		{
+		    val->start = i + begin;
+		    val->end = val->start + cols - 1;
+		}
+
 		val->score = sum;
 		val->threshold = threshold;
 		val->scorepc  = scorepc;
@@ -725,14 +910,6 @@ static void jaspscan_scan(const AjPStr seq, const ajuint begin,
 	    }
 	}
     }
-    
-
-    for(i = 0; i < 4; ++i)
-	AJFREE(matrix[i]);
-    AJFREE(matrix);
-
-
-    ajStrDel(&mname);
 
     return;
 }
@@ -45,7 +45,7 @@ int main(int argc, char **argv)
     AjPSeq seq2;
     AjPSeqout seqout;
     ajint wordlen;
-    AjPTable seq1MatchTable = NULL;
+    EmbPWordIndex seq1MatchIndex = NULL;
     AjPList matchlist = NULL;
     AjPFile outfile;
     AjBool prefer;
@@ -64,9 +64,9 @@ int main(int argc, char **argv)
     ajSeqTrim(seq2);
 
     embWordLength(wordlen);
-    if(embWordGetTable(&seq1MatchTable, seq1))
-	/* get table of words */
-	matchlist = embWordBuildMatchTable(seq1MatchTable, seq2, ajTrue);
+    if(embWordGetIndex(&seq1MatchIndex, seq1))
+	/* get index of words */
+	matchlist = embWordBuildMatchIndex(seq1MatchIndex, seq2, ajTrue);
     else
 	ajFatal("No match found\n");
 
@@ -83,7 +83,7 @@ int main(int argc, char **argv)
     }
 
     embWordMatchListDelete(&matchlist); /* free the match structures */
-    embWordFreeTable(&seq1MatchTable);
+    embWordFreeIndex(&seq1MatchIndex);
 
     ajSeqoutClose(seqout);
     ajFileClose(&outfile);
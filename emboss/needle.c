@@ -69,6 +69,11 @@ int main(int argc, char **argv)
 
     AjBool dobrief = ajTrue;
     AjBool endweight = ajFalse; /* should end gap penalties be applied */
+    AjBool linear = ajFalse;    /* path too big for full matrices */
+    AjBool band = ajFalse;      /* banded alignment from word matches */
+    ajint wordlen = 0;
+    ajint dlo = 0;
+    ajint dhi = 0;
 
     float id   = 0.;
     float sim  = 0.;
@@ -89,6 +94,8 @@ int main(int argc, char **argv)
     endgapextend = ajAcdGetFloat("endextend");
     dobrief   = ajAcdGetBoolean("brief");
     endweight   = ajAcdGetBoolean("endweight");
+    band      = ajAcdGetToggle("band");
+    wordlen   = ajAcdGetInt("wordlen");
 
     align     = ajAcdGetAlign("outfile");
 
@@ -114,46 +121,83 @@ int main(int argc, char **argv)
 	ajSeqTrim(b);
 	lenb = ajSeqGetLen(b);
 
-	if(lenb > (LONG_MAX/(size_t)(lena+1)))
-	   ajDie("Sequences too big. Try 'stretcher'");
+	linear = ajFalse;
 
-	len = (size_t)lena*(size_t)lenb;
-
-	if(len>maxarr)
+	if(band)
+	    ajDebug("needle: %d x %d aligned in a band\n", lena, lenb);
+	else if(lenb > (LONG_MAX/(size_t)(lena+1)))
+	    linear = ajTrue;
+	else
 	{
-	    AJCRESIZETRY0(compass,(size_t)maxarr,len);
-	    if(!compass)
-		ajDie("Sequences too big. Try 'stretcher'");
-	    AJCRESIZETRY0(m,(size_t)maxarr,len);
-	    if(!m)
-		ajDie("Sequences too big. Try 'stretcher'");
-	    AJCRESIZETRY0(ix,(size_t)maxarr,len);
-	    if(!ix)
-		ajDie("Sequences too big. Try 'stretcher'");
-	    AJCRESIZETRY0(iy,(size_t)maxarr,len);
-	    if(!iy)
-		ajDie("Sequences too big. Try 'stretcher'");
-	    maxarr=len;
+	    len = (size_t)lena*(size_t)lenb;
+
+	    if(len > EMBALNLINEARCELLS)
+		linear = ajTrue;
+	    else if(len>maxarr)
+	    {
+		AJCRESIZETRY0(compass,(size_t)maxarr,len);
+		AJCRESIZETRY0(m,(size_t)maxarr,len);
+		AJCRESIZETRY0(ix,(size_t)maxarr,len);
+		AJCRESIZETRY0(iy,(size_t)maxarr,len);
+
+		if(!compass || !m || !ix || !iy)
+		{
+		    /* keep going in linear space with small arrays */
+		    AJFREE(compass);
+		    AJFREE(m);
+		    AJFREE(ix);
+		    AJFREE(iy);
+		    maxarr = 1000;
+		    AJCNEW0(compass, maxarr);
+		    AJCNEW0(m, maxarr);
+		    AJCNEW0(ix, maxarr);
+		    AJCNEW0(iy, maxarr);
+		    linear = ajTrue;
+		}
+		else
+		    maxarr=len;
+	    }
 	}
 
-
 	p = ajSeqGetSeqC(a);
 	q = ajSeqGetSeqC(b);
 
 	ajStrAssignC(&alga,"");
 	ajStrAssignC(&algb,"");
 
-	score = embAlignPathCalcWithEndGapPenalties(p, q, lena, lenb,
-	        gapopen, gapextend, endgapopen, endgapextend,
-	        &start1, &start2, sub, cvt,
-	        m, ix, iy, compass, ajFalse, endweight);
-
-
+	if(band)
+	{
+	    if(!embAlignBandSeed(a, b, wordlen, &dlo, &dhi))
+	    {
+		dlo = 0;
+		dhi = 0;
+	    }
+
+	    score = embAlignPathCalcBanded(p, q, lena, lenb, dlo, dhi,
+	            gapopen, gapextend, endgapopen, endgapextend,
+	            sub, cvt, endweight, &alga, &algb,
+	            &start1, &start2);
+	}
+	else if(linear)
+	{
+	    ajDebug("needle: %d x %d aligned in linear space\n", lena, lenb);
+	    score = embAlignPathCalcLinear(p, q, lena, lenb,
+	            gapopen, gapextend, endgapopen, endgapextend,
+	            sub, cvt, endweight, &alga, &algb,
+	            &start1, &start2);
+	}
+	else
+	{
+	    score = embAlignPathCalcWithEndGapPenalties(p, q, lena, lenb,
+	            gapopen, gapextend, endgapopen, endgapextend,
+	            &start1, &start2, sub, cvt,
+	            m, ix, iy, compass, ajFalse, endweight);
+
+	    embAlignWalkNWMatrixUsingCompass(p, q, &alga, &algb,
+	            lena, lenb, &start1, &start2,
+	            compass);
+	}
 
-	embAlignWalkNWMatrixUsingCompass(p, q, &alga, &algb,
-	        lena, lenb, &start1, &start2,
-	        compass);
-		
 	embAlignReportGlobal(align, a, b, alga, algb,
 			     start1, start2,
 			     gapopen, gapextend,
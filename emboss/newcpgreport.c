@@ -30,30 +30,27 @@
 #include "emboss.h"
 #include <math.h>
 #include <stdlib.h>
+#include <ctype.h>
 
 
 
 
-static void newcpgreport_findbases(const AjPStr substr, ajint len,
-				   ajint window, ajint shift, float *obsexp,
-				   float *xypc, const AjPStr bases,
-				   float *obsexpmax, ajint *plotstart,
-				   ajint *plotend);
+static void newcpgreport_findbases(AjPSeqwin seqwin, ajint pos, ajint len,
+				   ajint window, ajint shift,
+				   const char *bases,
+				   float *obsexp, float *xypc);
 static void newcpgreport_countbases(const char *seq, const char *bases,
 				    ajint window,
 				    ajint *cx, ajint *cy, ajint *cxpy);
-static void newcpgreport_identify(AjPFile outf,
-				  const float *obsexp, const float *xypc,
-				  AjBool *thresh, ajint begin, ajint len,
-				  ajint shift,
+static void newcpgreport_identify(AjPFile outf, AjPSeqwin seqwin,
+				  float *obsexp, float *xypc,
+				  ajint len, ajint window, ajint shift,
 				  const char *bases, const char *name,
 				  ajint minlen, float minobsexp, float minpc,
 				  const char *seq);
-static void newcpgreport_reportislands(AjPFile outf, const AjBool *thresh,
-				       const char *bases, const char *name,
-				       float minobsexp, float minpc,
-				       ajint minlen, ajint begin,
-				       ajint len, const char *seq);
+static void newcpgreport_reportisland(AjPFile outf, ajint startpos,
+				      ajint endpos, ajint slen,
+				      const char *seq);
 static void newcpgreport_compisl(AjPFile outf, const char *p, ajint begin1,
 				 ajint end1);
 
@@ -70,9 +67,8 @@ int main(int argc, char **argv)
 {
     AjPSeqall seqall;
     AjPSeq seq    = NULL;
+    AjPSeqwin seqwin = NULL;
     AjPFile outf  = NULL;
-    AjPStr strand = NULL;
-    AjPStr substr = NULL;
     AjPStr bases  = NULL;
 
     ajint begin;
@@ -85,16 +81,9 @@ int main(int argc, char **argv)
 
     ajint window;
     ajint shift;
-    ajint plotstart;
-    ajint plotend;
 
     float  *xypc   = NULL;
     float  *obsexp = NULL;
-    AjBool *thresh = NULL;
-    float  obsexpmax;
-
-    ajint i;
-    ajint maxarr;
 
 
     embInit("newcpgreport",argc,argv);
@@ -107,49 +96,37 @@ int main(int argc, char **argv)
     minlen    = ajAcdGetInt("minlen");
     minpc     = ajAcdGetFloat("minpc");
 
-    substr = ajStrNew();
     bases  = ajStrNewC("CG");
-    maxarr = 0;
+
+    /*
+    ** Only the values averaged for the current position are kept,
+    ** in ring buffers covering 10 window shifts
+    */
+
+    AJCNEW0(obsexp, 10*shift+1);
+    AJCNEW0(xypc, 10*shift+1);
 
     while(ajSeqallNext(seqall, &seq))
     {
 	begin = ajSeqallGetseqBegin(seqall);
 	end   = ajSeqallGetseqEnd(seqall);
-	strand = ajSeqGetSeqCopyS(seq);
-	ajStrFmtUpper(&strand);
+	len   = end - begin + 1;
 
-	ajStrAssignSubC(&substr,ajStrGetPtr(strand),--begin,--end);
-	len=ajStrGetLen(substr);
+	seqwin = ajSeqwinNew(seq, begin, end, window, 0);
 
-	if(len > maxarr)
-	{
-	    AJCRESIZE(obsexp, len);
-	    AJCRESIZE(thresh, len);
-	    AJCRESIZE(xypc, len);
-	    maxarr = len;
-	}
-	for(i=0;i<len;++i)
-	    obsexp[i]=xypc[i]=0.0;
-
-
-	newcpgreport_findbases(substr, len, window, shift, obsexp,
-			       xypc, bases, &obsexpmax, &plotstart, &plotend);
-
-	newcpgreport_identify(outf, obsexp, xypc, thresh, 0, len, shift,
+	newcpgreport_identify(outf, seqwin, obsexp, xypc, len, window, shift,
 			      ajStrGetPtr(bases), ajSeqGetNameC(seq), minlen,
-			      minobsexp, minpc, ajStrGetPtr(strand));
+			      minobsexp, minpc, ajSeqGetSeqC(seq));
 
-	ajStrDel(&strand);
+	ajSeqwinDel(&seqwin);
     }
 
     ajStrDel(&bases);
 
     ajSeqDel(&seq);
-    ajStrDel(&substr);
     ajFileClose(&outf);
 
     AJFREE(obsexp);
-    AJFREE(thresh);
     AJFREE(xypc);
 
     ajSeqallDel(&seqall);
@@ -164,27 +141,26 @@ int main(int argc, char **argv)
 
 /* @funcstatic newcpgreport_findbases *****************************************
 **
-** Undocumented.
+** Calculates the observed/expected ratio and base percentage plotted at
+** one position. Only positions at the centre of a window that starts on
+** a shift boundary have values, all others are zero.
 **
-** @param [r] substr [const AjPStr] sequence
+** @param [u] seqwin [AjPSeqwin] Window scanner, moved forward as needed
+** @param [r] pos [ajint] position
 ** @param [r] len [ajint] length
 ** @param [r] window [ajint] window
 ** @param [r] shift [ajint] shift
+** @param [r] bases [const char*] bases to look for
 ** @param [w] obsexp [float*] observed/expected
 ** @param [w] xypc [float*] CG content
-** @param [r] bases [const AjPStr] bases to look for
-** @param [w] obsexpmax [float*] maximum obsexp
-** @param [w] plotstart [ajint*] start
-** @param [w] plotend [ajint*] end
 ** @@
 ******************************************************************************/
 
 
-static void newcpgreport_findbases(const AjPStr substr, ajint len,
-				   ajint window, ajint shift, float *obsexp,
-				   float *xypc, const AjPStr bases,
-				   float *obsexpmax, ajint *plotstart,
-				   ajint *plotend)
+static void newcpgreport_findbases(AjPSeqwin seqwin, ajint pos, ajint len,
+				   ajint window, ajint shift,
+				   const char *bases,
+				   float *obsexp, float *xypc)
 {
     ajint cxpy;
     ajint cx;
@@ -197,38 +173,33 @@ static void newcpgreport_findbases(const AjPStr substr, ajint len,
     float obs;
     float expect;
     ajint i;
-    ajint j = 0;
-    ajint offset;
 
     const char *p;
-    const char *q;
+
+    *obsexp = 0.0;
+    *xypc   = 0.0;
+
+    i = pos - window/2;
+
+    if(i < 0 || i%shift || i > len-window)
+	return;
+
+    while(i >= (ajint) (ajSeqwinGetStart(seqwin) + ajSeqwinGetCount(seqwin)))
+	if(!ajSeqwinNext(seqwin))
+	    return;
 
     windowf = (float)window;
-    *obsexpmax = 0.0;
-    offset     = window/2;
-    *plotstart   = offset;
-    q = ajStrGetPtr(bases);
 
-    for(i=0; i<(len-window+1);i+=shift)
-    {
-	j = i+offset;
-	p = ajStrGetPtr(substr) + i;
-	newcpgreport_countbases(p, q, window, &cx, &cy, &cxpy);
-	obs = (float) cxpy;
-	expect = (float)(cx*cy)/windowf;
-	cxf = (float)cx;
-	cyf = (float)cy;
-	if(!expect)
-	    obsexp[j] = 0.0;
-	else
-	{
-	    obsexp[j]  = obs/expect;
-	    *obsexpmax = (*obsexpmax > obsexp[j]) ? *obsexpmax : obsexp[j];
-	}
-	xypc[j] = (cxf/windowf)*(float)100.0 + (cyf/windowf)*(float)100.0;
-    }
+    p = ajSeqwinGetPtr(seqwin) + (i - ajSeqwinGetStart(seqwin));
+    newcpgreport_countbases(p, bases, window, &cx, &cy, &cxpy);
+    obs = (float) cxpy;
+    expect = (float)(cx*cy)/windowf;
+    cxf = (float)cx;
+    cyf = (float)cy;
+    if(expect)
+	*obsexp  = obs/expect;
+    *xypc = (cxf/windowf)*(float)100.0 + (cyf/windowf)*(float)100.0;
 
-    *plotend = j;
     return;
 }
 
@@ -296,28 +267,28 @@ static void newcpgreport_countbases(const char *seq, const char *bases,
 **    % composition is over 50% and the calculated Obs/Exp ratio is over 0.6
 **    and the conditions hold for a minimum of 200 bases.
 **
-** The results rae returned as true values in the thresh array.
+** Window values are calculated as the average moves along the sequence
+** and islands are reported as soon as they end.
 **
-** @param [u] outf [AjPFile] Undocumented
-** @param [r] obsexp [const float*] Array of observed/expected values
-** @param [r] xypc [const float*] Array of base percent values
-** @param [w] thresh [AjBool*] Array of threshold flags
-** @param [r] begin [ajint] Undocumented
-** @param [r] len [ajint] Undocumented
-** @param [r] shift [ajint] Undocumented
-** @param [r] bases [const char*] Undocumented
-** @param [r] name [const char*] Undocumented
-** @param [r] minlen [ajint] Undocumented
-** @param [r] minobsexp [float] Undocumented
-** @param [r] minpc [float] Undocumented
-** @param [r] seq [const char*] Undocumented
+** @param [u] outf [AjPFile] Output file
+** @param [u] seqwin [AjPSeqwin] Window scanner
+** @param [w] obsexp [float*] Ring buffer of observed/expected values
+** @param [w] xypc [float*] Ring buffer of base percent values
+** @param [r] len [ajint] Region length
+** @param [r] window [ajint] Window size
+** @param [r] shift [ajint] Window shift
+** @param [r] bases [const char*] Bases to look for
+** @param [r] name [const char*] Sequence name
+** @param [r] minlen [ajint] Minimum island length
+** @param [r] minobsexp [float] Minimum observed/expected ratio
+** @param [r] minpc [float] Minimum percentage
+** @param [r] seq [const char*] Sequence
 ** @@
 ******************************************************************************/
 
-static void newcpgreport_identify(AjPFile outf, const float *obsexp,
-				  const float *xypc,
-				  AjBool *thresh, ajint begin, ajint len,
-				  ajint shift,
+static void newcpgreport_identify(AjPFile outf, AjPSeqwin seqwin,
+				  float *obsexp, float *xypc,
+				  ajint len, ajint window, ajint shift,
 				  const char *bases, const char *name,
 				  ajint minlen, float minobsexp, float minpc,
 				  const char *seq)
@@ -330,27 +301,41 @@ static void newcpgreport_identify(AjPFile outf, const float *obsexp,
 
     ajint i;
     ajint pos;
+    ajint next;
+    ajint nring;
 
     ajint sumlen;
     ajint first;
+    ajint cnt = 0;
 
+    ajFmtPrintF(outf,"ID   %s  %d BP.\n",name, len);
+    ajFmtPrintF(outf,"XX\n");
+    ajFmtPrintF(outf,"DE   CpG Island report.\n");
+    ajFmtPrintF(outf,"XX\n");
+    ajFmtPrintF(outf,"CC   Obs/Exp ratio > %.2f.\n",minobsexp);
+    ajFmtPrintF(outf,"CC   %% %c + %% %c > %.2f.\n",bases[0],
+		bases[1],minpc);
+    ajFmtPrintF(outf,"CC   Length > %d.\n",minlen);
+    ajFmtPrintF(outf,"XX\n");
+    ajFmtPrintF(outf,"FH   Key              Location/Qualifiers\n");
 
-    for(i=0; i<len; ++i)
-	thresh[i] = ajFalse;
-
+    nring = avwindow*shift + 1;
+    next = 0;
     sumlen=0;
 
     for(pos=0,first=0;pos<(len-avwindow*shift);pos+=shift)
     {
+	for(;next<=(pos+avwindow*shift);++next)
+	    newcpgreport_findbases(seqwin, next, len, window, shift, bases,
+				   &obsexp[next%nring], &xypc[next%nring]);
+
 	sumpc = sumobsexp = 0.0;
 
 	ajDebug("pos: %d max: %d\n", pos, pos+avwindow*shift);
 	for(i=pos;i<=(pos+avwindow*shift);++i)
 	{
-	    ajDebug("obsexp[%d] %.2f xypc[%d] %.2f\n",
-		    i, obsexp[i], i, xypc[i]);
-	    sumpc += xypc[i];
-	    sumobsexp += obsexp[i];
+	    sumpc += xypc[i%nring];
+	    sumobsexp += obsexp[i%nring];
 	}
 
 	avpc = sumpc/(float)avwindow;
@@ -369,24 +354,28 @@ static void newcpgreport_identify(AjPFile outf, const float *obsexp,
 	{
 	    if(sumlen >= minlen)
 	    {				/* island long enough? */
-		for(i=first; i<=pos-shift;++i)
-		    thresh[i]=ajTrue;
+		newcpgreport_reportisland(outf, first, pos-shift+1,
+					  pos-shift+1-first, seq);
+		++cnt;
 	    }
 	    sumlen = 0;
 	}
     }
 
+    /* an island running to the end is reported as it always has been */
+
     if(sumlen>=minlen)
     {
-	for(i=first;i<len;++i)
-	    thresh[i] = ajTrue;
+	newcpgreport_reportisland(outf, first, len-1, len-first+1, seq);
+	++cnt;
     }
 
+    if(cnt < 1)
+	ajFmtPrintF(outf,"FT   no islands detected\n");
+    else
+	ajFmtPrintF(outf,"FT   numislands       %d\n",cnt);
 
-
-
-    newcpgreport_reportislands(outf, thresh, bases, name, minobsexp, minpc,
-			       minlen, begin, len, seq);
+    ajFmtPrintF(outf,"//\n");
 
     return;
 }
@@ -394,97 +383,27 @@ static void newcpgreport_identify(AjPFile outf, const float *obsexp,
 
 
 
-/* @funcstatic newcpgreport_reportislands *************************************
+/* @funcstatic newcpgreport_reportisland **************************************
 **
-** Undocumented.
+** Reports one CpG island
 **
-** @param [u] outf [AjPFile] Undocumented
-** @param [r] thresh [const AjBool*] Undocumented
-** @param [r] bases [const char*] Undocumented
-** @param [r] name [const char*] Undocumented
-** @param [r] minobsexp [float] Undocumented
-** @param [r] minpc [float] Undocumented
-** @param [r] minlen [ajint] Undocumented
-** @param [r] begin [ajint] Undocumented
-** @param [r] len [ajint] Undocumented
-** @param [r] seq [const char*] Undocumented
+** @param [u] outf [AjPFile] Output file
+** @param [r] startpos [ajint] Start offset in the region
+** @param [r] endpos [ajint] End position
+** @param [r] slen [ajint] Reported size
+** @param [r] seq [const char*] Sequence
 ** @@
 ******************************************************************************/
 
-
-static void newcpgreport_reportislands(AjPFile outf,const  AjBool *thresh,
-				       const char *bases, const char *name,
-				       float minobsexp, float minpc,
-				       ajint minlen, ajint begin,
-				       ajint len, const char *seq)
+static void newcpgreport_reportisland(AjPFile outf, ajint startpos,
+				      ajint endpos, ajint slen,
+				      const char *seq)
 {
-    AjBool island;
-    ajint startpos = 0;
-    ajint endpos;
-    ajint slen;
-    ajint i;
-    ajint cnt = 0;
-
-    ajFmtPrintF(outf,"ID   %s  %d BP.\n",name, len);
-    ajFmtPrintF(outf,"XX\n");
-    ajFmtPrintF(outf,"DE   CpG Island report.\n");
-    ajFmtPrintF(outf,"XX\n");
-    ajFmtPrintF(outf,"CC   Obs/Exp ratio > %.2f.\n",minobsexp);
-    ajFmtPrintF(outf,"CC   %% %c + %% %c > %.2f.\n",bases[0],
-		bases[1],minpc);
-    ajFmtPrintF(outf,"CC   Length > %d.\n",minlen);
-    ajFmtPrintF(outf,"XX\n");
-    ajFmtPrintF(outf,"FH   Key              Location/Qualifiers\n");
-
-
-    island = ajFalse;
-    for(i=0;i<len;++i)
-    {
-	if(island)
-	{
-	    island = thresh[i];
-	    if(!island)
-	    {
-	       slen = i - startpos;
-		endpos = i;
-		ajFmtPrintF(outf,"FT   CpG island       %d..%d\n",
-			    startpos+begin+1, endpos+begin);
-		ajFmtPrintF(outf,"FT                    /size=%d\n",
-			    slen);
-		newcpgreport_compisl(outf, seq, startpos+begin+1,
-				     endpos+begin);
-		++cnt;
-
-	    }
-	}
-	else
-	{
-	    island = thresh[i];
-	    if(island)
-		startpos=i;
-
-	}
-    }
-
-    if(island)
-    {
-        slen   = len-startpos+1;
-	endpos = len-1;
-       	ajFmtPrintF(outf,"FT   CpG island       %d..%d\n",
-			    startpos+begin+1, endpos+begin);
-        ajFmtPrintF(outf,"FT                    /size=%d\n",
-		    slen);
-	newcpgreport_compisl(outf, seq, startpos+begin+1, endpos+begin);
-	++cnt;
-    }
-
-    if(cnt < 1)
-	ajFmtPrintF(outf,"FT   no islands detected\n");
-    else
-	ajFmtPrintF(outf,"FT   numislands       %d\n",cnt);
-
-    ajFmtPrintF(outf,"//\n");
-
+    ajFmtPrintF(outf,"FT   CpG island       %d..%d\n",
+		startpos+1, endpos);
+    ajFmtPrintF(outf,"FT                    /size=%d\n",
+		slen);
+    newcpgreport_compisl(outf, seq, startpos+1, endpos);
 
     return;
 }
@@ -519,14 +438,14 @@ static void newcpgreport_compisl(AjPFile outf, const char *p, ajint begin1,
 
     for(i=begin1;i<end1;++i)
     {
-	if(p[i]=='C')
+	if(toupper((int)p[i])=='C')
 	{
 	    ++C;
-	    if(p[i+1]=='G')
+	    if(toupper((int)p[i+1])=='G')
 		++CG;
 	}
 
-	if(p[i]=='G')
+	if(toupper((int)p[i])=='G')
 	    ++G;
     }
 
@@ -18,11 +18,60 @@
 ** Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 ******************************************************************************/
 
+
 #include "emboss.h"
 
 
 
 
+/* @datastatic PPatmotif ******************************************************
+**
+** PROSITE motif compiled for scanning
+**
+** Motifs are read and their regular expressions compiled once, then
+** reused for every input sequence.
+**
+** @alias SPatmotif
+** @alias OPatmotif
+**
+** @attr Name [AjPStr] Motif name
+** @attr Accession [AjPStr] PROSITE accession number
+** @attr Regexp [AjPRegexp] Compiled regular expression
+** @attr Doc [AjPStr] Documentation text, read when first needed
+** @attr Need [ajuint[26]] Residues required by a match, counted by letter
+** @attr Nterm [AjBool] Pattern is anchored to the N-terminus
+** @attr Hasdoc [AjBool] Documentation file has been looked for
+** @@
+******************************************************************************/
+
+typedef struct SPatmotif
+{
+    AjPStr Name;
+    AjPStr Accession;
+    AjPRegexp Regexp;
+    AjPStr Doc;
+    ajuint Need[26];
+    AjBool Nterm;
+    AjBool Hasdoc;
+} OPatmotif;
+
+#define PPatmotif OPatmotif*
+
+
+
+
+static ajuint patmatmotifs_readmotifs(AjPFile inf, AjBool prune,
+                                      PPatmotif **motifs);
+static void   patmatmotifs_required(PPatmotif motif, const AjPStr regexp);
+static AjBool patmatmotifs_possible(const PPatmotif motif,
+                                    const ajuint *counts);
+static const AjPStr patmatmotifs_getdoc(PPatmotif motif,
+                                        const AjPStr docdata);
+static void   patmatmotifs_motifdel(PPatmotif *Pmotif);
+
+
+
+
 /* @prog patmatmotifs *********************************************************
 **
 ** Search a PROSITE motif database with a protein sequence
@@ -33,37 +82,33 @@ int main(int argc, char **argv)
 {
 
     AjPFile inf	 = NULL;
-    AjPFile inf2 = NULL;
     AjPFeattable tab = NULL;
     AjPReport report = NULL;
 
+    AjPSeqall seqall = NULL;
     AjPSeq sequence = NULL;
 
     AjPStr redatanew = NULL;
     AjPStr str	     = NULL;
-    AjPStr regexp    = NULL;
-    AjPStr temp	     = NULL;
-    AjPStr text      = NULL;
     AjPStr docdata   = NULL;
-    AjPStr data      = NULL;
-    AjPStr accession = NULL;
-    AjPStr name      = NULL;
     EmbPPatMatch match = NULL;
-    AjPStr savereg = NULL;
     AjPStr fthit   = NULL;
+    const AjPStr doc = NULL;
 
     AjBool full;
     AjBool prune;
 
+    PPatmotif *motifs = NULL;
+    ajuint nmotifs;
+    ajuint counts[26];
+    ajuint j;
+
     ajint i;
     ajint number;
     ajint start;
     ajint end;
     ajint length;
-    ajint zstart;
-    ajint zend;
     const char *p;
-    ajint seqlength;
     AjPStr tmpstr  = NULL;
     AjPStr tailstr = NULL;
     AjPFeature gf;
@@ -72,27 +117,13 @@ int main(int argc, char **argv)
 
     ajStrAssignC(&fthit, "SO:0001067");
 
-    savereg   = ajStrNew();
     str       = ajStrNew();
-    regexp    = ajStrNew();
-    temp      = ajStrNew();
-    data      = ajStrNew();
-    accession = ajStrNew();
-    text      = ajStrNew();
-    name      = ajStrNew();
 
-    sequence = ajAcdGetSeq("sequence");
+    seqall   = ajAcdGetSeqall("sequence");
     report   = ajAcdGetReport("outfile");
     full     = ajAcdGetBoolean("full");
     prune    = ajAcdGetBoolean("prune");
 
-    ajSeqFmtUpper(sequence);		/* prosite regexs are all upper case */
-    tab = ajFeattableNewSeq(sequence);
-    ajStrAssignC(&tailstr, "");
-
-    seqlength = ajStrGetLen(str);
-    str       = ajSeqGetSeqCopyS(sequence);
-
     redatanew = ajStrNewC("PROSITE/prosite.lines");
     docdata   = ajStrNewC("PROSITE/");
 
@@ -105,6 +136,128 @@ int main(int argc, char **argv)
     ajFmtPrintAppS(&tmpstr, "Data_file: %F\n", inf);
     ajReportSetHeaderS(report, tmpstr);
 
+    nmotifs = patmatmotifs_readmotifs(inf, prune, &motifs);
+    ajFileClose(&inf);
+
+    while(ajSeqallNext(seqall, &sequence))
+    {
+	ajSeqFmtUpper(sequence);	/* prosite regexs are all upper case */
+	tab = ajFeattableNewSeq(sequence);
+	ajStrAssignC(&tailstr, "");
+
+	ajStrAssignS(&str, ajSeqGetSeqS(sequence));
+
+	for(j=0;j<26;++j)
+	    counts[j] = 0;
+
+	for(p=ajStrGetPtr(str); *p; ++p)
+	    if(*p >= 'A' && *p <= 'Z')
+		++counts[*p - 'A'];
+
+	for(j=0;j<nmotifs;++j)
+	{
+	    if(!patmatmotifs_possible(motifs[j], counts))
+		continue;
+
+	    match = embPatMatchFindRegexp(motifs[j]->Regexp, motifs[j]->Nterm,
+					  str);
+	    number = embPatMatchGetNumber(match);
+
+	    for(i=0; i<number; i++)
+	    {
+		start = 1+embPatMatchGetStart(match, i);
+
+		end = 1+embPatMatchGetEnd(match, i);
+
+		length = embPatMatchGetLen(match, i);
+
+		gf = ajFeatNew(tab, NULL, fthit, start, end,
+			       (float) length, ' ', 0);
+
+		ajFmtPrintS(&tmpstr, "*motif %S", motifs[j]->Name);
+		ajFeatTagAddSS(gf, NULL, tmpstr);
+	    }
+
+
+	    if(full && number)
+	    {
+		doc = patmatmotifs_getdoc(motifs[j], docdata);
+
+		if(doc)
+		{
+		    /*
+		    ** Insert Prosite documentation from files made by
+		    ** prosextract.c
+		    */
+		    ajFmtPrintAppS(&tailstr, "Motif: %S\n", motifs[j]->Name);
+		    ajFmtPrintAppS(&tailstr, "Count: %d\n\n", number);
+		    ajStrAppendS(&tailstr, doc);
+		    ajFmtPrintAppS(&tailstr, "\n***************\n\n");
+		}
+	    }
+
+	    embPatMatchDel(&match);
+	}
+
+	ajReportSetTailS(report,tailstr);
+	ajReportWrite(report, tab, sequence);
+	ajFeattableDel(&tab);
+    }
+
+    ajReportDel(&report);
+
+    for(j=0;j<nmotifs;++j)
+	patmatmotifs_motifdel(&motifs[j]);
+    AJFREE(motifs);
+
+    ajStrDel(&str);
+    ajStrDel(&docdata);
+    ajStrDel(&redatanew);
+    ajSeqallDel(&seqall);
+    ajSeqDel(&sequence);
+    ajStrDel(&tailstr);
+    ajStrDel(&fthit);
+    ajStrDel(&tmpstr);
+
+    embExit();
+
+    return 0;
+}
+
+
+
+
+/* @funcstatic patmatmotifs_readmotifs ****************************************
+**
+** Read the motifs from a prosite.lines file made by prosextract and
+** compile their regular expressions
+**
+** @param [u] inf [AjPFile] prosite.lines file
+** @param [r] prune [AjBool] Ignore simple patterns
+** @param [w] motifs [PPatmotif**] Array of motifs in file order
+** @return [ajuint] Number of motifs
+** @@
+******************************************************************************/
+
+static ajuint patmatmotifs_readmotifs(AjPFile inf, AjBool prune,
+                                      PPatmotif **motifs)
+{
+    AjPList list = NULL;
+    AjPStr regexp = NULL;
+    AjPStr temp = NULL;
+    AjPStr name = NULL;
+    AjPStr accession = NULL;
+    PPatmotif motif = NULL;
+    const char *p;
+    ajuint i;
+    ajuint n;
+
+    list      = ajListNew();
+    regexp    = ajStrNew();
+    temp      = ajStrNew();
+    name      = ajStrNew();
+    accession = ajStrNew();
+
     while(ajReadlineTrim(inf, &regexp))
     {
 	p=ajStrGetPtr(regexp);
@@ -133,92 +286,202 @@ int main(int argc, char **argv)
 	    p = ajStrGetPtr(regexp);
 
 	    ajStrAssignC(&temp,p+1);
-	    ajStrAssignC(&savereg,p+1);
 
-	    match = embPatMatchFind(temp, str, ajFalse, ajFalse);
-	    number = embPatMatchGetNumber(match);
+	    AJNEW0(motif);
+	    motif->Name = ajStrNewS(name);
+	    motif->Accession = ajStrNewS(accession);
+	    motif->Regexp = ajRegComp(temp);
+	    motif->Nterm = (ajStrGetCharFirst(temp) == '^');
+	    patmatmotifs_required(motif, temp);
 
-	    for(i=0; i<number; i++)
-	    {
-		seqlength = ajStrGetLen(str);
+	    ajListPushAppend(list, motif);
+	}
+    }
 
-		start = 1+embPatMatchGetStart(match, i);
+    n = (ajuint) ajListToarray(list, (void***) motifs);
 
-		end = 1+embPatMatchGetEnd(match, i);
+    ajListFree(&list);
+    ajStrDel(&regexp);
+    ajStrDel(&temp);
+    ajStrDel(&name);
+    ajStrDel(&accession);
 
-		length = embPatMatchGetLen(match, i);
+    return n;
+}
 
-		gf = ajFeatNew(tab, NULL, fthit, start, end,
-			       (float) length, ' ', 0);
 
-		ajFmtPrintS(&tmpstr, "*motif %S", name);
-		ajFeatTagAddSS(gf, NULL, tmpstr);
 
-		if(start-5<0)
-		    zstart = 0;
-		else
-		    zstart = start-5;
 
-		if(end+5> seqlength)
-		    zend = end;
-		else
-		    zend = end+5;
+/* @funcstatic patmatmotifs_required ******************************************
+**
+** Count the residues a sequence must contain to match a motif, from the
+** single residues outside character classes in its regular expression.
+** Expressions using anything other than the syntax written by
+** embPatPrositeToRegExp require nothing, so they are always searched.
+**
+** @param [u] motif [PPatmotif] Motif
+** @param [r] regexp [const AjPStr] Regular expression
+** @return [void]
+** @@
+******************************************************************************/
 
+static void patmatmotifs_required(PPatmotif motif, const AjPStr regexp)
+{
+    const char *p;
+    ajuint need[26];
+    ajuint n;
+    ajuint i;
+    char c;
 
-		ajStrAssignSubS(&temp, str, zstart, zend);
-	    }
+    for(i=0;i<26;++i)
+	need[i] = 0;
 
+    p = ajStrGetPtr(regexp);
 
-	    if(full && number)
-	    {
-		ajStrAssignC(&redatanew,ajStrGetPtr(docdata));
-		ajStrAppendC(&redatanew,ajStrGetPtr(accession));
-		inf2 = ajDatafileNewInNameS(redatanew);
-		if(!inf2)
-		    continue;
+    while(*p)
+    {
+	c = *p++;
+
+	if(c == '^' || c == '$')
+	    continue;
 
-		/*
-		** Insert Prosite documentation from files made by
-		** prosextract.c
-		*/
-		ajFmtPrintAppS(&tailstr, "Motif: %S\n", name);
-		ajFmtPrintAppS(&tailstr, "Count: %d\n\n", number);
-		while(ajReadlineTrim(inf2, &text))
-		    ajFmtPrintAppS(&tailstr, "%S\n", text);
+	if(c == '[')
+	{
+	    while(*p && *p != ']')
+		++p;
 
-		ajFmtPrintAppS(&tailstr, "\n***************\n\n");
-		ajFileClose(&inf2);
+	    if(!*p)
+		return;
 
-	    }
-	    embPatMatchDel(&match);
+	    ++p;
+	    c = '.';
+	}
+	else if(c != '.' && (c < 'A' || c > 'Z'))
+	    return;
+
+	n = 1;
+
+	if(*p == '{')
+	{
+	    ++p;
+
+	    if(!isdigit((int)*p))
+		return;
+
+	    n = 0;
+	    while(isdigit((int)*p))
+		n = n*10 + (ajuint) (*p++ - '0');
+
+	    while(*p && *p != '}')
+		++p;
+
+	    if(!*p)
+		return;
+
+	    ++p;
 	}
+
+	if(c != '.')
+	    need[c - 'A'] += n;
     }
 
-    ajReportSetTailS(report,tailstr);
-    ajReportWrite(report, tab, sequence);
+    for(i=0;i<26;++i)
+	motif->Need[i] = need[i];
 
-    ajReportDel(&report);
-    ajFeattableDel(&tab);
+    return;
+}
 
-    ajStrDel(&temp);
-    ajStrDel(&regexp);
-    ajStrDel(&savereg);
-    ajStrDel(&str);
-    ajStrDel(&data);
-    ajStrDel(&docdata);
+
+
+
+/* @funcstatic patmatmotifs_possible ******************************************
+**
+** Test whether a sequence has the residues a motif needs to match
+**
+** @param [r] motif [const PPatmotif] Motif
+** @param [r] counts [const ajuint*] Residue counts of the sequence
+** @return [AjBool] True if the motif could match
+** @@
+******************************************************************************/
+
+static AjBool patmatmotifs_possible(const PPatmotif motif,
+                                    const ajuint *counts)
+{
+    ajuint i;
+
+    for(i=0;i<26;++i)
+	if(counts[i] < motif->Need[i])
+	    return ajFalse;
+
+    return ajTrue;
+}
+
+
+
+
+/* @funcstatic patmatmotifs_getdoc ********************************************
+**
+** Return the documentation of a motif, reading the file made by
+** prosextract the first time it is needed
+**
+** @param [u] motif [PPatmotif] Motif
+** @param [r] docdata [const AjPStr] Documentation data directory
+** @return [const AjPStr] Documentation text or NULL if there is none
+** @@
+******************************************************************************/
+
+static const AjPStr patmatmotifs_getdoc(PPatmotif motif,
+                                        const AjPStr docdata)
+{
+    AjPFile inf2 = NULL;
+    AjPStr fname = NULL;
+    AjPStr text  = NULL;
+
+    if(motif->Hasdoc)
+	return motif->Doc;
+
+    motif->Hasdoc = ajTrue;
+
+    ajStrAssignS(&fname, docdata);
+    ajStrAppendS(&fname, motif->Accession);
+    inf2 = ajDatafileNewInNameS(fname);
+    ajStrDel(&fname);
+
+    if(!inf2)
+	return NULL;
+
+    motif->Doc = ajStrNew();
+
+    while(ajReadlineTrim(inf2, &text))
+	ajFmtPrintAppS(&motif->Doc, "%S\n", text);
+
+    ajFileClose(&inf2);
     ajStrDel(&text);
-    ajStrDel(&redatanew);
-    ajStrDel(&accession);
-    ajSeqDel(&sequence);
-    ajStrDel(&tailstr);
-    ajStrDel(&fthit);
-    ajStrDel(&name);
-    ajStrDel(&tmpstr);
 
-    ajFeattableDel(&tab);
-    ajFileClose(&inf);
+    return motif->Doc;
+}
 
-    embExit();
 
-    return 0;
+
+
+/* @funcstatic patmatmotifs_motifdel ******************************************
+**
+** Delete a motif
+**
+** @param [d] Pmotif [PPatmotif*] Motif
+** @return [void]
+** @@
+******************************************************************************/
+
+static void patmatmotifs_motifdel(PPatmotif *Pmotif)
+{
+    PPatmotif motif = *Pmotif;
+
+    ajStrDel(&motif->Name);
+    ajStrDel(&motif->Accession);
+    ajRegFree(&motif->Regexp);
+    ajStrDel(&motif->Doc);
+    AJFREE(*Pmotif);
+
+    return;
 }
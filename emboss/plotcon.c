@@ -72,6 +72,25 @@ typedef struct SPoint
 } OPoint;
 #define PPoint OPoint*
 
+#define PLOTCON_EXACT 16777216	/* largest float holding every integer */
+
+
+
+
+static AjBool plotcon_profileIsExact(const AjPSeqset seqset,
+                                     ajint* const * matrix,
+                                     ajint matsize, ajuint numseq);
+static void plotcon_pairScore(const AjPSeqset seqset,
+                              const char* const * seqcharptr,
+                              ajuint numseq, ajuint lenseq, ajuint winsize,
+                              ajint* const * matrix, const AjPSeqCvt cvt,
+                              float* sumscore);
+static void plotcon_profileScore(const char* const * seqcharptr,
+                                 ajuint numseq, ajuint lenseq,
+                                 ajuint winsize,
+                                 ajint* const * matrix, ajint matsize,
+                                 const AjPSeqCvt cvt, float* sumscore);
+
 
 
 
@@ -88,8 +107,6 @@ int main(int argc, char **argv)
     ajuint i;
     ajuint numseq;
     ajuint lenseq;
-    ajuint j = 0;
-    ajuint k;
     AjPMatrix cmpmatrix = 0;
     AjPSeqCvt cvt = 0;
     AjOTime ajtime;
@@ -99,22 +116,13 @@ int main(int argc, char **argv)
 
     float *x;
     float *y;
-    AjPFloat2d score = NULL;
     float *sumscore  = 0;
     float ymin;
     float ymax;
-    float contri = 0;
-    float contrj = 0;
     ajint **matrix;
-    ajint m1 = 0;
-    ajint m2 = 0;
     ajuint winsize;	/* window size */
     ajint numbins;	/* total no. of bins making up the seq length */
-    ajint binup;
-    ajint binlo;
-    ajint binmid;
     ajint bin;
-    ajint bin2;
     AjPGraph graphs = NULL;
     AjPGraphdata gdata;
     AjPList list = NULL;
@@ -150,31 +158,172 @@ int main(int argc, char **argv)
     /****************** Memory allocation *****************/
 
     AJCNEW(seqcharptr, numseq);		/* sequence string */
-    score = ajFloat2dNew();
 
     numbins = lenseq;
     AJCNEW(sumscore,numbins);		/* sum of scores for each column */
     AJCNEW(x,numbins);			/* x data                        */
     AJCNEW(y,numbins);			/* y data                        */
 
-    bin2 = (ajint)((float)winsize/2.);
-
-    for(i=0;i<numseq;i++)
-    {
-	ajSeqsetFmtUpper(seqset);
+    ajSeqsetFmtUpper(seqset);
 
-	/* get sequence as a string */
+    for(i=0;i<numseq;i++)		/* get sequence as a string */
 	seqcharptr[i] =  ajSeqsetGetseqSeqC(seqset, i);
 
-	for(j=0;j<lenseq;j++)
-	    ajFloat2dPut(&score,i,j,0.);
-    }
-
     for(bin=0; bin<numbins; bin++)
 	sumscore[bin] = 0.;
 
 
     /************** Loop over the sequence set length **************/
+    if(plotcon_profileIsExact(seqset, matrix, ajMatrixGetSize(cmpmatrix),
+			      numseq))
+	plotcon_profileScore(seqcharptr, numseq, lenseq, winsize,
+			     matrix, ajMatrixGetSize(cmpmatrix), cvt,
+			     sumscore);
+    else
+	plotcon_pairScore(seqset, seqcharptr, numseq, lenseq, winsize,
+			  matrix, cvt, sumscore);
+
+    /*************** End of Loop ***************/
+
+    ajGraphicsSetCharscale(0.50);
+    gdata = ajGraphdataNewI(lenseq);
+
+
+    for(bin=0;bin<numbins;bin++)
+	sumscore[bin] = sumscore[bin]/((float)(numseq*(numseq-1)*winsize*
+					       winsize));
+
+    /* plot out results */
+
+    for(bin=0;bin<numbins;bin++)
+    {
+	gdata->x[bin] = (float)(bin+1);
+	gdata->y[bin] = sumscore[bin];
+    }
+
+
+    ajGraphicsCalcRange(gdata->y,(ajint)flen,&ymin,&ymax);
+    ajGraphdataSetTruescale(gdata,0,flen,ymin,ymax);
+    
+    ajGraphdataSetTypeC(gdata,"2D Plot");
+    ajGraphDataAdd(graphs,gdata);
+    ajGraphxyShowYtick(graphs, ajTrue);
+    ajGraphSetTitleC(graphs,"Similarity Plot of Aligned Sequences");
+    ajGraphSetYlabelC(graphs,"Similarity");
+    
+    ajGraphxyDisplay(graphs,ajTrue);
+    
+    ajGraphicsClose();
+    ajGraphxyDel(&graphs);
+
+    AJFREE(x);
+    AJFREE(y);
+    AJFREE(sumscore);
+    freeptr = (void *) seqcharptr;
+    AJFREE(freeptr);
+    ajListFree(&list);
+
+    ajSeqsetDel(&seqset);
+    ajMatrixDel(&cmpmatrix);
+
+    embExit ();
+
+    return 0;
+}
+
+
+
+
+/* @funcstatic plotcon_profileIsExact *****************************************
+**
+** Tests whether the window scores can be computed from the residue counts
+** of each column with exactly the same result as summing over every pair
+** of sequences. This holds when all sequence weights are 1.0 and each
+** sequence score is a whole number small enough to be held exactly in
+** a float.
+**
+** @param [r] seqset [const AjPSeqset] Sequence alignment
+** @param [r] matrix [ajint* const *] Comparison matrix
+** @param [r] matsize [ajint] Comparison matrix size
+** @param [r] numseq [ajuint] Number of sequences
+** @return [AjBool] True if column profiles give identical results
+******************************************************************************/
+
+static AjBool plotcon_profileIsExact(const AjPSeqset seqset,
+                                     ajint* const * matrix,
+                                     ajint matsize, ajuint numseq)
+{
+    ajuint i;
+    ajint m1;
+    ajint m2;
+    ajint maxscore = 1;
+
+    for(i=0;i<numseq;i++)
+	if(ajSeqsetGetseqWeight(seqset, i) != 1.0)
+	    return ajFalse;
+
+    for(m1=1;m1<matsize;m1++)
+	for(m2=1;m2<matsize;m2++)
+	{
+	    if(matrix[m1][m2] > maxscore)
+		maxscore = matrix[m1][m2];
+	    else if(-matrix[m1][m2] > maxscore)
+		maxscore = -matrix[m1][m2];
+	}
+
+    if((double) maxscore * (double) numseq >= (double) PLOTCON_EXACT)
+	return ajFalse;
+
+    return ajTrue;
+}
+
+
+
+
+/* @funcstatic plotcon_pairScore **********************************************
+**
+** Sums the scores of each window by comparing every pair of sequences in
+** every column. Used for weighted alignments.
+**
+** @param [r] seqset [const AjPSeqset] Sequence alignment
+** @param [r] seqcharptr [const char* const *] Sequences as C strings
+** @param [r] numseq [ajuint] Number of sequences
+** @param [r] lenseq [ajuint] Alignment length
+** @param [r] winsize [ajuint] Window size
+** @param [r] matrix [ajint* const *] Comparison matrix
+** @param [r] cvt [const AjPSeqCvt] Comparison matrix conversion table
+** @param [u] sumscore [float*] Score for each window middle position
+** @return [void]
+******************************************************************************/
+
+static void plotcon_pairScore(const AjPSeqset seqset,
+                              const char* const * seqcharptr,
+                              ajuint numseq, ajuint lenseq, ajuint winsize,
+                              ajint* const * matrix, const AjPSeqCvt cvt,
+                              float* sumscore)
+{
+    ajuint i;
+    ajuint j;
+    ajuint k;
+    AjPFloat2d score = NULL;
+    float contri = 0;
+    float contrj = 0;
+    ajint m1 = 0;
+    ajint m2 = 0;
+    ajint binup;
+    ajint binlo;
+    ajint binmid;
+    ajint bin;
+    ajint bin2;
+
+    score = ajFloat2dNew();
+
+    bin2 = (ajint)((float)winsize/2.);
+
+    for(i=0;i<numseq;i++)
+	for(j=0;j<lenseq;j++)
+	    ajFloat2dPut(&score,i,j,0.);
+
     for(k=0; k< lenseq; k++)
     {
 	/* Generate a score for each column */
@@ -188,9 +337,11 @@ int main(int argc, char **argv)
 		m2 = ajSeqcvtGetCodeK(cvt, seqcharptr[j][k]);
 		if(m1 && m2)
 		{
-		    contrj = (float)matrix[m1][m2]*ajSeqsetGetseqWeight(seqset, j)+
+		    contrj = (float)matrix[m1][m2]*
+			ajSeqsetGetseqWeight(seqset, j)+
 			ajFloat2dGet(score,i,k);
-		    contri = (float)matrix[m1][m2]*ajSeqsetGetseqWeight(seqset, i)+
+		    contri = (float)matrix[m1][m2]*
+			ajSeqsetGetseqWeight(seqset, i)+
 			ajFloat2dGet(score,j,k);
 
 		    ajFloat2dPut(&score,i,k,contrj);
@@ -213,51 +364,138 @@ int main(int argc, char **argv)
 	}
     }
 
-    /*************** End of Loop ***************/
+    ajFloat2dDel(&score);
 
-    ajGraphicsSetCharscale(0.50);
-    gdata = ajGraphdataNewI(lenseq);
+    return;
+}
 
 
-    for(bin=0;bin<numbins;bin++)
-	sumscore[bin] = sumscore[bin]/((float)(numseq*(numseq-1)*winsize*
-					       winsize));
 
-    /* plot out results */
 
-    for(bin=0;bin<numbins;bin++)
+/* @funcstatic plotcon_profileScore *******************************************
+**
+** Sums the scores of each window from the residue counts of each column.
+** A sequence scores the same as every other sequence with the same
+** residue, so each column needs one score per residue code, and the
+** window total is kept as a running sum over the last winsize columns.
+**
+** Windows whose total could lose precision in float are summed sequence
+** by sequence in the same order as plotcon_pairScore.
+**
+** @param [r] seqcharptr [const char* const *] Sequences as C strings
+** @param [r] numseq [ajuint] Number of sequences
+** @param [r] lenseq [ajuint] Alignment length
+** @param [r] winsize [ajuint] Window size
+** @param [r] matrix [ajint* const *] Comparison matrix
+** @param [r] matsize [ajint] Comparison matrix size
+** @param [r] cvt [const AjPSeqCvt] Comparison matrix conversion table
+** @param [u] sumscore [float*] Score for each window middle position
+** @return [void]
+******************************************************************************/
+
+static void plotcon_profileScore(const char* const * seqcharptr,
+                                 ajuint numseq, ajuint lenseq,
+                                 ajuint winsize,
+                                 ajint* const * matrix, ajint matsize,
+                                 const AjPSeqCvt cvt, float* sumscore)
+{
+    ajuint i;
+    ajuint k;
+    ajuint ring;
+    ajuint col;
+    ajint m1;
+    ajint m2;
+    ajint binup;
+    ajint binlo;
+    ajint binmid;
+    ajint bin;
+    ajint bin2;
+    ajint *count;
+    ajint **colscore;		/* score of each code in recent columns */
+    ajlong *colsum;		/* total score of recent columns */
+    ajlong *colabs;		/* total absolute score of recent columns */
+    ajlong winsum = 0;
+    ajlong winabs = 0;
+
+    bin2 = (ajint)((float)winsize/2.);
+
+    ring = winsize ? winsize : 1;
+    AJCNEW0(count, matsize);
+    AJCNEW0(colscore, ring);
+    AJCNEW0(colsum, ring);
+    AJCNEW0(colabs, ring);
+
+    for(k=0;k<ring;k++)
+	AJCNEW0(colscore[k], matsize);
+
+    for(k=0; k< lenseq; k++)
     {
-	gdata->x[bin] = (float)(bin+1);
-	gdata->y[bin] = sumscore[bin];
-    }
+	col = k % ring;
 
+	if(k >= ring)
+	{
+	    winsum -= colsum[col];
+	    winabs -= colabs[col];
+	}
 
-    ajGraphicsCalcRange(gdata->y,(ajint)flen,&ymin,&ymax);
-    ajGraphdataSetTruescale(gdata,0,flen,ymin,ymax);
-    
-    ajGraphdataSetTypeC(gdata,"2D Plot");
-    ajGraphDataAdd(graphs,gdata);
-    ajGraphxyShowYtick(graphs, ajTrue);
-    ajGraphSetTitleC(graphs,"Similarity Plot of Aligned Sequences");
-    ajGraphSetYlabelC(graphs,"Similarity");
-    
-    ajGraphxyDisplay(graphs,ajTrue);
-    
-    ajGraphicsClose();
-    ajGraphxyDel(&graphs);
+	/* Count the residues in each column */
+	for(m1=0;m1<matsize;m1++)
+	    count[m1] = 0;
 
-    AJFREE(x);
-    AJFREE(y);
-    AJFREE(sumscore);
-    freeptr = (void *) seqcharptr;
-    AJFREE(freeptr);
-    ajListFree(&list);
-    ajFloat2dDel(&score);
+	for(i=0;i<numseq;i++)
+	    count[ajSeqcvtGetCodeK(cvt, seqcharptr[i][k])]++;
 
-    ajSeqsetDel(&seqset);
-    ajMatrixDel(&cmpmatrix);
+	/* Generate a score for each residue, excluding itself */
+	colsum[col] = 0;
+	colabs[col] = 0;
 
-    embExit ();
+	for(m1=0;m1<matsize;m1++)
+	{
+	    colscore[col][m1] = 0;
 
-    return 0;
+	    if(!m1 || !count[m1])
+		continue;
+
+	    for(m2=1;m2<matsize;m2++)
+		if(count[m2])
+		    colscore[col][m1] += matrix[m1][m2]*count[m2];
+
+	    colscore[col][m1] -= matrix[m1][m1];
+
+	    colsum[col] += (ajlong) count[m1] * colscore[col][m1];
+	    if(colscore[col][m1] < 0)
+		colabs[col] -= (ajlong) count[m1] * colscore[col][m1];
+	    else
+		colabs[col] += (ajlong) count[m1] * colscore[col][m1];
+	}
+
+	winsum += colsum[col];
+	winabs += colabs[col];
+
+	/* calculate score for the entire window */
+	if(k >= (winsize-1))
+	{
+	    binup = k+1;
+	    binlo = k - winsize + 1;
+	    binmid = binlo+bin2;
+
+	    if(winabs < PLOTCON_EXACT)
+		sumscore[binmid] = (float) winsum;
+	    else
+		for(i=0;i<numseq;i++)
+		    for(bin=binlo;bin<binup;bin++)
+			sumscore[binmid] += (float) colscore[bin % ring]
+			    [ajSeqcvtGetCodeK(cvt, seqcharptr[i][bin])];
+	}
+    }
+
+    for(k=0;k<ring;k++)
+	AJFREE(colscore[k]);
+
+    AJFREE(count);
+    AJFREE(colscore);
+    AJFREE(colsum);
+    AJFREE(colabs);
+
+    return;
 }
@@ -50,7 +50,7 @@ int main(int argc, char **argv)
     const AjPSeq seq1;
     const AjPSeq seq2;
     ajint wordlen;
-    AjPTable seq1MatchTable = NULL;
+    EmbPWordIndex seq1MatchIndex = NULL;
     AjPList matchlist ;
     AjPGraph graph = 0;
     ajuint i;
@@ -134,7 +134,7 @@ int main(int argc, char **argv)
 	tui = ajSeqGetLen(seq1);
 	flen1 = (float) tui;
 
-	if(embWordGetTable(&seq1MatchTable, seq1)){ /* get table of words */
+	if(embWordGetIndex(&seq1MatchIndex, seq1)){ /* get index of words */
 	    for(j=0;j<ajSeqsetGetSize(seqset);j++)
 	    {
 		seq2 = ajSeqsetGetseqSeq(seqset, j);
@@ -146,7 +146,7 @@ int main(int argc, char **argv)
                                           xstart+flen1,
                                           ystart+flen2);
 
-		matchlist = embWordBuildMatchTable(seq1MatchTable, seq2,
+		matchlist = embWordBuildMatchIndex(seq1MatchIndex, seq2,
 						   ajTrue);
 		if(matchlist)
 		    polydot_plotMatches(matchlist);
@@ -198,8 +198,8 @@ int main(int argc, char **argv)
 		ystart += flen2+(float)gap;
 	    }
 	}
-	embWordFreeTable(&seq1MatchTable);
-	seq1MatchTable = NULL;
+	embWordFreeIndex(&seq1MatchIndex);
+	seq1MatchIndex = NULL;
 	xstart += flen1+(float)gap;
 	ystart = 0.0;
     }
@@ -53,8 +53,13 @@
 ** @attr re [AjPStr] Undocumented
 ** @attr skipm [ajuint**] Undocumented
 ** @attr tidy [const void*] Undocumented
+** @attr hitpos [ajuint*[2]] match positions on the sequence and on its
+**                           reverse complement, in embPatFuzzSearch order
+** @attr hitmm [ajuint*[2]] mismatches of each match
 ** @attr solimit [ajuint] Undocumented
-** @attr Padding [char[4]] Padding to alignment boundary
+** @attr seedpat [ajuint] pattern number in the primer seed set
+** @attr nhits [ajuint[2]] number of matches on each strand
+** @attr maxhits [ajuint[2]] allocated size of the match arrays
 ******************************************************************************/
 
 typedef struct primerguts
@@ -76,8 +81,12 @@ typedef struct primerguts
     AjPStr re;
     ajuint** skipm;
     const void* tidy;
+    ajuint* hitpos[2];
+    ajuint* hitmm[2];
     ajuint solimit;
-    char Padding[4];
+    ajuint seedpat;
+    ajuint nhits[2];
+    ajuint maxhits[2];
 } *PGuts;
 
 
@@ -155,13 +164,16 @@ static void primersearch_clean_hitlist(AjPList* hlist);
 static void primersearch_read_primers(AjPList* primerList, AjPFile primerFile,
 				 ajint mmp);
 static AjBool primersearch_classify_and_compile(Primer* primdata);
+static EmbPPatSeedSet primersearch_seed_primers(const AjPList primerList);
 static void primersearch_primer_search(const AjPList primerList,
+				       EmbPPatSeedSet seeds,
 				       const AjPSeq seq);
-static void primersearch_scan_seq(const Primer primdata,
-			     const AjPSeq seq, AjBool reverse);
-static void primersearch_store_hits(const Primer primdata, AjPList fhits_list,
-			       AjPList rhits_list, const AjPSeq seq,
-			       AjBool reverse);
+static void primersearch_find_hits(PGuts guts, const EmbPPatSeedSet seeds,
+				   const AjPSeq seq, const AjPStr text,
+				   ajuint strand);
+static void primersearch_store_hits(const Primer primdata,
+				    const PGuts fguts, const PGuts rguts,
+				    const AjPSeq seq, AjBool reverse);
 static void primersearch_print_hits(const AjPList primerList, AjPFile outf);
 
 
@@ -180,6 +192,7 @@ int main(int argc, char **argv)
     AjPFile primerFile;		  /* read the primer pairs from a file */
     AjPFile outf;
     AjPList primerList;
+    EmbPPatSeedSet seeds = NULL;
 
     ajint mmp = 0;
 
@@ -205,9 +218,14 @@ int main(int argc, char **argv)
 
     }
 
+    /* index the primers so each sequence strand is scanned only once */
+    seeds = primersearch_seed_primers(primerList);
+
     /* query sequences one by one */
     while(ajSeqallNext(seqall,&seq))
-	primersearch_primer_search(primerList, seq);
+	primersearch_primer_search(primerList, seeds, seq);
+
+    embPatSeedSetDel(&seeds);
 
     /* output the results */
     primersearch_print_hits(primerList, outf);
@@ -247,6 +265,7 @@ int main(int argc, char **argv)
 
 static void primersearch_initialise_pguts(PGuts* primer)
 {
+    ajuint i;
 
     AJNEW(*primer);
     (*primer)->patstr  = NULL;
@@ -266,6 +285,16 @@ static void primersearch_initialise_pguts(PGuts* primer)
     (*primer)->re = NULL;
     (*primer)->skipm = NULL;
 
+    (*primer)->seedpat = 0;
+
+    for(i=0;i<2;++i)
+    {
+	(*primer)->hitpos[i] = NULL;
+	(*primer)->hitmm[i] = NULL;
+	(*primer)->nhits[i] = 0;
+	(*primer)->maxhits[i] = 0;
+    }
+
     return;
 }
 
@@ -303,6 +332,13 @@ static void primersearch_free_pguts(PGuts* primer)
 
     if((*primer)->type==6)
 	for(i=0;i<(*primer)->real_len;++i) AJFREE((*primer)->skipm[i]);
+
+    for(i=0;i<2;++i)
+    {
+	AJFREE((*primer)->hitpos[i]);
+	AJFREE((*primer)->hitmm[i]);
+    }
+
     AJFREE(*primer);
 
     return;
@@ -538,171 +574,245 @@ static AjBool primersearch_classify_and_compile(Primer* primdata)
 
 
 
-/* @funcstatic primersearch_primer_search *************************************
+/* @funcstatic primersearch_seed_primers **************************************
 **
-** tests the primers in primdata against seq and writes results to outfile
+** builds a k-mer seed index of the primers that are plain base strings,
+** so that they can all be found in one scan of each sequence strand.
+** Primers of other pattern types are left out and are searched for one
+** at a time with embPatFuzzSearch.
 **
 ** @param [r] primerList [const AjPList] primer list
-** @param [r] seq [const AjPSeq] sequence
+** @return [EmbPPatSeedSet] primer seed set
 ** @@
 ******************************************************************************/
 
-static void primersearch_primer_search(const AjPList primerList,
-				       const AjPSeq seq)
+static EmbPPatSeedSet primersearch_seed_primers(const AjPList primerList)
 {
+    EmbPPatSeedSet seeds;
     AjIList listIter;
+    const AjPStr* patterns;
+    ajuint* mismatch;
+    PGuts guts[2];
+    ajuint npat;
+    ajuint i;
+    ajuint j = 0;
+
+    npat = 2 * (ajuint) ajListGetLength(primerList);
+    AJCNEW0(patterns, npat);
+    AJCNEW0(mismatch, npat);
 
-    /* test each list node against this sequence */
     listIter = ajListIterNewread(primerList);
     while(!ajListIterDone(listIter))
     {
 	Primer curr_primer = ajListIterGet(listIter);
 
-	primersearch_scan_seq(curr_primer, seq, AJFALSE);
-	primersearch_scan_seq(curr_primer, seq, AJTRUE);
+	guts[0] = curr_primer->forward;
+	guts[1] = curr_primer->reverse;
+
+	for(i=0;i<2;++i,++j)
+	{
+	    guts[i]->seedpat = j;
+	    mismatch[j] = guts[i]->mm;
+
+	    /* exact, shift-or and Baeza-Yates-Perleberg types only */
+	    if(guts[i]->type >= 1 && guts[i]->type <= 3 &&
+	       !guts[i]->amino && !guts[i]->carboxyl)
+		patterns[j] = guts[i]->patstr;
+	}
     }
 
     ajListIterDel(&listIter);
 
-    return;
+    seeds = embPatSeedSetNew(patterns, mismatch, npat);
+
+    AJFREE(patterns);
+    AJFREE(mismatch);
+
+    return seeds;
 }
 
 
 
 
-/* @funcstatic primersearch_scan_seq ******************************************
+/* @funcstatic primersearch_primer_search *************************************
 **
-** scans the primer pairs against the sequence in either forward
-** sense or reverse complemented
-** works out amplimer length if the two primers both hit
+** tests the primers in primdata against seq and writes results to outfile
 **
-** @param [r] primdata [const Primer] primer data
+** Both strands of the sequence are scanned once for all seeded primers;
+** each primer pair is then tested with the forward primer on the forward
+** strand, and with the reverse primer on the forward strand
+**
+** @param [r] primerList [const AjPList] primer list
+** @param [u] seeds [EmbPPatSeedSet] primer seed set
 ** @param [r] seq [const AjPSeq] sequence
-** @param [r] reverse [AjBool] do reverse
 ** @@
 ******************************************************************************/
 
-static void primersearch_scan_seq(const Primer primdata,
-			     const AjPSeq seq, AjBool reverse)
+static void primersearch_primer_search(const AjPList primerList,
+				       EmbPPatSeedSet seeds,
+				       const AjPSeq seq)
 {
+    AjIList listIter;
     AjPStr seqstr = NULL;
     AjPStr revstr = NULL;
-    AjPStr seqname = NULL;
-    ajuint fhits = 0;
-    ajuint rhits = 0;
-    AjPList fhits_list = NULL;
-    AjPList rhits_list = NULL;
 
-    /* initialise variables for search */
-    ajStrAssignC(&seqname,ajSeqGetNameC(seq));
     ajStrAssignS(&seqstr, ajSeqGetSeqS(seq));
     ajStrAssignS(&revstr, ajSeqGetSeqS(seq));
     ajStrFmtUpper(&seqstr);
     ajStrFmtUpper(&revstr);
     ajSeqstrReverse(&revstr);
-    fhits_list = ajListNew();
-    rhits_list = ajListNew();
 
-    if(!reverse)
+    /* matches of every primer on the forward strand */
+    embPatSeedSetScan(seeds, seqstr);
+
+    listIter = ajListIterNewread(primerList);
+    while(!ajListIterDone(listIter))
     {
+	Primer curr_primer = ajListIterGet(listIter);
+	primersearch_find_hits(curr_primer->forward, seeds, seq, seqstr, 0);
+	primersearch_find_hits(curr_primer->reverse, seeds, seq, seqstr, 0);
+    }
+
+    ajListIterDel(&listIter);
+
+    /*
+    ** matches on the reverse strand, only needed for a primer whose
+    ** partner matched the forward strand
+    */
+
+    embPatSeedSetScan(seeds, revstr);
+
+    listIter = ajListIterNewread(primerList);
+    while(!ajListIterDone(listIter))
+    {
+	Primer curr_primer = ajListIterGet(listIter);
+
+	curr_primer->forward->nhits[1] = 0;
+	curr_primer->reverse->nhits[1] = 0;
+
+	if(curr_primer->forward->nhits[0])
+	    primersearch_find_hits(curr_primer->reverse, seeds, seq,
+				   revstr, 1);
+
+	if(curr_primer->reverse->nhits[0])
+	    primersearch_find_hits(curr_primer->forward, seeds, seq,
+				   revstr, 1);
+
 	/* test OligoA against forward sequence, and OligoB against reverse */
-	embPatFuzzSearch(primdata->forward->type,
-			 ajSeqGetBegin(seq),
-			 primdata->forward->patstr,
-			 seqname,
-			 seqstr,
-			 fhits_list,
-			 primdata->forward->len,
-			 primdata->forward->mm,
-			 primdata->forward->amino,
-			 primdata->forward->carboxyl,
-			 primdata->forward->buf,
-			 primdata->forward->off,
-			 primdata->forward->sotable,
-			 primdata->forward->solimit,
-			 primdata->forward->re,
-			 primdata->forward->skipm,
-			 &fhits,
-			 primdata->forward->real_len,
-			 &(primdata->forward->tidy));
-
-	if(fhits)
-	    embPatFuzzSearch(primdata->reverse->type,
-			     ajSeqGetBegin(seq),
-			     primdata->reverse->patstr,
-			     seqname,
-			     revstr,
-			     rhits_list,
-			     primdata->reverse->len,
-			     primdata->reverse->mm,
-			     primdata->reverse->amino,
-			     primdata->reverse->carboxyl,
-			     primdata->reverse->buf,
-			     primdata->reverse->off,
-			     primdata->reverse->sotable,
-			     primdata->reverse->solimit,
-			     primdata->reverse->re,
-			     primdata->reverse->skipm,
-			     &rhits,
-			     primdata->reverse->real_len,
-			     &(primdata->reverse->tidy));
+	primersearch_store_hits(curr_primer, curr_primer->forward,
+				curr_primer->reverse, seq, AJFALSE);
+
+	/*test OligoB against forward sequence, and OligoA against reverse  */
+	primersearch_store_hits(curr_primer, curr_primer->reverse,
+				curr_primer->forward, seq, AJTRUE);
     }
+
+    ajListIterDel(&listIter);
+
+    ajStrDel(&seqstr);
+    ajStrDel(&revstr);
+
+    return;
+}
+
+
+
+
+/* @funcstatic primersearch_find_hits *****************************************
+**
+** finds the matches of one primer to one strand of a sequence, in the
+** order embPatFuzzSearch lists them (last match first)
+**
+** Matches of seeded primers are taken from the last scan of the seed set;
+** other primers, and primers longer than the sequence, are searched for
+** with embPatFuzzSearch
+**
+** @param [u] guts [PGuts] primer guts
+** @param [r] seeds [const EmbPPatSeedSet] primer seed set
+** @param [r] seq [const AjPSeq] sequence
+** @param [r] text [const AjPStr] sequence strand, as scanned
+** @param [r] strand [ajuint] 0 for the sequence, 1 for its reverse
+**                           complement
+** @@
+******************************************************************************/
+
+static void primersearch_find_hits(PGuts guts, const EmbPPatSeedSet seeds,
+				   const AjPSeq seq, const AjPStr text,
+				   ajuint strand)
+{
+    AjPStr seqname = NULL;
+    AjPList hits_list = NULL;
+    AjIList lIter;
+    ajuint begin;
+    ajuint nhits = 0;
+    ajuint i;
+    ajuint n;
+
+    begin = ajSeqGetBegin(seq);
+
+    if(seeds->Compiled[guts->seedpat] && ajStrGetLen(text) >= guts->len)
+	nhits = seeds->Nhits[guts->seedpat];
     else
     {
-	/*test OligoB against forward sequence, and OligoA against reverse  */
-	embPatFuzzSearch(primdata->reverse->type,
-			 ajSeqGetBegin(seq),
-			 primdata->reverse->patstr,
+	ajStrAssignC(&seqname,ajSeqGetNameC(seq));
+	hits_list = ajListNew();
+
+	embPatFuzzSearch(guts->type,
+			 begin,
+			 guts->patstr,
 			 seqname,
-			 seqstr,
-			 fhits_list,
-			 primdata->reverse->len,
-			 primdata->reverse->mm,
-			 primdata->reverse->amino,
-			 primdata->reverse->carboxyl,
-			 primdata->reverse->buf,
-			 primdata->reverse->off,
-			 primdata->reverse->sotable,
-			 primdata->reverse->solimit,
-			 primdata->reverse->re,
-			 primdata->reverse->skipm,
-			 &fhits,
-			 primdata->reverse->real_len,
-			 &(primdata->reverse->tidy));
-
-	if(fhits)
-	    embPatFuzzSearch(primdata->forward->type,
-			     ajSeqGetBegin(seq),
-			     primdata->forward->patstr,
-			     seqname,
-			     revstr,
-			     rhits_list,
-			     primdata->forward->len,
-			     primdata->forward->mm,
-			     primdata->forward->amino,
-			     primdata->forward->carboxyl,
-			     primdata->forward->buf,
-			     primdata->forward->off,
-			     primdata->forward->sotable,
-			     primdata->forward->solimit,
-			     primdata->forward->re,
-			     primdata->forward->skipm,
-			     &rhits,
-			     primdata->forward->real_len,
-			     &(primdata->forward->tidy));
+			 text,
+			 hits_list,
+			 guts->len,
+			 guts->mm,
+			 guts->amino,
+			 guts->carboxyl,
+			 guts->buf,
+			 guts->off,
+			 guts->sotable,
+			 guts->solimit,
+			 guts->re,
+			 guts->skipm,
+			 &nhits,
+			 guts->real_len,
+			 &(guts->tidy));
+
+	nhits = (ajuint) ajListGetLength(hits_list);
     }
 
-    if(fhits && rhits)
-	/* get amplimer length(s) and write out the hit */
-	primersearch_store_hits(primdata, fhits_list, rhits_list,
-				seq, reverse);
+    if(nhits > guts->maxhits[strand])
+    {
+	guts->maxhits[strand] = nhits;
+	AJCRESIZE(guts->hitpos[strand], nhits);
+	AJCRESIZE(guts->hitmm[strand], nhits);
+    }
 
-    /* tidy up */
-    primersearch_clean_hitlist(&fhits_list);
-    primersearch_clean_hitlist(&rhits_list);
+    guts->nhits[strand] = nhits;
 
-    ajStrDel(&seqstr);
-    ajStrDel(&revstr);
+    if(!hits_list)
+    {
+	/* seed set matches are in sequence order */
+	for(i=0,n=nhits;n--;++i)
+	{
+	    guts->hitpos[strand][i] = seeds->Hits[guts->seedpat][n] + begin;
+	    guts->hitmm[strand][i] = seeds->Hitmm[guts->seedpat][n];
+	}
+
+	return;
+    }
+
+    i = 0;
+    lIter = ajListIterNewread(hits_list);
+    while(!ajListIterDone(lIter))
+    {
+	EmbPMatMatch m = ajListIterGet(lIter);
+	guts->hitpos[strand][i] = m->start;
+	guts->hitmm[strand][i] = m->mm;
+	++i;
+    }
+    ajListIterDel(&lIter);
+
+    primersearch_clean_hitlist(&hits_list);
     ajStrDel(&seqname);
 
     return;
@@ -715,41 +825,67 @@ static void primersearch_scan_seq(const Primer primdata,
 **
 ** Store primer hits
 **
+** Pairs the forward strand matches of one primer with the reverse strand
+** matches of the other. When the reverse matches are in descending order,
+** those giving a positive amplimer length for a forward match are a run
+** at the end, found by binary search.
+**
 ** @param [r] primdata [const Primer] primer data
-** @param [w] fhits [AjPList] forward hits
-** @param [w] rhits [AjPList] reverse hits
+** @param [r] fguts [const PGuts] primer matching the forward strand
+** @param [r] rguts [const PGuts] primer matching the reverse strand
 ** @param [r] seq [const AjPSeq] sequence
 ** @param [r] reverse [AjBool] do reverse
 ** @@
 ******************************************************************************/
 
 static void primersearch_store_hits(const Primer primdata,
-			       AjPList fhits, AjPList rhits,
-			       const AjPSeq seq, AjBool reverse)
+				    const PGuts fguts, const PGuts rguts,
+				    const AjPSeq seq, AjBool reverse)
 {
     ajint amplen = 0;
-    AjIList fi;
-    AjIList ri;
+    ajint seqlen = ajSeqGetLen(seq);
+    const ajuint* rpos = rguts->hitpos[1];
+    ajuint nf = fguts->nhits[0];
+    ajuint nr = rguts->nhits[1];
+    ajuint i;
+    ajuint j;
+    ajuint lo;
+    ajuint hi;
+    ajuint mid;
+    AjBool sorted = AJTRUE;
 
     PHit primerhit = NULL;
 
-    fi = ajListIterNewread(fhits);
-    while(!ajListIterDone(fi))
+    if(!nf || !nr)
+	return;
+
+    for(j=1;j<nr;++j)
+	if(rpos[j] > rpos[j-1])
+	    sorted = AJFALSE;
+
+    for(i=0;i<nf;++i)
     {
-	EmbPMatMatch fm = NULL;
-	EmbPMatMatch rm = NULL;
-	amplen = 0;
+	ajint s = (fguts->hitpos[0][i]);
+	ajint e;
 
-	fm = ajListIterGet(fi);
-	ri = ajListIterNewread(rhits);
-	while(!ajListIterDone(ri))
+	lo = 0;
+
+	if(sorted)
 	{
-	    ajint seqlen = ajSeqGetLen(seq);
-	    ajint s = (fm->start);
-	    ajint e;
+	    hi = nr;
+	    while(lo < hi)
+	    {
+		mid = (lo + hi) / 2;
+		if(seqlen-(s-1)-((ajint) rpos[mid]-1) > 0)
+		    hi = mid;
+		else
+		    lo = mid + 1;
+	    }
+	}
 
-	    rm = ajListIterGet(ri);
-	    e = (rm->start-1);
+	for(j=lo;j<nr;++j)
+	{
+	    e = (rpos[j]-1);
 	    amplen = seqlen-(s-1)-e;
 
 	    if (amplen > 0)	   /* no point making a hit if -ve length! */
@@ -764,10 +900,10 @@ static void primersearch_store_hits(const Primer primdata,
 		ajStrAssignC(&primerhit->seqname,ajSeqGetNameC(seq));
 		ajStrAssignS(&primerhit->desc, ajSeqGetDescS(seq));
 		ajStrAssignS(&primerhit->acc, ajSeqGetAccS(seq));
-		primerhit->forward_pos = fm->start;
-		primerhit->reverse_pos = rm->start;
-		primerhit->forward_mismatch = fm->mm;
-		primerhit->reverse_mismatch = rm->mm;
+		primerhit->forward_pos = fguts->hitpos[0][i];
+		primerhit->reverse_pos = rpos[j];
+		primerhit->forward_mismatch = fguts->hitmm[0][i];
+		primerhit->reverse_mismatch = rguts->hitmm[1][j];
 		primerhit->amplen = amplen;
 		if(!reverse)
 		{
@@ -788,14 +924,8 @@ static void primersearch_store_hits(const Primer primdata,
 
 	    }
 	}
-	/*
-	**  clean up rListIter here as it will be new'ed again next
-	**  time through
-	*/
-	ajListIterDel(&ri);
     }
 
-    ajListIterDel(&fi);
     return;
 }
 
@@ -45,7 +45,7 @@ ajuint statwordlen;
 
 int main(int argc, char **argv)
 {
-    AjPTable seq1MatchTable = 0;
+    EmbPWordIndex seq1MatchIndex = 0;
     AjPList matchlist;
     AjPSeqset seqset;
     AjPAlign align = NULL;
@@ -68,17 +68,17 @@ int main(int argc, char **argv)
     for(i=0;i<nseqs;i++)
     {
         iseq1 = i;
-	seq1MatchTable = 0;
+	seq1MatchIndex = 0;
 	if(ajSeqGetLen(seqs[iseq1]) > statwordlen)
 	{
-	    if(embWordGetTable(&seq1MatchTable, seqs[i])) /* get word table */
+	    if(embWordGetIndex(&seq1MatchIndex, seqs[i])) /* get word index */
 	    {
 		for(j=i+1;j<ajSeqsetGetSize(seqset);j++)
 		{
 		    iseq2 = j;
 		    if(ajSeqGetLen(seqs[j]) >= statwordlen)
 		    {
-			matchlist = embWordBuildMatchTable(seq1MatchTable,
+			matchlist = embWordBuildMatchIndex(seq1MatchIndex,
 							   seqs[j], ajTrue);
 			if (ajListGetLength(matchlist))
 			{
@@ -91,7 +91,7 @@ int main(int argc, char **argv)
 		    }
 		}
 	    }
-	    embWordFreeTable(&seq1MatchTable); /* free table of words */
+	    embWordFreeIndex(&seq1MatchIndex); /* free index of words */
 	}
     }
 
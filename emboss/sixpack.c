@@ -56,6 +56,8 @@ int main(int argc, char **argv)
     ajint peplen;
     AjPSeq seq;
     AjPSeq pep;
+    AjPSeq peps[6];
+    AjBool frames[6];
     const AjPStr pepseq = NULL;
     AjPStr substr = NULL;
     EmbPShow ss;
@@ -205,17 +207,20 @@ int main(int argc, char **argv)
     ajFmtPrintF(outfile, "Minimum size of ORFs : %d\n\n", orfminsize);
     
     /* Write ORFs in a separate file */
-    
+
+    /* translate all frames in one pass, frame -1 uses frame 1 codons */
+    for(i=0; i<6; i++)
+        frames[i] = (i < totalframes);
+
+    ajTrnSeqSix(trnTable, seq, frames, ajFalse, ajFalse, peps);
+
     for(i=0; i<totalframes; i++)
     {
 	ajDebug("try frame: %d\n", i);
 
-	if(i<3)
-	    pep = ajTrnSeqOrig(trnTable, seq, i+1);
-	else
-	    /* frame -1 uses frame 1 codons */
-	    pep = ajTrnSeqOrig(trnTable, seq, 2-i);
-	  
+	pep = peps[i];
+	peps[i] = NULL;
+
 	pepbegin = ajSeqGetBegin(pep)-1;
 	pepend = ajSeqGetEnd(pep)-1;
 	pepseq = ajSeqGetSeqS(pep);
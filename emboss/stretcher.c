@@ -51,6 +51,8 @@ static ajint stretcher_CheckScore(const unsigned char *A,
 				  const unsigned char *B,
 				  const AjPSeq seq0, const AjPSeq seq1,
 				  ajint *S,ajint *NC);
+static ajint stretcher_Band(const AjPSeq seq0, const AjPSeq seq1,
+			    ajint wordlen, ajint G, ajint H, ajint *NC);
 
 static ajint *sapp;				/* Current script append ptr */
 static ajint  last;				/* Last script op appended */
@@ -146,6 +148,8 @@ int main(int argc, char **argv)
     const char *s2;
     ajint gdelval;
     ajint ggapval;
+    AjBool band;
+    ajint wordlen;
     ajuint i;
     ajint gscore;
     /* float percent; */
@@ -166,6 +170,8 @@ int main(int argc, char **argv)
     matrix  = ajAcdGetMatrix("datafile");
     gdelval = ajAcdGetInt("gapopen");
     ggapval = ajAcdGetInt("gapextend");
+    band    = ajAcdGetToggle("band");
+    wordlen = ajAcdGetInt("wordlen");
     align   = ajAcdGetAlign("outfile");
 
     /* obsolete. Can be uncommented in acd file and here to reuse */
@@ -212,11 +218,18 @@ int main(int argc, char **argv)
     AJCNEW(seqc0, ajSeqGetLen(glseq0)+ajSeqGetLen(glseq1));
     AJCNEW(seqc1, ajSeqGetLen(glseq0)+ajSeqGetLen(glseq1));
 
-    gscore = stretcher_Ealign(ajStrGetPtr(aa0str),ajStrGetPtr(aa1str),
-			      glseq0, glseq1,
-			      (gdelval-ggapval),ggapval,glres,&nres);
+    if(band)
+	gscore = stretcher_Band(glseq0, glseq1, wordlen,
+				gdelval, ggapval, &glnc);
+    else
+    {
+	gscore = stretcher_Ealign(ajStrGetPtr(aa0str),ajStrGetPtr(aa1str),
+				  glseq0, glseq1,
+				  (gdelval-ggapval),ggapval,glres,&nres);
 
-    glnc = stretcher_Calcons(ajSeqGetLen(glseq0),ajSeqGetLen(glseq1),glres);
+	glnc = stretcher_Calcons(ajSeqGetLen(glseq0),ajSeqGetLen(glseq1),
+				 glres);
+    }
     /* percent = (double)nd*100.0/(double)glnc; */
 
 /*
@@ -702,3 +715,90 @@ static ajint stretcher_CheckScore(const unsigned char *A,
 
     return(score);
 }
+
+
+
+
+/* @funcstatic stretcher_Band *************************************************
+**
+** Align within a band of diagonals seeded by word matches, with the same
+** gap scores as stretcher_Ealign, and fill in the aligned sequences.
+**
+** @param [r] seq0 [const AjPSeq] Sequence A
+** @param [r] seq1 [const AjPSeq] Sequence B
+** @param [r] wordlen [ajint] Word length for seeding the band
+** @param [r] G [ajint] Gap penalty
+** @param [r] H [ajint] Gap extension penalty
+** @param [w] NC [ajint*] Alignment length returned
+** @return [ajint] Score
+******************************************************************************/
+
+static ajint stretcher_Band(const AjPSeq seq0, const AjPSeq seq1,
+			    ajint wordlen, ajint G, ajint H, ajint *NC)
+{
+    float **fsub;
+    AjPStr alga = NULL;
+    AjPStr algb = NULL;
+    const char *p;
+    const char *q;
+    ajint rows;
+    ajint cols;
+    ajint dlo;
+    ajint dhi;
+    ajint start1;
+    ajint start2;
+    ajint i;
+    ajint j;
+    float score;
+
+    rows = ajMatrixGetRows(matrix);
+    cols = ajMatrixGetSize(matrix);
+
+    AJCNEW(fsub, rows);
+
+    for(i=0;i<rows;i++)
+    {
+	AJCNEW(fsub[i], cols);
+
+	for(j=0;j<cols;j++)
+	    fsub[i][j] = (float) sub[i][j];
+    }
+
+    if(!embAlignBandSeed(seq0, seq1, wordlen, &dlo, &dhi))
+    {
+	dlo = 0;
+	dhi = 0;
+    }
+
+    score = embAlignPathCalcBanded(ajSeqGetSeqC(seq0), ajSeqGetSeqC(seq1),
+				   ajSeqGetLen(seq0), ajSeqGetLen(seq1),
+				   dlo, dhi,
+				   (float) G, (float) H, (float) G, (float) H,
+				   fsub, cvt, ajTrue,
+				   &alga, &algb, &start1, &start2);
+
+    p = ajStrGetPtr(alga);
+    q = ajStrGetPtr(algb);
+
+    nd = 0;
+    *NC = ajStrGetLen(alga);
+
+    for(i=0;i<*NC;i++)
+    {
+	seqc0[i] = (p[i] == '.') ? '-' : p[i];
+	seqc1[i] = (q[i] == '.') ? '-' : q[i];
+
+	if(seqc0[i] == seqc1[i])
+	    nd++;
+    }
+
+    for(i=0;i<rows;i++)
+	AJFREE(fsub[i]);
+
+    AJFREE(fsub);
+
+    ajStrDel(&alga);
+    ajStrDel(&algb);
+
+    return (ajint) score;
+}
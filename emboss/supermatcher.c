@@ -144,7 +144,15 @@ int main(int argc, char **argv)
 
     AJCNEW0(matchlist, ntargetseqs);
 
-    /* get tables of words */
+    /*
+    ** get tables of words
+    **
+    ** Words from all the target sequences go in one table, so each query
+    ** is scanned once by Rabin-Karp whatever the number of targets.
+    ** A packed word index (embWordGetIndex) per target would scan each
+    ** query once per target, and would report matches on every diagonal,
+    ** which could change the seed chosen for each alignment.
+    */
     for(k=0;k<ntargetseqs;k++)
     {
 	targetseq = ajSeqsetGetseqSeq(targetseqs, k);
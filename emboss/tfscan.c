@@ -53,21 +53,31 @@ int main(int argc, char **argv)
 
     AjPList l = NULL;
 
-    AjPStr strand = NULL;
     AjPStr substr = NULL;
     AjPStr line   = NULL;
-    AjPStr name   = NULL;
     AjPStr acc    = NULL;
     AjPStr bf     = NULL;
     AjPStr menu;
     AjPStr pattern  = NULL;
-    AjPStr opattern = NULL;
     AjPStr pname    = NULL;
     AjPStr key      = NULL;
     AjPStr value    = NULL;
     AjPTable atable = NULL;
     AjPTable btable = NULL;
-    
+
+    AjPList namelist = NULL;
+    AjPList patlist  = NULL;
+    AjPList acclist  = NULL;
+    AjPList bflist   = NULL;
+    AjPStr *names    = NULL;
+    AjPStr *patterns = NULL;
+    AjPStr *accs     = NULL;
+    AjPStr *bfs      = NULL;
+    EmbPPatSiteSet siteset = NULL;
+    ajuint nsites;
+    ajuint i;
+    ajuint k;
+
     ajint mismatch;
     ajint minlength;
     
@@ -109,59 +119,89 @@ int main(int argc, char **argv)
 	    ajFatal("Either EMBOSS_DATA undefined or TFEXTRACT needs running");
     }
 
-    name     = ajStrNew();
     acc      = ajStrNew();
     bf       = ajStrNewC("");
     substr   = ajStrNew();
     line     = ajStrNew();
     pattern  = ajStrNewC("AA");
-    opattern = ajStrNew();
+
+    /*
+    ** Read the sites once and compile them into a single matcher
+    */
+
+    namelist = ajListstrNew();
+    patlist  = ajListstrNew();
+    acclist  = ajListstrNew();
+    bflist   = ajListstrNew();
+
+    while(ajReadlineTrim(inf,&line))
+    {
+	p = ajStrGetPtr(line);
+
+	if(!*p || *p=='#' || *p=='\n' || *p=='!')
+	    continue;
+
+	ajFmtScanS(line,"%S%S%S",&pname,&pattern,&acc);
+	p += ajStrGetLen(pname);
+	while(*p && *p==' ')
+	    ++p;
+	p += ajStrGetLen(pattern);
+	while(*p && *p==' ')
+	    ++p;
+	p += ajStrGetLen(acc);
+	while(*p && *p==' ')
+	    ++p;
+
+	ajStrAssignC(&bf,p); /* rest of line */
+
+	ajListstrPushAppend(namelist, ajStrNewS(pname));
+	ajListstrPushAppend(patlist, ajStrNewS(pattern));
+	ajListstrPushAppend(acclist, ajStrNewS(acc));
+	ajListstrPushAppend(bflist, ajStrNewS(bf));
+    }
+
+    nsites = (ajuint) ajListstrToarray(namelist, &names);
+    ajListstrToarray(patlist, &patterns);
+    ajListstrToarray(acclist, &accs);
+    ajListstrToarray(bflist, &bfs);
+
+    siteset = embPatSiteSetNew((const AjPStr*) patterns, nsites, mismatch);
 
     while(ajSeqallNext(seqall, &seq))
     {
 	begin=ajSeqallGetseqBegin(seqall);
 	end=ajSeqallGetseqEnd(seqall);
-	ajStrAssignC(&name,ajSeqGetNameC(seq));
-	strand=ajSeqGetSeqCopyS(seq);
 
-	ajStrAssignSubC(&substr,ajStrGetPtr(strand),begin-1,end-1);
+	ajStrAssignSubS(&substr,ajSeqGetSeqS(seq),begin-1,end-1);
 	ajStrFmtUpper(&substr);
 
 	l=ajListNew();
 	atable = ajTablestrNew(1000);
 	btable = ajTablestrNew(1000);
-	
+
+	embPatSiteSetScan(siteset, substr);
+
 	sum=0;
-	while(ajReadlineTrim(inf,&line))
+	for(i=0;i<nsites;++i)
 	{
-	    p = ajStrGetPtr(line);
-
-	    if(!*p || *p=='#' || *p=='\n' || *p=='!')
-		continue;
-
-	    ajFmtScanS(line,"%S%S%S",&pname,&pattern,&acc);
-	    p += ajStrGetLen(pname);
-	    while(*p && *p==' ')
-		++p;
-	    p += ajStrGetLen(pattern);
-	    while(*p && *p==' ')
-		++p;
-	    p += ajStrGetLen(acc);
-	    while(*p && *p==' ')
-		++p;
-
-	    ajStrAssignS(&opattern,pattern);
-	    ajStrAssignC(&bf,p); /* rest of line */
-	    
-	    v = embPatVariablePattern(pattern,substr,pname,l,0,
-				      mismatch,begin);
+	    if(siteset->Compiled[i])
+	    {
+		v = siteset->Nhits[i];
+
+		for(k=0;k<siteset->Nhits[i];++k)
+		    embPatPushHit(l,names[i],siteset->Hits[i][k],
+				  siteset->Len[i],begin,0);
+	    }
+	    else
+		v = embPatVariablePattern(patterns[i],substr,names[i],l,0,
+					  mismatch,begin);
 	    if(v)
 	    {
-		key = ajStrNewS(pname);
-		value = ajStrNewS(acc);
+		key = ajStrNewS(names[i]);
+		value = ajStrNewS(accs[i]);
 		ajTablePut(atable,(void *)key,(void *)value);
-		key = ajStrNewS(pname);
-		value = ajStrNewS(bf);
+		key = ajStrNewS(names[i]);
+		value = ajStrNewS(bfs[i]);
 		ajTablePut(btable,(void *)key,(void *)value);
 	    }
 	    sum += v;
@@ -171,18 +211,24 @@ int main(int argc, char **argv)
 	    tfscan_print_hits(&l,sum,outf,atable,seq,minlength,
 			      btable);
 
-	ajFileSeek(inf,0L,0);
 	ajListFree(&l);
 	ajTablestrFree(&atable);
 	ajTablestrFree(&btable);
-	ajStrDel(&strand);
     }
 
+    embPatSiteSetDel(&siteset);
+    AJFREE(names);
+    AJFREE(patterns);
+    AJFREE(accs);
+    AJFREE(bfs);
+    ajListstrFreeData(&namelist);
+    ajListstrFreeData(&patlist);
+    ajListstrFreeData(&acclist);
+    ajListstrFreeData(&bflist);
+
     ajStrDel(&line);
-    ajStrDel(&name);
     ajStrDel(&acc);
     ajStrDel(&pname);
-    ajStrDel(&opattern);
     ajStrDel(&bf);
     ajStrDel(&pattern);
     ajStrDel(&substr);
@@ -47,7 +47,7 @@ int main(int argc, char **argv)
     AjPSeqout seqout;
     AjPSeq seq;
     AjPTrn trnTable;
-    AjPSeq pep = NULL;
+    AjPSeq peps[6];	/* translations in frames 1 to 3, -1 to -3 */
     AjPStr *framelist;
     AjBool frames[6];	/* frames to be translated 1 to 3, -1 to -3 */
     AjPStr tablename;
@@ -96,41 +96,23 @@ int main(int argc, char **argv)
 	if(!wholeseq)
 	    ajRangeSeqExtract(seqregions, seq);
 
+        /* translate all the requested frames in one pass */
+        ajTrnSeqSix(trnTable, seq, frames, alternate,
+                    (methionine && !wholeseq), peps);
+
         for(i=0; i<6; i++)
 	{
-            ajDebug("try frame: %d\n", i);
-            if(frames[i])
-	    {
-                if(methionine && !wholeseq)
-                {
-                    if(i<3)
-                        pep = ajTrnSeqInit(trnTable, seq, i+1);
-                    else
-                        if(alternate) /* frame -1 uses codons starting at end */
-                            pep = ajTrnSeqInit(trnTable, seq, -i-1);
-                        else	/* frame -1 uses frame 1 codons */
-                            pep = ajTrnSeqInit(trnTable, seq, 2-i);
-                }
-                else 
-                {
-                    if(i<3)
-                        pep = ajTrnSeqOrig(trnTable, seq, i+1);
-                    else
-                        if(alternate) /* frame -1 uses codons starting at end */
-                            pep = ajTrnSeqOrig(trnTable, seq, -i-1);
-                        else	/* frame -1 uses frame 1 codons */
-                            pep = ajTrnSeqOrig(trnTable, seq, 2-i);
-                }
-                
-	        if(trim)
-	            transeq_Trim(pep);
-
-                if(clean)
-                    transeq_Clean(pep); /* clean after the trim */
-
-	        ajSeqoutWriteSeq(seqout, pep);
-	        ajSeqDel(&pep);
-	    }
+            if(!peps[i])
+                continue;
+
+            if(trim)
+                transeq_Trim(peps[i]);
+
+            if(clean)
+                transeq_Clean(peps[i]); /* clean after the trim */
+
+            ajSeqoutWriteSeq(seqout, peps[i]);
+            ajSeqDel(&peps[i]);
 	}
 	ajRangeDel(&seqregions);
     }
@@ -140,7 +122,6 @@ int main(int argc, char **argv)
     ajTrnDel(&trnTable);
     ajSeqallDel(&seqall);
     ajSeqDel(&seq);
-    ajSeqDel(&pep);
     ajStrDelarray(&framelist);
     ajStrDel(&tablename);
     ajSeqoutDel(&seqout);
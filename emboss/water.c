@@ -41,6 +41,7 @@ int main(int argc, char **argv)
     AjPStr ss;
 
     AjBool  show = ajFalse;
+    AjBool  linear = ajFalse;
 
     ajuint lena;
     ajuint lenb;
@@ -113,20 +114,34 @@ int main(int argc, char **argv)
 	ajSeqTrim(b);
 	lenb = ajSeqGetLen(b);
 
-	if(lenb > (LONG_MAX/(size_t)(lena+1)))
-            ajDie("Sequences too big. Try 'matcher' or 'supermatcher'");
-
-	len = (size_t)lena*(size_t)lenb;
+	linear = ajFalse;
 
-	if(len>maxarr)
+	if(lenb > (LONG_MAX/(size_t)(lena+1)))
+	    linear = ajTrue;
+	else
 	{
-	    AJCRESIZETRY0(path,maxarr,len);
-	    if(!path)
-		ajDie("Sequences too big. Try 'matcher' or 'supermatcher'");
-	    AJCRESIZETRY0(compass,maxarr,len);
-	    if(!compass)
-		ajDie("Sequences too big. Try 'matcher' or 'supermatcher'");
-	    maxarr=len;
+	    len = (size_t)lena*(size_t)lenb;
+
+	    if(len > EMBALNLINEARCELLS)
+		linear = ajTrue;
+	    else if(len>maxarr)
+	    {
+		AJCRESIZETRY0(path,maxarr,len);
+		AJCRESIZETRY0(compass,maxarr,len);
+
+		if(!path || !compass)
+		{
+		    /* keep going in linear space with small arrays */
+		    AJFREE(path);
+		    AJFREE(compass);
+		    maxarr = 1000;
+		    AJCNEW(path, maxarr);
+		    AJCNEW(compass, maxarr);
+		    linear = ajTrue;
+		}
+		else
+		    maxarr=len;
+	    }
 	}
 
 	beginb=ajSeqGetBegin(b)+ajSeqGetOffset(b);
@@ -137,14 +152,23 @@ int main(int argc, char **argv)
 	ajStrAssignC(&m,"");
 	ajStrAssignC(&n,"");
 
-	score = embAlignPathCalcSW(p,q,lena,lenb,gapopen,gapextend,path,sub,cvt,
-			   compass,show);
+	if(linear)
+	{
+	    ajDebug("water: %u x %u aligned in linear space\n", lena, lenb);
+	    score = embAlignPathCalcSWLinear(p,q,lena,lenb,gapopen,gapextend,
+	                                     sub,cvt,&m,&n,&start1,&start2);
+	}
+	else
+	{
+	    score = embAlignPathCalcSW(p,q,lena,lenb,gapopen,gapextend,path,
+	                               sub,cvt,compass,show);
 
-	/*score=embAlignScoreSWMatrix(path,compass,gapopen,gapextend,a,b,lena,
-          lenb,sub,cvt,&start1,&start2);*/
+	    /*score=embAlignScoreSWMatrix(path,compass,gapopen,gapextend,a,b,
+	      lena,lenb,sub,cvt,&start1,&start2);*/
 
-	embAlignWalkSWMatrix(path,compass,gapopen,gapextend,a,b,&m,&n,
-			     lena,lenb,&start1,&start2);
+	    embAlignWalkSWMatrix(path,compass,gapopen,gapextend,a,b,&m,&n,
+	                         lena,lenb,&start1,&start2);
+	}
 
 	ajDebug("ReportLocal call start1:%d begina:%d start2:%d beginb:%d\n",
 		start1, begina, start2, beginb);
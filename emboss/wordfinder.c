@@ -64,7 +64,7 @@ typedef struct concatS
 static void wordfinder_matchListOrder(void **x,void *cl);
 static void wordfinder_orderandconcat(AjPList list,AjPList ordered);
 static void wordfinder_removelists(void **x,void *cl);
-static ajint wordfinder_findstartpoints(AjPTable seq1MatchTable,
+static ajint wordfinder_findstartpoints(EmbPWordIndex seq1MatchIndex,
 					const AjPSeq b, const AjPSeq a,
 					ajint *trgstart, ajint *qrystart,
 					ajint *trgend, ajint *qryend);
@@ -134,7 +134,7 @@ int main(int argc, char **argv)
     ajint trgend   = 0;
     ajint qryend   = 0;
     ajint width  = 0;
-    AjPTable seq1MatchTable = 0;
+    EmbPWordIndex seq1MatchIndex = 0;
     ajint wordlen = 6;
     ajint oldmax = 0;
     ajint newmax = 0;
@@ -184,7 +184,7 @@ int main(int argc, char **argv)
 
 	ajDebug("Read '%S'\n", ajSeqGetNameS(trgseq));
 	ajSeqTrace(trgseq);
-	if(embWordGetTable(&seq1MatchTable, trgseq)) /* get table of words */
+	if(embWordGetIndex(&seq1MatchIndex, trgseq)) /* get index of words */
 	{
 	    for(k=0;k<ajSeqsetGetSize(qryseqs);k++)
 	    {
@@ -194,7 +194,7 @@ int main(int argc, char **argv)
 
 		ajDebug("Processing '%S'\n", ajSeqGetNameS(qryseq));
 
-		matchscore = wordfinder_findstartpoints(seq1MatchTable,
+		matchscore = wordfinder_findstartpoints(seq1MatchIndex,
 							qryseq, trgseq,
 							&qrystart, &trgstart,
 							&qryend, &trgend);
@@ -303,8 +303,8 @@ int main(int argc, char **argv)
             ajStrDel(&nqry);
 	    }
 	}
-	embWordFreeTable(&seq1MatchTable); /* free table of words */
-	seq1MatchTable=0;
+	embWordFreeIndex(&seq1MatchIndex); /* free index of words */
+	seq1MatchIndex=0;
 
 	ajStrDel(&mtrg);
 
@@ -477,7 +477,7 @@ static void wordfinder_findmax(void **x,void *cl)
 **
 ** Undocumented.
 **
-** @param [w] seq1MatchTable [AjPTable] match table
+** @param [w] seq1MatchIndex [EmbPWordIndex] word index
 ** @param [r] qryseq [const AjPSeq] query sequence 1
 ** @param [r] trgseq [const AjPSeq] target sequence 2
 ** @param [w] qrystart [ajint*] start in sequence 2
@@ -488,7 +488,7 @@ static void wordfinder_findmax(void **x,void *cl)
 ** @@
 ******************************************************************************/
 
-static ajint wordfinder_findstartpoints(AjPTable seq1MatchTable,
+static ajint wordfinder_findstartpoints(EmbPWordIndex seq1MatchIndex,
 					const AjPSeq qryseq,
 					const AjPSeq trgseq,
 					ajint *qrystart, ajint *trgstart,
@@ -511,7 +511,7 @@ static ajint wordfinder_findstartpoints(AjPTable seq1MatchTable,
 
     ajDebug("wordfinder_findstartpoints len %d %d off %d %d\n",
 	     trgmax, qrymax, bega, begb);
-    matchlist = embWordBuildMatchTable(seq1MatchTable, qryseq, ajTrue);
+    matchlist = embWordBuildMatchIndex(seq1MatchIndex, qryseq, ajTrue);
 
     if(!matchlist)
 	return 0;
@@ -118,6 +118,13 @@ int main(int argc, char **argv)
             seqsetsize);
     ajFmtPrintF(logfile, "Pattern/word length: %u\n", wordlen);
 
+    /*
+    ** Words from all the pattern sequences go in one table for a single
+    ** Rabin-Karp scan of each query. A packed word index (embWordGetIndex)
+    ** covers one sequence and reports matches on every diagonal, which
+    ** would change the matches and the per-pattern statistics reported.
+    */
+
     for(i=0;i<seqsetsize;i++)
     {
         targetseq = ajSeqsetGetseqSeq(seqset, i);
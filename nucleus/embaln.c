@@ -27,6 +27,7 @@
 #include "ajlib.h"
 
 #include "embaln.h"
+#include "embword.h"
 #include "ajmath.h"
 #include "ajseq.h"
 #include "ajalign.h"
@@ -48,6 +49,144 @@
 #define LEFT 1
 #define DOWN 2
 
+#define ALNLINEARBASE   4096        /* max cells solved with a full matrix */
+#define ALNLINEARSLACK  0.02        /* gap starts kept within this of the best */
+#define ALNBANDMARGIN   16          /* diagonals added to each side of a band */
+#define ALNBANDFLOOR    (-FLT_MAX/4) /* score of cells outside a band */
+
+
+
+
+/* @datastatic AlignPLinear ***************************************************
+**
+** Linear space alignment workspace
+**
+** Holds the parameters and the alignment being built. The alignment is
+** written in reverse, as the traceback walks from the end to the start.
+**
+** @alias AlignSLinear
+** @alias AlignOLinear
+**
+** @attr A [const char*] First sequence
+** @attr B [const char*] Second sequence
+** @attr Sub [float* const*] Substitution matrix
+** @attr Acode [ajint*] Substitution matrix codes for first sequence
+** @attr Bcode [ajint*] Substitution matrix codes for second sequence
+** @attr Col0 [float*] Local path scores in the first column
+** @attr Row0 [float*] Local path scores in the first row
+** @attr M [AjPStr*] Alignment for first sequence
+** @attr N [AjPStr*] Alignment for second sequence
+** @attr Lena [ajint] Length of first sequence
+** @attr Lenb [ajint] Length of second sequence
+** @attr Gapopen [float] Gap opening penalty
+** @attr Gapextend [float] Gap extension penalty
+** @attr Endgapopen [float] End gap opening penalty
+** @attr Endgapextend [float] End gap extension penalty
+** @attr Score [float] Global alignment score
+** @attr Padding [char[4]] Padding to alignment boundary
+** @@
+******************************************************************************/
+
+typedef struct AlignSLinear
+{
+    const char *A;
+    const char *B;
+    float * const *Sub;
+    ajint *Acode;
+    ajint *Bcode;
+    float *Col0;
+    float *Row0;
+    AjPStr *M;
+    AjPStr *N;
+    ajint Lena;
+    ajint Lenb;
+    float Gapopen;
+    float Gapextend;
+    float Endgapopen;
+    float Endgapextend;
+    float Score;
+    char Padding[4];
+} AlignOLinear;
+
+#define AlignPLinear AlignOLinear*
+
+
+
+
+/* @datastatic AlignPLinearWalk ***********************************************
+**
+** Position of the global alignment traceback walk
+**
+** The walk in embAlignPathCalcWithEndGapPenalties chooses each step from
+** the scores of the current cell, the previous step and the gap score
+** of the cell it came from, so these are all kept.
+**
+** @alias AlignSLinearWalk
+** @alias AlignOLinearWalk
+**
+** @attr Row [ajint] Position in first sequence
+** @attr Col [ajint] Position in second sequence
+** @attr Last [ajint] Previous step, DIAG, LEFT or DOWN
+** @attr Prev [float] Gap score of the previous cell for a LEFT
+**                    or DOWN step
+** @@
+******************************************************************************/
+
+typedef struct AlignSLinearWalk
+{
+    ajint Row;
+    ajint Col;
+    ajint Last;
+    float Prev;
+} AlignOLinearWalk;
+
+#define AlignPLinearWalk AlignOLinearWalk*
+
+
+
+
+/* @datastatic AlignPLinearBorder *********************************************
+**
+** Local alignment scores for one column of the path matrix
+**
+** Holds everything embAlignPathCalcSW carries from one column to the
+** next, and for each row the earlier columns where a gap could start
+** when embAlignWalkSWMatrix searches back along the row.
+**
+** Gap starts are kept only when their score is within ALNLINEARSLACK
+** of the best in the row, and not below a later gap start. The first row
+** only extends the previous cell, so it is saved in full instead.
+**
+** @alias AlignSLinearBorder
+** @alias AlignOLinearBorder
+**
+** @attr Path [float*] Path scores
+** @attr Maxa [double*] Best horizontal gap score for each row
+** @attr Num [ajint*] Number of gap starts for each row
+** @attr Gapcol [ajint*] Gap start columns, Keep for each row
+** @attr Gappath [float*] Gap start path scores, Keep for each row
+** @attr Rows [ajint] Number of rows
+** @attr Keep [ajint] Space for gap starts in each row
+** @attr Col [ajint] Column, -1 before the first column
+** @attr Comp [ajint] Path direction in the first row
+** @@
+******************************************************************************/
+
+typedef struct AlignSLinearBorder
+{
+    float *Path;
+    double *Maxa;
+    ajint *Num;
+    ajint *Gapcol;
+    float *Gappath;
+    ajint Rows;
+    ajint Keep;
+    ajint Col;
+    ajint Comp;
+} AlignOLinearBorder;
+
+#define AlignPLinearBorder AlignOLinearBorder*
+
 
 
 
@@ -58,6 +197,64 @@ static float embAlignGetScoreNWMatrix(
 	const float *ix, const float *iy, const float *m, ajint lena,
         ajint lenb, ajint *xpos, ajint *ypos, AjBool endweight);
 
+static AlignPLinear alignLinearNew(const char *a, const char *b,
+                                   ajint lena, ajint lenb,
+                                   float gapopen, float gapextend,
+                                   float * const *sub, const AjPSeqCvt cvt,
+                                   AjPStr *m, AjPStr *n);
+static void  alignLinearDel(AlignPLinear *Plin);
+static void  alignLinearEmit(AlignPLinear lin, ajint i, ajint j,
+                             ajint step);
+static void  alignLinearNWRow(AlignPLinear lin, ajint i,
+                              ajint c1, ajint c2,
+                              const float *up, const float *left,
+                              float *row);
+static ajint alignLinearNWStep(const AlignPLinear lin,
+                               const AlignPLinearWalk walk,
+                               const float *cell);
+static void  alignLinearNWNext(AlignPLinearWalk walk, const float *cell,
+                               ajint step);
+static void  alignLinearNWSolve(AlignPLinear lin,
+                                ajint r1, ajint r2, ajint c1, ajint c2,
+                                const float *top, const float *left,
+                                AlignPLinearWalk walk);
+static void  alignLinearNWBase(AlignPLinear lin,
+                               ajint r1, ajint r2, ajint c1, ajint c2,
+                               const float *top, const float *left,
+                               AlignPLinearWalk walk);
+static AlignPLinearBorder alignLinearBorderNew(ajint rows, AjBool gaps);
+static AlignPLinearBorder alignLinearBorderClone(
+                               const AlignPLinearBorder border,
+                               ajint rows);
+static void  alignLinearBorderDel(AlignPLinearBorder *Pborder);
+static void  alignLinearBorderPush(AlignPLinearBorder border,
+                                   ajint i, ajint j, float path,
+                                   float gapextend);
+static void  alignLinearSWColumn(const AlignPLinear lin, ajint j,
+                                 AlignPLinearBorder border,
+                                 ajint *comp, float *ret);
+static float alignLinearSWEnd(AlignPLinear lin,
+                              ajint *end1, ajint *end2);
+static AjBool alignLinearSWSolve(AlignPLinear lin, ajint c1, ajint c2,
+                                 const AlignPLinearBorder border,
+                                 ajint *ypos, ajint *xpos);
+static AjBool alignLinearSWBase(AlignPLinear lin, ajint c1, ajint c2,
+                                const AlignPLinearBorder border,
+                                ajint *ypos, ajint *xpos);
+static ajint alignLinearSWLeft(const AlignPLinear lin,
+                               const float *path, ajint rows, ajint c1,
+                               const AlignPLinearBorder border,
+                               ajint i, ajint j, double score,
+                               double *bimble);
+static int   alignBandCompare(const void* a, const void* b);
+static double alignBandMaxsub(const AlignPLinear lin);
+static double alignBandBound(ajint lena, ajint lenb, ajint d,
+                             double maxsub, double mingap);
+static size_t alignBandOffsets(ajint lena, ajint lenb,
+                               ajint dlo, ajint dhi, size_t *offset);
+static void  alignBandFill(AlignPLinear lin, ajint dlo, ajint dhi,
+                           const size_t *offset, float *cells);
+
 
 
 
@@ -104,7 +301,7 @@ float embAlignPathCalc(const char *a, const char *b,
     double *maxa;
     double maxb;
 
-    static AjPStr outstr = NULL;
+    AjPStr outstr = NULL;
     char compasschar;
 
     float ret = -FLT_MAX;
@@ -240,7 +437,7 @@ float embAlignPathCalc(const char *a, const char *b,
 
     AJFREE(maxa);
 
-    ajStrDelStatic(&outstr);
+    ajStrDel(&outstr);
 
     return ret;
 }
@@ -295,7 +492,8 @@ float embAlignPathCalcWithEndGapPenalties(const char *a, const char *b,
 {
     ajint xpos;
     ajint ypos;
-    ajint bconvcode;
+    ajint *bcode;
+    const float *subrow;
 
     float match;
     float ixp;
@@ -371,24 +569,34 @@ float embAlignPathCalcWithEndGapPenalties(const char *a, const char *b,
     iy[cursor] -= endgapopen;
     iy[cursor] += gapopen;
 
-    xpos = 1;
+    /* Look up the substitution matrix codes once for each position */
+    bcode = AJALLOC(lenb*sizeof(ajint));
 
-    /* Now construct match, ix, and iy matrices */
-    while (xpos != lenb)
+    for (xpos = 0; xpos < lenb; ++xpos)
+        bcode[xpos] = ajSeqcvtGetCodeK(cvt, b[xpos]);
+
+    /*
+    ** Now construct match, ix, and iy matrices
+    **
+    ** The rows are filled in turn so the matrices are read and written in
+    ** memory order. Each cell needs only its diagonal, upper and left
+    ** neighbours, so the scores are the same in any order that has
+    ** those ready.
+    */
+    for (ypos = 1; ypos < lena; ++ypos)
     {
-        ypos = 1;
-        bconvcode = ajSeqcvtGetCodeK(cvt, *++b);
+        subrow = sub[ajSeqcvtGetCodeK(cvt, a[ypos])];
 
         /* coordinates of the cells being processed */
-        cursorp = xpos-1;
-        cursor = xpos++;
+        cursorp = (ypos-1) * lenb;
+        cursor = ypos * lenb;
 
-        while (ypos < lena)
+        for (xpos = 1; xpos < lenb; ++xpos)
         {
             /* get match for current xpos/ypos */
-            match = sub[ajSeqcvtGetCodeK(cvt, a[ypos++])][bconvcode];
+            match = subrow[bcode[xpos]];
 
-            cursor += lenb;
+            ++cursor;
 
             /* match matrix calculations */
             mp = m[cursorp];
@@ -403,7 +611,7 @@ float embAlignPathCalcWithEndGapPenalties(const char *a, const char *b,
                 m[cursor] = iyp+match;
 
             /* iy matrix calculations */
-            if(xpos==lenb)
+            if(xpos==lenb-1)
             {
         	testog = m[++cursorp] - endgapopen;
         	testeg = iy[cursorp] - endgapextend;
@@ -424,23 +632,21 @@ float embAlignPathCalcWithEndGapPenalties(const char *a, const char *b,
             else
         	iy[cursor] = testeg;
 
-            cursorp += lenb;
-
             /* ix matrix calculations */
-            if(ypos==lena)
+            if(ypos==lena-1)
             {
-        	testog = m[--cursorp] - endgapopen;
-        	testeg = ix[cursorp] - endgapextend;
+        	testog = m[cursor-1] - endgapopen;
+        	testeg = ix[cursor-1] - endgapextend;
             }
             else
             {
-        	testog = m[--cursorp];
+        	testog = m[cursor-1];
         	
-        	if (testog<iy[cursorp])
-        	    testog = iy[cursorp];
+        	if (testog<iy[cursor-1])
+        	    testog = iy[cursor-1];
         	
         	testog -= gapopen;
-        	testeg = ix[cursorp] - gapextend;
+        	testeg = ix[cursor-1] - gapextend;
             }
             
             if(testog > testeg )
@@ -451,6 +657,8 @@ float embAlignPathCalcWithEndGapPenalties(const char *a, const char *b,
         }
     }
 
+    AJFREE(bcode);
+
     score = embAlignGetScoreNWMatrix(ix, iy, m, lena, lenb,
             start1, start2, endweight);
 
@@ -524,9 +732,9 @@ float embAlignPathCalcWithEndGapPenalties(const char *a, const char *b,
 
     if(show)
     {
-        printPathMatrix(m, compass, a, b-lenb+1, lena, lenb);
-        printPathMatrix(ix, compass, a, b-lenb+1, lena, lenb);
-        printPathMatrix(iy, compass, a, b-lenb+1, lena, lenb);
+        printPathMatrix(m, compass, a, b, lena, lenb);
+        printPathMatrix(ix, compass, a, b, lena, lenb);
+        printPathMatrix(iy, compass, a, b, lena, lenb);
     }
 
     
@@ -577,8 +785,15 @@ float embAlignPathCalcSW(const char *a, const char *b, ajint lena, ajint lenb,
     double result;
     double fnew;
     double *maxa;
-
-    static AjPStr outstr = NULL;
+    double *bxa;
+    ajint *acode;
+    ajint *bcode;
+    const float *subrow;
+    const float *prow;
+    float *row;
+    ajint *crow;
+
+    AjPStr outstr = NULL;
     double bx;
     char compasschar;
 
@@ -589,12 +804,23 @@ float embAlignPathCalcSW(const char *a, const char *b, ajint lena, ajint lenb,
     /* Create stores for the maximum values in a row or column */
 
     maxa = AJALLOC(lena*sizeof(double));
+    bxa  = AJALLOC(lenb*sizeof(double));
+
+    /* Look up the substitution matrix codes once for each position */
+
+    acode = AJALLOC(lena*sizeof(ajint));
+    bcode = AJALLOC(lenb*sizeof(ajint));
+
+    for(i=0;i<lena;++i)
+	acode[i] = ajSeqcvtGetCodeK(cvt,a[i]);
 
+    for(j=0;j<lenb;++j)
+	bcode[j] = ajSeqcvtGetCodeK(cvt,b[j]);
 
     /* First initialise the first column and row */
     for(i=0;i<lena;++i)
     {
-	result = sub[ajSeqcvtGetCodeK(cvt,a[i])][ajSeqcvtGetCodeK(cvt,b[0])];
+	result = sub[acode[i]][bcode[0]];
 
 	fnew = i==0 ? 0. :
 		path[(i-1)*lenb] -(compass[(i-1)*lenb]==DOWN ?
@@ -622,7 +848,7 @@ float embAlignPathCalcSW(const char *a, const char *b, ajint lena, ajint lenb,
 
     for(j=0;j<lenb;++j)
     {
-	result = sub[ajSeqcvtGetCodeK(cvt,a[0])][ajSeqcvtGetCodeK(cvt,b[j])];
+	result = sub[acode[0]][bcode[j]];
 
 	fnew = j==0 ? 0. :
 		path[j-1] -(compass[j-1]==LEFT ? gapextend : gapopen);
@@ -646,31 +872,41 @@ float embAlignPathCalcSW(const char *a, const char *b, ajint lena, ajint lenb,
     }
 
 
-    /* xpos and ypos are the diagonal steps so start at 1 */
-    xpos = 1;
-
-    while(xpos!=lenb)
+    /*
+    ** xpos and ypos are the diagonal steps so start at 1
+    **
+    ** The matrix is filled one row at a time, so path and compass are
+    ** written in memory order. Each cell only needs its left, upper and
+    ** diagonal neighbours, so the scores are the same as filling one
+    ** column at a time. The vertical gap scores (bx) are kept for each
+    ** column and the horizontal gap scores (maxa) for the current row.
+    */
+
+    for(xpos=1;xpos<lenb;++xpos)
+	bxa[xpos] = path[xpos]-gapopen-gapextend;
+
+    for(ypos=1;ypos<lena;++ypos)
     {
-	ypos  = 1;
-	bx = path[xpos]-gapopen-gapextend;
+	subrow = sub[acode[ypos]];
+	prow = &path[(ypos-1)*lenb];
+	row  = &path[ypos*lenb];
+	crow = &compass[ypos*lenb];
 
-	while(ypos < lena)
+	for(xpos=1;xpos<lenb;++xpos)
 	{
 	    /* get match for current xpos/ypos */
-	    match = sub[ajSeqcvtGetCodeK(cvt,a[ypos])]
-                       [ajSeqcvtGetCodeK(cvt,b[xpos])];
+	    match = subrow[bcode[xpos]];
 
 	    /* Get diag score */
-	    mscore = path[(ypos-1)*lenb+xpos-1] + match;
+	    mscore = prow[xpos-1] + match;
 
 	    /* Set compass to diagonal value 0 */
-	    compass[ypos*lenb+xpos] = 0;
-	    path[ypos*lenb+xpos] = (float) mscore;
+	    crow[xpos] = 0;
 
 
 	    /* Now parade back along X axis */
             maxa[ypos] -= gapextend;
-            fnew=path[(ypos)*lenb+xpos-1];
+            fnew=row[xpos-1];
             fnew-=gapopen;
 
 #ifdef TESTALL
@@ -684,35 +920,33 @@ float embAlignPathCalcSW(const char *a, const char *b, ajint lena, ajint lenb,
             if( maxa[ypos] > mscore)
             {
                 mscore = maxa[ypos];
-                path[ypos*lenb+xpos] = (float) mscore;
-                compass[ypos*lenb+xpos] = LEFT; /* Score comes from left */
+                crow[xpos] = LEFT; /* Score comes from left */
             }
 
 	    /* And then bimble down Y axis */
-            bx -= gapextend;
-            fnew = path[(ypos-1)*lenb+xpos];
+            bx = bxa[xpos] - gapextend;
+            fnew = prow[xpos];
             fnew-=gapopen;
 
             if(fnew > bx)
                 bx = fnew;
 
+            bxa[xpos] = bx;
+
             if(bx > mscore)
             {
                 mscore = bx;
-                path[ypos*lenb+xpos] = (float) mscore;
-                compass[ypos*lenb+xpos] = DOWN; /* Score comes from bottom */
+                crow[xpos] = DOWN; /* Score comes from bottom */
             }
 
             if(mscore > ret)
                 ret = (float) mscore;
 
-	    result = path[ypos*lenb+xpos];
-	    if(result < 0.)
-		path[ypos*lenb+xpos] = 0.;
+	    row[xpos] = (float) mscore;
 
-	    ypos++;
+	    if(row[xpos] < 0.)
+		row[xpos] = 0.;
 	}
-	++xpos;
     }
 
     if(show)
@@ -747,8 +981,11 @@ float embAlignPathCalcSW(const char *a, const char *b, ajint lena, ajint lenb,
     }
 
     AJFREE(maxa);
+    AJFREE(bxa);
+    AJFREE(acode);
+    AJFREE(bcode);
 
-    ajStrDelStatic(&outstr);
+    ajStrDel(&outstr);
 
     return ret;
 }
@@ -756,239 +993,630 @@ float embAlignPathCalcSW(const char *a, const char *b, ajint lena, ajint lenb,
 
 
 
-/* @func embAlignWalkSWMatrix *************************************************
+/* @func embAlignPathCalcLinear ***********************************************
 **
-** Walk down a matrix for Smith Waterman. Form aligned strings.
-** Nucleotides or proteins as needed.
+** Needleman-Wunsch alignment of two sequences in linear space.
+** Nucleotides or proteins as needed. Supports end gap penalties.
 **
-** @param [r] path [const float*] path matrix
-** @param [r] compass [const ajint*] Path direction pointer array
+** Gives the same score and alignment as embAlignPathCalcWithEndGapPenalties
+** followed by embAlignWalkNWMatrixUsingCompass, but the path matrices are
+** never stored. The rows are split in half (as in Myers and Miller,
+** CABIOS 1989) and the traceback is followed from the final cell to find
+** where it reaches the middle row. The two halves are solved in turn,
+** keeping only single rows of the match and gap scores, so memory use is
+** proportional to lena+lenb.
+**
+** The aligned strings are written directly, in the form returned by
+** embAlignWalkNWMatrixUsingCompass, for use by embAlignReportGlobal.
+**
+** @param [r] a [const char *] first sequence
+** @param [r] b [const char *] second sequence
+** @param [r] lena [ajint] length of first sequence
+** @param [r] lenb [ajint] length of second sequence
 ** @param [r] gapopen [float] gap opening penalty
 ** @param [r] gapextend [float] gap extension penalty
-** @param [r] a [const AjPSeq] first sequence
-** @param [r] b [const AjPSeq] second sequence
+** @param [r] endgapopen [float] end gap opening penalty
+** @param [r] endgapextend [float] end gap extension penalty
+** @param [r] sub [float * const *] substitution matrix from AjPMatrixf
+** @param [r] cvt [const AjPSeqCvt] Conversion array for AjPMatrixf
+** @param [r] endweight [AjBool] Use end gap weights
 ** @param [w] m [AjPStr *] alignment for first sequence
 ** @param [w] n [AjPStr *] alignment for second sequence
-** @param [r] lena [ajint] length of first sequence
-** @param [r] lenb [ajint] length of second sequence
 ** @param [w] start1 [ajint *] start of alignment in first sequence
 ** @param [w] start2 [ajint *] start of alignment in second sequence
 **
-** @return [void]
+** @return [float] Score
 **
-** @release 1.0.0
+** @release 6.6.0
+** @@
 ******************************************************************************/
 
-void embAlignWalkSWMatrix(const float *path, const ajint *compass,
-			  float gapopen, float gapextend,
-                          const AjPSeq a, const AjPSeq b,
-			  AjPStr *m, AjPStr *n,
-                          ajint lena, ajint lenb,
-			  ajint *start1, ajint *start2)
+float embAlignPathCalcLinear(const char *a, const char *b,
+                             ajint lena, ajint lenb,
+                             float gapopen, float gapextend,
+                             float endgapopen, float endgapextend,
+                             float * const *sub, const AjPSeqCvt cvt,
+                             AjBool endweight,
+                             AjPStr *m, AjPStr *n,
+                             ajint *start1, ajint *start2)
 {
-    ajlong i;
-    ajlong j;
-    ajlong k;
-    ajlong gapcnt;
-    double pmax;
-    double score;
-    double bimble;
+    AlignPLinear lin;
+    AlignOLinearWalk walk;
+    float score;
+    ajint i;
 
-    ajlong ix;
-    ajlong iy;
+    ajDebug("embAlignPathCalcLinear lena:%d lenb:%d\n", lena, lenb);
 
-    ajlong xpos = 0;
-    ajlong ypos = 0;
-    const char *p;
-    const char *q;
+    ajStrAssignClear(m);
+    ajStrAssignClear(n);
 
-    ajint ic;
-    double errbounds;
+    *start1 = 0;
+    *start2 = 0;
 
-    ajDebug("embAlignWalkSWMatrix\n");
+    if(!endweight)
+    {
+	endgapopen   = 0.0F;
+	endgapextend = 0.0F;
+    }
 
-    /* errbounds = gapextend; */
-    errbounds = (double) 0.01;
+    if(lena < 1 || lenb < 1)
+	return 0.0F;
 
-    /* Get maximum path score and save position */
-    pmax = -FLT_MAX;
-    k = (ajlong)lena*(ajlong)lenb-1;
+    lin = alignLinearNew(a, b, lena, lenb, gapopen, gapextend,
+                         sub, cvt, m, n);
+    lin->Endgapopen   = endgapopen;
+    lin->Endgapextend = endgapextend;
 
-    for(i=lena-1; i>=0; --i)
-	for(j=lenb-1; j>=0; --j)
-	    if((path[k--] > pmax) || E_FPEQ(path[k+1],pmax,U_FEPS))
-	    {
-		pmax = path[k+1];
-		xpos = j;
-		ypos = i;
-	    }
+    /* the walk starts at the final cell with no previous step */
 
-    ajStrAssignClear(m);
-    ajStrAssignClear(n);
+    walk.Row  = lena-1;
+    walk.Col  = lenb-1;
+    walk.Last = DIAG;
+    walk.Prev = 0.0F;
 
-    p = ajSeqGetSeqC(a);
-    q = ajSeqGetSeqC(b);
+    alignLinearNWSolve(lin, 0, lena-1, 0, lenb-1, NULL, NULL, &walk);
 
-    while(xpos>=0 && ypos>=0)
+    for(i=walk.Col;i>=0;--i)
     {
-	if(!compass[ypos*lenb+xpos])	/* diagonal */
-	{
-	    ajStrAppendK(m,p[ypos--]);
-	    ajStrAppendK(n,q[xpos--]);
+	ajStrAppendK(m, '.');
+	ajStrAppendK(n, b[i]);
+    }
 
-	    if(ypos >= 0 && xpos>=0 && path[(ypos)*lenb+xpos]<=0.)
-		break;
+    for(i=walk.Row;i>=0;--i)
+    {
+	ajStrAppendK(m, a[i]);
+	ajStrAppendK(n, '.');
+    }
 
-	    continue;
-	}
-	else if(compass[ypos*lenb+xpos]==LEFT) /* Left, gap(s) in vertical */
-	{
-	    score  = path[ypos*lenb+xpos];
-	    gapcnt = 0;
-	    ix     = xpos-1;
+    ajStrReverse(m);
+    ajStrReverse(n);
 
-	    while(1)
-	    {
-		bimble = path[ypos*lenb+ix]-gapopen-(gapcnt*gapextend);
+    score = lin->Score;
 
-		if(!ix || fabs((double)score-(double)bimble)<errbounds)
-		    break;
+    alignLinearDel(&lin);
 
-		--ix;
-		++gapcnt;
-	    }
+    return score;
+}
 
-	    if(bimble<=0.0)
-		break;
 
-	    for(ic=0;ic<=gapcnt;++ic)
-	    {
-		ajStrAppendK(m,'.');
-		ajStrAppendK(n,q[xpos--]);
-	    }
 
-	    continue;
-	}
-	else if(compass[ypos*lenb+xpos]==DOWN) /* Down, gap(s) in horizontal */
-	{
-	    score  = path[ypos*lenb+xpos];
-	    gapcnt = 0;
-	    iy = ypos-1;
 
-	    while(1)
-	    {
-		bimble=path[iy*lenb+xpos]-gapopen-(gapcnt*gapextend);
+/* @func embAlignPathCalcSWLinear *********************************************
+**
+** Smith-Waterman alignment of two sequences in linear space.
+** Nucleotides or proteins as needed.
+**
+** Gives the same score and alignment as embAlignPathCalcSW followed by
+** embAlignWalkSWMatrix, but the path matrix is never stored. A first pass
+** with the same recurrences, keeping one column at a time, finds the
+** maximum score and the end of the alignment. The columns up to the end
+** are then split in half, recalculating the scores carried from column
+** to column, and the traceback is followed through the right half and
+** then the left half. Memory use is proportional to lena, plus lenb for
+** the sequence codes and the first row.
+**
+** The aligned strings and start positions are returned as by
+** embAlignWalkSWMatrix, for use by embAlignReportLocal.
+**
+** @param [r] a [const char *] first sequence
+** @param [r] b [const char *] second sequence
+** @param [r] lena [ajint] length of first sequence
+** @param [r] lenb [ajint] length of second sequence
+** @param [r] gapopen [float] gap opening penalty
+** @param [r] gapextend [float] gap extension penalty
+** @param [r] sub [float * const *] substitution matrix from AjPMatrixf
+** @param [r] cvt [const AjPSeqCvt] Conversion array for AjPMatrixf
+** @param [w] m [AjPStr *] alignment for first sequence
+** @param [w] n [AjPStr *] alignment for second sequence
+** @param [w] start1 [ajint *] start of alignment in first sequence
+** @param [w] start2 [ajint *] start of alignment in second sequence
+**
+** @return [float] Maximum score
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
 
-		if(!iy || fabs((double)score-(double)bimble)<errbounds)
-		    break;
+float embAlignPathCalcSWLinear(const char *a, const char *b,
+                               ajint lena, ajint lenb,
+                               float gapopen, float gapextend,
+                               float * const *sub, const AjPSeqCvt cvt,
+                               AjPStr *m, AjPStr *n,
+                               ajint *start1, ajint *start2)
+{
+    AlignPLinear lin;
+    AlignPLinearBorder border;
+    float ret;
+    ajint ypos = 0;
+    ajint xpos = 0;
 
-		--iy;
+    ajDebug("embAlignPathCalcSWLinear lena:%d lenb:%d\n", lena, lenb);
 
-		if(iy<0)
-		    ajFatal("SW: Error walking down");
+    ajStrAssignClear(m);
+    ajStrAssignClear(n);
 
-		++gapcnt;
-	    }
+    *start1 = 0;
+    *start2 = 0;
 
-	    if(bimble<=0.0)
-		break;
+    if(lena < 1 || lenb < 1)
+	return -FLT_MAX;
 
-	    for(ic=0;ic<=gapcnt;++ic)
-	    {
-		ajStrAppendK(m,p[ypos--]);
-		ajStrAppendK(n,'.');
-	    }
-	    continue;
-	}
-	else
-	    ajFatal("Walk Error in SW");
-    }
+    lin = alignLinearNew(a, b, lena, lenb, gapopen, gapextend,
+                         sub, cvt, m, n);
 
-    *start1 = (ajint) (ypos + 1); /* Potential lossy cast */
-    *start2 = (ajint) (xpos + 1); /* Potential lossy cast */
+    ret = alignLinearSWEnd(lin, &ypos, &xpos);
 
-    ajStrReverse(m);            /* written with append, need to reverse */
-    ajStrReverse(n);
+    ajDebug("embAlignPathCalcSWLinear end %d,%d score %.2f\n",
+            ypos, xpos, ret);
 
-    ajDebug("embAlignWalkSWMatrix done\n");
+    border = alignLinearBorderNew(ypos+1, ajTrue);
 
-    return;
+    alignLinearSWSolve(lin, 0, xpos, border, &ypos, &xpos);
+
+    alignLinearBorderDel(&border);
+    alignLinearDel(&lin);
+
+    *start1 = ypos + 1;
+    *start2 = xpos + 1;
+
+    ajStrReverse(m);
+    ajStrReverse(n);
+
+    return ret;
 }
 
 
 
 
-/* @func embAlignWalkNWMatrix *************************************************
+/* @func embAlignBandSeed *****************************************************
 **
-** Walk down a matrix for Needleman Wunsch. Form aligned strings.
-** Nucleotides or proteins as needed.
+** Find the diagonals of a banded global alignment from word matches.
+**
+** The word matches found by embWordBuildMatchIndex are chained in order
+** along both sequences, keeping the chain with the most matched residues,
+** so that isolated matches off the main alignment are ignored.
+** Diagonals are numbered as the position in the second sequence minus
+** the position in the first sequence.
 **
-** @param [r] path [const float*] path matrix
 ** @param [r] a [const AjPSeq] first sequence
 ** @param [r] b [const AjPSeq] second sequence
-** @param [w] m [AjPStr *] alignment for first sequence
-** @param [w] n [AjPStr *] alignment for second sequence
-** @param [r] lena [ajint] length of first sequence
-** @param [r] lenb [ajint] length of second sequence
-** @param [w] start1 [ajint *] start of alignment in first sequence
-** @param [w] start2 [ajint *] start of alignment in second sequence
-** @param [r] gapopen [float] gap open penalty
+** @param [r] wordlen [ajint] word length
+** @param [w] dlo [ajint*] lowest diagonal of the chained matches
+** @param [w] dhi [ajint*] highest diagonal of the chained matches
+**
+** @return [AjBool] True if any word matches were found
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjBool embAlignBandSeed(const AjPSeq a, const AjPSeq b, ajint wordlen,
+                        ajint *dlo, ajint *dhi)
+{
+    EmbPWordIndex index = NULL;
+    AjPList matchlist = NULL;
+    EmbPWordMatch *matches = NULL;
+    ajint *chain;
+    ajint *prev;
+    ajint *treescore;
+    ajint *treeidx;
+    ajint lenb;
+    ajint nmatches;
+    ajint best;
+    ajint score;
+    ajint from;
+    ajint diag;
+    ajint i;
+    ajint k;
+
+    *dlo = 0;
+    *dhi = 0;
+
+    if((ajint) ajSeqGetLen(a) < wordlen || (ajint) ajSeqGetLen(b) < wordlen)
+	return ajFalse;
+
+    embWordLength(wordlen);
+
+    if(!embWordGetIndex(&index, a))
+    {
+	embWordFreeIndex(&index);
+	return ajFalse;
+    }
+
+    matchlist = embWordBuildMatchIndex(index, b, ajTrue);
+    nmatches = (ajint) ajListToarray(matchlist, (void***) &matches);
+
+    if(!nmatches)
+    {
+	embWordMatchListDelete(&matchlist);
+	embWordFreeIndex(&index);
+	return ajFalse;
+    }
+
+    qsort(matches, nmatches, sizeof(EmbPWordMatch), alignBandCompare);
+
+    /*
+    ** Heaviest chain of matches increasing in both sequences.
+    ** The matches are taken in order along the first sequence and a
+    ** tree over positions in the second sequence gives the best chain
+    ** ending before each match.
+    */
+
+    lenb = ajSeqGetLen(b);
+
+    AJCNEW(chain, nmatches);
+    AJCNEW(prev, nmatches);
+    AJCNEW0(treescore, lenb+1);
+    AJCNEW(treeidx, lenb+1);
+
+    best = 0;
+
+    for(i=0;i<nmatches;++i)
+    {
+	score = 0;
+	from  = -1;
+
+	for(k=matches[i]->seq2start;k>0;k-=(k & -k))
+	    if(treescore[k] > score)
+	    {
+		score = treescore[k];
+		from  = treeidx[k];
+	    }
+
+	chain[i] = score + matches[i]->length;
+	prev[i]  = from;
+
+	for(k=matches[i]->seq2start+1;k<=lenb;k+=(k & -k))
+	    if(chain[i] > treescore[k])
+	    {
+		treescore[k] = chain[i];
+		treeidx[k]   = i;
+	    }
+
+	if(chain[i] > chain[best])
+	    best = i;
+    }
+
+    *dlo = (ajint) matches[best]->seq2start - (ajint) matches[best]->seq1start;
+    *dhi = *dlo;
+
+    for(i=best;i>=0;i=prev[i])
+    {
+	diag = (ajint) matches[i]->seq2start - (ajint) matches[i]->seq1start;
+
+	if(diag < *dlo)
+	    *dlo = diag;
+
+	if(diag > *dhi)
+	    *dhi = diag;
+    }
+
+    ajDebug("embAlignBandSeed %d matches chain %d diagonals %d..%d\n",
+            nmatches, chain[best], *dlo, *dhi);
+
+    AJFREE(chain);
+    AJFREE(prev);
+    AJFREE(treescore);
+    AJFREE(treeidx);
+    AJFREE(matches);
+
+    embWordMatchListDelete(&matchlist);
+    embWordFreeIndex(&index);
+
+    return ajTrue;
+}
+
+
+
+
+/* @func embAlignPathCalcBanded ***********************************************
+**
+** Needleman-Wunsch alignment of two sequences within a band of diagonals.
+** Nucleotides or proteins as needed. Supports end gap penalties.
+**
+** Scores are calculated as in embAlignPathCalcWithEndGapPenalties, but
+** only for cells within the band, and the traceback is the same walk.
+** The band always includes the first and last cells. It is widened
+** by ALNBANDMARGIN diagonals on each side.
+**
+** The best score in the band is compared with an upper bound on the
+** score of any alignment that leaves it: the maximum substitution score
+** for each cell on the first diagonal outside, less the smallest gap
+** penalty for each gap needed to get there and back. The band is widened
+** until both bounds are no better than the score, so the score is always
+** the optimal global score. Alignments with equal scores outside the band
+** may be reported differently. Time and memory are proportional to the
+** sequence length times the band width. Without end gap weights any
+** overlap of the sequences can be reached at no cost, so the band is
+** usually widened much further. If the band grows beyond
+** EMBALNLINEARCELLS cells, embAlignPathCalcLinear is used instead.
+**
+** Diagonals are numbered as the position in the second sequence minus
+** the position in the first sequence, as returned by embAlignBandSeed.
+**
+** @param [r] a [const char *] first sequence
+** @param [r] b [const char *] second sequence
+** @param [r] lena [ajint] length of first sequence
+** @param [r] lenb [ajint] length of second sequence
+** @param [r] dlo [ajint] lowest diagonal of the initial band
+** @param [r] dhi [ajint] highest diagonal of the initial band
+** @param [r] gapopen [float] gap opening penalty
 ** @param [r] gapextend [float] gap extension penalty
+** @param [r] endgapopen [float] end gap opening penalty
+** @param [r] endgapextend [float] end gap extension penalty
+** @param [r] sub [float * const *] substitution matrix from AjPMatrixf
+** @param [r] cvt [const AjPSeqCvt] Conversion array for AjPMatrixf
+** @param [r] endweight [AjBool] Use end gap weights
+** @param [w] m [AjPStr *] alignment for first sequence
+** @param [w] n [AjPStr *] alignment for second sequence
+** @param [w] start1 [ajint *] start of alignment in first sequence
+** @param [w] start2 [ajint *] start of alignment in second sequence
+**
+** @return [float] Score
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+float embAlignPathCalcBanded(const char *a, const char *b,
+                             ajint lena, ajint lenb,
+                             ajint dlo, ajint dhi,
+                             float gapopen, float gapextend,
+                             float endgapopen, float endgapextend,
+                             float * const *sub, const AjPSeqCvt cvt,
+                             AjBool endweight,
+                             AjPStr *m, AjPStr *n,
+                             ajint *start1, ajint *start2)
+{
+    AlignPLinear lin;
+    AlignOLinearWalk walk;
+    float *cells;
+    const float *cell;
+    size_t *offset;
+    size_t ncells;
+    double maxsub;
+    double mingap;
+    float score;
+    ajint newlo;
+    ajint newhi;
+    ajint lo;
+    ajint step;
+    ajint i;
+
+    ajDebug("embAlignPathCalcBanded lena:%d lenb:%d band %d..%d\n",
+            lena, lenb, dlo, dhi);
+
+    ajStrAssignClear(m);
+    ajStrAssignClear(n);
+
+    *start1 = 0;
+    *start2 = 0;
+
+    if(!endweight)
+    {
+	endgapopen   = 0.0F;
+	endgapextend = 0.0F;
+    }
+
+    if(lena < 1 || lenb < 1)
+	return 0.0F;
+
+    /* the band must hold the first and last cells */
+
+    dlo = AJMIN(dlo, AJMIN(0, lenb-lena)) - ALNBANDMARGIN;
+    dhi = AJMAX(dhi, AJMAX(0, lenb-lena)) + ALNBANDMARGIN;
+
+    dlo = AJMAX(dlo, 1-lena);
+    dhi = AJMIN(dhi, lenb-1);
+
+    lin = alignLinearNew(a, b, lena, lenb, gapopen, gapextend,
+                         sub, cvt, m, n);
+    lin->Endgapopen   = endgapopen;
+    lin->Endgapextend = endgapextend;
+
+    maxsub = alignBandMaxsub(lin);
+
+    mingap = AJMIN(AJMIN(gapopen, gapextend), AJMIN(endgapopen, endgapextend));
+
+    /* negative gap penalties give no bound, so use the full matrix */
+
+    if(mingap < 0.0)
+    {
+	dlo = 1-lena;
+	dhi = lenb-1;
+    }
+
+    AJCNEW(offset, lena);
+
+    cells = NULL;
+
+    for(;;)
+    {
+	ncells = alignBandOffsets(lena, lenb, dlo, dhi, offset);
+
+	if(ncells/3 > EMBALNLINEARCELLS)
+	    break;
+
+	AJFREE(cells);
+	AJCNEW(cells, ncells);
+
+	alignBandFill(lin, dlo, dhi, offset, cells);
+
+	/*
+	** Widen each side until no alignment through the next diagonal
+	** can beat the score in the band. Scores only improve as the
+	** band grows, so one more pass is normally enough.
+	*/
+
+	score = lin->Score;
+
+	for(newlo=dlo;
+	    newlo > 1-lena &&
+		alignBandBound(lena, lenb, newlo-1, maxsub, mingap) > score;
+	    --newlo);
+
+	for(newhi=dhi;
+	    newhi < lenb-1 &&
+		alignBandBound(lena, lenb, newhi+1, maxsub, mingap) > score;
+	    ++newhi);
+
+	ajDebug("embAlignPathCalcBanded band %d..%d score %.2f widen %d..%d\n",
+		dlo, dhi, score, newlo, newhi);
+
+	if(newlo == dlo && newhi == dhi)
+	    break;
+
+	dlo = newlo;
+	dhi = newhi;
+    }
+
+    if(ncells/3 > EMBALNLINEARCELLS)
+    {
+	ajDebug("embAlignPathCalcBanded band %d..%d too wide, "
+		"using linear space\n", dlo, dhi);
+
+	AJFREE(cells);
+	AJFREE(offset);
+	alignLinearDel(&lin);
+
+	return embAlignPathCalcLinear(a, b, lena, lenb, gapopen, gapextend,
+				      endgapopen, endgapextend, sub, cvt,
+				      ajTrue, m, n, start1, start2);
+    }
+
+    /* the walk starts at the final cell with no previous step */
+
+    walk.Row  = lena-1;
+    walk.Col  = lenb-1;
+    walk.Last = DIAG;
+    walk.Prev = 0.0F;
+
+    while(walk.Row >= 0 && walk.Col >= 0)
+    {
+	lo = AJMAX(0, walk.Row+dlo);
+
+	if(walk.Col < lo || walk.Col > AJMIN(lenb-1, walk.Row+dhi))
+	    ajFatal("Walk Error in banded alignment");
+
+	cell = &cells[offset[walk.Row] + 3*(walk.Col-lo+1)];
+	step = alignLinearNWStep(lin, &walk, cell);
+	alignLinearEmit(lin, walk.Row, walk.Col, step);
+	alignLinearNWNext(&walk, cell, step);
+    }
+
+    for(i=walk.Col;i>=0;--i)
+    {
+	ajStrAppendK(m, '.');
+	ajStrAppendK(n, b[i]);
+    }
+
+    for(i=walk.Row;i>=0;--i)
+    {
+	ajStrAppendK(m, a[i]);
+	ajStrAppendK(n, '.');
+    }
+
+    ajStrReverse(m);
+    ajStrReverse(n);
+
+    score = lin->Score;
+
+    AJFREE(cells);
+    AJFREE(offset);
+    alignLinearDel(&lin);
+
+    return score;
+}
+
+
+
+
+/* @func embAlignWalkSWMatrix *************************************************
+**
+** Walk down a matrix for Smith Waterman. Form aligned strings.
+** Nucleotides or proteins as needed.
+**
+** @param [r] path [const float*] path matrix
 ** @param [r] compass [const ajint*] Path direction pointer array
+** @param [r] gapopen [float] gap opening penalty
+** @param [r] gapextend [float] gap extension penalty
+** @param [r] a [const AjPSeq] first sequence
+** @param [r] b [const AjPSeq] second sequence
+** @param [w] m [AjPStr *] alignment for first sequence
+** @param [w] n [AjPStr *] alignment for second sequence
+** @param [r] lena [ajint] length of first sequence
+** @param [r] lenb [ajint] length of second sequence
+** @param [w] start1 [ajint *] start of alignment in first sequence
+** @param [w] start2 [ajint *] start of alignment in second sequence
 **
 ** @return [void]
 **
 ** @release 1.0.0
 ******************************************************************************/
 
-void embAlignWalkNWMatrix(const float *path, const AjPSeq a, const AjPSeq b,
-			  AjPStr *m,
-			  AjPStr *n, ajint lena, ajint lenb, ajint *start1,
-			  ajint *start2, float gapopen,
-			  float gapextend,
-			  const ajint *compass)
+void embAlignWalkSWMatrix(const float *path, const ajint *compass,
+			  float gapopen, float gapextend,
+                          const AjPSeq a, const AjPSeq b,
+			  AjPStr *m, AjPStr *n,
+                          ajint lena, ajint lenb,
+			  ajint *start1, ajint *start2)
 {
-    ajint i;
-    ajint j;
-    ajint gapcnt;
+    ajlong i;
+    ajlong j;
+    ajlong k;
+    ajlong gapcnt;
     double pmax;
     double score;
     double bimble;
 
-    ajint ix;
-    ajint iy;
+    ajlong ix;
+    ajlong iy;
 
-    ajint xpos = 0;
-    ajint ypos = 0;
+    ajlong xpos = 0;
+    ajlong ypos = 0;
     const char *p;
     const char *q;
 
     ajint ic;
     double errbounds;
 
-    ajDebug("embAlignWalkNWMatrix\n");
+    ajDebug("embAlignWalkSWMatrix\n");
 
-    /*errbounds=gapextend;*/
+    /* errbounds = gapextend; */
     errbounds = (double) 0.01;
 
-    /* Get maximum path axis score and save position */
-    pmax = (double) (-1*INT_MAX);
-
-    for(i=0;i<lenb;++i)
-	if(path[(lena-1)*lenb+i]>=pmax)
-	{
-	    pmax = path[(lena-1)*lenb+i];
-	    xpos = i;
-	    ypos = lena-1;
-	}
+    /* Get maximum path score and save position */
+    pmax = -FLT_MAX;
+    k = (ajlong)lena*(ajlong)lenb-1;
 
-    for(j=0;j<lena;++j)
-	if(path[j*lenb+lenb-1]>pmax)
-	{
-	    pmax = path[j*lenb+lenb-1];
-	    xpos = lenb-1;
-	    ypos = j;
-	}
+    for(i=lena-1; i>=0; --i)
+	for(j=lenb-1; j>=0; --j)
+	    if((path[k--] > pmax) || E_FPEQ(path[k+1],pmax,U_FEPS))
+	    {
+		pmax = path[k+1];
+		xpos = j;
+		ypos = i;
+	    }
 
     ajStrAssignClear(m);
     ajStrAssignClear(n);
@@ -1002,6 +1630,10 @@ void embAlignWalkNWMatrix(const float *path, const AjPSeq a, const AjPSeq b,
 	{
 	    ajStrAppendK(m,p[ypos--]);
 	    ajStrAppendK(n,q[xpos--]);
+
+	    if(ypos >= 0 && xpos>=0 && path[(ypos)*lenb+xpos]<=0.)
+		break;
+
 	    continue;
 	}
 	else if(compass[ypos*lenb+xpos]==LEFT) /* Left, gap(s) in vertical */
@@ -1014,18 +1646,22 @@ void embAlignWalkNWMatrix(const float *path, const AjPSeq a, const AjPSeq b,
 	    {
 		bimble = path[ypos*lenb+ix]-gapopen-(gapcnt*gapextend);
 
-		if(!ix || fabs((double)score-(double)bimble)< errbounds)
+		if(!ix || fabs((double)score-(double)bimble)<errbounds)
 		    break;
 
 		--ix;
 		++gapcnt;
 	    }
 
+	    if(bimble<=0.0)
+		break;
+
 	    for(ic=0;ic<=gapcnt;++ic)
 	    {
 		ajStrAppendK(m,'.');
 		ajStrAppendK(n,q[xpos--]);
 	    }
+
 	    continue;
 	}
 	else if(compass[ypos*lenb+xpos]==DOWN) /* Down, gap(s) in horizontal */
@@ -1036,44 +1672,203 @@ void embAlignWalkNWMatrix(const float *path, const AjPSeq a, const AjPSeq b,
 
 	    while(1)
 	    {
-		bimble = path[iy*lenb+xpos]-gapopen-(gapcnt*gapextend);
+		bimble=path[iy*lenb+xpos]-gapopen-(gapcnt*gapextend);
 
-		if(!iy || fabs((double)score-(double)bimble)< errbounds)
+		if(!iy || fabs((double)score-(double)bimble)<errbounds)
 		    break;
 
 		--iy;
+
+		if(iy<0)
+		    ajFatal("SW: Error walking down");
+
 		++gapcnt;
 	    }
 
+	    if(bimble<=0.0)
+		break;
+
 	    for(ic=0;ic<=gapcnt;++ic)
 	    {
 		ajStrAppendK(m,p[ypos--]);
 		ajStrAppendK(n,'.');
 	    }
-
 	    continue;
 	}
 	else
-	    ajFatal("Walk Error in NW");
-
+	    ajFatal("Walk Error in SW");
     }
 
-    *start2 = xpos+1;
-    *start1 = ypos+1;
+    *start1 = (ajint) (ypos + 1); /* Potential lossy cast */
+    *start2 = (ajint) (xpos + 1); /* Potential lossy cast */
 
     ajStrReverse(m);            /* written with append, need to reverse */
     ajStrReverse(n);
 
+    ajDebug("embAlignWalkSWMatrix done\n");
+
     return;
 }
 
 
 
 
-/* @func embAlignWalkNWMatrixUsingCompass *************************************
+/* @func embAlignWalkNWMatrix *************************************************
 **
-** Walk down a matrix for Needleman Wunsch which was constructed using end gap
-** penalties. Form aligned strings. Nucleotides or proteins as needed.
+** Walk down a matrix for Needleman Wunsch. Form aligned strings.
+** Nucleotides or proteins as needed.
+**
+** @param [r] path [const float*] path matrix
+** @param [r] a [const AjPSeq] first sequence
+** @param [r] b [const AjPSeq] second sequence
+** @param [w] m [AjPStr *] alignment for first sequence
+** @param [w] n [AjPStr *] alignment for second sequence
+** @param [r] lena [ajint] length of first sequence
+** @param [r] lenb [ajint] length of second sequence
+** @param [w] start1 [ajint *] start of alignment in first sequence
+** @param [w] start2 [ajint *] start of alignment in second sequence
+** @param [r] gapopen [float] gap open penalty
+** @param [r] gapextend [float] gap extension penalty
+** @param [r] compass [const ajint*] Path direction pointer array
+**
+** @return [void]
+**
+** @release 1.0.0
+******************************************************************************/
+
+void embAlignWalkNWMatrix(const float *path, const AjPSeq a, const AjPSeq b,
+			  AjPStr *m,
+			  AjPStr *n, ajint lena, ajint lenb, ajint *start1,
+			  ajint *start2, float gapopen,
+			  float gapextend,
+			  const ajint *compass)
+{
+    ajint i;
+    ajint j;
+    ajint gapcnt;
+    double pmax;
+    double score;
+    double bimble;
+
+    ajint ix;
+    ajint iy;
+
+    ajint xpos = 0;
+    ajint ypos = 0;
+    const char *p;
+    const char *q;
+
+    ajint ic;
+    double errbounds;
+
+    ajDebug("embAlignWalkNWMatrix\n");
+
+    /*errbounds=gapextend;*/
+    errbounds = (double) 0.01;
+
+    /* Get maximum path axis score and save position */
+    pmax = (double) (-1*INT_MAX);
+
+    for(i=0;i<lenb;++i)
+	if(path[(lena-1)*lenb+i]>=pmax)
+	{
+	    pmax = path[(lena-1)*lenb+i];
+	    xpos = i;
+	    ypos = lena-1;
+	}
+
+    for(j=0;j<lena;++j)
+	if(path[j*lenb+lenb-1]>pmax)
+	{
+	    pmax = path[j*lenb+lenb-1];
+	    xpos = lenb-1;
+	    ypos = j;
+	}
+
+    ajStrAssignClear(m);
+    ajStrAssignClear(n);
+
+    p = ajSeqGetSeqC(a);
+    q = ajSeqGetSeqC(b);
+
+    while(xpos>=0 && ypos>=0)
+    {
+	if(!compass[ypos*lenb+xpos])	/* diagonal */
+	{
+	    ajStrAppendK(m,p[ypos--]);
+	    ajStrAppendK(n,q[xpos--]);
+	    continue;
+	}
+	else if(compass[ypos*lenb+xpos]==LEFT) /* Left, gap(s) in vertical */
+	{
+	    score  = path[ypos*lenb+xpos];
+	    gapcnt = 0;
+	    ix     = xpos-1;
+
+	    while(1)
+	    {
+		bimble = path[ypos*lenb+ix]-gapopen-(gapcnt*gapextend);
+
+		if(!ix || fabs((double)score-(double)bimble)< errbounds)
+		    break;
+
+		--ix;
+		++gapcnt;
+	    }
+
+	    for(ic=0;ic<=gapcnt;++ic)
+	    {
+		ajStrAppendK(m,'.');
+		ajStrAppendK(n,q[xpos--]);
+	    }
+	    continue;
+	}
+	else if(compass[ypos*lenb+xpos]==DOWN) /* Down, gap(s) in horizontal */
+	{
+	    score  = path[ypos*lenb+xpos];
+	    gapcnt = 0;
+	    iy = ypos-1;
+
+	    while(1)
+	    {
+		bimble = path[iy*lenb+xpos]-gapopen-(gapcnt*gapextend);
+
+		if(!iy || fabs((double)score-(double)bimble)< errbounds)
+		    break;
+
+		--iy;
+		++gapcnt;
+	    }
+
+	    for(ic=0;ic<=gapcnt;++ic)
+	    {
+		ajStrAppendK(m,p[ypos--]);
+		ajStrAppendK(n,'.');
+	    }
+
+	    continue;
+	}
+	else
+	    ajFatal("Walk Error in NW");
+
+    }
+
+    *start2 = xpos+1;
+    *start1 = ypos+1;
+
+    ajStrReverse(m);            /* written with append, need to reverse */
+    ajStrReverse(n);
+
+    return;
+}
+
+
+
+
+/* @func embAlignWalkNWMatrixUsingCompass *************************************
+**
+** Walk down a matrix for Needleman Wunsch which was constructed using end gap
+** penalties. Form aligned strings. Nucleotides or proteins as needed.
 **
 ** @param [r] p [const char*] first sequence
 ** @param [r] q [const char*] second sequence
@@ -1609,6 +2404,8 @@ float embAlignPathCalcSWFast(const char *a, const char *b,
     float fnew;
     float *maxa;
     float bx = 0.0F;
+    ajint *bcode;
+    const float *subrow;
 
     ajint width;
     ajint leftwidth;
@@ -1667,8 +2464,18 @@ float embAlignPathCalcSWFast(const char *a, const char *b,
     ajDebug("b: '%s'\n", b);
     
 
-    /* Create stores for the maximum values in a row or column */
-    maxa = AJALLOC((xmax+1)*sizeof(float));
+    /*
+    ** Create stores for the maximum values in a row or column
+    ** Columns entering the band at its edges are read before they are set,
+    ** so start them at zero (no gap) rather than leaving them undefined
+    */
+    AJCNEW0(maxa, xmax+1);
+
+    /* Look up the substitution matrix codes once for each position */
+    bcode = AJALLOC(lenb*sizeof(ajint));
+
+    for(j=0;j<lenb;++j)
+        bcode[j] = ajSeqcvtGetCodeK(cvt,b[j]);
 
     /* TODO: in the following 2 loops we miss the cases when it is possible
      * to have gaps just after the first base
@@ -1751,6 +2558,7 @@ float embAlignPathCalcSWFast(const char *a, const char *b,
     {
         ip = irow*width-1;
         icol = xmin++;
+        subrow = sub[ajSeqcvtGetCodeK(cvt,a[irow])];
 
         for(i=0;i<width;i++)
         {
@@ -1762,15 +2570,16 @@ float embAlignPathCalcSWFast(const char *a, const char *b,
             if(icol >= xmax)
                 break;
 
-            match = sub[ajSeqcvtGetCodeK(cvt,a[irow])]
-                       [ajSeqcvtGetCodeK(cvt,b[icol])];
+            match = subrow[bcode[icol]];
 
 	    /* Get diag score */
 	    mscore = path[ip-width] + match;
 
+#ifdef TESTALL
             ajDebug("match %4.1f irow:%d icol:%d i:%d ip:%2d a:%c b:%c "
         	    "mscore: %4.2f bx: %4.2f\n",
         	    match, irow, icol, i, ip, a[irow], b[icol], mscore, bx);
+#endif
 
             if(mscore < 0.0)
                 mscore = 0.0;
@@ -1876,6 +2685,7 @@ float embAlignPathCalcSWFast(const char *a, const char *b,
     }
 
     AJFREE(maxa);
+    AJFREE(bcode);
 
     return ret;
 }
@@ -2133,7 +2943,7 @@ float embAlignProfilePathCalc(const char *a, ajint proflen, ajint seqlen,
 
     ajint column;		        /* sequence position in path */
 
-    static AjPStr outstr = NULL;
+    AjPStr outstr = NULL;
 
     double fmscore;
     double mscore;
@@ -2239,7 +3049,7 @@ float embAlignProfilePathCalc(const char *a, ajint proflen, ajint seqlen,
     {
 	for(row=proflen-1;row>-1;--row)
 	{
-	    ajStrDelStatic(&outstr);
+	    ajStrAssignClear(&outstr);
 
 	    for(column=0;column<seqlen;++column)
 		ajFmtPrintAppS(&outstr,"%6.2f ",
@@ -2249,7 +3059,7 @@ float embAlignProfilePathCalc(const char *a, ajint proflen, ajint seqlen,
     }
 
 
-    ajStrDelStatic(&outstr);
+    ajStrDel(&outstr);
     AJFREE(maxs);
 
     return ret;
@@ -3297,6 +4107,1729 @@ static void printPathMatrix(const float* path, const ajint* compass,
 
 
 
+/* @funcstatic alignLinearNew *************************************************
+**
+** Constructor for a linear space alignment workspace
+**
+** @param [r] a [const char *] first sequence
+** @param [r] b [const char *] second sequence
+** @param [r] lena [ajint] length of first sequence
+** @param [r] lenb [ajint] length of second sequence
+** @param [r] gapopen [float] gap opening penalty
+** @param [r] gapextend [float] gap extension penalty
+** @param [r] sub [float * const *] substitution matrix from AjPMatrixf
+** @param [r] cvt [const AjPSeqCvt] Conversion array for AjPMatrixf
+** @param [u] m [AjPStr *] alignment for first sequence
+** @param [u] n [AjPStr *] alignment for second sequence
+**
+** @return [AlignPLinear] New workspace
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static AlignPLinear alignLinearNew(const char *a, const char *b,
+                                   ajint lena, ajint lenb,
+                                   float gapopen, float gapextend,
+                                   float * const *sub, const AjPSeqCvt cvt,
+                                   AjPStr *m, AjPStr *n)
+{
+    AlignPLinear ret;
+    ajint i;
+
+    AJNEW0(ret);
+
+    ret->A    = a;
+    ret->B    = b;
+    ret->Lena = lena;
+    ret->Lenb = lenb;
+    ret->Sub  = sub;
+    ret->M    = m;
+    ret->N    = n;
+
+    ret->Gapopen   = gapopen;
+    ret->Gapextend = gapextend;
+
+    AJCNEW(ret->Acode, lena);
+    AJCNEW(ret->Bcode, lenb);
+    AJCNEW0(ret->Col0, lena);
+    AJCNEW0(ret->Row0, lenb);
+
+    for(i=0;i<lena;++i)
+	ret->Acode[i] = ajSeqcvtGetCodeK(cvt, a[i]);
+
+    for(i=0;i<lenb;++i)
+	ret->Bcode[i] = ajSeqcvtGetCodeK(cvt, b[i]);
+
+    ajStrSetRes(m, lena+lenb+1);
+    ajStrSetRes(n, lena+lenb+1);
+
+    return ret;
+}
+
+
+
+
+/* @funcstatic alignLinearDel *************************************************
+**
+** Destructor for a linear space alignment workspace
+**
+** @param [d] Plin [AlignPLinear*] Workspace
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void alignLinearDel(AlignPLinear *Plin)
+{
+    AlignPLinear lin;
+
+    lin = *Plin;
+
+    if(!lin)
+	return;
+
+    AJFREE(lin->Acode);
+    AJFREE(lin->Bcode);
+    AJFREE(lin->Col0);
+    AJFREE(lin->Row0);
+
+    AJFREE(*Plin);
+
+    return;
+}
+
+
+
+
+/* @funcstatic alignLinearEmit ************************************************
+**
+** Append one traceback step to the alignment, which is built in reverse
+**
+** @param [u] lin [AlignPLinear] Workspace
+** @param [r] i [ajint] Position in first sequence
+** @param [r] j [ajint] Position in second sequence
+** @param [r] step [ajint] DIAG, LEFT (gap in first sequence)
+**                         or DOWN (gap in second sequence)
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void alignLinearEmit(AlignPLinear lin, ajint i, ajint j, ajint step)
+{
+    if(step == LEFT)
+	ajStrAppendK(lin->M, '.');
+    else
+	ajStrAppendK(lin->M, lin->A[i]);
+
+    if(step == DOWN)
+	ajStrAppendK(lin->N, '.');
+    else
+	ajStrAppendK(lin->N, lin->B[j]);
+
+    return;
+}
+
+
+
+
+/* @funcstatic alignLinearNWRow ***********************************************
+**
+** Calculate the match and gap scores of one row of a global alignment,
+** between two columns, from the previous row and the cell to the left.
+**
+** The scores are exactly those stored by
+** embAlignPathCalcWithEndGapPenalties, including the initialisation of
+** the first row and column. Scores for each cell are stored as DIAG, LEFT
+** and DOWN, with the cell to the left of the first column first.
+**
+** The score of the final cell is saved in the workspace.
+**
+** @param [u] lin [AlignPLinear] Workspace
+** @param [r] i [ajint] Row (position in first sequence)
+** @param [r] c1 [ajint] First column
+** @param [r] c2 [ajint] Last column
+** @param [r] up [const float*] Previous row, from column c1-1,
+**                              NULL for the first row
+** @param [r] left [const float*] Cell in column c1-1,
+**                                NULL for the first column
+** @param [w] row [float*] Scores from column c1-1
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void alignLinearNWRow(AlignPLinear lin, ajint i,
+                             ajint c1, ajint c2,
+                             const float *up, const float *left,
+                             float *row)
+{
+    const float *subrow;
+    float *cell;
+    const float *lp;
+    float match;
+    float testog;
+    float testeg;
+    float mp;
+    float ixp;
+    float iyp;
+    float eo;
+    float ee;
+    float go;
+    float ge;
+    ajint lena;
+    ajint lenb;
+    ajint j;
+    ajint k;
+
+    lena = lin->Lena;
+    lenb = lin->Lenb;
+    eo = lin->Endgapopen;
+    ee = lin->Endgapextend;
+    go = lin->Gapopen;
+    ge = lin->Gapextend;
+
+    subrow = lin->Sub[lin->Acode[i]];
+
+    if(left)
+    {
+	row[DIAG] = left[DIAG];
+	row[LEFT] = left[LEFT];
+	row[DOWN] = left[DOWN];
+    }
+
+    for(j=c1, k=1; j<=c2; ++j, ++k)
+    {
+	match = subrow[lin->Bcode[j]];
+	cell = &row[3*k];
+	lp   = &row[3*(k-1)];
+
+	if(!i && !j)
+	{
+	    cell[DIAG] = match;
+	    cell[LEFT] = -eo-go;
+	    cell[DOWN] = -eo-go;
+
+	    if(lena == 1)
+	    {
+		cell[LEFT] -= eo;
+		cell[LEFT] += go;
+	    }
+
+	    if(lenb == 1)
+	    {
+		cell[DOWN] -= eo;
+		cell[DOWN] += go;
+	    }
+	}
+	else if(!i)
+	{
+	    testog = lp[DIAG] - go;
+	    testeg = lp[LEFT] - ge;
+
+	    if(testog >= testeg)
+		cell[LEFT] = testog;
+	    else
+		cell[LEFT] = testeg;
+
+	    cell[DIAG] = match - (eo + (j - 1) * ee);
+	    cell[DOWN] = -eo - j * ee - go;
+
+	    if(j == lenb-1)
+	    {
+		cell[DOWN] -= eo;
+		cell[DOWN] += go;
+	    }
+	}
+	else if(!j)
+	{
+	    /*
+	    ** the first column is calculated before the end gap
+	    ** is applied to a single residue second sequence
+	    */
+
+	    iyp = up[3*k+DOWN];
+
+	    if(i == 1 && lenb == 1)
+		iyp = -eo-go;
+
+	    testog = up[3*k+DIAG] - go;
+	    testeg = iyp - ge;
+
+	    if(testog >= testeg)
+		cell[DOWN] = testog;
+	    else
+		cell[DOWN] = testeg;
+
+	    cell[DIAG] = match - (eo + (i - 1) * ee);
+	    cell[LEFT] = -eo - i * ee - go;
+
+	    if(i == lena-1)
+	    {
+		cell[LEFT] -= eo;
+		cell[LEFT] += go;
+	    }
+	}
+	else
+	{
+	    mp  = up[3*(k-1)+DIAG];
+	    ixp = up[3*(k-1)+LEFT];
+	    iyp = up[3*(k-1)+DOWN];
+
+	    if(mp > ixp && mp > iyp)
+		cell[DIAG] = mp+match;
+	    else if(ixp > iyp)
+		cell[DIAG] = ixp+match;
+	    else
+		cell[DIAG] = iyp+match;
+
+	    if(j == lenb-1)
+	    {
+		testog = up[3*k+DIAG] - eo;
+		testeg = up[3*k+DOWN] - ee;
+	    }
+	    else
+	    {
+		testog = up[3*k+DIAG];
+
+		if(testog < up[3*k+LEFT])
+		    testog = up[3*k+LEFT];
+
+		testog -= go;
+		testeg = up[3*k+DOWN] - ge;
+	    }
+
+	    if(testog > testeg)
+		cell[DOWN] = testog;
+	    else
+		cell[DOWN] = testeg;
+
+	    if(i == lena-1)
+	    {
+		testog = lp[DIAG] - eo;
+		testeg = lp[LEFT] - ee;
+	    }
+	    else
+	    {
+		testog = lp[DIAG];
+
+		if(testog < lp[DOWN])
+		    testog = lp[DOWN];
+
+		testog -= go;
+		testeg = lp[LEFT] - ge;
+	    }
+
+	    if(testog > testeg)
+		cell[LEFT] = testog;
+	    else
+		cell[LEFT] = testeg;
+	}
+
+	if(i == lena-1 && j == lenb-1)
+	{
+	    /* as embAlignGetScoreNWMatrix */
+	    if(cell[DIAG] > cell[LEFT] && cell[DIAG] > cell[DOWN])
+		lin->Score = cell[DIAG];
+	    else if(cell[LEFT] > cell[DOWN])
+		lin->Score = cell[LEFT];
+	    else
+		lin->Score = cell[DOWN];
+	}
+    }
+
+    return;
+}
+
+
+
+
+/* @funcstatic alignLinearNWStep **********************************************
+**
+** Choose the next traceback step of a global alignment, as in
+** embAlignPathCalcWithEndGapPenalties
+**
+** @param [r] lin [const AlignPLinear] Workspace
+** @param [r] walk [const AlignPLinearWalk] Current position
+** @param [r] cell [const float*] Scores of the current cell
+**
+** @return [ajint] DIAG, LEFT or DOWN
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static ajint alignLinearNWStep(const AlignPLinear lin,
+                               const AlignPLinearWalk walk,
+                               const float *cell)
+{
+    float gap;
+    float diff;
+    float mp;
+    ajint ypos;
+    ajint xpos;
+
+    ypos = walk->Row;
+    xpos = walk->Col;
+    mp = cell[DIAG];
+
+    if(walk->Last == LEFT)
+    {
+	gap = (ypos==0 || ypos==lin->Lena-1) ?
+	    lin->Endgapextend : lin->Gapextend;
+	diff = cell[LEFT] - walk->Prev;
+
+	if(E_FPEQ(gap, diff, U_FEPS))
+	    return LEFT;
+    }
+    else if(walk->Last == DOWN)
+    {
+	gap = (xpos==0 || xpos==lin->Lenb-1) ?
+	    lin->Endgapextend : lin->Gapextend;
+	diff = cell[DOWN] - walk->Prev;
+
+	if(E_FPEQ(gap, diff, U_FEPS))
+	    return DOWN;
+    }
+
+    if(mp >= cell[LEFT] && mp >= cell[DOWN])
+    {
+	if(walk->Last == LEFT && E_FPEQ(mp, cell[LEFT], U_FEPS))
+	    return LEFT;
+
+	if(walk->Last == DOWN && E_FPEQ(mp, cell[DOWN], U_FEPS))
+	    return DOWN;
+
+	return DIAG;
+    }
+
+    if(cell[LEFT] >= cell[DOWN])
+	return LEFT;
+
+    return DOWN;
+}
+
+
+
+
+/* @funcstatic alignLinearNWNext **********************************************
+**
+** Move a global alignment traceback walk by one step
+**
+** @param [u] walk [AlignPLinearWalk] Position
+** @param [r] cell [const float*] Scores of the current cell
+** @param [r] step [ajint] DIAG, LEFT or DOWN
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void alignLinearNWNext(AlignPLinearWalk walk, const float *cell,
+                              ajint step)
+{
+    walk->Last = step;
+    walk->Prev = 0.0F;
+
+    if(step == DIAG)
+    {
+	walk->Row--;
+	walk->Col--;
+    }
+    else if(step == LEFT)
+    {
+	walk->Prev = cell[LEFT];
+	walk->Col--;
+    }
+    else
+    {
+	walk->Prev = cell[DOWN];
+	walk->Row--;
+    }
+
+    return;
+}
+
+
+
+
+/* @funcstatic alignLinearNWSolve *********************************************
+**
+** Follow the global alignment traceback through a block of the path
+** matrix, appending each step to the alignment.
+**
+** Scores are calculated down to the middle row. Below it, the first
+** position each traceback would reach in the middle row, or to the left
+** of the block, is carried forward from row to row for each cell and
+** previous step. That gives the end of the traceback in the lower half,
+** which is solved first, and the start of the traceback in the upper half.
+**
+** @param [u] lin [AlignPLinear] Workspace
+** @param [r] r1 [ajint] First row
+** @param [r] r2 [ajint] Last row
+** @param [r] c1 [ajint] First column
+** @param [r] c2 [ajint] Last column
+** @param [r] top [const float*] Row r1-1 from column c1-1,
+**                               NULL for the first row
+** @param [r] left [const float*] Column c1-1 from row r1-1,
+**                                NULL for the first column
+** @param [u] walk [AlignPLinearWalk] Position in row r2 and column c2,
+**                                    returned as the first position
+**                                    outside the block
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void alignLinearNWSolve(AlignPLinear lin,
+                               ajint r1, ajint r2, ajint c1, ajint c2,
+                               const float *top, const float *left,
+                               AlignPLinearWalk walk)
+{
+    float *midrow;
+    float *prev;
+    float *cur;
+    float *next;
+    float *swap;
+    float *nleft = NULL;
+    const float *bleft = NULL;
+    const float *up;
+    AlignPLinearWalk eprev;
+    AlignPLinearWalk ecur;
+    AlignPLinearWalk eswap;
+    AlignPLinearWalk out;
+    AlignOLinearWalk pos;
+    AlignOLinearWalk exit;
+    ajint rows;
+    ajint cols;
+    ajint rmid;
+    ajint cmid;
+    ajint i;
+    ajint j;
+    ajint k;
+    ajint s;
+
+    rows = r2 - r1 + 1;
+    cols = c2 - c1 + 1;
+
+    if(rows <= 2 || (ajlong) rows * cols <= ALNLINEARBASE)
+    {
+	alignLinearNWBase(lin, r1, r2, c1, c2, top, left, walk);
+	return;
+    }
+
+    rmid = r1 + (rows - 1) / 2;
+
+    AJCNEW(prev, 3*(cols+1));
+    AJCNEW(cur, 3*(cols+1));
+    AJCNEW(next, 3*(cols+1));
+    AJCNEW(midrow, 3*(cols+1));
+    AJCNEW(eprev, 3*cols);
+    AJCNEW(ecur, 3*cols);
+
+    /* scores down to the middle row */
+
+    up = top;
+
+    for(i=r1;i<=rmid;++i)
+    {
+	alignLinearNWRow(lin, i, c1, c2, up,
+			 left ? &left[3*(i-r1+1)] : NULL, cur);
+	swap = prev;
+	prev = cur;
+	cur  = swap;
+	up   = prev;
+    }
+
+    memcpy(midrow, prev, 3*(cols+1)*sizeof(float));
+
+    /*
+    ** where the traceback leaves the lower half from each position.
+    ** Steps from a cell depend on the row below, so each row is done
+    ** once the next row is calculated.
+    */
+
+    alignLinearNWRow(lin, rmid+1, c1, c2, midrow,
+		     left ? &left[3*(rmid-r1+2)] : NULL, cur);
+
+    for(i=rmid+1;i<=r2;++i)
+    {
+	if(i < r2)
+	    alignLinearNWRow(lin, i+1, c1, c2, cur,
+			     left ? &left[3*(i-r1+2)] : NULL, next);
+
+	for(j=c1, k=1; j<=c2; ++j, ++k)
+	{
+	    for(s=DIAG;s<=DOWN;++s)
+	    {
+		if((s == LEFT && j == c2) || (s == DOWN && i == r2))
+		    continue;
+
+		pos.Row  = i;
+		pos.Col  = j;
+		pos.Last = s;
+
+		if(s == LEFT)
+		    pos.Prev = cur[3*(k+1)+LEFT];
+		else if(s == DOWN)
+		    pos.Prev = next[3*k+DOWN];
+		else
+		    pos.Prev = 0.0F;
+
+		out = &ecur[3*(k-1)+s];
+		alignLinearNWNext(&pos, &cur[3*k],
+				  alignLinearNWStep(lin, &pos, &cur[3*k]));
+
+		if(pos.Row == rmid || pos.Col < c1)
+		    *out = pos;
+		else if(pos.Row == i)
+		    *out = ecur[3*(pos.Col-c1)+LEFT];
+		else
+		    *out = eprev[3*(pos.Col-c1)+pos.Last];
+	    }
+	}
+
+	if(i < r2)
+	{
+	    eswap = eprev;
+	    eprev = ecur;
+	    ecur  = eswap;
+
+	    swap = cur;
+	    cur  = next;
+	    next = swap;
+	}
+    }
+
+    /* follow the walk from its current position in the last row */
+
+    pos = *walk;
+    alignLinearNWNext(&pos, &cur[3*cols],
+		      alignLinearNWStep(lin, &pos, &cur[3*cols]));
+
+    if(pos.Row == rmid || pos.Col < c1)
+	exit = pos;
+    else if(pos.Row == r2)
+	exit = ecur[3*(pos.Col-c1)+LEFT];
+    else
+	exit = eprev[3*(pos.Col-c1)+pos.Last];
+
+    AJFREE(eprev);
+    AJFREE(ecur);
+
+    /* first column of the lower half */
+
+    if(exit.Row == rmid)
+	cmid = exit.Col + ((exit.Last == DIAG) ? 1 : 0);
+    else
+	cmid = c1;
+
+    if(cmid == c1)
+    {
+	if(left)
+	    bleft = &left[3*(rmid-r1+1)];
+    }
+    else
+    {
+	AJCNEW(nleft, 3*(r2-rmid+1));
+	memcpy(nleft, &midrow[3*(cmid-c1)], 3*sizeof(float));
+
+	up = midrow;
+
+	for(i=rmid+1;i<=r2;++i)
+	{
+	    alignLinearNWRow(lin, i, c1, cmid-1, up,
+			     left ? &left[3*(i-r1+1)] : NULL, cur);
+	    memcpy(&nleft[3*(i-rmid)], &cur[3*(cmid-c1)], 3*sizeof(float));
+	    swap = prev;
+	    prev = cur;
+	    cur  = swap;
+	    up   = prev;
+	}
+
+	bleft = nleft;
+    }
+
+    AJFREE(prev);
+    AJFREE(cur);
+    AJFREE(next);
+
+    alignLinearNWSolve(lin, rmid+1, r2, cmid, c2,
+		       &midrow[3*(cmid-c1)], bleft, walk);
+
+    AJFREE(nleft);
+
+    AJFREE(midrow);
+
+    if(walk->Row != exit.Row || walk->Col != exit.Col)
+	ajFatal("Walk Error in linear space alignment");
+
+    if(walk->Row == rmid && walk->Col >= c1)
+	alignLinearNWSolve(lin, r1, rmid, c1, walk->Col, top, left, walk);
+
+    return;
+}
+
+
+
+
+/* @funcstatic alignLinearNWBase **********************************************
+**
+** Follow the global alignment traceback through a block of the path
+** matrix small enough to calculate in full, appending each step to the
+** alignment.
+**
+** @param [u] lin [AlignPLinear] Workspace
+** @param [r] r1 [ajint] First row
+** @param [r] r2 [ajint] Last row
+** @param [r] c1 [ajint] First column
+** @param [r] c2 [ajint] Last column
+** @param [r] top [const float*] Row r1-1 from column c1-1,
+**                               NULL for the first row
+** @param [r] left [const float*] Column c1-1 from row r1-1,
+**                                NULL for the first column
+** @param [u] walk [AlignPLinearWalk] Position in row r2 and column c2,
+**                                    returned as the first position
+**                                    outside the block
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void alignLinearNWBase(AlignPLinear lin,
+                              ajint r1, ajint r2, ajint c1, ajint c2,
+                              const float *top, const float *left,
+                              AlignPLinearWalk walk)
+{
+    float *block;
+    const float *cell;
+    size_t width;
+    ajint i;
+    ajint step;
+
+    width = 3 * (size_t) (c2 - c1 + 2);
+
+    AJCNEW(block, (size_t) (r2 - r1 + 1) * width);
+
+    for(i=r1;i<=r2;++i)
+	alignLinearNWRow(lin, i, c1, c2,
+			 (i == r1) ? top : &block[(i-r1-1)*width],
+			 left ? &left[3*(i-r1+1)] : NULL,
+			 &block[(i-r1)*width]);
+
+    while(walk->Row >= r1 && walk->Col >= c1)
+    {
+	cell = &block[(walk->Row-r1)*width + 3*(walk->Col-c1+1)];
+	step = alignLinearNWStep(lin, walk, cell);
+	alignLinearEmit(lin, walk->Row, walk->Col, step);
+	alignLinearNWNext(walk, cell, step);
+    }
+
+    AJFREE(block);
+
+    return;
+}
+
+
+
+
+/* @funcstatic alignLinearBorderNew *******************************************
+**
+** Constructor for the local alignment scores of one column
+**
+** @param [r] rows [ajint] Number of rows
+** @param [r] gaps [AjBool] Keep gap starts for the traceback
+**
+** @return [AlignPLinearBorder] New column scores before the first column
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static AlignPLinearBorder alignLinearBorderNew(ajint rows, AjBool gaps)
+{
+    AlignPLinearBorder ret;
+
+    AJNEW0(ret);
+
+    ret->Rows = rows;
+    ret->Col  = -1;
+
+    AJCNEW0(ret->Path, rows);
+    AJCNEW0(ret->Maxa, rows);
+
+    if(gaps)
+    {
+	ret->Keep = 2;
+	AJCNEW0(ret->Num, rows);
+	AJCNEW0(ret->Gapcol, (size_t) rows * ret->Keep);
+	AJCNEW0(ret->Gappath, (size_t) rows * ret->Keep);
+    }
+
+    return ret;
+}
+
+
+
+
+/* @funcstatic alignLinearBorderClone *****************************************
+**
+** Copy the first rows of the local alignment scores of a column
+**
+** @param [r] border [const AlignPLinearBorder] Column scores
+** @param [r] rows [ajint] Number of rows to copy
+**
+** @return [AlignPLinearBorder] New column scores
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static AlignPLinearBorder alignLinearBorderClone(
+    const AlignPLinearBorder border, ajint rows)
+{
+    AlignPLinearBorder ret;
+    size_t size;
+
+    AJNEW0(ret);
+
+    ret->Rows = rows;
+    ret->Keep = border->Keep;
+    ret->Col  = border->Col;
+    ret->Comp = border->Comp;
+
+    AJCNEW(ret->Path, rows);
+    AJCNEW(ret->Maxa, rows);
+    memcpy(ret->Path, border->Path, rows*sizeof(float));
+    memcpy(ret->Maxa, border->Maxa, rows*sizeof(double));
+
+    if(border->Num)
+    {
+	size = (size_t) rows * ret->Keep;
+	AJCNEW(ret->Num, rows);
+	AJCNEW(ret->Gapcol, size);
+	AJCNEW(ret->Gappath, size);
+	memcpy(ret->Num, border->Num, rows*sizeof(ajint));
+	memcpy(ret->Gapcol, border->Gapcol, size*sizeof(ajint));
+	memcpy(ret->Gappath, border->Gappath, size*sizeof(float));
+    }
+
+    return ret;
+}
+
+
+
+
+/* @funcstatic alignLinearBorderDel *******************************************
+**
+** Destructor for the local alignment scores of a column
+**
+** @param [d] Pborder [AlignPLinearBorder*] Column scores
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void alignLinearBorderDel(AlignPLinearBorder *Pborder)
+{
+    AlignPLinearBorder border;
+
+    border = *Pborder;
+
+    if(!border)
+	return;
+
+    AJFREE(border->Path);
+    AJFREE(border->Maxa);
+    AJFREE(border->Num);
+    AJFREE(border->Gapcol);
+    AJFREE(border->Gappath);
+
+    AJFREE(*Pborder);
+
+    return;
+}
+
+
+
+
+/* @funcstatic alignLinearBorderPush ******************************************
+**
+** Add a cell as a possible gap start for later columns in its row.
+**
+** Gap starts below a later gap start in the same row are never found by
+** the search in embAlignWalkSWMatrix, which looks for the nearest match.
+** Gap starts more than ALNLINEARSLACK below the best in the row cannot
+** match the score of a horizontal gap.
+**
+** @param [u] border [AlignPLinearBorder] Column scores
+** @param [r] i [ajint] Row
+** @param [r] j [ajint] Column
+** @param [r] path [float] Path score
+** @param [r] gapextend [float] Gap extension penalty
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void alignLinearBorderPush(AlignPLinearBorder border,
+                                  ajint i, ajint j, float path,
+                                  float gapextend)
+{
+    ajint *gapcol;
+    float *gappath;
+    double score;
+    size_t base;
+    ajint keep;
+    ajint num;
+    ajint k;
+
+    score = (double) path + (double) j * gapextend;
+
+    base = (size_t) i * border->Keep;
+    num  = border->Num[i];
+
+    if(num && score < (double) border->Gappath[base] +
+       (double) border->Gapcol[base] * gapextend - ALNLINEARSLACK)
+	return;
+
+    while(num && (double) border->Gappath[base+num-1] +
+	  (double) border->Gapcol[base+num-1] * gapextend <= score)
+	--num;
+
+    if(num == border->Keep)
+    {
+	keep = 2 * border->Keep;
+
+	AJCNEW(gapcol, (size_t) border->Rows * keep);
+	AJCNEW(gappath, (size_t) border->Rows * keep);
+
+	for(k=0;k<border->Rows;++k)
+	{
+	    memcpy(&gapcol[(size_t) k * keep],
+		   &border->Gapcol[(size_t) k * border->Keep],
+		   border->Num[k]*sizeof(ajint));
+	    memcpy(&gappath[(size_t) k * keep],
+		   &border->Gappath[(size_t) k * border->Keep],
+		   border->Num[k]*sizeof(float));
+	}
+
+	AJFREE(border->Gapcol);
+	AJFREE(border->Gappath);
+
+	border->Gapcol  = gapcol;
+	border->Gappath = gappath;
+	border->Keep    = keep;
+
+	base = (size_t) i * keep;
+    }
+
+    border->Gapcol[base+num]  = j;
+    border->Gappath[base+num] = path;
+    border->Num[i] = num + 1;
+
+    return;
+}
+
+
+
+
+/* @funcstatic alignLinearSWColumn ********************************************
+**
+** Calculate the next column of a local alignment path matrix.
+**
+** The recurrences, including the initialisation of the first row and
+** column, are those of embAlignPathCalcSW so the scores are identical.
+**
+** @param [r] lin [const AlignPLinear] Workspace
+** @param [r] j [ajint] Column (position in second sequence)
+** @param [u] border [AlignPLinearBorder] Scores of the previous column,
+**                                        replaced by this column
+** @param [w] comp [ajint*] Path directions for this column, or NULL
+** @param [u] ret [float*] Maximum score, or NULL
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void alignLinearSWColumn(const AlignPLinear lin, ajint j,
+                                AlignPLinearBorder border,
+                                ajint *comp, float *ret)
+{
+    float *path;
+    double *maxa;
+    float gapopen;
+    float gapextend;
+    float diag;
+    double match;
+    double mscore;
+    double result;
+    double fnew;
+    double bx;
+    ajint rows;
+    ajint i;
+    ajint c;
+    ajint prevc;
+
+    path = border->Path;
+    maxa = border->Maxa;
+    rows = border->Rows;
+    gapopen   = lin->Gapopen;
+    gapextend = lin->Gapextend;
+
+    border->Col = j;
+
+    if(!j)
+    {
+	c = 0;
+
+	for(i=0;i<rows;++i)
+	{
+	    result = lin->Sub[lin->Acode[i]][lin->Bcode[0]];
+
+	    fnew = i==0 ? 0. :
+		path[i-1] -(c==DOWN ? gapextend : gapopen);
+
+	    prevc = c;
+
+	    if(result > fnew && result > 0)
+	    {
+		path[i] = (float) result;
+		c = 0;
+	    }
+	    else if(fnew > 0)
+	    {
+		path[i] = (float) fnew;
+		c = DOWN;
+	    }
+	    else
+	    {
+		path[i] = 0.;
+		c = 0;
+	    }
+
+	    maxa[i] = i==0 ? path[i]-gapopen :
+		path[i] - (prevc==DOWN ? gapextend : gapopen);
+
+	    if(comp)
+		comp[i] = c;
+
+	    if(!i)
+		border->Comp = c;
+	}
+
+	return;
+    }
+
+    /* first row */
+
+    result = lin->Sub[lin->Acode[0]][lin->Bcode[j]];
+
+    fnew = path[0] -(border->Comp==LEFT ? gapextend : gapopen);
+
+    diag = path[0];
+
+    if(result > fnew && result > 0)
+    {
+	path[0] = (float) result;
+	c = 0;
+    }
+    else if(fnew > 0)
+    {
+	path[0] = (float) fnew;
+	c = LEFT;
+    }
+    else
+    {
+	path[0] = 0.;
+	c = 0;
+    }
+
+    border->Comp = c;
+
+    if(comp)
+	comp[0] = c;
+
+    bx = path[0]-gapopen-gapextend;
+
+    for(i=1;i<rows;++i)
+    {
+	match = lin->Sub[lin->Acode[i]][lin->Bcode[j]];
+
+	mscore = diag + match;
+	c = 0;
+
+	maxa[i] -= gapextend;
+	fnew = path[i];
+	fnew -= gapopen;
+
+	if(fnew > maxa[i])
+	    maxa[i] = fnew;
+
+	if(maxa[i] > mscore)
+	{
+	    mscore = maxa[i];
+	    c = LEFT;
+	}
+
+	bx -= gapextend;
+	fnew = path[i-1];
+	fnew -= gapopen;
+
+	if(fnew > bx)
+	    bx = fnew;
+
+	if(bx > mscore)
+	{
+	    mscore = bx;
+	    c = DOWN;
+	}
+
+	if(ret && mscore > *ret)
+	    *ret = (float) mscore;
+
+	diag = path[i];
+	path[i] = (float) mscore;
+
+	if(path[i] < 0.)
+	    path[i] = 0.;
+
+	if(comp)
+	    comp[i] = c;
+
+	if(border->Num)
+	    alignLinearBorderPush(border, i, j, path[i], gapextend);
+    }
+
+    return;
+}
+
+
+
+
+/* @funcstatic alignLinearSWEnd ***********************************************
+**
+** Find the maximum Smith-Waterman score and the end of the best local
+** alignment, keeping one column of the path matrix at a time.
+**
+** The end is the cell chosen by embAlignWalkSWMatrix, which takes the
+** first in row order of the cells with the maximum path score.
+** The first column is saved for the traceback.
+**
+** @param [u] lin [AlignPLinear] Workspace
+** @param [w] end1 [ajint*] End in first sequence
+** @param [w] end2 [ajint*] End in second sequence
+**
+** @return [float] Maximum score
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static float alignLinearSWEnd(AlignPLinear lin,
+                              ajint *end1, ajint *end2)
+{
+    AlignPLinearBorder border;
+    float ret;
+    double pmax;
+    float path;
+    ajint i;
+    ajint j;
+
+    ret  = -FLT_MAX;
+    pmax = -FLT_MAX;
+    *end1 = 0;
+    *end2 = 0;
+
+    border = alignLinearBorderNew(lin->Lena, ajFalse);
+
+    for(j=0;j<lin->Lenb;++j)
+    {
+	alignLinearSWColumn(lin, j, border, NULL, &ret);
+
+	if(!j)
+	    memcpy(lin->Col0, border->Path, lin->Lena*sizeof(float));
+
+	lin->Row0[j] = border->Path[0];
+
+	for(i=0;i<lin->Lena;++i)
+	{
+	    path = border->Path[i];
+
+	    if((path > pmax && !E_FPEQ(path,pmax,U_FEPS)) ||
+	       (E_FPEQ(path,pmax,U_FEPS) &&
+		(i < *end1 || (i == *end1 && j < *end2))))
+	    {
+		pmax  = path;
+		*end1 = i;
+		*end2 = j;
+	    }
+	}
+    }
+
+    alignLinearBorderDel(&border);
+
+    return ret;
+}
+
+
+
+
+/* @funcstatic alignLinearSWSolve *********************************************
+**
+** Follow the local alignment traceback through a range of columns,
+** appending each step to the alignment.
+**
+** The scores carried across the middle column are calculated and the
+** right half is solved first. The left half is solved from where the
+** traceback leaves the right half.
+**
+** @param [u] lin [AlignPLinear] Workspace
+** @param [r] c1 [ajint] First column
+** @param [r] c2 [ajint] Last column
+** @param [r] border [const AlignPLinearBorder] Scores of column c1-1
+** @param [u] ypos [ajint*] Row of the traceback
+** @param [u] xpos [ajint*] Column of the traceback, returned as
+**                          the first column to the left of c1
+**                          unless the traceback has finished
+**
+** @return [AjBool] True if the traceback has finished
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static AjBool alignLinearSWSolve(AlignPLinear lin, ajint c1, ajint c2,
+                                 const AlignPLinearBorder border,
+                                 ajint *ypos, ajint *xpos)
+{
+    AlignPLinearBorder work;
+    AjBool done;
+    ajint rows;
+    ajint cols;
+    ajint cmid;
+    ajint j;
+
+    rows = *ypos + 1;
+    cols = c2 - c1 + 1;
+
+    if(cols <= 2 || (ajlong) rows * cols <= ALNLINEARBASE)
+	return alignLinearSWBase(lin, c1, c2, border, ypos, xpos);
+
+    cmid = c1 + (cols - 1) / 2;
+
+    work = alignLinearBorderClone(border, rows);
+
+    for(j=c1;j<=cmid;++j)
+	alignLinearSWColumn(lin, j, work, NULL, NULL);
+
+    done = alignLinearSWSolve(lin, cmid+1, c2, work, ypos, xpos);
+
+    alignLinearBorderDel(&work);
+
+    if(done || *xpos < c1)
+	return done;
+
+    return alignLinearSWSolve(lin, c1, *xpos, border, ypos, xpos);
+}
+
+
+
+
+/* @funcstatic alignLinearSWBase **********************************************
+**
+** Follow the local alignment traceback through a range of columns
+** small enough to calculate in full, appending each step to the alignment.
+**
+** The steps are those of embAlignWalkSWMatrix.
+**
+** @param [u] lin [AlignPLinear] Workspace
+** @param [r] c1 [ajint] First column
+** @param [r] c2 [ajint] Last column
+** @param [r] border [const AlignPLinearBorder] Scores of column c1-1
+** @param [u] ypos [ajint*] Row of the traceback
+** @param [u] xpos [ajint*] Column of the traceback, returned as
+**                          the first column to the left of c1
+**                          unless the traceback has finished
+**
+** @return [AjBool] True if the traceback has finished
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static AjBool alignLinearSWBase(AlignPLinear lin, ajint c1, ajint c2,
+                                const AlignPLinearBorder border,
+                                ajint *ypos, ajint *xpos)
+{
+    AlignPLinearBorder work;
+    AjBool done = ajFalse;
+    float *path;
+    ajint *comp;
+    ajint rows;
+    ajint i;
+    ajint j;
+    ajint k;
+    size_t cursor;
+    ajlong gapcnt;
+    double score;
+    double bimble;
+    double errbounds;
+    float gapopen;
+    float gapextend;
+    float prevpath;
+
+    rows = *ypos + 1;
+    gapopen   = lin->Gapopen;
+    gapextend = lin->Gapextend;
+    errbounds = (double) 0.01;
+
+    AJCNEW(path, (size_t) rows * (c2 - c1 + 1));
+    AJCNEW(comp, (size_t) rows * (c2 - c1 + 1));
+
+    work = alignLinearBorderClone(border, rows);
+
+    for(j=c1;j<=c2;++j)
+    {
+	cursor = (size_t) (j - c1) * rows;
+	alignLinearSWColumn(lin, j, work, &comp[cursor], NULL);
+	memcpy(&path[cursor], work->Path, rows*sizeof(float));
+    }
+
+    alignLinearBorderDel(&work);
+
+    while(*xpos >= c1 && *ypos >= 0)
+    {
+	i = *ypos;
+	j = *xpos;
+	cursor = (size_t) (j - c1) * rows + i;
+
+	if(!comp[cursor])	/* diagonal */
+	{
+	    alignLinearEmit(lin, i, j, DIAG);
+	    --*ypos;
+	    --*xpos;
+
+	    if(*ypos >= 0 && *xpos >= 0)
+	    {
+		if(*xpos >= c1)
+		    prevpath = path[cursor - rows - 1];
+		else
+		    prevpath = border->Path[*ypos];
+
+		if(prevpath <= 0.)
+		{
+		    done = ajTrue;
+		    break;
+		}
+	    }
+
+	    continue;
+	}
+
+	score = path[cursor];
+
+	if(comp[cursor] == LEFT) /* Left, gap(s) in vertical */
+	{
+	    k = alignLinearSWLeft(lin, path, rows, c1, border,
+				  i, j, score, &bimble);
+
+	    if(bimble<=0.0)
+	    {
+		done = ajTrue;
+		break;
+	    }
+
+	    for(;*xpos>k;--*xpos)
+		alignLinearEmit(lin, i, *xpos, LEFT);
+
+	    continue;
+	}
+
+	/* Down, gap(s) in horizontal */
+
+	gapcnt = 0;
+	k = i-1;
+
+	while(1)
+	{
+	    bimble = path[cursor-i+k]-gapopen-(gapcnt*gapextend);
+
+	    if(!k || fabs((double)score-(double)bimble)<errbounds)
+		break;
+
+	    --k;
+	    ++gapcnt;
+	}
+
+	if(bimble<=0.0)
+	{
+	    done = ajTrue;
+	    break;
+	}
+
+	for(;*ypos>k;--*ypos)
+	    alignLinearEmit(lin, *ypos, j, DOWN);
+    }
+
+    if(*xpos < 0 || *ypos < 0)
+	done = ajTrue;
+
+    AJFREE(path);
+    AJFREE(comp);
+
+    return done;
+}
+
+
+
+
+/* @funcstatic alignLinearSWLeft **********************************************
+**
+** Find the start of a horizontal gap in a local alignment traceback,
+** searching back along the row as in embAlignWalkSWMatrix.
+**
+** Columns in the current range are searched first, then the gap starts
+** kept for earlier columns, or the saved first row. The first column is
+** used if nothing matches.
+**
+** @param [r] lin [const AlignPLinear] Workspace
+** @param [r] path [const float*] Path scores from column c1
+** @param [r] rows [ajint] Number of rows in each column of path scores
+** @param [r] c1 [ajint] First column of path scores
+** @param [r] border [const AlignPLinearBorder] Scores of column c1-1
+** @param [r] i [ajint] Row
+** @param [r] j [ajint] Column of the gap end
+** @param [r] score [double] Path score of the gap end
+** @param [w] bimble [double*] Score of the gap from the start column
+**
+** @return [ajint] Gap start column
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static ajint alignLinearSWLeft(const AlignPLinear lin,
+                               const float *path, ajint rows, ajint c1,
+                               const AlignPLinearBorder border,
+                               ajint i, ajint j, double score,
+                               double *bimble)
+{
+    float gapopen;
+    float gapextend;
+    double errbounds;
+    ajlong gapcnt;
+    size_t base;
+    ajint ix;
+    ajint k;
+
+    gapopen   = lin->Gapopen;
+    gapextend = lin->Gapextend;
+    errbounds = (double) 0.01;
+
+    gapcnt = 0;
+
+    for(ix=j-1;ix>=c1;--ix)
+    {
+	*bimble = path[(size_t) (ix - c1) * rows + i] - gapopen -
+	    (gapcnt*gapextend);
+
+	if(!ix || fabs((double)score-(double)*bimble)<errbounds)
+	    return ix;
+
+	++gapcnt;
+    }
+
+    if(!i)
+    {
+	for(ix=c1-1;ix>=0;--ix)
+	{
+	    *bimble = lin->Row0[ix] - gapopen - (gapcnt*gapextend);
+
+	    if(!ix || fabs((double)score-(double)*bimble)<errbounds)
+		return ix;
+
+	    ++gapcnt;
+	}
+    }
+
+    base = (size_t) i * border->Keep;
+
+    for(k=border->Num[i]-1;k>=0;--k)
+    {
+	ix = border->Gapcol[base+k];
+	gapcnt = j - 1 - ix;
+
+	*bimble = border->Gappath[base+k] - gapopen - (gapcnt*gapextend);
+
+	if(fabs((double)score-(double)*bimble)<errbounds)
+	    return ix;
+    }
+
+    gapcnt = j - 1;
+    *bimble = lin->Col0[i] - gapopen - (gapcnt*gapextend);
+
+    return 0;
+}
+
+
+
+
+/* @funcstatic alignBandCompare ***********************************************
+**
+** Sort word matches by start in the first sequence, then by descending
+** start in the second sequence, so that matches starting at the same
+** position in the first sequence are never chained together.
+**
+** @param [r] a [const void*] First word match
+** @param [r] b [const void*] Second word match
+**
+** @return [int] Comparison result
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static int alignBandCompare(const void* a, const void* b)
+{
+    const EmbPWordMatch wa = *(EmbPWordMatch const *) a;
+    const EmbPWordMatch wb = *(EmbPWordMatch const *) b;
+
+    if(wa->seq1start != wb->seq1start)
+	return (wa->seq1start < wb->seq1start) ? -1 : 1;
+
+    if(wa->seq2start != wb->seq2start)
+	return (wa->seq2start > wb->seq2start) ? -1 : 1;
+
+    return 0;
+}
+
+
+
+
+/* @funcstatic alignBandMaxsub ************************************************
+**
+** Find the highest substitution score between residues of the two
+** sequences
+**
+** @param [r] lin [const AlignPLinear] Workspace
+**
+** @return [double] Highest substitution score
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static double alignBandMaxsub(const AlignPLinear lin)
+{
+    AjBool *acodes;
+    AjBool *bcodes;
+    ajint ncodes;
+    ajint i;
+    ajint j;
+    double ret;
+
+    ncodes = 0;
+
+    for(i=0;i<lin->Lena;++i)
+	if(lin->Acode[i] >= ncodes)
+	    ncodes = lin->Acode[i] + 1;
+
+    for(j=0;j<lin->Lenb;++j)
+	if(lin->Bcode[j] >= ncodes)
+	    ncodes = lin->Bcode[j] + 1;
+
+    AJCNEW0(acodes, ncodes);
+    AJCNEW0(bcodes, ncodes);
+
+    for(i=0;i<lin->Lena;++i)
+	acodes[lin->Acode[i]] = ajTrue;
+
+    for(j=0;j<lin->Lenb;++j)
+	bcodes[lin->Bcode[j]] = ajTrue;
+
+    ret = -FLT_MAX;
+
+    for(i=0;i<ncodes;++i)
+	if(acodes[i])
+	    for(j=0;j<ncodes;++j)
+		if(bcodes[j] && lin->Sub[i][j] > ret)
+		    ret = lin->Sub[i][j];
+
+    AJFREE(acodes);
+    AJFREE(bcodes);
+
+    return ret;
+}
+
+
+
+
+/* @funcstatic alignBandBound *************************************************
+**
+** Upper bound on the score of any global alignment that uses a diagonal.
+**
+** Reaching diagonal d from the first cell and then the last cell needs
+** at least abs(d) + abs(lenb-lena-d) gap positions, and leaves fewer
+** residues that can be aligned.
+**
+** @param [r] lena [ajint] length of first sequence
+** @param [r] lenb [ajint] length of second sequence
+** @param [r] d [ajint] Diagonal, position in second sequence minus
+**                      position in first sequence
+** @param [r] maxsub [double] Highest substitution score
+** @param [r] mingap [double] Lowest penalty for one gap position
+**
+** @return [double] Upper bound on the score
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static double alignBandBound(ajint lena, ajint lenb, ajint d,
+                             double maxsub, double mingap)
+{
+    ajint gaps;
+    ajint pairs;
+
+    gaps = abs(d) + abs(lenb - lena - d);
+
+    pairs = (lena + lenb - gaps) / 2;
+
+    if(d > 0 && pairs > lenb - d)
+	pairs = lenb - d;
+
+    if(d < 0 && pairs > lena + d)
+	pairs = lena + d;
+
+    if(maxsub < 0.0)
+	maxsub = 0.0;
+
+    return pairs * maxsub - gaps * mingap;
+}
+
+
+
+
+/* @funcstatic alignBandOffsets ***********************************************
+**
+** Find where each row of a band is stored. Each row holds the match and
+** gap scores of its cells within the band, plus one cell on each side.
+**
+** @param [r] lena [ajint] length of first sequence
+** @param [r] lenb [ajint] length of second sequence
+** @param [r] dlo [ajint] Lowest diagonal
+** @param [r] dhi [ajint] Highest diagonal
+** @param [w] offset [size_t*] Start of each row
+**
+** @return [size_t] Number of scores to store
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static size_t alignBandOffsets(ajint lena, ajint lenb,
+                               ajint dlo, ajint dhi, size_t *offset)
+{
+    size_t ret;
+    ajint lo;
+    ajint hi;
+    ajint i;
+
+    ret = 0;
+
+    for(i=0;i<lena;++i)
+    {
+	lo = AJMAX(0, i+dlo);
+	hi = AJMIN(lenb-1, i+dhi);
+
+	offset[i] = ret;
+	ret += 3 * (size_t) (hi - lo + 3);
+    }
+
+    return ret;
+}
+
+
+
+
+/* @funcstatic alignBandFill **************************************************
+**
+** Calculate the match and gap scores of a global alignment within a band.
+**
+** The cells on each side of the band are set to ALNBANDFLOOR so that
+** no path can use them.
+**
+** @param [u] lin [AlignPLinear] Workspace
+** @param [r] dlo [ajint] Lowest diagonal
+** @param [r] dhi [ajint] Highest diagonal
+** @param [r] offset [const size_t*] Start of each row
+** @param [w] cells [float*] Scores
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void alignBandFill(AlignPLinear lin, ajint dlo, ajint dhi,
+                          const size_t *offset, float *cells)
+{
+    float *row;
+    const float *up;
+    ajint lo;
+    ajint hi;
+    ajint uplo;
+    ajint i;
+    ajint k;
+
+    up   = NULL;
+    uplo = 0;
+
+    for(i=0;i<lin->Lena;++i)
+    {
+	lo = AJMAX(0, i+dlo);
+	hi = AJMIN(lin->Lenb-1, i+dhi);
+
+	row = &cells[offset[i]];
+
+	for(k=0;k<3;++k)
+	{
+	    row[k] = ALNBANDFLOOR;
+	    row[3*(hi-lo+2)+k] = ALNBANDFLOOR;
+	}
+
+	alignLinearNWRow(lin, i, lo, hi,
+			 up ? &up[3*(lo-uplo)] : NULL, NULL, row);
+
+	up   = row;
+	uplo = lo;
+    }
+
+    return;
+}
+
+
+
+
 #ifdef AJ_COMPILE_DEPRECATED_BOOK
 #endif
 
@@ -52,6 +52,13 @@ AJ_BEGIN_DECLS
 #define PAZ  26
 #define PAZ1 27
 
+/*
+** Path matrix size (lena*lenb) above which applications switch to the
+** linear space functions embAlignPathCalcLinear and embAlignPathCalcSWLinear
+*/
+
+#define EMBALNLINEARCELLS 50000000
+
 
 
 
@@ -99,6 +106,35 @@ float embAlignPathCalcSW(const char *a, const char *b, ajint lena, ajint lenb,
                          ajint *compass,
                          AjBool show);
 
+float embAlignPathCalcLinear(const char *a, const char *b,
+                             ajint lena, ajint lenb,
+                             float gapopen, float gapextend,
+                             float endgapopen, float endgapextend,
+                             float * const *sub, const AjPSeqCvt cvt,
+                             AjBool endweight,
+                             AjPStr *m, AjPStr *n,
+                             ajint *start1, ajint *start2);
+
+float embAlignPathCalcSWLinear(const char *a, const char *b,
+                               ajint lena, ajint lenb,
+                               float gapopen, float gapextend,
+                               float * const *sub, const AjPSeqCvt cvt,
+                               AjPStr *m, AjPStr *n,
+                               ajint *start1, ajint *start2);
+
+AjBool embAlignBandSeed(const AjPSeq a, const AjPSeq b, ajint wordlen,
+                        ajint *dlo, ajint *dhi);
+
+float embAlignPathCalcBanded(const char *a, const char *b,
+                             ajint lena, ajint lenb,
+                             ajint dlo, ajint dhi,
+                             float gapopen, float gapextend,
+                             float endgapopen, float endgapextend,
+                             float * const *sub, const AjPSeqCvt cvt,
+                             AjBool endweight,
+                             AjPStr *m, AjPStr *n,
+                             ajint *start1, ajint *start2);
+
 void embAlignPrintGlobal(AjPFile outf, const char *a, const char *b,
 			 const AjPStr m, const AjPStr n,
 			 ajint start1, ajint start2, float score, AjBool mark,
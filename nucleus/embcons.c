@@ -38,6 +38,57 @@
 
 
 
+#define CONS_EXACT 16777216	/* largest float holding every integer */
+
+
+
+
+/* @funcstatic consProfileIsExact *********************************************
+**
+** Tests whether the column scores of an alignment can be computed from
+** residue counts with exactly the same result as summing over every pair
+** of sequences. This holds when all sequence weights are 1.0 and every
+** partial sum is a whole number small enough to be held exactly in a float.
+**
+** @param [r] seqset [const AjPSeqset] multiple alignment
+** @param [r] matrix [ajint* const *] comparison scoring matrix
+** @param [r] matsize [ajint] comparison scoring matrix size
+** @param [r] nseqs [ajint] number of sequences in alignment
+** @return [AjBool] True if column profiles give identical results
+**
+** @release 6.6.0
+******************************************************************************/
+
+static AjBool consProfileIsExact(const AjPSeqset seqset,
+                                 ajint* const * matrix,
+                                 ajint matsize, ajint nseqs)
+{
+    ajint i;
+    ajint j;
+    ajint maxscore = 1;
+
+    for(i=0;i<nseqs;i++)
+        if(ajSeqsetGetseqWeight(seqset, i) != 1.0)
+            return ajFalse;
+
+    for(i=1;i<matsize;i++)
+        for(j=1;j<matsize;j++)
+        {
+            if(matrix[i][j] > maxscore)
+                maxscore = matrix[i][j];
+            else if(-matrix[i][j] > maxscore)
+                maxscore = -matrix[i][j];
+        }
+
+    if((double) maxscore * (double) nseqs >= (double) CONS_EXACT)
+        return ajFalse;
+
+    return ajTrue;
+}
+
+
+
+
 /* @func embConsCalc **********************************************************
 **
 ** Calculates a consensus.
@@ -73,6 +124,10 @@ void embConsCalc(const AjPSeqset seqset,const AjPMatrix cmpmatrix,
     ajint matsize;
     ajint matchingmaxindex;
     ajint identicalmaxindex;
+    ajint colmatch;
+    ajint *code;
+    ajint *count;
+    ajint *colscore;
 
     float max;
     float contri = 0;
@@ -80,6 +135,7 @@ void embConsCalc(const AjPSeqset seqset,const AjPMatrix cmpmatrix,
     float *identical;
     float *matching;
 
+    AjBool profile;
     AjPSeqCvt cvt  = 0;
     AjPFloat score = NULL;
     const char **seqcharptr;
@@ -94,6 +150,9 @@ void embConsCalc(const AjPSeqset seqset,const AjPMatrix cmpmatrix,
     AJCNEW(seqcharptr,nseqs);
     AJCNEW(identical,matsize);
     AJCNEW(matching,matsize);
+    AJCNEW(code,nseqs);
+    AJCNEW(count,matsize);
+    AJCNEW(colscore,matsize);
 
     score = ajFloatNew();
 
@@ -105,6 +164,12 @@ void embConsCalc(const AjPSeqset seqset,const AjPMatrix cmpmatrix,
     for(i=0;i<nseqs;i++)		/* get sequence as string */
 	seqcharptr[i] =  ajSeqsetGetseqSeqC(seqset, i);
 
+    /*
+    ** with unit weights each column is scored from its residue counts
+    ** instead of comparing every pair of sequences
+    */
+    profile = consProfileIsExact(seqset, matrix, matsize, nseqs);
+
     for(k=0; k< mlen; k++)
     {
 	res = nocon;
@@ -113,35 +178,102 @@ void embConsCalc(const AjPSeqset seqset,const AjPMatrix cmpmatrix,
 	{
 	    identical[i] = 0.0;
 	    matching[i] = 0.0;
+	    count[i] = 0;
 	}
 
 	for(i=0;i<nseqs;i++)
-	    ajFloatPut(&score,i,0.);
+	{
+	    code[i] = ajSeqcvtGetCodeK(cvt,seqcharptr[i][k]);
+	    count[code[i]]++;
+	}
 
-	for(i=0;i<nseqs;i++)	      /* generate score for columns */
+	if(profile)
 	{
-	    m1 = ajSeqcvtGetCodeK(cvt,seqcharptr[i][k]);
+	    for(m1=0;m1<matsize;m1++)   /* generate score for each residue */
+	    {
+		colscore[m1] = 0;
+
+		if(!count[m1])
+		    continue;
+
+		if(m1 || gaps)
+		    identical[m1] = (float) count[m1];
+
+		if(!m1)
+		{
+		    if(gaps)
+			matching[m1] = (float) count[m1];
+
+		    continue;
+		}
+
+		colmatch = 0;
 
-	    if(m1 || gaps)
-		identical[m1] += ajSeqsetGetseqWeight(seqset,i);
+		for(m2=1;m2<matsize;m2++)
+		{
+		    if(!count[m2])
+			continue;
+
+		    colscore[m1] += matrix[m1][m2]*count[m2];
+
+		    if(matrix[m1][m2] > 0)
+			colmatch += count[m2];
+		}
+
+		colscore[m1] -= matrix[m1][m1];
+		matching[m1] = (float) colmatch;
+	    }
+
+	    for(i=0;i<nseqs;i++)
+		ajFloatPut(&score,i,(float) colscore[code[i]]);
+	}
+	else
+	{
+	    for(i=0;i<nseqs;i++)
+		ajFloatPut(&score,i,0.);
 
-	    for(j=i+1;j<nseqs;j++)
+	    for(i=0;i<nseqs;i++)      /* generate score for columns */
 	    {
-		m2 = ajSeqcvtGetCodeK(cvt,seqcharptr[j][k]);
+		m1 = code[i];
 
-		if(m1 && m2)
+		if(m1 || gaps)
+		    identical[m1] += ajSeqsetGetseqWeight(seqset,i);
+
+		for(j=i+1;j<nseqs;j++)
 		{
-		    contri = (float)matrix[m1][m2]*
-                             ajSeqsetGetseqWeight(seqset,j)
-			+ajFloatGet(score,i);
-		    contrj = (float)matrix[m1][m2]*
-                             ajSeqsetGetseqWeight(seqset,i)
-			+ajFloatGet(score,j);
-
-		    ajFloatPut(&score,i,contri);
-		    ajFloatPut(&score,j,contrj);
+		    m2 = code[j];
+
+		    if(m1 && m2)
+		    {
+			contri = (float)matrix[m1][m2]*
+			    ajSeqsetGetseqWeight(seqset,j)
+			    +ajFloatGet(score,i);
+			contrj = (float)matrix[m1][m2]*
+			    ajSeqsetGetseqWeight(seqset,i)
+			    +ajFloatGet(score,j);
+
+			ajFloatPut(&score,i,contri);
+			ajFloatPut(&score,j,contrj);
+		    }
 		}
 	    }
+
+	    for(i=0;i<nseqs;i++)      /* find +ve matches in the column */
+	    {
+		m1 = code[i];
+
+		if(!matching[m1])
+		    for(j=0;j<nseqs;j++)
+		    {
+			m2 = code[j];
+
+			if(m1 && m2 && matrix[m1][m2] > 0)
+			    matching[m1] += ajSeqsetGetseqWeight(seqset, j);
+
+			if(gaps && !m1 && !m2)
+			    matching[m1] += ajSeqsetGetseqWeight(seqset, j);
+		    }
+	    }
 	}
 
 	highindex = -1;
@@ -156,38 +288,13 @@ void embConsCalc(const AjPSeqset seqset,const AjPMatrix cmpmatrix,
 		max       = ajFloatGet(score,i);
 	    }
 
-	for(i=0;i<nseqs;i++)	  /* find +ve matches in the column */
-	{
-	    m1 = ajSeqcvtGetCodeK(cvt, seqcharptr[i][k]);
-
-	    if(!matching[m1])
-		for(j=0;j<nseqs;j++)
-		{
-/*
-//		    if( i != j)
-//		    {
-//			m2 = ajSeqcvtGetCodeK(cvt, seqcharptr[j][k]);
-//			if(m1 && m2 && matrix[m1][m2] > 0)
-//			    matching[m1] += ajSeqsetGetseqWeight(seqset, j);
-//		    }
-*/
-		    m2 = ajSeqcvtGetCodeK(cvt, seqcharptr[j][k]);
-
-		    if(m1 && m2 && matrix[m1][m2] > 0)
-                        matching[m1] += ajSeqsetGetseqWeight(seqset, j);
-
-		    if(gaps && !m1 && !m2)
-                        matching[m1] += ajSeqsetGetseqWeight(seqset, j);
-		}
-	}
-
 
 	matchingmaxindex  = 0;	  /* get max matching and identical */
 	identicalmaxindex = 0;
 
 	for(i=0;i<nseqs;i++)
 	{
-	    m1 = ajSeqcvtGetCodeK(cvt,seqcharptr[i][k]);
+	    m1 = code[i];
 
 	    if(identical[m1] > identical[identicalmaxindex])
 		identicalmaxindex = m1;
@@ -195,7 +302,7 @@ void embConsCalc(const AjPSeqset seqset,const AjPMatrix cmpmatrix,
 
 	for(i=0;i<nseqs;i++)
 	{
-	    m1 = ajSeqcvtGetCodeK(cvt,seqcharptr[i][k]);
+	    m1 = code[i];
 
 	    if(matching[m1] > matching[matchingmaxindex])
 		matchingmaxindex = m1;
@@ -205,7 +312,7 @@ void embConsCalc(const AjPSeqset seqset,const AjPMatrix cmpmatrix,
 	}
 
 	/* plurality check */
-        m1 = ajSeqcvtGetCodeK(cvt,seqcharptr[highindex][k]);
+        m1 = code[highindex];
 
 /*	if(matching[m1] >= fplural
 	   && seqcharptr[highindex][k] != '-')
@@ -219,11 +326,7 @@ void embConsCalc(const AjPSeqset seqset,const AjPMatrix cmpmatrix,
 
 	if(identity)			/* if just looking for id's */
 	{
-	    j = 0;
-
-	    for(i=0;i<nseqs;i++)
-		if(matchingmaxindex == ajSeqcvtGetCodeK(cvt,seqcharptr[i][k]))
-		    j++;
+	    j = count[matchingmaxindex];
 
 	    if(j<identity)
 		res = nocon;
@@ -236,6 +339,9 @@ void embConsCalc(const AjPSeqset seqset,const AjPMatrix cmpmatrix,
     AJFREE(freeptr);
     AJFREE(matching);
     AJFREE(identical);
+    AJFREE(code);
+    AJFREE(count);
+    AJFREE(colscore);
     ajFloatDel(&score);
 
     return;
@@ -62,6 +62,11 @@
 /* ================= Prototypes for private functions ==================== */
 /* ======================================================================= */
 
+static float dmxSeqNRScore(const EmbPDmxNrseq seqx, const EmbPDmxNrseq seqy,
+                           float * const *sub, const AjPSeqCvt cvt,
+                           float gapopen, float gapextend,
+                           float **Ppath, ajint **Pcompass, ajint *maxarr,
+                           AjPStr *Pm, AjPStr *Pn);
 
 
 
@@ -74,6 +79,86 @@
 
 
 
+/* @funcstatic dmxSeqNRScore **************************************************
+**
+** Returns the similarity of two sequences for redundancy checking, from a
+** global alignment. Identical sequences score 100 without an alignment.
+**
+** The path and compass arrays are grown as needed and reused between
+** calls.
+**
+** @param [r] seqx [const EmbPDmxNrseq] First sequence
+** @param [r] seqy [const EmbPDmxNrseq] Second sequence
+** @param [r] sub [float* const *] Substitution matrix
+** @param [r] cvt [const AjPSeqCvt] Conversion table for the matrix
+** @param [r] gapopen [float] Gap insertion penalty
+** @param [r] gapextend [float] Gap extension penalty
+** @param [u] Ppath [float**] Path array
+** @param [u] Pcompass [ajint**] Compass array
+** @param [u] maxarr [ajint*] Allocated size of the path and compass arrays
+** @param [w] Pm [AjPStr*] Work string for the first aligned sequence
+** @param [w] Pn [AjPStr*] Work string for the second aligned sequence
+**
+** @return [float] Percentage similarity
+**
+** @release 6.6.0
+** @@
+****************************************************************************/
+
+static float dmxSeqNRScore(const EmbPDmxNrseq seqx, const EmbPDmxNrseq seqy,
+                           float * const *sub, const AjPSeqCvt cvt,
+                           float gapopen, float gapextend,
+                           float **Ppath, ajint **Pcompass, ajint *maxarr,
+                           AjPStr *Pm, AjPStr *Pn)
+{
+    ajint start1  = 0;	  /* Start of seq 1, passed as arg but not used */
+    ajint start2  = 0;	  /* Start of seq 2, passed as arg but not used */
+    ajint lenx;
+    ajint leny;
+    ajint len;
+    float id   = 0.;	  /* Passed as arg but not used here */
+    float sim  = 0.;
+    float idx  = 0.;	  /* Passed as arg but not used here */
+    float simx = 0.;	  /* Passed as arg but not used here */
+    AjBool show = ajFalse; /* Passed as arg but not used here */
+
+    /* Process w/o alignment identical sequences */
+    if(ajStrMatchS(seqx->Seq->Seq, seqy->Seq->Seq))
+	return (float) 100.0;
+
+    lenx = ajSeqGetLen(seqx->Seq);
+    leny = ajSeqGetLen(seqy->Seq);
+
+    /* Intitialise variables for use by alignment functions */
+    len = lenx*leny;
+
+    if(len>*maxarr)
+    {
+	AJCRESIZE(*Ppath,len);
+	AJCRESIZE(*Pcompass,len);
+	*maxarr=len;
+    }
+
+    ajStrAssignC(Pm,"");
+    ajStrAssignC(Pn,"");
+
+    /* Call alignment functions */
+    embAlignPathCalc(ajSeqGetSeqC(seqx->Seq),ajSeqGetSeqC(seqy->Seq),
+		     lenx,leny,gapopen,gapextend,*Ppath,sub,cvt,*Pcompass,
+		     show);
+
+    embAlignWalkNWMatrix(*Ppath,seqx->Seq,seqy->Seq,Pm,Pn,
+			 lenx,leny,&start1,&start2,gapopen,gapextend,
+			 *Pcompass);
+
+    embAlignCalcSimilarity(*Pm,*Pn,sub,cvt,lenx,leny,&id,&sim,&idx,&simx);
+
+    return sim;
+}
+
+
+
+
 /* ======================================================================= */
 /* =========================== constructors ============================== */
 /* ======================================================================= */
@@ -1290,23 +1375,15 @@ AjBool embDmxSeqNR(const AjPList input, AjPUint *keep, ajint *nset,
 		      const AjPMatrixf matrix, float gapopen, float gapextend,
 		      float thresh, AjBool CheckGarbage)
 {
-    ajint start1  = 0;	  /* Start of seq 1, passed as arg but not used */
-    ajint start2  = 0;	  /* Start of seq 2, passed as arg but not used */
     ajint maxarr  = 300;  /* Initial size for matrix */
-    ajint len;
     ajuint x;		  /* Counter for seq 1 */
     ajuint y;		  /* Counter for seq 2 */
     ajuint nin;		  /* Number of sequences in input list */
+    ajuint nempty = 0;	  /* Number of zero length sequences */
     ajint *compass;
 
-    const char  *p;
-    const char  *q;
-
     AjFloatArray *sub;
-    float id   = 0.;	  /* Passed as arg but not used here */
     float sim  = 0.;
-    float idx  = 0.;	  /* Passed as arg but not used here */
-    float simx = 0.;	  /* Passed as arg but not used here */
     float *path;
 
     AjPStr m = NULL;	  /* Passed as arg but not used here */
@@ -1314,9 +1391,7 @@ AjBool embDmxSeqNR(const AjPList input, AjPUint *keep, ajint *nset,
 
     EmbPDmxNrseq *inseqs = NULL;	 /* Array containing input sequences */
     AjPUint     lens    = NULL;	 /* 1: Lengths of sequences* in input list */
-    AjPFloat2d  scores  = NULL;
     AjPSeqCvt   cvt     = 0;
-    AjBool      show    = ajFalse; /* Passed as arg but not used here */
 
 
     /* Intitialise some variables */
@@ -1346,103 +1421,45 @@ AjBool embDmxSeqNR(const AjPList input, AjPUint *keep, ajint *nset,
     lens = ajUintNewRes(nin);
 
     for(x=0; x<nin; x++)
+    {
 	ajUintPut(&lens,x,ajSeqGetLen(inseqs[x]->Seq));
 
+	if(!ajUintGet(lens,x))
+	    nempty++;
+    }
+
 
     /* Set the keep array elements to 1 */
     for(x=0;x<nin;x++)
 	ajUintPut(keep,x,1);
 
 
-    /* Create a 2d float array to hold the similarity scores */
-    scores = ajFloat2dNew();
-
-    /* Start of main application loop */
-    for(x=0; x<nin; x++)
+    /*
+    ** Check that no sequence length is 0. Zero length sequences only
+    ** align without error to each other, as identical sequences.
+    */
+    if(nempty && nempty < nin)
     {
-	for(y=x+1; y<nin; y++)
-	{
-	    /* DIAGNOSTICS 
-	       ajFmtPrint("x=%d y=%d\nComparing\n%S\nto\n%S\n\n", 
-		       x, y, inseqs[x]->Seq->Seq, inseqs[y]->Seq->Seq);*/
-	    
-	    
-
-	    /* Process w/o alignment identical sequences */
-	    if(ajStrMatchS(inseqs[x]->Seq->Seq, inseqs[y]->Seq->Seq))
-	    {
-/*  DIAGNOSTICS		printf("Score=%f\n", 100.0);  */
-		
-		ajFloat2dPut(&scores,x,y,(float)100.0);
-		continue;
-	    }
-
-
-	    /* Intitialise variables for use by alignment functions */
-	    len = ajUintGet(lens,x)*ajUintGet(lens,y);
-
-	    if(len>maxarr)
-	    {
-		AJCRESIZE(path,len);
-		AJCRESIZE(compass,len);
-		maxarr=len;
-	    }
-
-	    p = ajSeqGetSeqC(inseqs[x]->Seq);
-	    q = ajSeqGetSeqC(inseqs[y]->Seq);
-
-	    ajStrAssignC(&m,"");
-	    ajStrAssignC(&n,"");
-
-
-	    /* Check that no sequence length is 0 */
-	    if((ajUintGet(lens,x)==0)||(ajUintGet(lens,y)==0))
-	    {
-		ajWarn("Zero length sequence in SeqsetNR");
-		AJFREE(compass);
-		AJFREE(path);
-		ajStrDel(&m);
-		ajStrDel(&n);
-		ajFloat2dDel(&scores);
-		ajUintDel(&lens);
-		AJFREE(inseqs);
-
-		return ajFalse;
-	    }
-
-
-	    /* Call alignment functions */
-	    embAlignPathCalc(p,q,ajUintGet(lens,x),ajUintGet(lens,y), gapopen,
-			     gapextend,path,sub,cvt,compass,show);
-
-	    embAlignWalkNWMatrix(path,inseqs[x]->Seq,inseqs[y]->Seq,&m,&n,
-				 ajUintGet(lens,x),ajUintGet(lens,y),
-				 &start1,&start2,gapopen,gapextend,compass);
-
-	    embAlignCalcSimilarity(m,n,sub,cvt,ajUintGet(lens,x),
-				   ajUintGet(lens,y),&id,&sim,&idx, &simx);
-
+	ajWarn("Zero length sequence in SeqsetNR");
+	AJFREE(compass);
+	AJFREE(path);
+	ajStrDel(&m);
+	ajStrDel(&n);
+	ajUintDel(&lens);
+	AJFREE(inseqs);
 
-	    /* Write array with score*/
-            /* DIAGNOSTICS	   printf("Score=%f\n", sim);  */
-	    ajFloat2dPut(&scores,x,y,sim);
-	}
+	return ajFalse;
     }
 
 
-    /* DIAGNOSTIC 
-    for(x=0; x<nin; x++)
-    {
-	for(y=x+1; y<nin; y++)	
-	{
-	    ajFmtPrint("%d:%d : %f\n", x+1, y+1, ajFloat2dGet(scores,x,y));
-        }
-    }
+    /*
+    ** Write the keep array as appropriate. Each score is worked out when
+    ** its pair is reached and used once, so none are stored. A pair is
+    ** skipped if the second sequence, or the first sequence before its
+    ** own pass, has already been dropped. A first sequence dropped during
+    ** its own pass is still compared to the rest, as before, because it
+    ** can still drop later sequences.
     */
-    
-
-
-    /* Write the keep array as appropriate */
     for(x=0; x<nin; x++)
     {
 	if(!ajUintGet(*keep,x))
@@ -1453,7 +1470,10 @@ AjBool embDmxSeqNR(const AjPList input, AjPUint *keep, ajint *nset,
 	    if(!ajUintGet(*keep,y))
 		continue;
 
-	    if(ajFloat2dGet(scores,x,y) >= thresh)
+	    sim = dmxSeqNRScore(inseqs[x],inseqs[y],sub,cvt,gapopen,gapextend,
+				&path,&compass,&maxarr,&m,&n);
+
+	    if(sim >= thresh)
 	    {
 		/* If both are garbage, set on length as usual */
 		if(CheckGarbage && inseqs[x]->Garbage && inseqs[y]->Garbage)
@@ -1524,7 +1544,6 @@ AjBool embDmxSeqNR(const AjPList input, AjPUint *keep, ajint *nset,
     AJFREE(path);
     ajStrDel(&m);
     ajStrDel(&n);
-    ajFloat2dDel(&scores);
     ajUintDel(&lens);
     AJFREE(inseqs);
 
@@ -1575,23 +1594,15 @@ AjBool embDmxSeqNRRange(const AjPList input, AjPUint *keep, ajint *nset,
 		      const AjPMatrixf matrix, float gapopen, float gapextend,
 		      float threshlow, float threshup, AjBool CheckGarbage)
 {
-    ajint start1 = 0;	/* Start of seq 1, passed as arg but not used */
-    ajint start2 = 0;	/* Start of seq 2, passed as arg but not used */
     ajint maxarr = 300;	/* Initial size for matrix */
-    ajint len;
     ajuint x;		/* Counter for seq 1 */
     ajuint y;		/* Counter for seq 2 */
     ajuint nin;		/* Number of sequences in input list */
+    ajuint nempty = 0;	/* Number of zero length sequences */
     ajint *compass;
 
-    const char  *p;
-    const char  *q;
-
     float **sub;
-    float id   = 0.;	/* Passed as arg but not used here */
     float sim  = 0.;
-    float idx  = 0.;	/* Passed as arg but not used here */
-    float simx = 0.;	/* Passed as arg but not used here */
     float *path;
 
     AjPStr m = NULL;	/* Passed as arg but not used here */
@@ -1599,9 +1610,7 @@ AjBool embDmxSeqNRRange(const AjPList input, AjPUint *keep, ajint *nset,
 
     EmbPDmxNrseq *inseqs = NULL;	/* Array containing input sequences */
     AjPUint lens    = NULL;	/* 1: Lengths of sequences* in input list */
-    AjPFloat2d  scores = NULL;
     AjPSeqCvt cvt = 0;
-    AjBool show = ajFalse;	/* Passed as arg but not used here */
 
 
 
@@ -1633,83 +1642,41 @@ AjBool embDmxSeqNRRange(const AjPList input, AjPUint *keep, ajint *nset,
     lens = ajUintNewRes(nin);
 
     for(x=0; x<nin; x++)
+    {
 	ajUintPut(&lens,x,ajSeqGetLen(inseqs[x]->Seq));
 
+	if(!ajUintGet(lens,x))
+	    nempty++;
+    }
+
 
     /* Set the keep array elements to 1 */
     for(x=0;x<nin;x++)
 	ajUintPut(keep,x,1);
 
 
-    /* Create a 2d float array to hold the similarity scores */
-    scores = ajFloat2dNew();
-
-
-    /* Start of main application loop */
-    for(x=0; x<nin; x++)
+    /*
+    ** Check that no sequence length is 0. Zero length sequences only
+    ** align without error to each other, as identical sequences.
+    */
+    if(nempty && nempty < nin)
     {
-	for(y=x+1; y<nin; y++)
-	{
-	    /* Process w/o alignment identical sequences */
-	    if(ajStrMatchS(inseqs[x]->Seq->Seq, inseqs[y]->Seq->Seq))
-	    {
-		ajFloat2dPut(&scores,x,y,(float)100.0);
-		continue;
-	    }
-
-
-	    /* Intitialise variables for use by alignment functions */
-	    len = ajUintGet(lens,x)*ajUintGet(lens,y);
-
-	    if(len>maxarr)
-	    {
-		AJCRESIZE(path,len);
-		AJCRESIZE(compass,len);
-		maxarr=len;
-	    }
-
-	    p = ajSeqGetSeqC(inseqs[x]->Seq);
-	    q = ajSeqGetSeqC(inseqs[y]->Seq);
-
-	    ajStrAssignC(&m,"");
-	    ajStrAssignC(&n,"");
-
-
-	    /* Check that no sequence length is 0 */
-	    if((ajUintGet(lens,x)==0)||(ajUintGet(lens,y)==0))
-	    {
-		ajWarn("Zero length sequence in SeqsetNR");
-		AJFREE(compass);
-		AJFREE(path);
-		ajStrDel(&m);
-		ajStrDel(&n);
-		ajFloat2dDel(&scores);
-		ajUintDel(&lens);
-		AJFREE(inseqs);
-
-		return ajFalse;
-	    }
-
-
-	    /* Call alignment functions */
-	    embAlignPathCalc(p,q,ajUintGet(lens,x),ajUintGet(lens,y), gapopen,
-			     gapextend,path,sub,cvt,compass,show);
-
-	    embAlignWalkNWMatrix(path,inseqs[x]->Seq,inseqs[y]->Seq,&m,&n,
-				 ajUintGet(lens,x),ajUintGet(lens,y),
-				 &start1,&start2,gapopen,gapextend,compass);
-
-	    embAlignCalcSimilarity(m,n,sub,cvt,ajUintGet(lens,x),
-				   ajUintGet(lens,y),&id,&sim,&idx, &simx);
-
+	ajWarn("Zero length sequence in SeqsetNR");
+	AJFREE(compass);
+	AJFREE(path);
+	ajStrDel(&m);
+	ajStrDel(&n);
+	ajUintDel(&lens);
+	AJFREE(inseqs);
 
-	    /* Write array with score */
-	    ajFloat2dPut(&scores,x,y,sim);
-	}
+	return ajFalse;
     }
 
 
-    /* Write the keep array as appropriate, first check the upper limit */
+    /*
+    ** Write the keep array as appropriate, first check the upper limit.
+    ** Pairs are skipped as in embDmxSeqNR.
+    */
     for(x=0; x<nin; x++)
     {
 	if(!ajUintGet(*keep,x))
@@ -1720,10 +1687,12 @@ AjBool embDmxSeqNRRange(const AjPList input, AjPUint *keep, ajint *nset,
 	    if(!ajUintGet(*keep,y))
 		continue;
 
+	    sim = dmxSeqNRScore(inseqs[x],inseqs[y],sub,cvt,gapopen,gapextend,
+				&path,&compass,&maxarr,&m,&n);
+
 /*	    if(ajFloat2dGet(scores,x,y) >= threshup) */
 	    
-	    if((ajFloat2dGet(scores,x,y) <= threshup) &&
-	       (ajFloat2dGet(scores,x,y) >= threshlow))
+	    if((sim <= threshup) && (sim >= threshlow))
 
 	    {
 		/* If both are garbage, set on length as usual */
@@ -1815,7 +1784,6 @@ AjBool embDmxSeqNRRange(const AjPList input, AjPUint *keep, ajint *nset,
     AJFREE(path);
     ajStrDel(&m);
     ajStrDel(&n);
-    ajFloat2dDel(&scores);
     ajUintDel(&lens);
     AJFREE(inseqs);
 
@@ -34,6 +34,7 @@
 #include "embgroup.h"
 #include "embindex.h"
 #include "embword.h"
+#include "embpat.h"
 #include "embpatlist.h"
 
 #include "ajtextdb.h"
@@ -72,6 +73,7 @@ __noreturn void embExit (void)
     embGrpExit();
     embIndexExit();
     embWordExit();
+    embPatExit();
     embPatlistExit();
 
     ajAssemdbExit();
@@ -33,11 +33,21 @@
 #include "ajreg.h"
 #include "ajarr.h"
 #include "ajnam.h"
+#include "ajfileio.h"
+#include "ajsys.h"
 
 #include <errno.h>
 
+#ifndef WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #define BTENTRYFILE     ".ent"
 #define KWLIMIT 12
+#define BTBULKSIZE 500000U
+#define BTBULKMERGE 16U
 
 
 static AjPStr embindexLine      = NULL;
@@ -49,10 +59,49 @@ static AjPStrTok embindexHandle = NULL;
 
 static AjPStr  indexWord = NULL;
 static AjPBtId indexId   = NULL;
+static AjPList embindexBulkList = NULL;
 
 static AjPFile btreeCreateFile(const AjPStr idirectory, const AjPStr dbname,
 			       const char *add);
 
+static EmbPBtreeBulk btreeBulkNew(const AjPStr dbname, const AjPStr ext,
+                                  const AjPStr idirectory,
+                                  ajuint size, ajuint refcount,
+                                  AjBool secondary, AjBool sorted);
+static void          btreeBulkDel(EmbPBtreeBulk *Pbulk);
+static void          btreeBulkClear(EmbPBtreeBulk bulk);
+static void          btreeBulkFail(const AjPStr runfile);
+static void          btreeBulkAddId(EmbPBtreeBulk bulk,
+                                    const AjPBtcache cache,
+                                    const AjPBtId id);
+static void          btreeBulkAddKey(EmbPBtreeBulk bulk,
+                                     const AjPBtcache cache,
+                                     const AjPStr key, const AjPStr id);
+static int           btreeBulkCompare(const void* a, const void* b);
+static void          btreeBulkIndex(EmbPBtreeBulk bulk, AjPBtcache cache);
+static void          btreeBulkMerge(EmbPBtreeBulk bulk, ajuint nruns,
+                                    AjPBtcache cache);
+static void          btreeBulkReplay(EmbPBtreeBulk bulk, AjPBtcache cache);
+static void          btreeBulkIndexTerm(const EmbPBtreeBulk bulk,
+                                        AjPBtcache cache,
+                                        const EmbPBtreeTerm term);
+static EmbPBtreeTerm btreeBulkNext(EmbPBtreeBulk bulk);
+static AjBool        btreeBulkRead(AjPFile inf, const EmbPBtreeBulk bulk,
+                                   EmbPBtreeTerm term);
+static AjPStr        btreeBulkRunName(EmbPBtreeBulk bulk);
+static void          btreeBulkSift(EmbPBtreeTerm *heap, ajuint n, ajuint i);
+static void          btreeBulkSpill(EmbPBtreeBulk bulk);
+static void          btreeBulkWrite(AjPFile outf, const EmbPBtreeBulk bulk,
+                                    const EmbPBtreeTerm term);
+static EmbPBtreeTerm btreeTermNew(const EmbPBtreeBulk bulk);
+static void          btreeTermDel(EmbPBtreeTerm *Pterm);
+static AjPStr        btreeJobName(const EmbPBtreeEntry entry, ajuint ifile);
+static void          btreeJobReadBulk(AjPFile inf, EmbPBtreeBulk bulk,
+                                      AjPBtcache cache);
+static void          btreeJobReap(EmbPBtreeEntry entry);
+static void          btreeJobSetBulk(EmbPBtreeBulk bulk, ajuint ifile);
+static void          btreeJobWriteBulk(AjPFile outf, EmbPBtreeBulk bulk);
+
 
 
 
@@ -112,7 +161,10 @@ void embBtreeIndexEntry(EmbPBtreeEntry entry,
                 indexId->refoffsets[iref] = entry->reffpos[iref];
         }
 
-        ajBtreeIdentIndex(entry->idcache,indexId);
+        if(entry->idbulk)
+            btreeBulkAddId(entry->idbulk, entry->idcache, indexId);
+        else
+            ajBtreeIdentIndex(entry->idcache,indexId);
     }
 
     return;
@@ -171,7 +223,11 @@ void embBtreeIndexField(EmbPBtreeField field,
 
         if(field->secondary)
         {
-            ajBtreeKeyIndex(field->cache, indexWord, entry->id);
+            if(field->bulk)
+                btreeBulkAddKey(field->bulk, field->cache,
+                                indexWord, entry->id);
+            else
+                ajBtreeKeyIndex(field->cache, indexWord, entry->id);
         }
         else 
         {
@@ -186,7 +242,10 @@ void embBtreeIndexField(EmbPBtreeField field,
                     indexId->refoffsets[iref] = entry->reffpos[iref];
             }
 
-            ajBtreeIdentIndex(field->cache,indexId);
+            if(field->bulk)
+                btreeBulkAddId(field->bulk, field->cache, indexId);
+            else
+                ajBtreeIdentIndex(field->cache,indexId);
         }
     }
 
@@ -257,7 +316,11 @@ ajuint embBtreeIndexPrimary(EmbPBtreeField field,
                indexId->refoffsets[iref] = entry->reffpos[iref];
         }
 
-        ajBtreeIdentIndex(field->cache, indexId);
+        if(field->bulk)
+            btreeBulkAddId(field->bulk, field->cache, indexId);
+        else
+            ajBtreeIdentIndex(field->cache, indexId);
+
         ret++;
     }
 
@@ -310,7 +373,11 @@ ajuint embBtreeIndexSecondary(EmbPBtreeField field,
             ajStrTruncateLen(&indexWord,field->len);
         }
 
-        ajBtreeKeyIndex(field->cache, indexWord, entry->id);
+        if(field->bulk)
+            btreeBulkAddKey(field->bulk, field->cache, indexWord, entry->id);
+        else
+            ajBtreeKeyIndex(field->cache, indexWord, entry->id);
+
         ret++;
     }
 
@@ -2197,6 +2264,8 @@ void embBtreeEntryDel(EmbPBtreeEntry* pthis)
     if(thys->reffpos)
         AJFREE(thys->reffpos);
 
+    AJFREE(thys->jobpids);
+
     while(ajListPop(thys->fields,(void **)&field))
 	embBtreeFieldDel(&field);
 
@@ -2212,6 +2281,56 @@ void embBtreeEntryDel(EmbPBtreeEntry* pthis)
 
 
 
+/* @func embBtreeEntrySetBulk *************************************************
+**
+** Set database entry to be bulk loaded on writing.
+**
+** Index terms are saved and sorted, and added to the indexes in key order
+** by embBtreeBulkLoad when all entries have been read.
+**
+** @param [u] entry [EmbPBtreeEntry] Database entry information
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void embBtreeEntrySetBulk(EmbPBtreeEntry entry)
+{
+    entry->bulk = ajTrue;
+
+    return;
+}
+
+
+
+
+/* @func embBtreeEntrySetBulksize *********************************************
+**
+** Set the maximum number of index terms in each sorted run when bulk
+** loading. Smaller runs use less memory, but more run files are written
+** and merged.
+**
+** @param [u] entry [EmbPBtreeEntry] Database entry information
+** @param [r] size [ajuint] Maximum number of terms in a run
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void embBtreeEntrySetBulksize(EmbPBtreeEntry entry, ajuint size)
+{
+    entry->bulksize = size;
+
+    return;
+}
+
+
+
+
 /* @func embBtreeEntrySetCompressed *******************************************
 **
 ** Set database entry to be compressed on writing
@@ -2234,6 +2353,44 @@ void embBtreeEntrySetCompressed(EmbPBtreeEntry entry)
 
 
 
+/* @func embBtreeEntrySetJobs *************************************************
+**
+** Set the number of input files to be indexed in parallel.
+**
+** Each input file is parsed by a separate process, started by
+** embBtreeJobStart. The terms from each process are added to the
+** indexes in input file order, so the index files are the same as when
+** the input files are indexed one at a time, with or without bulk
+** loading.
+**
+** Parallel indexing is not available on Windows, where input files are
+** always indexed one at a time.
+**
+** @param [u] entry [EmbPBtreeEntry] Database entry information
+** @param [r] jobs [ajuint] Maximum number of input files indexed at once
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void embBtreeEntrySetJobs(EmbPBtreeEntry entry, ajuint jobs)
+{
+#ifndef WIN32
+    if(jobs > 1)
+        entry->jobs = jobs;
+#else
+    (void) entry;
+    (void) jobs;
+#endif
+
+    return;
+}
+
+
+
+
 /* @func embBtreeSetFields ****************************************************
 **
 ** Set database fields to index
@@ -2876,6 +3033,13 @@ AjBool embBtreeOpenCaches(EmbPBtreeEntry entry)
                                             countall);
 	if(!entry->idcache)
 	    ajFatal("Cannot open ID index");
+
+        if(entry->bulk || entry->jobs > 1)
+            entry->idbulk = btreeBulkNew(entry->dbname, entry->idextension,
+                                         entry->idirectory,
+                                         entry->bulksize,
+                                         entry->refcount, ajFalse,
+                                         entry->bulk);
     }
 
     if(ajListGetLength(entry->fields))
@@ -2930,6 +3094,62 @@ AjBool embBtreeOpenCaches(EmbPBtreeEntry entry)
                                                   countall);
             if(!field->cache)
                 ajFatal("Cannot open %S index", field->extension);
+
+            if(entry->bulk || entry->jobs > 1)
+                field->bulk = btreeBulkNew(entry->dbname, field->extension,
+                                           entry->idirectory,
+                                           entry->bulksize,
+                                           field->refcount,
+                                           field->secondary,
+                                           entry->bulk);
+        }
+
+        ajListIterDel(&iter);
+    }
+
+    return ajTrue;
+}
+
+
+
+
+/* @func embBtreeBulkLoad *****************************************************
+**
+** Add all terms saved for bulk loading to the index files
+**
+** Each index has its terms merged from the sorted runs and added in key
+** order. Terms with the same key are added in the order they were read,
+** so the indexes have the same contents as when each term is added as it
+** is read. Inserting in key order means each new key goes into the
+** rightmost leaf of the tree, so pages stay in the cache and are written
+** once when they fill.
+**
+** @param [u] entry [EmbPBtreeEntry] database data
+**
+** @return [AjBool] true on success
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjBool embBtreeBulkLoad(EmbPBtreeEntry entry)
+{
+    AjIList iter;
+    EmbPBtreeField field;
+
+    if(entry->idbulk)
+        btreeBulkIndex(entry->idbulk, entry->idcache);
+
+    if(ajListGetLength(entry->fields))
+    {
+        iter = ajListIterNewread(entry->fields);
+
+        while(!ajListIterDone(iter))
+        {
+            field = ajListIterGet(iter);
+
+            if(field->bulk)
+                btreeBulkIndex(field->bulk, field->cache);
         }
 
         ajListIterDel(&iter);
@@ -2941,6 +3161,1325 @@ AjBool embBtreeOpenCaches(EmbPBtreeEntry entry)
 
 
 
+/* @funcstatic btreeBulkNew ***************************************************
+**
+** Constructor for a bulk loading term store
+**
+** @param [r] dbname [const AjPStr] Database name
+** @param [r] ext [const AjPStr] Index file extension
+** @param [r] idirectory [const AjPStr] Index directory for run files
+** @param [r] size [ajuint] Maximum number of terms in a run, or zero
+**                         for the default
+** @param [r] refcount [ajuint] Number of reference files per entry
+** @param [r] secondary [AjBool] Secondary index if true
+** @param [r] sorted [AjBool] Sort runs by key if true, otherwise keep
+**                           terms in the order they are saved
+** @return [EmbPBtreeBulk] Bulk loading term store
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static EmbPBtreeBulk btreeBulkNew(const AjPStr dbname, const AjPStr ext,
+                                  const AjPStr idirectory,
+                                  ajuint size, ajuint refcount,
+                                  AjBool secondary, AjBool sorted)
+{
+    EmbPBtreeBulk thys;
+
+    AJNEW0(thys);
+
+    thys->Size = size ? size : BTBULKSIZE;
+    AJCNEW0(thys->Terms, thys->Size);
+
+    thys->Runfiles  = ajListstrNew();
+    thys->Name      = ajStrNewS(idirectory);
+    thys->Refcount  = refcount;
+    thys->Secondary = secondary;
+    thys->Sorted    = sorted;
+
+    if(ajStrGetLen(thys->Name) &&
+       ajStrGetCharLast(thys->Name) != SLASH_CHAR)
+        ajStrAppendC(&thys->Name, SLASH_STRING);
+
+    ajFmtPrintAppS(&thys->Name, "%S.%S", dbname, ext);
+
+    if(!embindexBulkList)
+        embindexBulkList = ajListNew();
+
+    ajListPushAppend(embindexBulkList, thys);
+
+    return thys;
+}
+
+
+
+
+/* @funcstatic btreeBulkDel ***************************************************
+**
+** Destructor for a bulk loading term store. Any run files left from an
+** incomplete load are deleted.
+**
+** @param [d] Pbulk [EmbPBtreeBulk*] Bulk loading term store
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeBulkDel(EmbPBtreeBulk *Pbulk)
+{
+    EmbPBtreeBulk thys;
+    AjIList iter;
+    ajuint i;
+
+    if(!Pbulk || !*Pbulk)
+        return;
+
+    thys = *Pbulk;
+
+    iter = ajListIterNew(embindexBulkList);
+
+    while(!ajListIterDone(iter))
+        if(ajListIterGet(iter) == thys)
+            ajListIterRemove(iter);
+
+    ajListIterDel(&iter);
+
+    if(!ajListGetLength(embindexBulkList))
+        ajListFree(&embindexBulkList);
+
+    btreeBulkClear(thys);
+
+    ajListstrFree(&thys->Runfiles);
+
+    for(i=0; i < thys->Size; i++)
+        btreeTermDel(&thys->Terms[i]);
+
+    AJFREE(thys->Terms);
+
+    ajStrDel(&thys->Name);
+
+    AJFREE(*Pbulk);
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeBulkClear *************************************************
+**
+** Delete all run files of a bulk loading term store
+**
+** @param [u] bulk [EmbPBtreeBulk] Bulk loading term store
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeBulkClear(EmbPBtreeBulk bulk)
+{
+    AjPStr runfile = NULL;
+
+    while(ajListstrPop(bulk->Runfiles, &runfile))
+    {
+        ajSysFileUnlinkS(runfile);
+        ajStrDel(&runfile);
+    }
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeBulkFail **************************************************
+**
+** Delete the run files of all bulk loading term stores and exit after
+** failing to open a run file
+**
+** @param [r] runfile [const AjPStr] Run file name
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeBulkFail(const AjPStr runfile)
+{
+    AjPStr failfile = NULL;
+    AjIList iter;
+
+    failfile = ajStrNewS(runfile);
+
+    iter = ajListIterNewread(embindexBulkList);
+
+    while(!ajListIterDone(iter))
+        btreeBulkClear(ajListIterGet(iter));
+
+    ajListIterDel(&iter);
+
+    ajFatal("Cannot open bulk load file '%S'", failfile);
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeBulkAddId *************************************************
+**
+** Save an identifier index term for bulk loading
+**
+** The key is converted to a query term and truncated as it would be by
+** ajBtreeIdentIndex, so that equal index keys sort together.
+**
+** @param [u] bulk [EmbPBtreeBulk] Bulk loading term store
+** @param [r] cache [const AjPBtcache] Index cache
+** @param [r] id [const AjPBtId] Identifier index term
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeBulkAddId(EmbPBtreeBulk bulk, const AjPBtcache cache,
+                           const AjPBtId id)
+{
+    EmbPBtreeTerm term;
+    ajuint iref;
+
+    term = btreeBulkNext(bulk);
+
+    ajStrAssignS(&term->Key, id->id);
+    ajStrFmtQuery(&term->Key);
+
+    if(ajStrGetLen(term->Key) > cache->keylimit)
+        ajStrTruncateLen(&term->Key, cache->keylimit);
+
+    term->Dbno   = id->dbno;
+    term->Offset = id->offset;
+
+    for(iref=0; iref < bulk->Refcount && iref < id->refcount; iref++)
+        term->Refoffsets[iref] = id->refoffsets[iref];
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeBulkAddKey ************************************************
+**
+** Save a secondary index term for bulk loading
+**
+** The key and identifier are converted to query terms and truncated as
+** they would be by ajBtreeKeyIndex.
+**
+** @param [u] bulk [EmbPBtreeBulk] Bulk loading term store
+** @param [r] cache [const AjPBtcache] Index cache
+** @param [r] key [const AjPStr] Secondary index keyword
+** @param [r] id [const AjPStr] Entry identifier
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeBulkAddKey(EmbPBtreeBulk bulk, const AjPBtcache cache,
+                            const AjPStr key, const AjPStr id)
+{
+    EmbPBtreeTerm term;
+
+    term = btreeBulkNext(bulk);
+
+    ajStrAssignS(&term->Key, key);
+    ajStrFmtQuery(&term->Key);
+
+    if(ajStrGetLen(term->Key) > cache->keylimit)
+        ajStrTruncateLen(&term->Key, cache->keylimit);
+
+    ajStrAssignS(&term->Id, id);
+    ajStrFmtQuery(&term->Id);
+
+    if(ajStrGetLen(term->Id) > cache->idlimit)
+        ajStrTruncateLen(&term->Id, cache->idlimit);
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeBulkNext **************************************************
+**
+** Return the next free term in the current run, writing out the run
+** if it is full.
+**
+** @param [u] bulk [EmbPBtreeBulk] Bulk loading term store
+** @return [EmbPBtreeTerm] Term to be filled in by the caller
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static EmbPBtreeTerm btreeBulkNext(EmbPBtreeBulk bulk)
+{
+    EmbPBtreeTerm term;
+
+    if(bulk->Length == bulk->Size)
+        btreeBulkSpill(bulk);
+
+    if(!bulk->Terms[bulk->Length])
+        bulk->Terms[bulk->Length] = btreeTermNew(bulk);
+
+    term = bulk->Terms[bulk->Length++];
+    term->Count = bulk->Count++;
+    term->File  = bulk->File;
+
+    return term;
+}
+
+
+
+
+/* @funcstatic btreeBulkCompare ***********************************************
+**
+** Sort terms by key, and then by the order in which they were saved.
+**
+** Terms saved by parallel indexing processes are counted within each
+** input file, so the input file number is compared before the count.
+**
+** @param [r] a [const void*] First term
+** @param [r] b [const void*] Second term
+** @return [int] -1 if first term should sort before second, +1 if the
+**               second term should sort first. Terms are never equal.
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static int btreeBulkCompare(const void* a, const void* b)
+{
+    const EmbPBtreeTerm terma = *(EmbPBtreeTerm const *) a;
+    const EmbPBtreeTerm termb = *(EmbPBtreeTerm const *) b;
+    int ret;
+
+    ret = ajStrCmpS(terma->Key, termb->Key);
+
+    if(ret)
+        return ret;
+
+    if(terma->File != termb->File)
+        return (terma->File < termb->File) ? -1 : 1;
+
+    if(terma->Count < termb->Count)
+        return -1;
+
+    return 1;
+}
+
+
+
+
+/* @funcstatic btreeBulkSpill *************************************************
+**
+** Sort the current run, unless terms are kept in the order they were
+** saved, and write it to a run file in the index directory
+**
+** @param [u] bulk [EmbPBtreeBulk] Bulk loading term store
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeBulkSpill(EmbPBtreeBulk bulk)
+{
+    AjPFile outf = NULL;
+    AjPStr runfile = NULL;
+    ajuint i;
+
+    if(bulk->Sorted)
+        qsort(bulk->Terms, bulk->Length, sizeof(EmbPBtreeTerm),
+              &btreeBulkCompare);
+
+    runfile = btreeBulkRunName(bulk);
+
+    outf = ajFileNewOutNameS(runfile);
+
+    if(!outf)
+    {
+        btreeBulkFail(runfile);
+    }
+
+    for(i=0; i < bulk->Length; i++)
+        btreeBulkWrite(outf, bulk, bulk->Terms[i]);
+
+    ajFileClose(&outf);
+
+    ajListstrPushAppend(bulk->Runfiles, runfile);
+
+    bulk->Length = 0;
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeBulkWrite *************************************************
+**
+** Write a term to a run file
+**
+** @param [u] outf [AjPFile] Run file
+** @param [r] bulk [const EmbPBtreeBulk] Bulk loading term store
+** @param [r] term [const EmbPBtreeTerm] Term
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeBulkWrite(AjPFile outf, const EmbPBtreeBulk bulk,
+                           const EmbPBtreeTerm term)
+{
+    ajuint iref;
+
+    ajWritebinUint4(outf, ajStrGetLen(term->Key));
+    ajWritebinChar(outf, ajStrGetPtr(term->Key), ajStrGetLen(term->Key));
+    ajWritebinUint4(outf, term->File);
+    ajWritebinUint8(outf, term->Count);
+
+    if(bulk->Secondary)
+    {
+        ajWritebinUint4(outf, ajStrGetLen(term->Id));
+        ajWritebinChar(outf, ajStrGetPtr(term->Id), ajStrGetLen(term->Id));
+    }
+    else
+    {
+        ajWritebinUint4(outf, term->Dbno);
+        ajWritebinUint8(outf, term->Offset);
+
+        for(iref=0; iref < bulk->Refcount; iref++)
+            ajWritebinUint8(outf, term->Refoffsets[iref]);
+    }
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeBulkRead **************************************************
+**
+** Read the next term from a run file
+**
+** @param [u] inf [AjPFile] Run file
+** @param [r] bulk [const EmbPBtreeBulk] Bulk loading term store
+** @param [w] term [EmbPBtreeTerm] Term
+** @return [AjBool] True if a term was read, false at end of file
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static AjBool btreeBulkRead(AjPFile inf, const EmbPBtreeBulk bulk,
+                            EmbPBtreeTerm term)
+{
+    ajuint len;
+    ajuint iref;
+
+    if(!ajReadbinUint4(inf, &len))
+        return ajFalse;
+
+    ajReadbinStr(inf, len, &term->Key);
+    ajReadbinUint4(inf, &term->File);
+    ajReadbinUint8(inf, &term->Count);
+
+    if(bulk->Secondary)
+    {
+        ajReadbinUint4(inf, &len);
+        ajReadbinStr(inf, len, &term->Id);
+    }
+    else
+    {
+        ajReadbinUint4(inf, &term->Dbno);
+        ajReadbinUint8(inf, &term->Offset);
+
+        for(iref=0; iref < bulk->Refcount; iref++)
+            ajReadbinUint8(inf, &term->Refoffsets[iref]);
+    }
+
+    return ajTrue;
+}
+
+
+
+
+/* @funcstatic btreeBulkRunName ***********************************************
+**
+** Return the name of the next run file
+**
+** @param [u] bulk [EmbPBtreeBulk] Bulk loading term store
+** @return [AjPStr] Run file name
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static AjPStr btreeBulkRunName(EmbPBtreeBulk bulk)
+{
+    return ajFmtStr("%S.run%u", bulk->Name, ++bulk->Runs);
+}
+
+
+
+
+/* @funcstatic btreeBulkSift **************************************************
+**
+** Move a term down a heap of run file terms to restore the heap order
+**
+** @param [u] heap [EmbPBtreeTerm*] Heap of the next term from each run
+** @param [r] n [ajuint] Number of terms in the heap
+** @param [r] i [ajuint] Position of the term to move
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeBulkSift(EmbPBtreeTerm *heap, ajuint n, ajuint i)
+{
+    EmbPBtreeTerm term;
+    ajuint child;
+
+    term = heap[i];
+
+    while((child = 2*i + 1) < n)
+    {
+        if(child+1 < n && btreeBulkCompare(&heap[child+1], &heap[child]) < 0)
+            child++;
+
+        if(btreeBulkCompare(&heap[child], &term) > 0)
+            break;
+
+        heap[i] = heap[child];
+        i = child;
+    }
+
+    heap[i] = term;
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeBulkIndex *************************************************
+**
+** Add all saved terms to an index in key order.
+**
+** If all terms fitted in a single run they are sorted in memory.
+** Otherwise the last run is also written out and the run files are
+** merged, keeping the next term from each run in a heap. No more than
+** BTBULKMERGE run files are merged at once, so if there are more runs
+** they are first merged into longer runs.
+**
+** Terms that are not sorted are added in the order they were saved.
+**
+** @param [u] bulk [EmbPBtreeBulk] Bulk loading term store
+** @param [u] cache [AjPBtcache] Index cache
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeBulkIndex(EmbPBtreeBulk bulk, AjPBtcache cache)
+{
+    ajuint i;
+
+    if(!bulk->Sorted)
+    {
+        btreeBulkReplay(bulk, cache);
+
+        return;
+    }
+
+    if(!ajListGetLength(bulk->Runfiles))
+    {
+        qsort(bulk->Terms, bulk->Length, sizeof(EmbPBtreeTerm),
+              &btreeBulkCompare);
+
+        for(i=0; i < bulk->Length; i++)
+            btreeBulkIndexTerm(bulk, cache, bulk->Terms[i]);
+
+        bulk->Length = 0;
+
+        return;
+    }
+
+    if(bulk->Length)
+        btreeBulkSpill(bulk);
+
+    while(ajListGetLength(bulk->Runfiles) > BTBULKMERGE)
+        btreeBulkMerge(bulk, BTBULKMERGE, NULL);
+
+    btreeBulkMerge(bulk, (ajuint) ajListGetLength(bulk->Runfiles), cache);
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeBulkMerge *************************************************
+**
+** Merge the first run files of a bulk loading term store.
+**
+** The merged terms are added to the index, or if there is no index cache
+** they are written to a new run file at the end of the list of runs.
+** The merged run files are deleted.
+**
+** @param [u] bulk [EmbPBtreeBulk] Bulk loading term store
+** @param [r] nruns [ajuint] Number of run files to merge
+** @param [u] cache [AjPBtcache] Index cache, or NULL to write a new run
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeBulkMerge(EmbPBtreeBulk bulk, ajuint nruns,
+                           AjPBtcache cache)
+{
+    AjPFile *runs = NULL;
+    AjPFile outf = NULL;
+    EmbPBtreeTerm *heap = NULL;
+    EmbPBtreeTerm term = NULL;
+    AjIList iter;
+    const AjPStr runname;
+    AjPStr runfile = NULL;
+    ajuint n = 0;
+    ajuint i;
+
+    AJCNEW0(runs, nruns);
+    AJCNEW0(heap, nruns);
+
+    if(!cache)
+    {
+        runfile = btreeBulkRunName(bulk);
+        outf = ajFileNewOutNameS(runfile);
+
+        if(!outf)
+        {
+            btreeBulkFail(runfile);
+        }
+
+        ajListstrPushAppend(bulk->Runfiles, runfile);
+        runfile = NULL;
+    }
+
+    iter = ajListIterNewread(bulk->Runfiles);
+
+    for(i=0; i < nruns; i++)
+    {
+        runname = ajListIterGet(iter);
+        runs[i] = ajFileNewInNameS(runname);
+
+        if(!runs[i])
+        {
+            ajFileClose(&outf);
+            btreeBulkFail(runname);
+        }
+
+        term = btreeTermNew(bulk);
+        term->Run = i;
+
+        if(btreeBulkRead(runs[i], bulk, term))
+            heap[n++] = term;
+        else
+            btreeTermDel(&term);
+    }
+
+    ajListIterDel(&iter);
+
+    for(i=n/2; i > 0; i--)
+        btreeBulkSift(heap, n, i-1);
+
+    while(n)
+    {
+        term = heap[0];
+
+        if(outf)
+            btreeBulkWrite(outf, bulk, term);
+        else
+            btreeBulkIndexTerm(bulk, cache, term);
+
+        if(!btreeBulkRead(runs[term->Run], bulk, term))
+        {
+            btreeTermDel(&term);
+            heap[0] = heap[--n];
+        }
+
+        if(n)
+            btreeBulkSift(heap, n, 0);
+    }
+
+    ajFileClose(&outf);
+
+    for(i=0; i < nruns; i++)
+    {
+        ajFileClose(&runs[i]);
+        ajListstrPop(bulk->Runfiles, &runfile);
+        ajSysFileUnlinkS(runfile);
+        ajStrDel(&runfile);
+    }
+
+    AJFREE(runs);
+    AJFREE(heap);
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeBulkReplay ************************************************
+**
+** Add all saved terms to an index in the order they were saved.
+**
+** Run files are read in turn and deleted, followed by any terms in the
+** current run.
+**
+** @param [u] bulk [EmbPBtreeBulk] Bulk loading term store
+** @param [u] cache [AjPBtcache] Index cache
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeBulkReplay(EmbPBtreeBulk bulk, AjPBtcache cache)
+{
+    AjPFile inf = NULL;
+    EmbPBtreeTerm term = NULL;
+    AjPStr runfile = NULL;
+    ajuint i;
+
+    while(ajListstrPop(bulk->Runfiles, &runfile))
+    {
+        inf = ajFileNewInNameS(runfile);
+
+        if(!inf)
+        {
+            ajSysFileUnlinkS(runfile);
+            btreeBulkFail(runfile);
+        }
+
+        if(!term)
+            term = btreeTermNew(bulk);
+
+        while(btreeBulkRead(inf, bulk, term))
+            btreeBulkIndexTerm(bulk, cache, term);
+
+        ajFileClose(&inf);
+        ajSysFileUnlinkS(runfile);
+        ajStrDel(&runfile);
+    }
+
+    btreeTermDel(&term);
+
+    for(i=0; i < bulk->Length; i++)
+        btreeBulkIndexTerm(bulk, cache, bulk->Terms[i]);
+
+    bulk->Length = 0;
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeBulkIndexTerm *********************************************
+**
+** Add a saved term to an index
+**
+** @param [r] bulk [const EmbPBtreeBulk] Bulk loading term store
+** @param [u] cache [AjPBtcache] Index cache
+** @param [r] term [const EmbPBtreeTerm] Term
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeBulkIndexTerm(const EmbPBtreeBulk bulk, AjPBtcache cache,
+                               const EmbPBtreeTerm term)
+{
+    ajuint iref;
+
+    if(bulk->Secondary)
+    {
+        ajBtreeKeyIndex(cache, term->Key, term->Id);
+
+        return;
+    }
+
+    if(!indexId)
+        indexId = ajBtreeIdNew(bulk->Refcount);
+
+    ajStrAssignS(&indexId->id, term->Key);
+    indexId->dbno = term->Dbno;
+    indexId->dups = 0;
+    indexId->offset = term->Offset;
+    indexId->refcount = bulk->Refcount;
+
+    for(iref=0; iref < bulk->Refcount; iref++)
+        indexId->refoffsets[iref] = term->Refoffsets[iref];
+
+    ajBtreeIdentIndex(cache, indexId);
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeTermNew ***************************************************
+**
+** Constructor for a bulk loading term
+**
+** @param [r] bulk [const EmbPBtreeBulk] Bulk loading term store
+** @return [EmbPBtreeTerm] Term
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static EmbPBtreeTerm btreeTermNew(const EmbPBtreeBulk bulk)
+{
+    EmbPBtreeTerm thys;
+
+    AJNEW0(thys);
+
+    if(bulk->Refcount && !bulk->Secondary)
+        AJCNEW0(thys->Refoffsets, bulk->Refcount);
+
+    return thys;
+}
+
+
+
+
+/* @funcstatic btreeTermDel ***************************************************
+**
+** Destructor for a bulk loading term
+**
+** @param [d] Pterm [EmbPBtreeTerm*] Term
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeTermDel(EmbPBtreeTerm *Pterm)
+{
+    EmbPBtreeTerm thys;
+
+    if(!Pterm || !*Pterm)
+        return;
+
+    thys = *Pterm;
+
+    ajStrDel(&thys->Key);
+    ajStrDel(&thys->Id);
+    AJFREE(thys->Refoffsets);
+
+    AJFREE(*Pterm);
+
+    return;
+}
+
+
+
+
+/* @func embBtreeJobStart *****************************************************
+**
+** Start indexing an input file.
+**
+** If input files are indexed in parallel, a new process is started to
+** index the file, first waiting for a running process to finish if
+** there are already as many as the maximum set by embBtreeEntrySetJobs.
+**
+** The caller indexes the input file only when this function returns
+** true, and then calls embBtreeJobEnd. In a parallel indexing process
+** embBtreeJobEnd saves the results and exits. The results are collected
+** by embBtreeJobWait when all input files have been started.
+**
+** The calling process must not write to any output file while a parallel
+** indexing process is running.
+**
+** @param [u] entry [EmbPBtreeEntry] Database entry information
+** @param [r] ifile [ajuint] Input file number
+**
+** @return [AjBool] True if the input file is to be indexed by the caller
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjBool embBtreeJobStart(EmbPBtreeEntry entry, ajuint ifile)
+{
+#ifndef WIN32
+    pid_t pid;
+    AjIList iter;
+    EmbPBtreeField field;
+
+    if(entry->jobs < 2)
+        return ajTrue;
+
+    if(!entry->jobpids)
+        AJCNEW0(entry->jobpids, entry->nfiles);
+
+    while(entry->jobsrunning >= entry->jobs)
+        btreeJobReap(entry);
+
+    /* flush output so the new process has nothing buffered to write */
+
+    fflush(NULL);
+
+    pid = fork();
+
+    if(pid == -1)
+        ajFatal("Cannot start process to index input file %u", ifile+1);
+
+    if(pid)
+    {
+        entry->jobpids[ifile] = (ajint) pid;
+        entry->jobsrunning++;
+
+        return ajFalse;
+    }
+
+    entry->jobchild = ajTrue;
+    entry->jobfile  = ifile;
+
+    if(entry->idbulk)
+        btreeJobSetBulk(entry->idbulk, ifile);
+
+    if(ajListGetLength(entry->fields))
+    {
+        iter = ajListIterNewread(entry->fields);
+
+        while(!ajListIterDone(iter))
+        {
+            field = ajListIterGet(iter);
+
+            if(field->bulk)
+                btreeJobSetBulk(field->bulk, ifile);
+        }
+
+        ajListIterDel(&iter);
+    }
+#else
+    (void) entry;
+    (void) ifile;
+#endif
+
+    return ajTrue;
+}
+
+
+
+
+/* @func embBtreeJobEnd *******************************************************
+**
+** End indexing an input file.
+**
+** In a parallel indexing process the saved terms are written to run
+** files, and the run file names and the entry and field statistics are
+** written to a job file in the index directory. The process then exits.
+**
+** Otherwise nothing is done.
+**
+** @param [u] entry [EmbPBtreeEntry] Database entry information
+** @param [r] nentries [ajulong] Number of entries in the input file
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void embBtreeJobEnd(EmbPBtreeEntry entry, ajulong nentries)
+{
+#ifndef WIN32
+    AjPFile outf = NULL;
+    AjPStr jobfile = NULL;
+    AjIList iter;
+    EmbPBtreeField field;
+
+    if(!entry->jobchild)
+        return;
+
+    jobfile = btreeJobName(entry, entry->jobfile);
+    outf = ajFileNewOutNameS(jobfile);
+
+    if(!outf)
+        ajFatal("Cannot open parallel indexing file '%S'", jobfile);
+
+    ajWritebinUint8(outf, nentries);
+    ajWritebinUint4(outf, entry->idmaxlen);
+    ajWritebinUint4(outf, entry->idtruncate);
+    ajWritebinUint4(outf, ajStrGetLen(entry->maxid));
+    ajWritebinChar(outf, ajStrGetPtr(entry->maxid),
+                   ajStrGetLen(entry->maxid));
+
+    if(entry->idbulk)
+        btreeJobWriteBulk(outf, entry->idbulk);
+
+    if(ajListGetLength(entry->fields))
+    {
+        iter = ajListIterNewread(entry->fields);
+
+        while(!ajListIterDone(iter))
+        {
+            field = ajListIterGet(iter);
+
+            ajWritebinUint4(outf, field->maxlen);
+            ajWritebinUint4(outf, field->truncate);
+            ajWritebinUint4(outf, ajStrGetLen(field->maxkey));
+            ajWritebinChar(outf, ajStrGetPtr(field->maxkey),
+                           ajStrGetLen(field->maxkey));
+
+            if(field->bulk)
+                btreeJobWriteBulk(outf, field->bulk);
+        }
+
+        ajListIterDel(&iter);
+    }
+
+    ajFileClose(&outf);
+
+    /* the caches belong to the parent process, so skip all cleanup */
+
+    _exit(0);
+#else
+    (void) entry;
+    (void) nentries;
+#endif
+
+    return;
+}
+
+
+
+
+/* @func embBtreeJobWait ******************************************************
+**
+** Collect the results of the next input file indexed in parallel.
+**
+** Input files are collected in order, waiting for each indexing process
+** to finish. The run files are added to the bulk loading terms, or
+** without bulk loading their terms are added to the indexes, and the
+** entry and field statistics are updated as if the input files had been
+** indexed one at a time.
+**
+** @param [u] entry [EmbPBtreeEntry] Database entry information
+** @param [w] nentries [ajulong*] Number of entries in the input file
+**
+** @return [AjBool] True if results were collected, false when all input
+**                  files have been collected or files were not indexed
+**                  in parallel.
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjBool embBtreeJobWait(EmbPBtreeEntry entry, ajulong *nentries)
+{
+#ifndef WIN32
+    AjPFile inf = NULL;
+    AjPStr jobfile = NULL;
+    AjIList iter;
+    EmbPBtreeField field;
+    ajuint maxlen = 0;
+    ajuint truncate = 0;
+    ajuint len = 0;
+
+    if(!entry->jobpids || entry->jobnext >= entry->nfiles)
+        return ajFalse;
+
+    while(entry->jobpids[entry->jobnext])
+        btreeJobReap(entry);
+
+    jobfile = btreeJobName(entry, entry->jobnext);
+    inf = ajFileNewInNameS(jobfile);
+
+    if(!inf)
+        ajFatal("Cannot open parallel indexing file '%S'", jobfile);
+
+    ajReadbinUint8(inf, nentries);
+    ajReadbinUint4(inf, &maxlen);
+    ajReadbinUint4(inf, &truncate);
+    ajReadbinUint4(inf, &len);
+    ajReadbinStr(inf, len, &indexWord);
+
+    entry->idtruncate += truncate;
+
+    if(maxlen > entry->idmaxlen)
+    {
+        entry->idmaxlen = maxlen;
+        ajStrAssignS(&entry->maxid, indexWord);
+    }
+
+    if(entry->idbulk)
+        btreeJobReadBulk(inf, entry->idbulk, entry->idcache);
+
+    if(ajListGetLength(entry->fields))
+    {
+        iter = ajListIterNewread(entry->fields);
+
+        while(!ajListIterDone(iter))
+        {
+            field = ajListIterGet(iter);
+
+            ajReadbinUint4(inf, &maxlen);
+            ajReadbinUint4(inf, &truncate);
+            ajReadbinUint4(inf, &len);
+            ajReadbinStr(inf, len, &indexWord);
+
+            field->truncate += truncate;
+
+            if(maxlen > field->maxlen)
+            {
+                field->maxlen = maxlen;
+                ajStrAssignS(&field->maxkey, indexWord);
+            }
+
+            if(field->bulk)
+                btreeJobReadBulk(inf, field->bulk, field->cache);
+        }
+
+        ajListIterDel(&iter);
+    }
+
+    ajFileClose(&inf);
+    ajSysFileUnlinkS(jobfile);
+    ajStrDel(&jobfile);
+
+    entry->jobnext++;
+
+    return ajTrue;
+#else
+    (void) entry;
+    (void) nentries;
+
+    return ajFalse;
+#endif
+}
+
+
+
+
+/* @funcstatic btreeJobName ***************************************************
+**
+** Return the name of the job file for an input file indexed in parallel
+**
+** @param [r] entry [const EmbPBtreeEntry] Database entry information
+** @param [r] ifile [ajuint] Input file number
+**
+** @return [AjPStr] Job file name
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static AjPStr btreeJobName(const EmbPBtreeEntry entry, ajuint ifile)
+{
+    AjPStr jobfile;
+
+    jobfile = ajStrNewS(entry->idirectory);
+
+    if(ajStrGetLen(jobfile) && ajStrGetCharLast(jobfile) != SLASH_CHAR)
+        ajStrAppendC(&jobfile, SLASH_STRING);
+
+    ajFmtPrintAppS(&jobfile, "%S.job%u", entry->dbname, ifile+1);
+
+    return jobfile;
+}
+
+
+
+
+/* @funcstatic btreeJobReap ***************************************************
+**
+** Wait for any parallel indexing process to finish
+**
+** @param [u] entry [EmbPBtreeEntry] Database entry information
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeJobReap(EmbPBtreeEntry entry)
+{
+#ifndef WIN32
+    pid_t pid;
+    ajint status = 0;
+    ajuint i;
+
+    pid = waitpid(-1, &status, 0);
+
+    if(pid == -1)
+    {
+        if(errno == EINTR)
+            return;
+
+        ajFatal("Failed to wait for parallel indexing process: %s",
+                strerror(errno));
+    }
+
+    for(i=0; i < entry->nfiles; i++)
+        if(entry->jobpids[i] == (ajint) pid)
+            break;
+
+    if(i == entry->nfiles)
+        return;
+
+    if(!WIFEXITED(status) || WEXITSTATUS(status))
+        ajFatal("Parallel indexing of input file %u failed", i+1);
+
+    entry->jobpids[i] = 0;
+    entry->jobsrunning--;
+#else
+    (void) entry;
+#endif
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeJobSetBulk ************************************************
+**
+** Set bulk loading terms for a parallel indexing process.
+**
+** Terms are counted from zero for the input file, and run files are
+** named with the input file number so that processes do not overwrite
+** each other's run files.
+**
+** @param [u] bulk [EmbPBtreeBulk] Bulk loading term store
+** @param [r] ifile [ajuint] Input file number
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeJobSetBulk(EmbPBtreeBulk bulk, ajuint ifile)
+{
+    bulk->File  = ifile;
+    bulk->Count = 0;
+
+    ajFmtPrintAppS(&bulk->Name, ".%u", ifile+1);
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeJobWriteBulk **********************************************
+**
+** Write the remaining bulk loading terms for a parallel indexing process
+** to a run file, and write the names of all run files to a job file.
+**
+** @param [u] outf [AjPFile] Job file
+** @param [u] bulk [EmbPBtreeBulk] Bulk loading term store
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeJobWriteBulk(AjPFile outf, EmbPBtreeBulk bulk)
+{
+    AjPStr runfile = NULL;
+
+    if(bulk->Length)
+        btreeBulkSpill(bulk);
+
+    ajWritebinUint4(outf, (ajuint) ajListGetLength(bulk->Runfiles));
+
+    while(ajListstrPop(bulk->Runfiles, &runfile))
+    {
+        ajWritebinUint4(outf, ajStrGetLen(runfile));
+        ajWritebinChar(outf, ajStrGetPtr(runfile), ajStrGetLen(runfile));
+    }
+
+    ajStrDel(&runfile);
+
+    return;
+}
+
+
+
+
+/* @funcstatic btreeJobReadBulk ***********************************************
+**
+** Read the run file names for a parallel indexing process from a job file
+** and add them to the bulk loading terms.
+**
+** Without bulk loading the terms are added to the index at once, in the
+** order they were read from the input file.
+**
+** @param [u] inf [AjPFile] Job file
+** @param [u] bulk [EmbPBtreeBulk] Bulk loading term store
+** @param [u] cache [AjPBtcache] Index cache
+**
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void btreeJobReadBulk(AjPFile inf, EmbPBtreeBulk bulk,
+                             AjPBtcache cache)
+{
+    AjPStr runfile = NULL;
+    ajuint nruns = 0;
+    ajuint len = 0;
+    ajuint i;
+
+    ajReadbinUint4(inf, &nruns);
+
+    for(i=0; i < nruns; i++)
+    {
+        runfile = NULL;
+        ajReadbinUint4(inf, &len);
+        ajReadbinStr(inf, len, &runfile);
+        ajListstrPushAppend(bulk->Runfiles, runfile);
+    }
+
+    if(!bulk->Sorted)
+        btreeBulkReplay(bulk, cache);
+
+    return;
+}
+
+
+
+
 /* @func embBtreeCloseCaches **************************************************
 **
 ** Close index files
@@ -2961,6 +4500,7 @@ AjBool embBtreeCloseCaches(EmbPBtreeEntry entry)
     if(entry->do_id)
     {
 	ajBtreeCacheDel(&entry->idcache);
+        btreeBulkDel(&entry->idbulk);
     }
 
     if(ajListGetLength(entry->fields))
@@ -2972,6 +4512,7 @@ AjBool embBtreeCloseCaches(EmbPBtreeEntry entry)
             field = ajListIterGet(iter);
 
             ajBtreeCacheDel(&field->cache);
+            btreeBulkDel(&field->bulk);
          }
         ajListIterDel(&iter);
     }
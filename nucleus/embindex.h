@@ -58,6 +58,91 @@ AJ_BEGIN_DECLS
 
 
 
+/* @data EmbPBtreeTerm ********************************************************
+**
+** Index term held for bulk loading
+**
+** @alias EmbSBtreeTerm
+** @alias EmbOBtreeTerm
+**
+** @attr Key [AjPStr] Index term
+** @attr Id [AjPStr] Entry identifier for a secondary index
+** @attr Refoffsets [ajulong*] Reference file offsets for an identifier index
+** @attr Offset [ajulong] Entry file offset for an identifier index
+** @attr Count [ajulong] Order in which the term was added
+** @attr Dbno [ajuint] Database file number for an identifier index
+** @attr Run [ajuint] Run file number when merging
+** @attr File [ajuint] Input file number when indexed in parallel
+** @attr Padding [char[4]] Padding to alignment boundary
+******************************************************************************/
+
+typedef struct EmbSBtreeTerm
+{
+    AjPStr Key;
+    AjPStr Id;
+    ajulong *Refoffsets;
+    ajulong Offset;
+    ajulong Count;
+    ajuint Dbno;
+    ajuint Run;
+    ajuint File;
+    char   Padding[4];
+} EmbOBtreeTerm;
+
+#define EmbPBtreeTerm EmbOBtreeTerm*
+
+
+
+
+/* @data EmbPBtreeBulk ********************************************************
+**
+** Bulk loading of an index.
+**
+** Terms are saved in runs, which are sorted and written to temporary
+** files in the index directory. The runs are merged when indexing is
+** complete, and the terms are added to the index in key order.
+**
+** Input files indexed in parallel without bulk loading save their terms
+** in unsorted runs, which are added to the index in the order they were
+** read so that the index is the same as when the input files are
+** indexed one at a time.
+**
+** @alias EmbSBtreeBulk
+** @alias EmbOBtreeBulk
+**
+** @attr Terms [EmbPBtreeTerm*] Terms in the current run
+** @attr Runfiles [AjPList] Names of completed run files
+** @attr Name [AjPStr] Index file path used as the base for run file names
+** @attr Count [ajulong] Number of terms added
+** @attr Size [ajuint] Maximum number of terms in a run
+** @attr Length [ajuint] Number of terms in the current run
+** @attr Refcount [ajuint] Number of reference file(s) per entry
+** @attr Secondary [AjBool] Secondary index if true
+** @attr Sorted [AjBool] Runs are sorted by key if true
+** @attr File [ajuint] Input file number when indexed in parallel
+** @attr Runs [ajuint] Number of run files written
+******************************************************************************/
+
+typedef struct EmbSBtreeBulk
+{
+    EmbPBtreeTerm *Terms;
+    AjPList Runfiles;
+    AjPStr Name;
+    ajulong Count;
+    ajuint Size;
+    ajuint Length;
+    ajuint Refcount;
+    AjBool Secondary;
+    AjBool Sorted;
+    ajuint File;
+    ajuint Runs;
+} EmbOBtreeBulk;
+
+#define EmbPBtreeBulk EmbOBtreeBulk*
+
+
+
+
 /* @data EmbPBtreeEntry *******************************************************
 **
 ** Index tree entries
@@ -79,10 +164,12 @@ AJ_BEGIN_DECLS
 ** @attr fields [AjPList] EMBOSS index field structures
 ** @attr id [AjPStr] Entry identifier
 ** @attr idcache [AjPBtcache] Id cache structure
+** @attr idbulk [EmbPBtreeBulk] Id index bulk loading terms
 ** @attr pripagecount [ajlong] Cache primary page count
 ** @attr secpagecount [ajlong] Cache secondary page count
 ** @attr do_id [AjBool] If true, build id index
 ** @attr compressed [AjBool] If true, compress id index
+** @attr bulk [AjBool] If true, bulk load the indexes
 ** @attr nfiles [ajuint] Data file count
 ** @attr refcount [ajuint] Reference file(s) for each entry
 ** @attr idlen [ajuint] Maximum id length in index
@@ -98,6 +185,13 @@ AJ_BEGIN_DECLS
 ** @attr idsecfill [ajuint] Id index secondary fill count
 ** @attr fpos [ajlong] Input file position
 ** @attr reffpos [ajlong*] Input extra (reference) file positions
+** @attr jobpids [ajint*] Process id for each input file indexed in parallel
+** @attr jobs [ajuint] Maximum number of input files indexed in parallel
+** @attr jobsrunning [ajuint] Number of input files being indexed
+** @attr jobnext [ajuint] Next input file to collect results for
+** @attr jobfile [ajuint] Input file number in a parallel indexing process
+** @attr jobchild [AjBool] True in a parallel indexing process
+** @attr bulksize [ajuint] Maximum number of terms in a bulk loading run
 ******************************************************************************/
 
 typedef struct EmbSBtreeEntry
@@ -119,11 +213,13 @@ typedef struct EmbSBtreeEntry
 
     AjPStr id;
     AjPBtcache idcache;
+    EmbPBtreeBulk idbulk;
     ajlong pripagecount;
     ajlong secpagecount;
 
     AjBool do_id;
     AjBool compressed;
+    AjBool bulk;
 
     ajuint nfiles;
 
@@ -148,7 +244,14 @@ typedef struct EmbSBtreeEntry
 
     ajlong fpos;
     ajlong *reffpos;
-    
+
+    ajint *jobpids;
+    ajuint jobs;
+    ajuint jobsrunning;
+    ajuint jobnext;
+    ajuint jobfile;
+    AjBool jobchild;
+    ajuint bulksize;
 } EmbOBtreeEntry;
 #define EmbPBtreeEntry EmbOBtreeEntry*
  
@@ -166,6 +269,7 @@ typedef struct EmbSBtreeEntry
 ** @attr extension [AjPStr] File extension
 ** @attr maxkey    [AjPStr] Longest keyword found
 ** @attr freelist  [AjPStr*] Free data elements for reuse
+** @attr bulk      [EmbPBtreeBulk] Bulk loading terms
 ** @attr pripagecount [ajulong] Index primary page count
 ** @attr secpagecount [ajulong] Index secondary page count
 ** @attr pripagesize  [ajuint] Index primary page size
@@ -196,6 +300,7 @@ typedef struct EmbSBtreeField
     AjPStr extension;
     AjPStr maxkey;
     AjPStr *freelist;
+    EmbPBtreeBulk bulk;
     ajulong pripagecount;
     ajulong secpagecount;
     ajuint pripagesize;
@@ -284,7 +389,11 @@ void   embBtreeFastaSV(const AjPStr kwline, AjPList kwlist, ajuint maxlen);
 ajuint  embBtreeReadDir(AjPStr **filelist, const AjPStr fdirectory,
 		       const AjPStr files, const AjPStr exclude);
 EmbPBtreeEntry embBtreeEntryNew(ajuint refcount);
+void           embBtreeEntrySetBulk(EmbPBtreeEntry entry);
 void           embBtreeEntrySetCompressed(EmbPBtreeEntry entry);
+void           embBtreeEntrySetBulksize(EmbPBtreeEntry entry,
+                                        ajuint size);
+void           embBtreeEntrySetJobs(EmbPBtreeEntry entry, ajuint jobs);
 ajuint         embBtreeSetFields(EmbPBtreeEntry entry, AjPStr const * fields);
 void           embBtreeEntryDel(EmbPBtreeEntry *thys);
 void           embBtreeSetDbInfo(EmbPBtreeEntry entry, const AjPStr name,
@@ -297,6 +406,10 @@ ajuint          embBtreeGetFiles(EmbPBtreeEntry entry, const AjPStr fdirectory,
 AjBool         embBtreeWriteEntryFile(const EmbPBtreeEntry entry);
 void           embBtreeGetRsInfo(EmbPBtreeEntry entry);
 AjBool         embBtreeOpenCaches(EmbPBtreeEntry entry);
+AjBool         embBtreeBulkLoad(EmbPBtreeEntry entry);
+AjBool         embBtreeJobStart(EmbPBtreeEntry entry, ajuint ifile);
+void           embBtreeJobEnd(EmbPBtreeEntry entry, ajulong nentries);
+AjBool         embBtreeJobWait(EmbPBtreeEntry entry, ajulong *nentries);
 AjBool         embBtreeCloseCaches(EmbPBtreeEntry entry);
 AjBool         embBtreeDumpParameters(EmbPBtreeEntry entry);
 
@@ -31,16 +31,22 @@
 #include "embprop.h"
 
 #include "ajarr.h"
+#include "ajseq.h"
+#include "ajfileio.h"
 
 #include <string.h>
 #include <stdlib.h>
 #include <limits.h>
 #include <stdio.h>
 #include <math.h>
+#include <ctype.h>
 
 
 
 static ajint embMolFragSort(const void* a, const void* b);
+static ajuint molIndexWeight(double mw);
+static int    molIndexFragSort(const void* a, const void* b);
+static void   molIndexWriteHeader(EmbPMolIndex thys, ajulong protpos);
 
 
 
@@ -88,23 +94,38 @@ ajint embMolGetFrags(const AjPStr thys, ajint rno, EmbPPropMolwt const *mwdata,
     ajint pos;
     const char *p;
 
-    static AjPInt defcut =NULL;
+    ajint *defcut = NULL;
     ajint defcnt;
 
     ajint beg;
     ajint end;
     ajint i;
+    ajint j;
+    ajint c;
     double mw;
+    double nmass;
+    double cmass;
+    double resmass[EMBPROPOINDEX+1];
+    double *rawmw = NULL;
 
 
-    if(!defcut)
-	defcut=ajIntNew();
-
     --rno;
 
     len = ajStrGetLen(thys);
     p   = ajStrGetPtr(thys);
 
+    /*
+    ** Residue masses indexed as by ajBasecodeToInt, summed in the same
+    ** order as embPropCalcMolwt so that the weights are unchanged
+    */
+
+    for(i=0;i<=EMBPROPOINDEX;++i)
+	resmass[i] = (mono) ? mwdata[i]->mono : mwdata[i]->average;
+
+    nmass = resmass[EMBPROPHINDEX];
+    cmass = resmass[EMBPROPOINDEX] + nmass;
+
+    AJCNEW(defcut, len+1);
     defcnt=0;
 
     /* Positions of complete digest cuts */
@@ -122,20 +143,47 @@ ajint embMolGetFrags(const AjPStr thys, ajint rno, EmbPPropMolwt const *mwdata,
 	if(rno==4 && p[pos+1]=='E')
 	    continue;
 
-	ajIntPut(&defcut,defcnt++,pos);
+	defcut[defcnt++] = pos;
+    }
+
+    if(!defcnt)
+    {
+	AJFREE(defcut);
+	ajListSort(*l, &embMolFragSort);
+
+	return (ajuint) ajListGetLength(*l);
     }
 
+    /*
+    ** Molwts of definite cuts, keeping the residue sums so that each
+    ** overlap can carry on from its first fragment
+    */
+
+    AJCNEW(ptr, defcnt+1);
+    AJCNEW(rawmw, defcnt+1);
 
-    /* Molwts of definite cuts */
     beg = 0;
-    for(i=0;i<defcnt;++i)
+    for(i=0;i<=defcnt;++i)
     {
-	end = ajIntGet(defcut,i);
+	if(i < defcnt)
+	{
+	    end = defcut[i];
 
-	if(strchr(zyme[rno].type,(ajint)'N'))
-	    --end;
+	    if(strchr(zyme[rno].type,(ajint)'N'))
+		--end;
+	}
+	else
+	    end = len-1;
 
-	mw = embPropCalcMolwt(p,beg,end, mwdata, mono);
+	rawmw[i] = 0.0;
+	for(j=beg;j<=end;++j)
+	{
+	    c = toupper((ajint)p[j]);
+	    rawmw[i] += resmass[(c >= 'A' && c <= 'Z') ?
+				c - 'A' : EMBPROPOINDEX];
+	}
+
+	mw = rawmw[i] + nmass + cmass;
 
 	if(rno==7)
 	    mw -= (double)(17.0079 + 31.095);
@@ -145,47 +193,38 @@ ajint embMolGetFrags(const AjPStr thys, ajint rno, EmbPPropMolwt const *mwdata,
 	frag->end   = end+1;
 	frag->mwt   = mw;
 	ajListPush(*l,(void *)frag);
+	ptr[i] = frag;
 	beg = end+1;
     }
 
-    if(defcnt)
-    {
-	mw = embPropCalcMolwt(p,beg,len-1,mwdata,mono);
-
-	if(rno==7)
-	    mw -= (double)(17.0079 + 31.095);
-
-	AJNEW0(frag);
-	frag->begin = beg+1;
-	frag->end   = len;
-	frag->mwt   = mw;
-	ajListPush(*l,(void *)frag);
-    }
-
     /* Overlaps */
-    if(defcnt)
+    ajListReverse(*l);
+
+    for(i=0;i<defcnt-1;++i)
     {
-	ajListReverse(*l);
-	ajListToarray(*l,(void ***)&ptr);
+	beg = ptr[i]->begin;
+	end = ptr[i+1]->end;
+	AJNEW0(frag);
+	frag->begin = beg;
+	frag->end   = end;
 
-	for(i=0;i<defcnt-1;++i)
+	mw = rawmw[i];
+	for(j=ptr[i+1]->begin-1;j<end;++j)
 	{
-	    beg = ptr[i]->begin;
-	    end = ptr[i+1]->end;
-	    AJNEW0(frag);
-	    frag->begin = beg;
-	    frag->end   = end;
-	    mw = embPropCalcMolwt(p,beg-1,end-1,mwdata,mono);
-	    frag->mwt = mw + EMBMOLPARDISP;
-	    ajListPush(*l,(void *)frag);
+	    c = toupper((ajint)p[j]);
+	    mw += resmass[(c >= 'A' && c <= 'Z') ? c - 'A' : EMBPROPOINDEX];
 	}
 
-	AJFREE(ptr);
+	frag->mwt = mw + nmass + cmass + EMBMOLPARDISP;
+	ajListPush(*l,(void *)frag);
     }
 
+    AJFREE(ptr);
+    AJFREE(rawmw);
+    AJFREE(defcut);
+
 
     ajListSort(*l, &embMolFragSort);
-    ajIntDel(&defcut);
 
     return (ajuint) ajListGetLength(*l);
 }
@@ -210,3 +249,499 @@ static ajint embMolFragSort(const void* a, const void* b)
     return (ajint)((*(EmbPMolFrag const *)a)->mwt -
 		   (*(EmbPMolFrag const *)b)->mwt);
 }
+
+
+
+
+/* @funcstatic molIndexWeight *************************************************
+**
+** Converts a fragment molecular weight to the integer key stored in a
+** fragment molecular weight index.
+**
+** Rounding never changes the order of two weights, so every fragment
+** within a weight range has a key within the keys of the range limits.
+**
+** @param [r] mw [double] Molecular weight
+** @return [ajuint] Weight in units of 1/EMBMOLINDEXSCALE daltons
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static ajuint molIndexWeight(double mw)
+{
+    mw *= EMBMOLINDEXSCALE;
+
+    if(mw <= 0.0)
+        return 0;
+
+    if(mw >= (double) UINT_MAX)
+        return UINT_MAX;
+
+    return (ajuint) (mw + 0.5);
+}
+
+
+
+
+/* @funcstatic molIndexFragSort ***********************************************
+**
+** Sort routine for fragments of a fragment molecular weight index, by
+** weight then protein and start position.
+**
+** @param [r] a [const void*] Fragment weight, protein and start
+** @param [r] b [const void*] Fragment weight, protein and start
+**
+** @return [int] -1 if a is first, +1 if b is first, else 0
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static int molIndexFragSort(const void* a, const void* b)
+{
+    const ajuint *fa = (const ajuint*) a;
+    const ajuint *fb = (const ajuint*) b;
+    ajuint i;
+
+    for(i=0;i<3;i++)
+    {
+        if(fa[i] < fb[i])
+            return -1;
+
+        if(fa[i] > fb[i])
+            return 1;
+    }
+
+    return 0;
+}
+
+
+
+
+/* @funcstatic molIndexWriteHeader ********************************************
+**
+** Writes the header of a fragment molecular weight index file.
+**
+** @param [u] thys [EmbPMolIndex] Fragment molecular weight index
+** @param [r] protpos [ajulong] File position of the protein positions
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void molIndexWriteHeader(EmbPMolIndex thys, ajulong protpos)
+{
+    char padding[EMBMOLINDEXHEADER];
+
+    memset(padding, 0, EMBMOLINDEXHEADER);
+
+    ajFileSeek(thys->File, 0L, 0);
+
+    ajWritebinChar(thys->File, EMBMOLINDEXMAGIC, 8);
+    ajWritebinUint4(thys->File, EMBMOLINDEXVERSION);
+    ajWritebinUint4(thys->File, thys->Enzyme);
+    ajWritebinUint4(thys->File, thys->Mono ? 1 : 0);
+    ajWritebinUint4(thys->File, thys->Nprots);
+    ajWritebinUint8(thys->File, thys->Nfrags);
+    ajWritebinUint8(thys->File, protpos);
+    ajWritebinUint8(thys->File, thys->Fragpos);
+    ajWritebinChar(thys->File, padding, EMBMOLINDEXHEADER - 48);
+
+    return;
+}
+
+
+
+
+/* @func embMolIndexNewFile ***************************************************
+**
+** Creates a fragment molecular weight index and writes a placeholder
+** header to the index file. Proteins are added by embMolIndexAddSeq
+** and the index is completed by embMolIndexWrite.
+**
+** The index file is:
+**   a 64 byte header: "EMOWSEIX", version, enzyme, monoisotopic flag,
+**     number of proteins, number of fragments, and the file positions
+**     of the protein positions and of the fragments;
+**   each protein: molecular weight, then the name, description and
+**     sequence, each as a length and characters;
+**   the file position of each protein;
+**   each fragment: weight in 1/EMBMOLINDEXSCALE daltons, protein number
+**     and start position, sorted by weight.
+**
+** All numbers are little-endian, as written by the ajWritebin functions.
+**
+** @param [u] outf [AjPFile] Index file, open for writing
+** @param [r] rno [ajint] Enzyme or reagent number, as for embMolGetFrags
+** @param [r] mono [AjBool] True for monoisotopic weights
+** @return [EmbPMolIndex] Fragment molecular weight index
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+EmbPMolIndex embMolIndexNewFile(AjPFile outf, ajint rno, AjBool mono)
+{
+    EmbPMolIndex thys;
+
+    AJNEW0(thys);
+
+    thys->File   = outf;
+    thys->Enzyme = (ajuint) rno;
+    thys->Mono   = mono;
+
+    molIndexWriteHeader(thys, 0);
+
+    return thys;
+}
+
+
+
+
+/* @func embMolIndexRead ******************************************************
+**
+** Opens a fragment molecular weight index from a file written by
+** embMolIndexWrite, reading the header and the protein positions.
+** Fragments are read by embMolIndexSearch as needed.
+**
+** @param [u] inf [AjPFile] Index file
+** @return [EmbPMolIndex] Fragment molecular weight index, or NULL if the
+**                        file is not a fragment molecular weight index
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+EmbPMolIndex embMolIndexRead(AjPFile inf)
+{
+    EmbPMolIndex thys;
+    char magic[9];
+    ajuint version = 0;
+    ajuint mono = 0;
+    ajulong protpos = 0;
+    ajuint i;
+
+    if(ajReadbinChar(inf, 8, magic) != 8)
+        return NULL;
+
+    magic[8] = '\0';
+
+    if(!ajCharMatchC(magic, EMBMOLINDEXMAGIC))
+        return NULL;
+
+    ajReadbinUint4(inf, &version);
+
+    if(version != EMBMOLINDEXVERSION)
+        return NULL;
+
+    AJNEW0(thys);
+
+    thys->File = inf;
+
+    ajReadbinUint4(inf, &thys->Enzyme);
+    ajReadbinUint4(inf, &mono);
+    ajReadbinUint4(inf, &thys->Nprots);
+    ajReadbinUint8(inf, &thys->Nfrags);
+    ajReadbinUint8(inf, &protpos);
+    ajReadbinUint8(inf, &thys->Fragpos);
+
+    thys->Mono = mono ? ajTrue : ajFalse;
+
+    if(thys->Nprots)
+    {
+        AJCNEW(thys->Protpos, thys->Nprots);
+        thys->Maxprots = thys->Nprots;
+
+        ajFileSeek(inf, (ajlong) protpos, 0);
+
+        for(i=0;i<thys->Nprots;i++)
+            ajReadbinUint8(inf, &thys->Protpos[i]);
+    }
+
+    return thys;
+}
+
+
+
+
+/* @func embMolIndexDel *******************************************************
+**
+** Deletes a fragment molecular weight index. The index file is left open
+** for the caller to close.
+**
+** @param [d] Pthys [EmbPMolIndex*] Fragment molecular weight index
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void embMolIndexDel(EmbPMolIndex *Pthys)
+{
+    EmbPMolIndex thys;
+
+    if(!Pthys || !*Pthys)
+        return;
+
+    thys = *Pthys;
+
+    AJFREE(thys->Protpos);
+    AJFREE(thys->Fragdata);
+    AJFREE(*Pthys);
+
+    return;
+}
+
+
+
+
+/* @func embMolIndexAddSeq ****************************************************
+**
+** Writes a protein to a fragment molecular weight index file, and saves
+** the weight of each of its digest fragments, as given by embMolGetFrags
+** for the enzyme and weights of the index.
+**
+** @param [u] thys [EmbPMolIndex] Fragment molecular weight index
+** @param [r] seq [const AjPSeq] Protein sequence
+** @param [r] molwt [double] Protein molecular weight
+** @param [r] mwdata [EmbPPropMolwt const *] Molecular weight data
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void embMolIndexAddSeq(EmbPMolIndex thys, const AjPSeq seq, double molwt,
+                       EmbPPropMolwt const *mwdata)
+{
+    AjPList flist = NULL;
+    EmbPMolFrag frag = NULL;
+    ajulong mwbits;
+    ajuint *fragdata;
+    double mw;
+
+    if(thys->Nprots == thys->Maxprots)
+    {
+        thys->Maxprots = thys->Maxprots ? 2 * thys->Maxprots : 1024;
+        AJCRESIZE(thys->Protpos, thys->Maxprots);
+    }
+
+    thys->Protpos[thys->Nprots] = (ajulong) ajFileResetPos(thys->File);
+
+    memcpy(&mwbits, &molwt, sizeof(mwbits));
+    ajWritebinUint8(thys->File, mwbits);
+
+    ajWritebinUint4(thys->File, ajStrGetLen(ajSeqGetNameS(seq)));
+    ajWritebinStr(thys->File, ajSeqGetNameS(seq),
+                  ajStrGetLen(ajSeqGetNameS(seq)));
+    ajWritebinUint4(thys->File, ajStrGetLen(ajSeqGetDescS(seq)));
+    ajWritebinStr(thys->File, ajSeqGetDescS(seq),
+                  ajStrGetLen(ajSeqGetDescS(seq)));
+    ajWritebinUint4(thys->File, ajStrGetLen(ajSeqGetSeqS(seq)));
+    ajWritebinStr(thys->File, ajSeqGetSeqS(seq),
+                  ajStrGetLen(ajSeqGetSeqS(seq)));
+
+    flist = ajListNew();
+    embMolGetFrags(ajSeqGetSeqS(seq), (ajint) thys->Enzyme, mwdata,
+                   thys->Mono, &flist);
+
+    while(ajListPop(flist, (void**) &frag))
+    {
+        if(thys->Nfrags == thys->Maxfrags)
+        {
+            thys->Maxfrags = thys->Maxfrags ? 2 * thys->Maxfrags : 16384;
+            AJCRESIZE(thys->Fragdata, 3 * thys->Maxfrags);
+        }
+
+        /* partial digest fragments are offset as in embMolGetFrags */
+        mw = frag->mwt;
+
+        if(mw > EMBMOLPARDISP)
+            mw -= EMBMOLPARDISP;
+
+        fragdata = &thys->Fragdata[3 * thys->Nfrags];
+        fragdata[0] = molIndexWeight(mw);
+        fragdata[1] = thys->Nprots;
+        fragdata[2] = (ajuint) frag->begin;
+
+        thys->Nfrags++;
+        AJFREE(frag);
+    }
+
+    ajListFree(&flist);
+
+    thys->Nprots++;
+
+    return;
+}
+
+
+
+
+/* @func embMolIndexWrite *****************************************************
+**
+** Completes a fragment molecular weight index file, writing the protein
+** positions, the fragments sorted by weight, and the final header.
+**
+** @param [u] thys [EmbPMolIndex] Fragment molecular weight index
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void embMolIndexWrite(EmbPMolIndex thys)
+{
+    ajulong protpos;
+    ajulong i;
+
+    protpos = (ajulong) ajFileResetPos(thys->File);
+
+    for(i=0;i<thys->Nprots;i++)
+        ajWritebinUint8(thys->File, thys->Protpos[i]);
+
+    if(thys->Nfrags)
+        qsort(thys->Fragdata, (size_t) thys->Nfrags, 3 * sizeof(ajuint),
+              &molIndexFragSort);
+
+    thys->Fragpos = (ajulong) ajFileResetPos(thys->File);
+
+    for(i=0;i<3*thys->Nfrags;i++)
+        ajWritebinUint4(thys->File, thys->Fragdata[i]);
+
+    molIndexWriteHeader(thys, protpos);
+
+    AJFREE(thys->Fragdata);
+    thys->Maxfrags = 0;
+
+    return;
+}
+
+
+
+
+/* @func embMolIndexSearch ****************************************************
+**
+** Finds the proteins in a fragment molecular weight index with a digest
+** fragment in a molecular weight range. A binary search finds the first
+** fragment in the range.
+**
+** Rounding of the stored weights can include a fragment just outside the
+** range, so callers recheck the weights of the proteins found.
+**
+** @param [u] thys [EmbPMolIndex] Fragment molecular weight index
+** @param [r] minmw [double] Minimum molecular weight
+** @param [r] maxmw [double] Maximum molecular weight
+** @param [u] found [AjBool*] Array of flags for each protein, set true
+**                            for each protein found
+** @return [ajulong] Number of fragments in the range
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+ajulong embMolIndexSearch(EmbPMolIndex thys, double minmw, double maxmw,
+                          AjBool *found)
+{
+    ajuint minkey;
+    ajuint maxkey;
+    ajuint key = 0;
+    ajuint iprot = 0;
+    ajuint ibegin = 0;
+    ajulong lo = 0;
+    ajulong hi = thys->Nfrags;
+    ajulong mid;
+    ajulong nfound = 0;
+
+    if(minmw > maxmw)
+        return 0;
+
+    minkey = molIndexWeight(minmw);
+    maxkey = molIndexWeight(maxmw);
+
+    while(lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+
+        ajFileSeek(thys->File, (ajlong) (thys->Fragpos + 12 * mid), 0);
+        ajReadbinUint4(thys->File, &key);
+
+        if(key < minkey)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    ajFileSeek(thys->File, (ajlong) (thys->Fragpos + 12 * lo), 0);
+
+    for(;lo<thys->Nfrags;lo++)
+    {
+        ajReadbinUint4(thys->File, &key);
+        ajReadbinUint4(thys->File, &iprot);
+        ajReadbinUint4(thys->File, &ibegin);
+
+        if(key > maxkey)
+            break;
+
+        if(iprot < thys->Nprots)
+            found[iprot] = ajTrue;
+
+        nfound++;
+    }
+
+    return nfound;
+}
+
+
+
+
+/* @func embMolIndexGetSeq ****************************************************
+**
+** Reads a protein from a fragment molecular weight index file.
+**
+** @param [u] thys [EmbPMolIndex] Fragment molecular weight index
+** @param [r] iprot [ajuint] Protein number, counting from zero
+** @param [u] Pseq [AjPSeq*] Sequence, created if NULL
+** @param [w] Pmolwt [double*] Protein molecular weight
+** @return [AjBool] True if the protein was read
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjBool embMolIndexGetSeq(EmbPMolIndex thys, ajuint iprot,
+                         AjPSeq *Pseq, double *Pmolwt)
+{
+    AjPStr tmpstr = NULL;
+    ajulong mwbits = 0;
+    ajuint len = 0;
+
+    if(iprot >= thys->Nprots)
+        return ajFalse;
+
+    if(!*Pseq)
+        *Pseq = ajSeqNew();
+
+    ajFileSeek(thys->File, (ajlong) thys->Protpos[iprot], 0);
+
+    ajReadbinUint8(thys->File, &mwbits);
+    memcpy(Pmolwt, &mwbits, sizeof(mwbits));
+
+    ajReadbinUint4(thys->File, &len);
+    ajReadbinStr(thys->File, len, &tmpstr);
+    ajSeqAssignNameS(*Pseq, tmpstr);
+
+    ajReadbinUint4(thys->File, &len);
+    ajReadbinStr(thys->File, len, &tmpstr);
+    ajSeqAssignDescS(*Pseq, tmpstr);
+
+    ajReadbinUint4(thys->File, &len);
+    ajReadbinStr(thys->File, len, &tmpstr);
+    ajSeqAssignSeqS(*Pseq, tmpstr);
+
+    ajStrDel(&tmpstr);
+
+    return ajTrue;
+}
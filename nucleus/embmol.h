@@ -34,6 +34,8 @@
 
 #include "ajdefine.h"
 #include "ajstr.h"
+#include "ajfile.h"
+#include "ajseqdata.h"
 #include "embprop.h"
 
 AJ_BEGIN_DECLS
@@ -50,6 +52,11 @@ AJ_BEGIN_DECLS
 
 #define EMBMOLPARDISP (double)1000000.0
 
+#define EMBMOLINDEXMAGIC   "EMOWSEIX"
+#define EMBMOLINDEXVERSION 1
+#define EMBMOLINDEXHEADER  64
+#define EMBMOLINDEXSCALE   1000.0
+
 
 
 
@@ -81,6 +88,46 @@ typedef struct EmbSMolFrag
 
 
 
+/* @data EmbPMolIndex *********************************************************
+**
+** Nucleus fragment molecular weight index object.
+**
+** Digest fragment molecular weights of a protein database for one enzyme,
+** sorted by weight, with the protein and start position of each fragment.
+** Written by emowseindex and searched by emowse.
+**
+** @attr File [AjPFile] Index file
+** @attr Protpos [ajulong*] File position of each protein record
+** @attr Fragdata [ajuint*] Weight, protein and start of each fragment,
+**                          while writing
+** @attr Fragpos [ajulong] File position of the sorted fragments
+** @attr Nfrags [ajulong] Number of fragments
+** @attr Nprots [ajuint] Number of proteins
+** @attr Enzyme [ajuint] Enzyme or reagent number, as for embMolGetFrags
+** @attr Mono [AjBool] True for monoisotopic weights
+** @attr Maxprots [ajuint] Size of the protein position array
+** @attr Maxfrags [ajulong] Number of fragments that Fragdata can hold
+** @@
+******************************************************************************/
+
+typedef struct EmbSMolIndex
+{
+    AjPFile File;
+    ajulong *Protpos;
+    ajuint *Fragdata;
+    ajulong Fragpos;
+    ajulong Nfrags;
+    ajuint Nprots;
+    ajuint Enzyme;
+    AjBool Mono;
+    ajuint Maxprots;
+    ajulong Maxfrags;
+} EmbOMolIndex;
+#define EmbPMolIndex EmbOMolIndex*
+
+
+
+
 /* ========================================================================= */
 /* =========================== public functions ============================ */
 /* ========================================================================= */
@@ -94,6 +141,17 @@ typedef struct EmbSMolFrag
 ajint embMolGetFrags(const AjPStr thys, ajint rno, EmbPPropMolwt const *mwdata,
 		     AjBool mono, AjPList *l);
 
+void   embMolIndexAddSeq(EmbPMolIndex thys, const AjPSeq seq, double molwt,
+                         EmbPPropMolwt const *mwdata);
+void   embMolIndexDel(EmbPMolIndex *Pthys);
+AjBool embMolIndexGetSeq(EmbPMolIndex thys, ajuint iprot,
+                         AjPSeq *Pseq, double *Pmolwt);
+EmbPMolIndex embMolIndexNewFile(AjPFile outf, ajint rno, AjBool mono);
+EmbPMolIndex embMolIndexRead(AjPFile inf);
+ajulong embMolIndexSearch(EmbPMolIndex thys, double minmw, double maxmw,
+                          AjBool *found);
+void   embMolIndexWrite(EmbPMolIndex thys);
+
 /*
 ** End of prototype definitions
 */
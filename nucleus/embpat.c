@@ -103,6 +103,17 @@ typedef struct MethSData
 #define MethPData MethOData*
 
 
+
+
+#define PATRESTRICTWORDBITS 64
+#define PATSEEDMAXK 10
+
+static EmbPPatRestrictSet patRestrictSet = NULL;
+static AjPFile patRestrictSetFile = NULL;
+static AjPStr  patRestrictSetKey = NULL;
+static AjPStr  patRestrictSetNewkey = NULL;
+
+
 static void    patRestrictPushHit(const EmbPPatRestrict enz,
 				 AjPList l, ajuint pos,
 				 ajuint begin, ajuint len,
@@ -110,6 +121,19 @@ static void    patRestrictPushHit(const EmbPPatRestrict enz,
 static void    patRestrictMethylMod(AjPStr *str, AjPStr *rstr,
                                     AjPList methlist);
 static AjPList patRestrictReadMethyl(AjPFile methfile);
+static AjBool  patRestrictSiteValid(const EmbPPatRestrict enz, ajuint pos,
+                                    ajuint len, ajuint limit, ajint mincut,
+                                    AjBool plasmid);
+static ajuint  patRestrictScanHits(AjPList tx, ajuint hits,
+                                   ajuint min, ajuint max, AjPList l);
+static void    patRestrictSetSearch(EmbPPatRestrictSet set,
+                                    const AjPStr text,
+                                    AjPUint *hits, ajuint *nhits);
+static ajuint  patSiteParse(const AjPStr cleanpat, AjPList elems);
+static AjBool  patSiteElemMatch(const AjPStr elem, ajuint c);
+static ajint   patSeedBase(char c);
+static AjBool  patSeedCheck(EmbPPatSeedSet set, ajuint seed,
+                            const char *text, ajuint tlen, ajuint t);
 
 
 static void   patAminoCarboxyl(const AjPStr s,AjPStr *cs,
@@ -407,16 +431,7 @@ EmbPPatMatch embPatMatchFindC(const AjPStr regexp, const char *sptr,
 {
     AjPRegexp compexp = NULL;
     EmbPPatMatch results;
-    AjPList poslist = ajListNew();
-    AjPList lenlist = ajListNew();
-    AjIList iter;
-    ajuint *pos;
-    ajuint *len;
-    ajuint posi;
-    ajuint i;
-    const char *ptr;
     AjBool nterm = ajFalse;
-/*    AjPListNode node;*/
     AjPStr regstr = NULL;
 
     if(*regexp->Ptr == '^')
@@ -437,11 +452,74 @@ EmbPPatMatch embPatMatchFindC(const AjPStr regexp, const char *sptr,
     ajDebug("embPatMatchFindC regexp: '%S' regstr: '%S'\n",
 	    regexp, regstr);
 
-    ajDebug("embPatMatchFindC sptr '%s'\n",
-	    sptr);
-
     compexp = ajRegComp(regstr);
 
+    results = embPatMatchFindRegexpC(compexp, nterm, sptr);
+
+    ajRegFree(&compexp);
+
+    ajDebug("embPatMatchFindC '%S' nterm:%B results: %d\n",
+	    regstr, nterm, results->number);
+
+    ajStrDel(&regstr);
+
+    return results;
+}
+
+
+
+
+/* @func embPatMatchFindRegexp ************************************************
+**
+** Find all the matches of a compiled regular expression in a string.
+**
+** Callers searching many strings with the same expression compile it
+** once with ajRegComp and avoid the cost of embPatMatchFind.
+**
+** @param [u] compexp [AjPRegexp] Compiled regular expression
+** @param [r] nterm [AjBool] Expression is anchored to the start
+** @param [r] strng [const AjPStr] String to be searched.
+**
+** @return [EmbPPatMatch] Results of the pattern matching.
+**
+** @release 6.6.0
+******************************************************************************/
+
+EmbPPatMatch embPatMatchFindRegexp(AjPRegexp compexp, AjBool nterm,
+                                   const AjPStr strng)
+{
+    return embPatMatchFindRegexpC(compexp, nterm, ajStrGetPtr(strng));
+}
+
+
+
+
+/* @func embPatMatchFindRegexpC ***********************************************
+**
+** Find all the matches of a compiled regular expression in a string.
+**
+** @param [u] compexp [AjPRegexp] Compiled regular expression
+** @param [r] nterm [AjBool] Expression is anchored to the start
+** @param [r] sptr   [const char *] String to be searched.
+**
+** @return [EmbPPatMatch] Results of the pattern matching.
+**
+** @release 6.6.0
+******************************************************************************/
+
+EmbPPatMatch embPatMatchFindRegexpC(AjPRegexp compexp, AjBool nterm,
+                                    const char *sptr)
+{
+    EmbPPatMatch results;
+    AjPList poslist = ajListNew();
+    AjPList lenlist = ajListNew();
+    AjIList iter;
+    ajuint *pos;
+    ajuint *len;
+    ajuint posi;
+    ajuint i;
+    const char *ptr;
+
     ptr = sptr;
 
     AJNEW(results);
@@ -461,12 +539,8 @@ EmbPPatMatch embPatMatchFindC(const AjPStr regexp, const char *sptr,
 	    break;
     }
 
-    ajRegFree(&compexp);
     results->number  = (ajuint) ajListGetLength(poslist);
 
-    ajDebug("embPatMatchFindC '%S' nterm:%B results: %d\n",
-	    regstr, nterm, results->number);
-
     if(results->number)
     {
 	AJCNEW(results->start, results->number);
@@ -506,8 +580,6 @@ EmbPPatMatch embPatMatchFindC(const AjPStr regexp, const char *sptr,
 	ajListFree(&lenlist);
     }
 
-    ajStrDel(&regstr);
-
     return results;
 }
 
@@ -1570,6 +1642,118 @@ static void patRestrictMethylMod(AjPStr *Pstr, AjPStr *Prstr, AjPList methlist)
 
 
 
+/* @funcstatic patRestrictSiteValid *******************************************
+**
+** Test whether a recognition site match at a sequence position gives
+** a usable cut
+**
+** @param [r] enz [const EmbPPatRestrict] Enzyme information
+** @param [r] pos [ajuint] Sequence match position
+** @param [r] len [ajuint] Length of sequence
+** @param [r] limit [ajuint] Last position allowed plus one
+** @param [r] mincut [ajint] Smallest cut position of the enzyme
+** @param [r] plasmid [AjBool] Allow circular DNA
+**
+** @return [AjBool] True if the site is to be reported
+**
+** @release 6.6.0
+******************************************************************************/
+
+static AjBool patRestrictSiteValid(const EmbPPatRestrict enz, ajuint pos,
+                                   ajuint len, ajuint limit, ajint mincut,
+                                   AjBool plasmid)
+{
+    if(!plasmid && (pos+enz->cut1>=len || pos+enz->cut2>=len))
+        return ajFalse;
+
+    if((plasmid || pos+mincut+1>0) && pos<limit)
+        return ajTrue;
+
+    return ajFalse;
+}
+
+
+
+
+/* @funcstatic patRestrictScanHits ********************************************
+**
+** Sort the raw hits of one enzyme by cut position, remove hits sharing
+** a cut site and append the survivors to the output list if their number
+** is within the allowed range
+**
+** @param [u] tx [AjPList] Raw hits for one enzyme
+** @param [r] hits [ajuint] Number of raw hits
+** @param [r] min [ajuint] Minimum # of matches allowed
+** @param [r] max [ajuint] Maximum # of matches
+** @param [u] l [AjPList] List to push hits to
+**
+** @return [ajuint] Number of matches
+**
+** @release 6.6.0
+******************************************************************************/
+
+static ajuint patRestrictScanHits(AjPList tx, ajuint hits,
+                                  ajuint min, ajuint max, AjPList l)
+{
+    ajuint i;
+    ajuint rhits = 0;
+    ajint  v;
+    AjPList ty     = NULL;
+    EmbPMatMatch m = NULL;
+    EmbPMatMatch z = NULL;
+
+    if(!hits)
+        return 0;
+
+    ty = ajListNew();
+
+    ajListSort(tx, &embPatRestrictCutCompare);
+
+    for(i=0,rhits=0,v=0;i<hits;++i)
+    {
+        ajListPop(tx,(void **)&m);
+
+        if(m->cut1 != v)
+        {
+            ajListPush(ty,(void *)m);
+            ++rhits;
+            v = m->cut1;
+        }
+        else
+        {
+            if(i)
+                if(m->forward)
+                {
+                    ajListPop(ty,(void **)&z);
+                    ajListPush(ty,(void *)m);
+                    m=z;
+                }
+
+            embMatMatchDel(&m);
+        }
+    }
+
+    if(rhits<min || rhits>max)
+    {
+        while(ajListPop(ty,(void **)&m))
+            embMatMatchDel(&m);
+
+        rhits = 0;
+    }
+    else
+    {
+        while(ajListPop(ty,(void **)&m))
+            ajListPush(l,(void *)m);
+    }
+
+    ajListFree(&ty);
+
+    return rhits;
+}
+
+
+
+
 /* @func embPatRestrictScan ***************************************************
 **
 ** Scan a sequence with a restriction object
@@ -1602,7 +1786,6 @@ ajuint embPatRestrictScan(const EmbPPatRestrict enz,
     ajuint i;
     ajuint j;
     ajuint hits;
-    ajuint rhits = 0;
     const char *p;
     const char *q;
     const char *t;
@@ -1611,9 +1794,6 @@ ajuint embPatRestrictScan(const EmbPPatRestrict enz,
     AjBool forward;
     ajint  v;
     AjPList tx     = NULL;
-    AjPList ty     = NULL;
-    EmbPMatMatch m = NULL;
-    EmbPMatMatch z = NULL;
 
     if(len < enz->len)
         return 0;
@@ -1645,7 +1825,6 @@ ajuint embPatRestrictScan(const EmbPPatRestrict enz,
 	    enz->cut1, enz->cut2, enz->cut3, enz->cut4 ); */
 
     tx = ajListNew();
-    ty = ajListNew();
 
     if(ambiguity)
     {
@@ -1664,11 +1843,8 @@ ajuint embPatRestrictScan(const EmbPPatRestrict enz,
 		    break;
 	    }
 
-	    if(j==enz->len && !plasmid && (i+enz->cut1>=len ||
-					      i+enz->cut2>=len))
-		continue;
-
-	    if(j==enz->len && (plasmid || i+mincut+1>0) && i<limit)
+	    if(j==enz->len &&
+	       patRestrictSiteValid(enz,i,len,limit,mincut,plasmid))
 	    {
 		++hits;
 		patRestrictPushHit(enz,tx,i,begin,len,forward, plasmid);
@@ -1689,11 +1865,8 @@ ajuint embPatRestrictScan(const EmbPPatRestrict enz,
 		    break;
 	    }
 
-	    if(j==enz->len && !plasmid && (i+enz->cut1>=len ||
-					      i+enz->cut2>=len))
-		continue;
-
-	    if(j==enz->len && (plasmid || i+mincut+1>0) && i<limit)
+	    if(j==enz->len &&
+	       patRestrictSiteValid(enz,i,len,limit,mincut,plasmid))
 	    {
 		++hits;
 		patRestrictPushHit(enz,tx,i,begin,len,forward, plasmid);
@@ -1718,11 +1891,8 @@ ajuint embPatRestrictScan(const EmbPPatRestrict enz,
 		    break;
 	    }
 
-	    if(j==enz->len && !plasmid && (i+enz->cut1>=len ||
-					      i+enz->cut2>=len))
-		continue;
-
-	    if(j==enz->len && (plasmid || i+mincut+1>0) && i<limit)
+	    if(j==enz->len &&
+	       patRestrictSiteValid(enz,i,len,limit,mincut,plasmid))
 	    {
 		++hits;
 		patRestrictPushHit(enz,tx,i,begin,len,forward, plasmid);
@@ -1743,11 +1913,8 @@ ajuint embPatRestrictScan(const EmbPPatRestrict enz,
 		    break;
 	    }
 
-	    if(j==enz->len && !plasmid && (i+enz->cut1>=len ||
-					      i+enz->cut2>=len))
-		continue;
-
-	    if(j==enz->len && (plasmid || i+mincut+1>0) && i<limit)
+	    if(j==enz->len &&
+	       patRestrictSiteValid(enz,i,len,limit,mincut,plasmid))
 	    {
 		++hits;
 		patRestrictPushHit(enz,tx,i,begin,len,forward, plasmid);
@@ -1756,53 +1923,9 @@ ajuint embPatRestrictScan(const EmbPPatRestrict enz,
     }
 
 
-    if(hits)
-    {
-	ajListSort(tx, &embPatRestrictCutCompare);
-
-	for(i=0,rhits=0,v=0;i<hits;++i)
-	{
-	    ajListPop(tx,(void **)&m);
-
-	    if(m->cut1 != v)
-	    {
-		ajListPush(ty,(void *)m);
-		++rhits;
-		v = m->cut1;
-	    }
-	    else
-	    {
-		if(i)
-		    if(m->forward)
-		    {
-			ajListPop(ty,(void **)&z);
-			ajListPush(ty,(void *)m);
-			m=z;
-		    }
-
-		embMatMatchDel(&m);
-	    }
-	}
-
-	if(rhits<min || rhits>max)
-	{
-	    while(ajListPop(ty,(void **)&m));
-
-	    ajListFree(&tx);
-	    ajListFree(&ty);
-
-	    return 0;
-	}
-	else
-	{
-	    while(ajListPop(ty,(void **)&m))
-		ajListPush(l,(void *)m);
-	    hits = rhits;
-	}
-    }
+    hits = patRestrictScanHits(tx,hits,min,max,l);
 
     ajListFree(&tx);
-    ajListFree(&ty);
 
     return hits;
 }
@@ -4612,19 +4735,14 @@ ajuint embPatRestrictMatch(const AjPSeq seq, ajuint begin, ajuint end,
 			   AjBool blunt, AjBool sticky, AjBool commercial,
 			   AjBool methyl, AjPList l)
 {
-    AjBool hassup;
-    AjBool isall = ajTrue;
-    AjPStr  name;
     const AjPStr  strand;
     AjPStr  substr;
     AjPStr  revstr;
     AjPStr  binstr;
     AjPStr  binrev;
-    AjPStr  *ea;
     AjPStr  tmpstr = NULL;
     AjPList methlist = NULL;
     
-    EmbPPatRestrict enz;
     MethPData md = NULL;
     
 
@@ -4632,51 +4750,41 @@ ajuint embPatRestrictMatch(const AjPSeq seq, ajuint begin, ajuint end,
     ajuint plen;
     ajuint i;
     ajuint hits;
-    ajuint ne = 0;
 
-    const char *cp;
     char *p;
     char *q;
 
-    if(enzymes)
-    {
-        ne = ajArrCommaList(enzymes,&ea);
+    if(enzymes && !ajStrParseCountC(enzymes,",\n"))
+        return 0;
 
-        if(!ne)
-            return 0;
+    /*
+    ** The enzyme file is parsed and compiled only when the file or
+    ** the enzyme selection changes, not for every sequence
+    */
+
+    ajFmtPrintS(&patRestrictSetNewkey, "%S %S %u %B %B %B %B",
+                ajFileGetNameS(enzfile), enzymes, sitelen,
+                blunt, sticky, commercial, ambiguity);
+
+    if(!patRestrictSet || enzfile != patRestrictSetFile ||
+       !ajStrMatchS(patRestrictSetNewkey, patRestrictSetKey))
+    {
+        embPatRestrictSetDel(&patRestrictSet);
+        patRestrictSet = embPatRestrictSetNew(enzfile, enzymes, sitelen,
+                                              blunt, sticky, commercial,
+                                              ambiguity);
+        patRestrictSetFile = enzfile;
+        ajStrAssignS(&patRestrictSetKey, patRestrictSetNewkey);
     }
-    
-    name   = ajStrNew();
+
     substr = ajStrNew();
     revstr = ajStrNew();
     binstr = ajStrNew();
     binrev = ajStrNew();
 
-    enz = embPatRestrictNew();
-
     if(methyl)
         methlist = patRestrictReadMethyl(methfile);
     
-    if(!enzymes)
-	isall = ajTrue;
-    else
-    {
-	for(i=0;i<ne;++i)
-	{
-	    ajStrRemoveWhite(&ea[i]);
-	    ajStrFmtUpper(&ea[i]);
-	}
-
-	if(ajStrMatchCaseC(ea[0],"all"))
-	    isall = ajTrue;
-	else
-	    isall = ajFalse;
-    }
-
-
-    
-    ajFileSeek(enzfile,0L,0);
-    ajStrAssignS(&name,ajSeqGetNameS(seq));
     strand = ajSeqGetSeqS(seq);
     ajStrAssignSubS(&substr,strand,begin-1,end-1);
     ajStrFmtUpper(&substr);
@@ -4728,58 +4836,8 @@ ajuint embPatRestrictMatch(const AjPSeq seq, ajuint begin, ajuint end,
     }
 
 
-    hits = 0;
-
-    while(!ajFileIsEof(enzfile))
-    {
-        if(!embPatRestrictReadEntry(enz,enzfile))
-	    continue;
-
-	if(!enz->ncuts)
-	    continue;
-
-	if(enz->len < sitelen)
-	    continue;
-
-	if(!blunt && enz->blunt)
-	    continue;
-
-	if(!sticky && !enz->blunt)
-	    continue;
-
-	cp = ajStrGetPtr(enz->pat);
-
-	if(*cp>='A' && *cp<='Z')
-	    hassup = ajTrue;
-	else
-	    hassup = ajFalse;
-
-	if(!hassup && isall && commercial)
-	    continue;
-
-	ajStrFmtUpper(&enz->pat);
-
-	if(!isall)
-	{
-	    for(i=0;i<ne;++i)
-		if(ajStrMatchCaseS(ea[i],enz->cod))
-		    break;
-
-	    if(i==ne)
-		continue;
-	}
-
-	hits += embPatRestrictScan(enz,substr,binstr,revstr,binrev,len,
-				   ambiguity,plasmid,min,max,begin,l);
-    }
-
-
-
-    for(i=0;i<ne;++i)
-	ajStrDel(&ea[i]);
-
-    if(ne)
-	AJFREE(ea);
+    hits = embPatRestrictSetScan(patRestrictSet,substr,binstr,revstr,binrev,
+                                 len,plasmid,min,max,begin,l);
 
     if(methyl)
     {
@@ -4794,19 +4852,1303 @@ ajuint embPatRestrictMatch(const AjPSeq seq, ajuint begin, ajuint end,
         ajListFree(&methlist);
     }
     
-    ajStrDel(&name);
     ajStrDel(&substr);
     ajStrDel(&revstr);
     ajStrDel(&binstr);
     ajStrDel(&binrev);
+
+    return hits;
+}
+
+
+
+
+/* @func embPatRestrictSetNew *************************************************
+**
+** Read the enzymes selected for a run from an enzyme file and compile
+** their recognition sites into a single automaton
+**
+** @param [u] enzfile [AjPFile] file pointer to .enz file
+** @param [r] enzymes [const AjPStr] comma separated list of REs
+**                                  or NULL for all
+** @param [r] sitelen [ajuint] minimum length of recognition site
+** @param [r] blunt [AjBool] Allow blunt cutters
+** @param [r] sticky [AjBool] Allow sticky cutters
+** @param [r] commercial [AjBool] Allow Only report REs with a supplier
+** @param [r] ambiguity [AjBool] Allow ambiguities
+**
+** @return [EmbPPatRestrictSet] Compiled enzyme set
+** @category new [EmbPPatRestrictSet] Constructor from an enzyme file
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+EmbPPatRestrictSet embPatRestrictSetNew(AjPFile enzfile,
+                                        const AjPStr enzymes,
+                                        ajuint sitelen,
+                                        AjBool blunt, AjBool sticky,
+                                        AjBool commercial,
+                                        AjBool ambiguity)
+{
+    EmbPPatRestrictSet set = NULL;
+    EmbPPatRestrict enz;
+    AjPList enzlist;
+    AjPStr *ea = NULL;
+    AjBool hassup;
+    AjBool isall = ajTrue;
+    ajuint ne = 0;
+    ajuint nstates = 0;
+    ajuint i;
+    ajuint j;
+    ajuint s;
+    ajuint v;
+    ajuint word;
+    ajulong bit;
+    ajint mincut;
+    const char *cp;
+    const char *bp;
+
+    AJNEW0(set);
+    set->Ambiguity = ambiguity;
+
+    if(ambiguity)
+        set->Nalpha = 16;
+    else
+        set->Nalpha = 256;
+
+    if(enzymes)
+    {
+        ne = ajArrCommaList(enzymes,&ea);
+
+        if(!ne)
+            return set;
+
+	for(i=0;i<ne;++i)
+	{
+	    ajStrRemoveWhite(&ea[i]);
+	    ajStrFmtUpper(&ea[i]);
+	}
+
+	if(ajStrMatchCaseC(ea[0],"all"))
+	    isall = ajTrue;
+	else
+	    isall = ajFalse;
+    }
+
+    enzlist = ajListNew();
+    enz = embPatRestrictNew();
+
+    ajFileSeek(enzfile,0L,0);
+
+    while(!ajFileIsEof(enzfile))
+    {
+        if(!embPatRestrictReadEntry(enz,enzfile))
+	    continue;
+
+	if(!enz->ncuts)
+	    continue;
+
+	if(enz->len < sitelen)
+	    continue;
+
+	if(!blunt && enz->blunt)
+	    continue;
+
+	if(!sticky && !enz->blunt)
+	    continue;
+
+	cp = ajStrGetPtr(enz->pat);
+
+	if(*cp>='A' && *cp<='Z')
+	    hassup = ajTrue;
+	else
+	    hassup = ajFalse;
+
+	if(!hassup && isall && commercial)
+	    continue;
+
+	ajStrFmtUpper(&enz->pat);
+
+	if(!isall)
+	{
+	    for(i=0;i<ne;++i)
+		if(ajStrMatchCaseS(ea[i],enz->cod))
+		    break;
+
+	    if(i==ne)
+		continue;
+	}
+
+        nstates += enz->len;
+        ajListPushAppend(enzlist, enz);
+        enz = embPatRestrictNew();
+    }
+
     embPatRestrictDel(&enz);
 
+    for(i=0;i<ne;++i)
+	ajStrDel(&ea[i]);
+
+    if(ne)
+	AJFREE(ea);
+
+    set->Nenz = (ajuint) ajListToarray(enzlist, (void***) &set->Enzymes);
+    ajListFree(&enzlist);
+
+    ajDebug("embPatRestrictSetNew %u enzymes %u states\n",
+            set->Nenz, nstates);
+
+    if(!set->Nenz || !nstates)
+        return set;
+
+    set->Nwords = (nstates + PATRESTRICTWORDBITS - 1) / PATRESTRICTWORDBITS;
+
+    AJCNEW0(set->Masks, set->Nalpha * set->Nwords);
+    AJCNEW0(set->Start, set->Nwords);
+    AJCNEW0(set->Final, set->Nwords);
+    AJCNEW0(set->State, set->Nwords);
+    AJCNEW0(set->Finalenz, nstates);
+    AJCNEW0(set->Mincut, set->Nenz);
+    AJCNEW0(set->Fwdhits, set->Nenz);
+    AJCNEW0(set->Revhits, set->Nenz);
+    AJCNEW0(set->Nfwd, set->Nenz);
+    AJCNEW0(set->Nrev, set->Nenz);
+
+    /*
+    ** One automaton state per site position. A sequence symbol matches
+    ** the states it would match in embPatRestrictScan.
+    */
+
+    for(i=0,s=0;i<set->Nenz;++i)
+    {
+        enz = set->Enzymes[i];
+
+        mincut=AJMIN(enz->cut1,enz->cut2);
+
+        if(enz->ncuts==4)
+        {
+            mincut=AJMIN(mincut,enz->cut3);
+            mincut=AJMIN(mincut,enz->cut4);
+        }
+
+        set->Mincut[i] = mincut;
+        set->Fwdhits[i] = ajUintNew();
+        set->Revhits[i] = ajUintNew();
+
+        cp = ajStrGetPtr(enz->pat);
+        bp = ajStrGetPtr(enz->bin);
+
+        for(j=0;j<enz->len;++j,++s)
+        {
+            word = s / PATRESTRICTWORDBITS;
+            bit = (ajulong) 1 << (s % PATRESTRICTWORDBITS);
+
+            if(!j)
+                set->Start[word] |= bit;
+
+            if(j+1 == enz->len)
+            {
+                set->Final[word] |= bit;
+                set->Finalenz[s] = i;
+            }
+
+            if(ambiguity)
+            {
+                for(v=0;v<15;++v)
+                    if(bp[j] & v)
+                        set->Masks[v*set->Nwords + word] |= bit;
+            }
+            else if(cp[j] != 'N')
+            {
+                v = (unsigned char) cp[j];
+                set->Masks[v*set->Nwords + word] |= bit;
+            }
+        }
+    }
+
+    return set;
+}
+
+
+
+
+/* @func embPatRestrictSetDel *************************************************
+**
+** Delete a compiled enzyme set
+**
+** @param [d] Pset [EmbPPatRestrictSet*] Compiled enzyme set
+** @return [void]
+** @category delete [EmbPPatRestrictSet] Standard destructor
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void embPatRestrictSetDel(EmbPPatRestrictSet *Pset)
+{
+    EmbPPatRestrictSet set;
+    ajuint i;
+
+    if(!Pset || !*Pset)
+        return;
+
+    set = *Pset;
+
+    for(i=0;i<set->Nenz;++i)
+    {
+        embPatRestrictDel(&set->Enzymes[i]);
+
+        if(set->Fwdhits)
+        {
+            ajUintDel(&set->Fwdhits[i]);
+            ajUintDel(&set->Revhits[i]);
+        }
+    }
+
+    AJFREE(set->Enzymes);
+    AJFREE(set->Masks);
+    AJFREE(set->Start);
+    AJFREE(set->Final);
+    AJFREE(set->State);
+    AJFREE(set->Finalenz);
+    AJFREE(set->Mincut);
+    AJFREE(set->Fwdhits);
+    AJFREE(set->Revhits);
+    AJFREE(set->Nfwd);
+    AJFREE(set->Nrev);
+
+    AJFREE(*Pset);
+
+    return;
+}
+
+
+
+
+/* @funcstatic patRestrictSetSearch *******************************************
+**
+** Run one strand of a sequence through the automaton of a compiled
+** enzyme set, saving the start position of every complete site
+**
+** @param [u] set [EmbPPatRestrictSet] Compiled enzyme set
+** @param [r] text [const AjPStr] Strand as ASCII or binary IUB
+** @param [u] hits [AjPUint*] Match positions of each enzyme
+** @param [w] nhits [ajuint*] Number of matches of each enzyme
+**
+** @return [void]
+**
+** @release 6.6.0
+******************************************************************************/
+
+static void patRestrictSetSearch(EmbPPatRestrictSet set, const AjPStr text,
+                                 AjPUint *hits, ajuint *nhits)
+{
+    const unsigned char *p;
+    const ajulong *mask;
+    ajulong *state;
+    ajulong carry;
+    ajulong x;
+    ajulong found;
+    ajuint nwords;
+    ajuint tlen;
+    ajuint t;
+    ajuint w;
+    ajuint b;
+    ajuint e;
+
+    p = (const unsigned char *) ajStrGetPtr(text);
+    tlen = ajStrGetLen(text);
+    nwords = set->Nwords;
+    state = set->State;
+
+    for(w=0;w<nwords;++w)
+        state[w] = 0;
+
+    for(e=0;e<set->Nenz;++e)
+        nhits[e] = 0;
+
+    for(t=0;t<tlen;++t)
+    {
+        if(p[t] >= set->Nalpha)
+            mask = NULL;
+        else
+            mask = &set->Masks[p[t]*nwords];
+
+        carry = 0;
+        found = 0;
+
+        for(w=0;w<nwords;++w)
+        {
+            x = state[w];
+
+            if(mask)
+                state[w] = ((x << 1) | carry | set->Start[w]) & mask[w];
+            else
+                state[w] = 0;
+
+            carry = x >> (PATRESTRICTWORDBITS - 1);
+            found |= state[w] & set->Final[w];
+        }
+
+        if(!found)
+            continue;
+
+        for(w=0;w<nwords;++w)
+        {
+            found = state[w] & set->Final[w];
+
+            for(b=0; found; ++b, found >>= 1)
+            {
+                if(!(found & 1))
+                    continue;
+
+                e = set->Finalenz[w*PATRESTRICTWORDBITS + b];
+                ajUintPut(&hits[e], nhits[e]++,
+                          t + 1 - set->Enzymes[e]->len);
+            }
+        }
+    }
+
+    return;
+}
+
+
+
+
+/* @func embPatRestrictSetScan ************************************************
+**
+** Scan a sequence with a compiled enzyme set. Each strand is read once
+** for all enzymes. Hits are reported as embPatRestrictScan would report
+** them for each enzyme in turn.
+**
+** @param [u] set [EmbPPatRestrictSet] Compiled enzyme set
+** @param [r] substr [const AjPStr] Sequence as ASCII
+** @param [r] binstr [const AjPStr] Sequence as binary IUB
+** @param [r] revstr [const AjPStr] Sequence as ASCII reversed
+** @param [r] binrev [const AjPStr] Sequence as binary IUB reversed
+** @param [r] len [ajuint] Length of sequence
+** @param [r] plasmid [AjBool] Allow circular DNA
+** @param [r] min [ajuint] Minimum # of matches allowed
+** @param [r] max [ajuint] Maximum # of matches
+** @param [r] begin [ajuint] Sequence offset
+** @param [u] l [AjPList] List to push hits to
+**
+** @return [ajuint] Number of matches
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+ajuint embPatRestrictSetScan(EmbPPatRestrictSet set,
+                             const AjPStr substr, const AjPStr binstr,
+                             const AjPStr revstr, const AjPStr binrev,
+                             ajuint len, AjBool plasmid, ajuint min,
+                             ajuint max, ajuint begin, AjPList l)
+{
+    EmbPPatRestrict enz;
+    AjPList tx;
+    ajuint limit;
+    ajuint hits = 0;
+    ajuint nhits;
+    ajuint pos;
+    ajuint i;
+    ajuint k;
+
+    if(!set->Nwords)
+        return 0;
+
+    if(set->Ambiguity)
+    {
+        patRestrictSetSearch(set, binstr, set->Fwdhits, set->Nfwd);
+        patRestrictSetSearch(set, binrev, set->Revhits, set->Nrev);
+    }
+    else
+    {
+        patRestrictSetSearch(set, substr, set->Fwdhits, set->Nfwd);
+        patRestrictSetSearch(set, revstr, set->Revhits, set->Nrev);
+    }
+
+    tx = ajListNew();
+
+    for(i=0;i<set->Nenz;++i)
+    {
+        enz = set->Enzymes[i];
+
+        if(len < enz->len)
+            continue;
+
+        if(plasmid)
+            limit=len;
+        else
+            limit=len-enz->len+1;
+
+        nhits = 0;
+
+        for(k=0;k<set->Nfwd[i];++k)
+        {
+            pos = ajUintGet(set->Fwdhits[i], k);
+
+            if(patRestrictSiteValid(enz,pos,len,limit,set->Mincut[i],
+                                    plasmid))
+            {
+                ++nhits;
+                patRestrictPushHit(enz,tx,pos,begin,len,ajTrue,plasmid);
+            }
+        }
+
+        for(k=0;k<set->Nrev[i];++k)
+        {
+            pos = ajUintGet(set->Revhits[i], k);
+
+            if(patRestrictSiteValid(enz,pos,len,limit,set->Mincut[i],
+                                    plasmid))
+            {
+                ++nhits;
+                patRestrictPushHit(enz,tx,pos,begin,len,ajFalse,plasmid);
+            }
+        }
+
+        hits += patRestrictScanHits(tx,nhits,min,max,l);
+    }
+
+    ajListFree(&tx);
+
+    return hits;
+}
+
+
+
+
+/* @funcstatic patSiteParse ***************************************************
+**
+** Split a classified nucleotide pattern into one element for each
+** position. An element is a single symbol, '?' for any symbol, or a
+** class starting with '[' or a complement class starting with '{'.
+**
+** @param [r] cleanpat [const AjPStr] Pattern from embPatClassify
+** @param [u] elems [AjPList] List of AjPStr elements to append to
+**
+** @return [ajuint] Number of positions, zero if the pattern does not
+**                  have a fixed length
+**
+** @release 6.6.0
+******************************************************************************/
+
+static ajuint patSiteParse(const AjPStr cleanpat, AjPList elems)
+{
+    const char *p;
+    const char *q;
+    AjPStr elem = NULL;
+    ajuint n;
+    ajuint len = 0;
+
+    p = ajStrGetPtr(cleanpat);
+
+    while(*p)
+    {
+        if(*p=='[' || *p=='{')
+        {
+            q = strchr(p, (*p=='[') ? ']' : '}');
+
+            if(!q)
+            {
+                ajStrDel(&elem);
+                return 0;
+            }
+
+            ajStrAssignLenC(&elem, p, q-p);
+            p = q+1;
+        }
+        else if(isalpha((ajuint)*p) || *p=='?')
+        {
+            ajStrAssignLenC(&elem, p, 1);
+            ++p;
+        }
+        else
+        {
+            ajStrDel(&elem);
+            return 0;
+        }
+
+        n = 1;
+
+        if(*p=='(')
+        {
+            for(n=0,++p; isdigit((ajuint)*p); ++p)
+                n = n*10 + (*p-'0');
+
+            if(*p!=')' || !n)
+            {
+                ajStrDel(&elem);
+                return 0;
+            }
+
+            ++p;
+        }
+
+        len += n;
+
+        while(n--)
+            ajListPushAppend(elems, ajStrNewS(elem));
+    }
+
+    ajStrDel(&elem);
+
+    return len;
+}
+
+
+
+
+/* @funcstatic patSiteElemMatch ***********************************************
+**
+** Test whether a sequence symbol matches a pattern element
+**
+** @param [r] elem [const AjPStr] Pattern element from patSiteParse
+** @param [r] c [ajuint] Sequence symbol
+**
+** @return [AjBool] True if the symbol matches
+**
+** @release 6.6.0
+******************************************************************************/
+
+static AjBool patSiteElemMatch(const AjPStr elem, ajuint c)
+{
+    const char *p;
+
+    p = ajStrGetPtr(elem);
+
+    if(!c)
+        return ajFalse;
+
+    if(*p=='?')
+        return ajTrue;
+
+    if(*p=='[')
+        return (strchr(p+1, c) != NULL);
+
+    if(*p=='{')
+        return (strchr(p+1, c) == NULL);
+
+    return ((ajuint) *p == c);
+}
+
+
+
+
+/* @func embPatSiteSetNew *****************************************************
+**
+** Compile a set of nucleotide site patterns, allowing a number of
+** mismatches, into a single automaton.
+**
+** Patterns with a fixed length are compiled. Patterns with ranges or
+** with start or end markers are marked as not compiled and should be
+** searched for with embPatVariablePattern.
+**
+** @param [r] patterns [const AjPStr*] Patterns
+** @param [r] npat [ajuint] Number of patterns
+** @param [r] mismatch [ajuint] Number of mismatches allowed
+**
+** @return [EmbPPatSiteSet] Compiled pattern set
+** @category new [EmbPPatSiteSet] Constructor from an array of patterns
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+EmbPPatSiteSet embPatSiteSetNew(const AjPStr *patterns, ajuint npat,
+                                ajuint mismatch)
+{
+    EmbPPatSiteSet set = NULL;
+    AjPList *elems = NULL;
+    AjPStr cleanpat = NULL;
+    AjPStr elem = NULL;
+    AjBool amino;
+    AjBool carboxyl;
+    AjBool fclass;
+    AjBool ajcompl;
+    AjBool dontcare;
+    AjBool range;
+    ajuint nstates = 0;
+    ajuint i;
+    ajuint j;
+    ajuint c;
+    ajuint s;
+    ajuint word;
+    ajulong bit;
+
+    AJNEW0(set);
+    set->Npat = npat;
+    set->Mismatch = mismatch;
+
+    if(!npat)
+        return set;
+
+    AJCNEW0(set->Compiled, npat);
+    AJCNEW0(set->Len, npat);
+    AJCNEW0(set->Hits, npat);
+    AJCNEW0(set->Nhits, npat);
+    AJCNEW0(set->Maxhits, npat);
+    AJCNEW0(elems, npat);
+
+    for(i=0;i<npat;++i)
+    {
+        if(!embPatClassify(patterns[i],&cleanpat,
+                           &amino,&carboxyl,&fclass,&ajcompl,&dontcare,
+                           &range,ajFalse))
+            continue;
+
+        if(range || amino || carboxyl)
+            continue;
+
+        elems[i] = ajListstrNew();
+        set->Len[i] = patSiteParse(cleanpat, elems[i]);
+
+        if(!set->Len[i])
+        {
+            ajListstrFreeData(&elems[i]);
+            continue;
+        }
+
+        set->Compiled[i] = ajTrue;
+        nstates += set->Len[i];
+    }
+
+    ajStrDel(&cleanpat);
+
+    ajDebug("embPatSiteSetNew %u patterns %u states\n", npat, nstates);
+
+    if(nstates)
+    {
+        set->Nwords = (nstates + PATRESTRICTWORDBITS - 1) /
+            PATRESTRICTWORDBITS;
+
+        AJCNEW0(set->Masks, 256 * set->Nwords);
+        AJCNEW0(set->Start, set->Nwords);
+        AJCNEW0(set->Final, set->Nwords);
+        AJCNEW0(set->State, (mismatch+1) * set->Nwords);
+        AJCNEW0(set->Carry, mismatch+1);
+        AJCNEW0(set->Finalpat, nstates);
+    }
+
+    /*
+    ** One automaton state per pattern position. A sequence symbol
+    ** matches the states whose element accepts it.
+    */
+
+    for(i=0,s=0;i<npat;++i)
+    {
+        if(!set->Compiled[i])
+            continue;
+
+        for(j=0;ajListstrPop(elems[i],&elem);++j,++s)
+        {
+            word = s / PATRESTRICTWORDBITS;
+            bit = (ajulong) 1 << (s % PATRESTRICTWORDBITS);
+
+            if(!j)
+                set->Start[word] |= bit;
+
+            if(j+1 == set->Len[i])
+            {
+                set->Final[word] |= bit;
+                set->Finalpat[s] = i;
+            }
+
+            for(c=1;c<256;++c)
+                if(patSiteElemMatch(elem, c))
+                    set->Masks[c*set->Nwords + word] |= bit;
+
+            ajStrDel(&elem);
+        }
+
+        ajListstrFree(&elems[i]);
+    }
+
+    AJFREE(elems);
+
+    return set;
+}
+
+
+
+
+/* @func embPatSiteSetDel *****************************************************
+**
+** Delete a compiled site pattern set
+**
+** @param [d] Pset [EmbPPatSiteSet*] Compiled pattern set
+** @return [void]
+** @category delete [EmbPPatSiteSet] Standard destructor
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void embPatSiteSetDel(EmbPPatSiteSet *Pset)
+{
+    EmbPPatSiteSet set;
+    ajuint i;
+
+    if(!Pset || !*Pset)
+        return;
+
+    set = *Pset;
+
+    for(i=0;i<set->Npat;++i)
+        AJFREE(set->Hits[i]);
+
+    AJFREE(set->Compiled);
+    AJFREE(set->Len);
+    AJFREE(set->Hits);
+    AJFREE(set->Nhits);
+    AJFREE(set->Maxhits);
+    AJFREE(set->Masks);
+    AJFREE(set->Start);
+    AJFREE(set->Final);
+    AJFREE(set->State);
+    AJFREE(set->Carry);
+    AJFREE(set->Finalpat);
+
+    AJFREE(*Pset);
+
+    return;
+}
+
+
+
+
+/* @func embPatSiteSetScan ****************************************************
+**
+** Scan a sequence once for all compiled patterns of a site pattern set.
+**
+** The start position (0 for the first base) of every match with no more
+** than the allowed number of mismatches is saved in the Hits array of
+** its pattern, in sequence order.
+**
+** @param [u] set [EmbPPatSiteSet] Compiled pattern set
+** @param [r] text [const AjPStr] Sequence
+**
+** @return [ajuint] Number of matches
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+ajuint embPatSiteSetScan(EmbPPatSiteSet set, const AjPStr text)
+{
+    const unsigned char *p;
+    const ajulong *mask;
+    ajulong *state;
+    ajulong *carry;
+    ajulong x;
+    ajulong y;
+    ajulong found;
+    ajuint nwords;
+    ajuint mm;
+    ajuint tlen;
+    ajuint t;
+    ajuint w;
+    ajuint b;
+    ajuint i;
+    ajuint k;
+    ajuint hits = 0;
+
+    for(i=0;i<set->Npat;++i)
+        set->Nhits[i] = 0;
+
+    if(!set->Nwords)
+        return 0;
+
+    p = (const unsigned char *) ajStrGetPtr(text);
+    tlen = ajStrGetLen(text);
+    nwords = set->Nwords;
+    mm = set->Mismatch;
+    state = set->State;
+    carry = set->Carry;
+
+    for(w=0;w<(mm+1)*nwords;++w)
+        state[w] = 0;
+
+    /*
+    ** state[k] holds the pattern prefixes matching the text so far with
+    ** at most k mismatches. Vectors are updated from the highest k down
+    ** so each can still read the previous value of state[k-1].
+    */
+
+    for(t=0;t<tlen;++t)
+    {
+        mask = &set->Masks[p[t]*nwords];
+        found = 0;
+
+        for(k=0;k<=mm;++k)
+            carry[k] = 0;
+
+        for(w=0;w<nwords;++w)
+        {
+            for(k=mm;k>0;--k)
+            {
+                x = state[k*nwords + w];
+                y = state[(k-1)*nwords + w];
+                state[k*nwords + w] =
+                    (((x << 1) | carry[k] | set->Start[w]) & mask[w]) |
+                    (y << 1) | carry[k-1] | set->Start[w];
+                carry[k] = x >> (PATRESTRICTWORDBITS - 1);
+            }
+
+            x = state[w];
+            state[w] = ((x << 1) | carry[0] | set->Start[w]) & mask[w];
+            carry[0] = x >> (PATRESTRICTWORDBITS - 1);
+
+            found |= state[mm*nwords + w] & set->Final[w];
+        }
+
+        if(!found)
+            continue;
+
+        for(w=0;w<nwords;++w)
+        {
+            found = state[mm*nwords + w] & set->Final[w];
+
+            for(b=0; found; ++b, found >>= 1)
+            {
+                if(!(found & 1))
+                    continue;
+
+                i = set->Finalpat[w*PATRESTRICTWORDBITS + b];
+
+                if(set->Nhits[i] == set->Maxhits[i])
+                {
+                    set->Maxhits[i] = set->Maxhits[i] ?
+                        2*set->Maxhits[i] : 64;
+                    AJCRESIZE(set->Hits[i], set->Maxhits[i]);
+                }
+
+                set->Hits[i][set->Nhits[i]++] = t + 1 - set->Len[i];
+                ++hits;
+            }
+        }
+    }
+
+    return hits;
+}
+
+
+
+
+/* @funcstatic patSeedBase ****************************************************
+**
+** Return the two bit code of a base for a seed k-mer
+**
+** @param [r] c [char] Sequence symbol
+**
+** @return [ajint] Code from 0 to 3, or -1 if not an upper case ACGT base
+**
+** @release 6.6.0
+******************************************************************************/
+
+static ajint patSeedBase(char c)
+{
+    switch(c)
+    {
+        case 'A':
+            return 0;
+        case 'C':
+            return 1;
+        case 'G':
+            return 2;
+        case 'T':
+            return 3;
+        default:
+            break;
+    }
+
+    return -1;
+}
+
+
+
+
+/* @funcstatic patSeedCheck ***************************************************
+**
+** Check a seed hit against the whole of its pattern, and save the match
+** if it has no more than the allowed number of mismatches.
+**
+** A match is only saved from the first of its pattern's seeds that it
+** matches exactly, so each match is found once.
+**
+** @param [u] set [EmbPPatSeedSet] Seed set
+** @param [r] seed [ajuint] Seed number
+** @param [r] text [const char*] Sequence
+** @param [r] tlen [ajuint] Sequence length
+** @param [r] t [ajuint] Position of the last base of the seed hit
+**
+** @return [AjBool] True if a match was saved
+**
+** @release 6.6.0
+******************************************************************************/
+
+static AjBool patSeedCheck(EmbPPatSeedSet set, ajuint seed,
+                           const char *text, ajuint tlen, ajuint t)
+{
+    const char *pat;
+    const char *seq;
+    ajuint i;
+    ajuint k;
+    ajuint s;
+    ajuint len;
+    ajuint start;
+    ajuint maxmm;
+    ajuint mm = 0;
+    ajuint n;
+    ajuint *hits;
+    ajuint *hitmm;
+
+    i = set->Seedpat[seed];
+    k = set->Kmer[i];
+    len = set->Len[i];
+
+    if(t + 1 < k + set->Seedoff[seed])
+        return ajFalse;
+
+    start = t + 1 - k - set->Seedoff[seed];
+
+    if(start + len > tlen)
+        return ajFalse;
+
+    pat = ajStrGetPtr(set->Pattern[i]);
+    seq = &text[start];
+
+    for(s=set->Firstseed[i];s<seed;++s)
+        if(!strncmp(&seq[set->Seedoff[s]], &pat[set->Seedoff[s]], k))
+            return ajFalse;
+
+    maxmm = set->Mismatch[i];
+
+    for(s=0;s<len;++s)
+        if(seq[s] != pat[s] && ++mm > maxmm)
+            return ajFalse;
+
+    if(set->Nhits[i] == set->Maxhits[i])
+    {
+        set->Maxhits[i] = set->Maxhits[i] ? 2*set->Maxhits[i] : 64;
+        AJCRESIZE(set->Hits[i], set->Maxhits[i]);
+        AJCRESIZE(set->Hitmm[i], set->Maxhits[i]);
+    }
+
+    /*
+    ** Matches from different seeds arrive slightly out of order, but
+    ** never by more than a pattern length, so insert in place
+    */
+
+    hits = set->Hits[i];
+    hitmm = set->Hitmm[i];
+
+    for(n=set->Nhits[i]; n && hits[n-1] > start; --n)
+    {
+        hits[n] = hits[n-1];
+        hitmm[n] = hitmm[n-1];
+    }
+
+    hits[n] = start;
+    hitmm[n] = mm;
+    ++set->Nhits[i];
+
+    return ajTrue;
+}
+
+
+
+
+/* @func embPatSeedSetNew *****************************************************
+**
+** Build a k-mer seed index for a set of nucleotide patterns, each with
+** its own number of allowed mismatches.
+**
+** Patterns made only of upper case ACGT, and longer than their number of
+** mismatches, are indexed. Other patterns, and NULL patterns, are marked
+** as not compiled and should be searched for with embPatFuzzSearch.
+**
+** @param [r] patterns [const AjPStr*] Patterns
+** @param [r] mismatch [const ajuint*] Number of mismatches allowed for
+**                                     each pattern
+** @param [r] npat [ajuint] Number of patterns
+**
+** @return [EmbPPatSeedSet] Seed set
+** @category new [EmbPPatSeedSet] Constructor from an array of patterns
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+EmbPPatSeedSet embPatSeedSetNew(const AjPStr *patterns,
+                                const ajuint *mismatch, ajuint npat)
+{
+    EmbPPatSeedSet set = NULL;
+    const char *p;
+    ajuint i;
+    ajuint j;
+    ajuint k;
+    ajuint s;
+    ajuint b;
+    ajuint len;
+    ajuint nseg;
+    ajuint code;
+
+    AJNEW0(set);
+    set->Npat = npat;
+
+    if(!npat)
+        return set;
+
+    AJCNEW0(set->Compiled, npat);
+    AJCNEW0(set->Pattern, npat);
+    AJCNEW0(set->Len, npat);
+    AJCNEW0(set->Mismatch, npat);
+    AJCNEW0(set->Kmer, npat);
+    AJCNEW0(set->Firstseed, npat);
+    AJCNEW0(set->Hits, npat);
+    AJCNEW0(set->Hitmm, npat);
+    AJCNEW0(set->Nhits, npat);
+    AJCNEW0(set->Maxhits, npat);
+    AJCNEW0(set->Heads, PATSEEDMAXK+1);
+
+    for(i=0;i<npat;++i)
+    {
+        if(!patterns[i])
+            continue;
+
+        len = ajStrGetLen(patterns[i]);
+        nseg = mismatch[i] + 1;
+
+        if(len < nseg)
+            continue;
+
+        for(p=ajStrGetPtr(patterns[i]); *p; ++p)
+            if(patSeedBase(*p) < 0)
+                break;
+
+        if(*p)
+            continue;
+
+        set->Compiled[i] = ajTrue;
+        set->Pattern[i] = ajStrNewS(patterns[i]);
+        set->Len[i] = len;
+        set->Mismatch[i] = mismatch[i];
+        set->Kmer[i] = (len/nseg < PATSEEDMAXK) ? len/nseg : PATSEEDMAXK;
+        set->Firstseed[i] = set->Nseeds;
+        set->Nseeds += nseg;
+
+        if(set->Kmer[i] > set->Maxk)
+            set->Maxk = set->Kmer[i];
+    }
+
+    ajDebug("embPatSeedSetNew %u patterns %u seeds\n", npat, set->Nseeds);
+
+    if(!set->Nseeds)
+        return set;
+
+    AJCNEW0(set->Next, set->Nseeds);
+    AJCNEW0(set->Seedpat, set->Nseeds);
+    AJCNEW0(set->Seedoff, set->Nseeds);
+
+    /*
+    ** Segment j of a pattern starts at j*len/nseg, and its seed is the
+    ** first Kmer bases. Seeds are chained from a table for their length.
+    */
+
+    for(i=0;i<npat;++i)
+    {
+        if(!set->Compiled[i])
+            continue;
+
+        k = set->Kmer[i];
+        len = set->Len[i];
+        nseg = set->Mismatch[i] + 1;
+        p = ajStrGetPtr(set->Pattern[i]);
+
+        if(!set->Heads[k])
+            AJCNEW0(set->Heads[k], (size_t) 1 << (2*k));
+
+        for(j=0;j<nseg;++j)
+        {
+            s = set->Firstseed[i] + j;
+            set->Seedpat[s] = i;
+            set->Seedoff[s] = j*len/nseg;
+
+            code = 0;
+
+            for(b=0;b<k;++b)
+                code = (code << 2) | (ajuint) patSeedBase(p[set->Seedoff[s]+b]);
+
+            set->Next[s] = set->Heads[k][code];
+            set->Heads[k][code] = s + 1;
+        }
+    }
+
+    return set;
+}
+
+
+
+
+/* @func embPatSeedSetDel *****************************************************
+**
+** Delete a k-mer seed set
+**
+** @param [d] Pset [EmbPPatSeedSet*] Seed set
+** @return [void]
+** @category delete [EmbPPatSeedSet] Standard destructor
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void embPatSeedSetDel(EmbPPatSeedSet *Pset)
+{
+    EmbPPatSeedSet set;
+    ajuint i;
+
+    if(!Pset || !*Pset)
+        return;
+
+    set = *Pset;
+
+    for(i=0;i<set->Npat;++i)
+    {
+        ajStrDel(&set->Pattern[i]);
+        AJFREE(set->Hits[i]);
+        AJFREE(set->Hitmm[i]);
+    }
+
+    if(set->Heads)
+        for(i=0;i<=PATSEEDMAXK;++i)
+            AJFREE(set->Heads[i]);
+
+    AJFREE(set->Compiled);
+    AJFREE(set->Pattern);
+    AJFREE(set->Len);
+    AJFREE(set->Mismatch);
+    AJFREE(set->Kmer);
+    AJFREE(set->Firstseed);
+    AJFREE(set->Hits);
+    AJFREE(set->Hitmm);
+    AJFREE(set->Nhits);
+    AJFREE(set->Maxhits);
+    AJFREE(set->Heads);
+    AJFREE(set->Next);
+    AJFREE(set->Seedpat);
+    AJFREE(set->Seedoff);
+
+    AJFREE(*Pset);
+
+    return;
+}
+
+
+
+
+/* @func embPatSeedSetScan ****************************************************
+**
+** Scan a sequence once for all compiled patterns of a k-mer seed set.
+**
+** The start position (0 for the first base) of every match with no more
+** than the pattern's allowed number of mismatches is saved in the Hits
+** array of its pattern, in sequence order, with its number of mismatches
+** in the Hitmm array.
+**
+** @param [u] set [EmbPPatSeedSet] Seed set
+** @param [r] text [const AjPStr] Sequence
+**
+** @return [ajuint] Number of matches
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+ajuint embPatSeedSetScan(EmbPPatSeedSet set, const AjPStr text)
+{
+    const char *p;
+    ajuint tlen;
+    ajuint t;
+    ajuint k;
+    ajuint i;
+    ajuint s;
+    ajuint valid = 0;
+    ajuint code = 0;
+    ajint c;
+    ajuint hits = 0;
+
+    for(i=0;i<set->Npat;++i)
+        set->Nhits[i] = 0;
+
+    if(!set->Nseeds)
+        return 0;
+
+    p = ajStrGetPtr(text);
+    tlen = ajStrGetLen(text);
+
+    /*
+    ** code holds the last Maxk bases, valid counts how many of them are
+    ** ACGT; any other symbol breaks every seed that spans it
+    */
+
+    for(t=0;t<tlen;++t)
+    {
+        c = patSeedBase(p[t]);
+
+        if(c < 0)
+        {
+            valid = 0;
+            continue;
+        }
+
+        code = (code << 2) | (ajuint) c;
+
+        if(valid < set->Maxk)
+            ++valid;
+
+        for(k=1;k<=valid;++k)
+        {
+            if(!set->Heads[k])
+                continue;
+
+            for(s=set->Heads[k][code & (((ajuint) 1 << (2*k)) - 1)];
+                s; s=set->Next[s-1])
+                if(patSeedCheck(set, s-1, p, tlen, t))
+                    ++hits;
+        }
+    }
+
     return hits;
 }
 
 
 
 
+/* @func embPatExit ***********************************************************
+**
+** Cleanup restriction enzyme matching internals on exit
+**
+** @return [void]
+**
+** @release 6.6.0
+******************************************************************************/
+
+void embPatExit(void)
+{
+    embPatRestrictSetDel(&patRestrictSet);
+    ajStrDel(&patRestrictSetKey);
+    ajStrDel(&patRestrictSetNewkey);
+    patRestrictSetFile = NULL;
+
+    return;
+}
+
+
+
+
 /* @func embPatGetType ********************************************************
 **
 ** Return the type of a pattern
@@ -41,6 +41,7 @@
 #include "ajlist.h"
 #include "ajfile.h"
 #include "ajpat.h"
+#include "ajreg.h"
 #include "ajseqdata.h"
 #include "ajarr.h"
 
@@ -162,6 +163,167 @@ typedef struct EmbSPatRestrict
 
 
 
+/* @data EmbPPatRestrictSet ***************************************************
+**
+** NUCLEUS data structure for a compiled set of restriction enzymes
+**
+** The recognition sites of all selected enzymes are compiled into one
+** bit-parallel (shift-and) automaton so that a sequence strand can be
+** searched for every enzyme in a single pass.
+**
+** @attr Enzymes [EmbPPatRestrict*] Selected enzymes in file order
+** @attr Masks [ajulong*] Automaton states matched by each sequence symbol
+** @attr Start [ajulong*] First state of each recognition site
+** @attr Final [ajulong*] Last state of each recognition site
+** @attr State [ajulong*] Automaton state work array
+** @attr Finalenz [ajuint*] Enzyme number for each final state
+** @attr Mincut [ajint*] Smallest cut position of each enzyme
+** @attr Fwdhits [AjPUint*] Forward strand match positions of each enzyme
+** @attr Revhits [AjPUint*] Reverse strand match positions of each enzyme
+** @attr Nfwd [ajuint*] Number of forward strand matches of each enzyme
+** @attr Nrev [ajuint*] Number of reverse strand matches of each enzyme
+** @attr Nenz [ajuint] Number of enzymes
+** @attr Nwords [ajuint] Number of words in each state vector
+** @attr Nalpha [ajuint] Number of sequence symbols in the mask table
+** @attr Ambiguity [AjBool] Compiled for ambiguity (binary IUB) matching
+** @@
+******************************************************************************/
+
+typedef struct EmbSPatRestrictSet
+{
+    EmbPPatRestrict *Enzymes;
+    ajulong *Masks;
+    ajulong *Start;
+    ajulong *Final;
+    ajulong *State;
+    ajuint  *Finalenz;
+    ajint   *Mincut;
+    AjPUint *Fwdhits;
+    AjPUint *Revhits;
+    ajuint  *Nfwd;
+    ajuint  *Nrev;
+    ajuint   Nenz;
+    ajuint   Nwords;
+    ajuint   Nalpha;
+    AjBool   Ambiguity;
+} EmbOPatRestrictSet;
+#define EmbPPatRestrictSet EmbOPatRestrictSet*
+
+
+
+
+/* @data EmbPPatSiteSet *******************************************************
+**
+** NUCLEUS data structure for a compiled set of nucleotide site patterns
+**
+** Fixed length patterns are compiled into one bit-parallel (shift-and)
+** automaton with a state vector for each allowed number of mismatches,
+** so that a sequence can be searched for every site in a single pass.
+** Patterns with variable length elements are not compiled and are left
+** to embPatVariablePattern.
+**
+** @attr Compiled [AjBool*] True if the pattern is in the automaton
+** @attr Len [ajuint*] Length of each compiled pattern
+** @attr Hits [ajuint**] Match positions of each pattern
+** @attr Nhits [ajuint*] Number of matches of each pattern
+** @attr Maxhits [ajuint*] Allocated size of each match position array
+** @attr Masks [ajulong*] Automaton states matched by each sequence symbol
+** @attr Start [ajulong*] First state of each pattern
+** @attr Final [ajulong*] Last state of each pattern
+** @attr State [ajulong*] Automaton state work array, one vector for
+**                        each number of mismatches
+** @attr Carry [ajulong*] Carry work array, one for each state vector
+** @attr Finalpat [ajuint*] Pattern number for each final state
+** @attr Npat [ajuint] Number of patterns
+** @attr Nwords [ajuint] Number of words in each state vector
+** @attr Mismatch [ajuint] Number of mismatches allowed
+** @attr Padding [char[4]] Padding to alignment boundary
+** @@
+******************************************************************************/
+
+typedef struct EmbSPatSiteSet
+{
+    AjBool  *Compiled;
+    ajuint  *Len;
+    ajuint **Hits;
+    ajuint  *Nhits;
+    ajuint  *Maxhits;
+    ajulong *Masks;
+    ajulong *Start;
+    ajulong *Final;
+    ajulong *State;
+    ajulong *Carry;
+    ajuint  *Finalpat;
+    ajuint   Npat;
+    ajuint   Nwords;
+    ajuint   Mismatch;
+    char     Padding[4];
+} EmbOPatSiteSet;
+#define EmbPPatSiteSet EmbOPatSiteSet*
+
+
+
+
+/* @data EmbPPatSeedSet *******************************************************
+**
+** NUCLEUS data structure for a k-mer seed index of a set of nucleotide
+** patterns, each allowing its own number of mismatches
+**
+** Each pattern is cut into one more segment than its allowed mismatches,
+** so any match has at least one segment with no mismatch. The first
+** bases of every segment are indexed as a seed, a sequence is scanned
+** once for all seeds, and each seed hit is checked against the whole
+** pattern. Patterns that are not plain ACGT strings, or are too short
+** for their mismatches, are not indexed.
+**
+** @attr Compiled [AjBool*] True if the pattern is indexed
+** @attr Pattern [AjPStr*] Pattern sequences
+** @attr Len [ajuint*] Length of each pattern
+** @attr Mismatch [ajuint*] Number of mismatches allowed for each pattern
+** @attr Kmer [ajuint*] Seed length for each pattern
+** @attr Firstseed [ajuint*] First seed number of each pattern
+** @attr Hits [ajuint**] Match positions of each pattern
+** @attr Hitmm [ajuint**] Number of mismatches of each match
+** @attr Nhits [ajuint*] Number of matches of each pattern
+** @attr Maxhits [ajuint*] Allocated size of each match array
+** @attr Heads [ajuint**] First seed (plus one) for each k-mer code,
+**                        one table for each seed length in use
+** @attr Next [ajuint*] Next seed (plus one) with the same k-mer code
+** @attr Seedpat [ajuint*] Pattern number of each seed
+** @attr Seedoff [ajuint*] Offset of each seed in its pattern
+** @attr Npat [ajuint] Number of patterns
+** @attr Nseeds [ajuint] Number of seeds
+** @attr Maxk [ajuint] Longest seed length
+** @attr Padding [char[4]] Padding to alignment boundary
+** @@
+******************************************************************************/
+
+typedef struct EmbSPatSeedSet
+{
+    AjBool  *Compiled;
+    AjPStr  *Pattern;
+    ajuint  *Len;
+    ajuint  *Mismatch;
+    ajuint  *Kmer;
+    ajuint  *Firstseed;
+    ajuint **Hits;
+    ajuint **Hitmm;
+    ajuint  *Nhits;
+    ajuint  *Maxhits;
+    ajuint **Heads;
+    ajuint  *Next;
+    ajuint  *Seedpat;
+    ajuint  *Seedoff;
+    ajuint   Npat;
+    ajuint   Nseeds;
+    ajuint   Maxk;
+    char     Padding[4];
+} EmbOPatSeedSet;
+#define EmbPPatSeedSet EmbOPatSeedSet*
+
+
+
+
 #define EmbPPatBYPNode AjOPatBYPNode*
 #define EmbOPatBYPNode AjOPatBYPNode
 
@@ -219,6 +381,7 @@ void            embPatCompile(ajuint type, const AjPStr pattern,
 			      ajuint* solimit, ajuint* m, AjPStr* regexp,
 			      ajuint*** skipm,  ajuint mismatch);
 
+void            embPatExit (void);
 void            embPatFuzzSearch(ajuint type, ajuint begin,
 				 const AjPStr pattern,
 				 const AjPStr name,
@@ -274,6 +437,10 @@ EmbPPatMatch    embPatMatchFindAll  (const AjPStr regexp, const AjPStr strng,
                                      AjBool left, AjBool right);
 EmbPPatMatch    embPatMatchFindAllC (const AjPStr regexp, const char *sptr,
                                      AjBool left, AjBool right);
+EmbPPatMatch    embPatMatchFindRegexp (AjPRegexp compexp, AjBool nterm,
+                                       const AjPStr strng);
+EmbPPatMatch    embPatMatchFindRegexpC (AjPRegexp compexp, AjBool nterm,
+                                        const char *sptr);
 ajuint          embPatMatchGetEnd (const EmbPPatMatch data, ajuint indexnum);
 ajuint          embPatMatchGetLen (const EmbPPatMatch data, ajuint indexnum);
 ajuint          embPatMatchGetNumber (const EmbPPatMatch data);
@@ -303,6 +470,21 @@ AjBool          embPatRestrictReadEntry (EmbPPatRestrict re, AjPFile inf);
 
 ajuint          embPatRestrictRestrict (AjPList l, ajuint hits, AjBool isos,
 					AjBool alpha);
+void            embPatRestrictSetDel (EmbPPatRestrictSet *Pset);
+EmbPPatRestrictSet embPatRestrictSetNew (AjPFile enzfile,
+                                         const AjPStr enzymes,
+                                         ajuint sitelen,
+                                         AjBool blunt, AjBool sticky,
+                                         AjBool commercial,
+                                         AjBool ambiguity);
+ajuint          embPatRestrictSetScan (EmbPPatRestrictSet set,
+                                       const AjPStr substr,
+                                       const AjPStr binstr,
+                                       const AjPStr revstr,
+                                       const AjPStr binrev, ajuint len,
+                                       AjBool plasmid, ajuint min,
+                                       ajuint max, ajuint begin,
+                                       AjPList l);
 ajuint          embPatRestrictScan (const EmbPPatRestrict enz,
 				    const AjPStr substr,
 				    const AjPStr binstr, const AjPStr revstr,
@@ -314,6 +496,14 @@ ajuint          embPatRestrictScan (const EmbPPatRestrict enz,
 ajint           embPatRestrictCutCompare(const void *a, const void *b);
 ajint           embPatRestrictNameCompare(const void *a, const void *b);
 ajint           embPatRestrictStartCompare(const void *a, const void *b);
+void            embPatSeedSetDel (EmbPPatSeedSet *Pset);
+EmbPPatSeedSet  embPatSeedSetNew (const AjPStr *patterns,
+                                  const ajuint *mismatch, ajuint npat);
+ajuint          embPatSeedSetScan (EmbPPatSeedSet set, const AjPStr text);
+void            embPatSiteSetDel (EmbPPatSiteSet *Pset);
+EmbPPatSiteSet  embPatSiteSetNew (const AjPStr *patterns, ajuint npat,
+                                  ajuint mismatch);
+ajuint          embPatSiteSetScan (EmbPPatSiteSet set, const AjPStr text);
 EmbPPatMatch    embPatSeqMatchFind  (const AjPSeq seq, const AjPStr reg);
 EmbPPatMatch    embPatSeqMatchFindC (const AjPSeq seq, const char *reg);
 EmbPPatMatch    embPatSeqMatchFindAll  (const AjPSeq seq, const AjPStr reg);
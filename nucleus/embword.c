@@ -67,19 +67,44 @@ static AjPList wordCurList = NULL;
 #define RK_MODULUS 1073741789UL
 #define RK_RADIX 256UL
 
+/*
+** Packed word index parameters. Words of up to 32 bases fit in an ajulong.
+** Offsets are indexed directly by packed word if there would be no more
+** than WORDINDEX_DIRECT offsets per word start. Otherwise the packed words
+** are radix sorted WORDINDEX_BITS bits at a time.
+*/
+
+#define WORDINDEX_MAXLEN    32U
+#define WORDINDEX_MAXDIRECT 16U
+#define WORDINDEX_DIRECT    4UL
+#define WORDINDEX_BITS      16U
+#define WORDINDEX_RADIX     (1U << WORDINDEX_BITS)
+
 
 
+static AjPList  wordBuildMatchTable(const AjPTable table,
+                                    const AjPTableinline itable,
+                                    const AjPSeq seq2, ajint orderit);
 static ajint    wordCmpStr(const void *x, const void *y);
 static ajint    wordCompare(const void *x, const void *y);
+static AjIList  wordCurIterNew(void);
 static void     wordCurIterTrace(const AjIList curiter);
 static void     wordCurListTrace(const AjPList curlist);
 static ajint    wordDeadZone(EmbPWordMatch match,
 			     ajint deadx1, ajint deady1,
 			     int deadx2, ajint deady2, ajint minlength);
+static ajuint   wordGetStarts(const AjPSeq seq, ajuint** Pstarts);
+static AjBool   wordGetTable(AjPTable *table, AjPTableinline *itable,
+                             const AjPSeq seq);
+static ajint    wordIndexBase(char c);
+static ajulong  wordIndexMask(ajuint wordlen);
 static void     wordListInsertNodeOld(AjPListNode* pnode, void* x);
 static void     wordListInsertOld(AjIList iter, void* x);
 static ajint    wordMatchCmp(const void* v1, const void* v2);
 static ajint    wordMatchCmpPos(const void* v1, const void* v2);
+static void     wordMatchDone(AjPList hitlist, ajint orderit);
+static void     wordMatchPos(AjPList hitlist, AjIList curiter,
+                             const AjPSeq seq2, ajuint i, ajuint knew);
 static void     wordNewListTrace(ajint i, const AjPList newlist);
 static void     wordOrderPosMatchTable(AjPList unorderedList);
 
@@ -440,6 +465,39 @@ void embWordFreeTable(AjPTable *table)
 
 
 
+/* @func embWordFreeIndex *****************************************************
+**
+** Delete a word index and free the memory.
+**
+** @param [d] Pindex [EmbPWordIndex*] Index to be deleted
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+void embWordFreeIndex(EmbPWordIndex* Pindex)
+{
+    EmbPWordIndex index;
+
+    if(!Pindex || !*Pindex)
+        return;
+
+    index = *Pindex;
+
+    ajTableinlineDelValdel(&index->Table, &wordVFreeLocs);
+    ajTableinlineDel(&index->Kmers);
+
+    AJFREE(index->Offsets);
+    AJFREE(index->Positions);
+    AJFREE(*Pindex);
+
+    return;
+}
+
+
+
+
 /* @funcstatic wordMatchListDelete ********************************************
 **
 ** deletes entries in a list of matches.
@@ -615,36 +673,36 @@ void embWordMatchListConvToFeat(const AjPList list,
 
 
 
-/* @func embWordGetTable ******************************************************
+/* @funcstatic wordGetStarts **************************************************
 **
-** Builds a table of all words in a sequence.
+** Finds the start positions of the words in a sequence that are used
+** by embWordGetTable and embWordGetIndex.
 **
-** The word length must be defined by a call to embWordLength.
+** Words are skipped where their last position (or, at the start of the
+** sequence, any position) is the unknown residue code N for nucleotides
+** or X for proteins.
 **
-** @param [u] table [AjPTable*] table to be created or updated.
 ** @param [r] seq [const AjPSeq] Sequence to be "worded"
-** @return [AjBool] ajTrue if successful
+** @param [w] Pstarts [ajuint**] Word start positions, to be freed by
+**                               the caller
+** @return [ajuint] Number of words, zero if there are none
 **
-** @release 1.0.0
+** @release 6.6.0
 ** @@
 ******************************************************************************/
 
-AjBool embWordGetTable(AjPTable *table, const AjPSeq seq)
+static ajuint wordGetStarts(const AjPSeq seq, ajuint** Pstarts)
 {
     const char * startptr;
     ajuint i;
     ajuint j;
     ajuint ilast;
-    ajuint *k;
-    EmbPWord rec;
-    EmbPWordSeqLocs seqlocs;
-    const AjPStr seqname;
-    char* key;
+    ajuint nstarts = 0;
+    ajuint *starts = NULL;
 
-    ajuint wordsize;
     char skipchar;
 
-    wordsize = wordLength+1;
+    *Pstarts = NULL;
 
     skipchar = 'X';
 
@@ -653,7 +711,7 @@ AjBool embWordGetTable(AjPTable *table, const AjPSeq seq)
 
     assert(wordLength > 0);
 
-    ajDebug("embWordGetTable seq.len %d wordlength %d skipchar '%c'\n",
+    ajDebug("wordGetStarts seq.len %d wordlength %d skipchar '%c'\n",
 	     ajSeqGetLen(seq), wordLength, skipchar);
 
     if(ajSeqGetLen(seq) < wordLength)
@@ -661,15 +719,7 @@ AjBool embWordGetTable(AjPTable *table, const AjPSeq seq)
 	ajDebug("sequence too short: wordsize = %d, sequence length = %d",
 	       wordLength, ajSeqGetLen(seq));
 
-	return ajFalse;
-    }
-
-    if(!*table)
-    {
-	*table = ajTableNewFunctionLen(ajSeqGetLen(seq),
-				       &wordCmpStr, &wordStrHash,
-                                       &ajMemFree, &wordVFreeLocs);
-	ajDebug("make new table\n");
+	return 0;
     }
 
     /* initialise ptr to start of seq string */
@@ -702,13 +752,15 @@ AjBool embWordGetTable(AjPTable *table, const AjPSeq seq)
 		ajDebug("sequence has no word without ambiguity code '%c'\n",
 			skipchar);
 
-		return ajFalse;
+		return 0;
 	    }
 	}
 	else
 	    j++;
     }
 
+    AJCNEW(starts, ilast - i + 1);
+
     j = wordLength - 1;
 
     while(i <= ilast)
@@ -729,7 +781,81 @@ AjBool embWordGetTable(AjPTable *table, const AjPSeq seq)
 	    continue;
 	}
 
-	rec = (EmbPWord) ajTableFetchmodV(*table, startptr);
+	starts[nstarts++] = i;
+
+	startptr++;
+	i++;
+
+    }
+
+    *Pstarts = starts;
+
+    return nstarts;
+}
+
+
+
+
+/* @funcstatic wordGetTable ***************************************************
+**
+** Builds a table of all words in a sequence, in either a word table or
+** an inline key word table.
+**
+** The word length must be defined by a call to embWordLength.
+**
+** @param [u] table [AjPTable*] Word table to be created or updated, or NULL
+** @param [u] itable [AjPTableinline*] Inline key word table to be created
+**                                     or updated if table is NULL
+** @param [r] seq [const AjPSeq] Sequence to be "worded"
+** @return [AjBool] ajTrue if successful
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static AjBool wordGetTable(AjPTable *table, AjPTableinline *itable,
+                           const AjPSeq seq)
+{
+    const char * seqstr;
+    const char * startptr;
+    ajuint i;
+    ajuint nstarts;
+    ajuint *starts = NULL;
+    ajuint *k;
+    EmbPWord rec;
+    EmbPWordSeqLocs seqlocs;
+    const AjPStr seqname;
+    char* key;
+
+    nstarts = wordGetStarts(seq, &starts);
+
+    if(!nstarts)
+	return ajFalse;
+
+    if(table && !*table)
+    {
+	*table = ajTableNewFunctionLen(ajSeqGetLen(seq),
+				       &wordCmpStr, &wordStrHash,
+                                       &ajMemFree, &wordVFreeLocs);
+	ajDebug("make new table\n");
+    }
+    else if(!table && !*itable)
+    {
+	*itable = ajTableinlineNewWordCase(ajSeqGetLen(seq)/4, wordLength);
+	ajDebug("make new inline table\n");
+    }
+
+    seqstr = ajSeqGetSeqC(seq);
+    seqname = ajSeqGetNameS(seq);
+
+    for(i = 0; i < nstarts; i++)
+    {
+	startptr = &seqstr[starts[i]];
+
+	if(table)
+	    rec = (EmbPWord) ajTableFetchmodV(*table, startptr);
+	else
+	    rec = (EmbPWord) ajTableinlineFetchmodC(*itable, startptr);
 
 	/* does it exist already */
 	if(rec)
@@ -737,20 +863,28 @@ AjBool embWordGetTable(AjPTable *table, const AjPSeq seq)
 	    /* if yes increment count */
 	    rec->count++;
 	}
-	else
+	else if(table)
 	{
 	    /* else create a new word */
 	    AJNEW0(rec);
 	    rec->count = 1;
-	    key = ajCharNewResLenC(startptr, wordsize, wordLength);
+	    key = ajCharNewResLenC(startptr, wordLength+1, wordLength);
 	    rec->fword = key;
 	    rec->seqlocs = ajTablestrNew(1000);
 	    ajTablePut(*table, key, rec);
 	}
+	else
+	{
+	    /* the inline table holds the key, location tables grow as needed */
+	    AJNEW0(rec);
+	    rec->count = 1;
+	    ajTableinlinePutC(*itable, startptr, rec);
+	    rec->fword = ajTableinlineFetchkeyC(*itable, startptr);
+	    rec->seqlocs = ajTablestrNew(1);
+	}
 
 	AJNEW0(k);
-	*k = i;
-	seqname = ajSeqGetNameS(seq);
+	*k = starts[i];
 	seqlocs = (EmbPWordSeqLocs) ajTableFetchmodS(rec->seqlocs, seqname);
 
 	if (seqlocs == NULL)
@@ -762,13 +896,297 @@ AjBool embWordGetTable(AjPTable *table, const AjPSeq seq)
 	}
 
 	ajListPushAppend(seqlocs->locs, k);
+    }
 
-	startptr++;
-	i++;
+    AJFREE(starts);
+
+    if(table)
+	ajDebug("table done, size %Lu\n", ajTableGetLength(*table));
+    else
+	ajDebug("inline table done, size %Lu\n",
+		ajTableinlineGetLength(*itable));
+
+    return ajTrue;
+}
 
+
+
+
+/* @func embWordGetTable ******************************************************
+**
+** Builds a table of all words in a sequence.
+**
+** The word length must be defined by a call to embWordLength.
+**
+** @param [u] table [AjPTable*] table to be created or updated.
+** @param [r] seq [const AjPSeq] Sequence to be "worded"
+** @return [AjBool] ajTrue if successful
+**
+** @release 1.0.0
+** @@
+******************************************************************************/
+
+AjBool embWordGetTable(AjPTable *table, const AjPSeq seq)
+{
+    return wordGetTable(table, NULL, seq);
+}
+
+
+
+
+/* @funcstatic wordIndexBase **************************************************
+**
+** Returns the 2-bit code of a nucleotide base for a packed word index.
+**
+** @param [r] c [char] Base
+** @return [ajint] Code 0 to 3 for A, C, G, T in either case, otherwise -1
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static ajint wordIndexBase(char c)
+{
+    switch(c)
+    {
+        case 'A':
+        case 'a':
+            return 0;
+        case 'C':
+        case 'c':
+            return 1;
+        case 'G':
+        case 'g':
+            return 2;
+        case 'T':
+        case 't':
+            return 3;
+        default:
+            break;
     }
 
-    ajDebug("table done, size %Lu\n", ajTableGetLength(*table));
+    return -1;
+}
+
+
+
+
+/* @funcstatic wordIndexMask **************************************************
+**
+** Returns the bit mask for a packed word of a given length
+**
+** @param [r] wordlen [ajuint] Word length, at most WORDINDEX_MAXLEN
+** @return [ajulong] Mask of the low 2*wordlen bits
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static ajulong wordIndexMask(ajuint wordlen)
+{
+    if(wordlen >= WORDINDEX_MAXLEN)
+        return ~((ajulong) 0);
+
+    return ((ajulong) 1 << (2 * wordlen)) - 1;
+}
+
+
+
+
+/* @func embWordGetIndex ******************************************************
+**
+** Builds an index of all words in a sequence, for use by
+** embWordBuildMatchIndex.
+**
+** The word length must be defined by a call to embWordLength.
+**
+** For nucleotide sequences with words of up to 32 bases, each word is
+** packed into 2 bits per base. The start positions of each word are
+** sorted by packed word with a counting sort into one array, with an
+** array of offsets to the first position of each word. For short words
+** the offsets are indexed by packed word, otherwise the offsets of the
+** words found are held in an inline key table.
+**
+** Protein sequences, longer words, and words with bases other than
+** A, C, G or T use an inline key word table instead.
+**
+** Any existing index is deleted.
+**
+** @param [w] Pindex [EmbPWordIndex*] Index to be created
+** @param [r] seq [const AjPSeq] Sequence to be "worded"
+** @return [AjBool] ajTrue if successful
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjBool embWordGetIndex(EmbPWordIndex* Pindex, const AjPSeq seq)
+{
+    EmbPWordIndex index;
+    const char *seqstr;
+    ajuint *starts = NULL;
+    ajuint *order  = NULL;
+    ajuint *sorted = NULL;
+    ajuint *counts = NULL;
+    ajuint *swap;
+    ajulong *kmers = NULL;
+    ajulong kmer = 0;
+    ajulong mask;
+    ajulong nkmers;
+    ajuint nstarts;
+    ajuint next = 0;
+    ajuint i;
+    ajuint j;
+    ajuint shift;
+    ajint base;
+
+    embWordFreeIndex(Pindex);
+
+    AJNEW0(index);
+    index->Seq     = seq;
+    index->Wordlen = wordLength;
+    *Pindex = index;
+
+    if(!ajSeqIsNuc(seq) || wordLength > WORDINDEX_MAXLEN)
+        return wordGetTable(NULL, &index->Table, seq);
+
+    nstarts = wordGetStarts(seq, &starts);
+
+    if(!nstarts)
+        return ajFalse;
+
+    seqstr = ajSeqGetSeqC(seq);
+    mask   = wordIndexMask(wordLength);
+
+    AJCNEW(kmers, nstarts);
+
+    /* pack each word, continuing from the previous word where possible */
+
+    for(i = 0; i < nstarts; i++)
+    {
+        if(!i || starts[i] != starts[i-1] + 1)
+        {
+            kmer = 0;
+            next = starts[i];
+        }
+
+        for(; next < starts[i] + wordLength; next++)
+        {
+            base = wordIndexBase(seqstr[next]);
+
+            if(base < 0)
+                break;
+
+            kmer = ((kmer << 2) | (ajulong) base) & mask;
+        }
+
+        if(next < starts[i] + wordLength)
+        {
+            ajDebug("embWordGetIndex '%c' at %u, using word table\n",
+                    seqstr[next], next+1);
+            AJFREE(starts);
+            AJFREE(kmers);
+
+            return wordGetTable(NULL, &index->Table, seq);
+        }
+
+        kmers[i] = kmer;
+    }
+
+    index->Npos = nstarts;
+    AJCNEW(index->Positions, nstarts);
+
+    if(wordLength < WORDINDEX_MAXDIRECT &&
+       ((ajulong) 1 << (2 * wordLength)) <= WORDINDEX_DIRECT * nstarts)
+    {
+        /* offsets indexed by packed word, counted and scattered in place */
+
+        index->Direct = ajTrue;
+        nkmers = (ajulong) 1 << (2 * wordLength);
+        AJCNEW0(index->Offsets, nkmers + 1);
+
+        for(i = 0; i < nstarts; i++)
+            index->Offsets[kmers[i] + 1]++;
+
+        for(kmer = 1; kmer <= nkmers; kmer++)
+            index->Offsets[kmer] += index->Offsets[kmer-1];
+
+        for(i = 0; i < nstarts; i++)
+            index->Positions[index->Offsets[kmers[i]]++] = starts[i];
+
+        for(kmer = nkmers; kmer > 0; kmer--)
+            index->Offsets[kmer] = index->Offsets[kmer-1];
+
+        index->Offsets[0] = 0;
+    }
+    else
+    {
+        /* stable radix sort of the packed words, WORDINDEX_BITS at a time */
+
+        AJCNEW(order, nstarts);
+        AJCNEW(sorted, nstarts);
+        AJCNEW(counts, WORDINDEX_RADIX);
+
+        for(i = 0; i < nstarts; i++)
+            order[i] = i;
+
+        for(shift = 0; shift < 2 * wordLength; shift += WORDINDEX_BITS)
+        {
+            AJCSET0(counts, WORDINDEX_RADIX);
+
+            for(i = 0; i < nstarts; i++)
+                counts[(kmers[order[i]] >> shift) & (WORDINDEX_RADIX-1)]++;
+
+            for(j = 0, next = 0; j < WORDINDEX_RADIX; j++)
+            {
+                kmer = counts[j];
+                counts[j] = next;
+                next += (ajuint) kmer;
+            }
+
+            for(i = 0; i < nstarts; i++)
+                sorted[counts[(kmers[order[i]] >> shift) &
+                              (WORDINDEX_RADIX-1)]++] = order[i];
+
+            swap   = order;
+            order  = sorted;
+            sorted = swap;
+        }
+
+        nkmers = 1;
+
+        for(i = 1; i < nstarts; i++)
+            if(kmers[order[i]] != kmers[order[i-1]])
+                nkmers++;
+
+        AJCNEW(index->Offsets, nkmers + 1);
+        index->Kmers = ajTableinlineNewUlong(nkmers);
+
+        for(i = 0, j = 0; i < nstarts; i++)
+        {
+            if(!i || kmers[order[i]] != kmers[order[i-1]])
+            {
+                index->Offsets[j] = i;
+                ajTableinlinePutUlong(index->Kmers, kmers[order[i]],
+                                      &index->Offsets[j]);
+                j++;
+            }
+
+            index->Positions[i] = starts[order[i]];
+        }
+
+        index->Offsets[nkmers] = nstarts;
+
+        AJFREE(order);
+        AJFREE(sorted);
+        AJFREE(counts);
+    }
+
+    ajDebug("embWordGetIndex %u words %s\n",
+            nstarts, index->Direct ? "direct" : "sorted");
+
+    AJFREE(starts);
+    AJFREE(kmers);
 
     return ajTrue;
 }
@@ -940,7 +1358,147 @@ static ajint wordMatchCmpPos(const void* v1, const void* v2)
 
 
 
-/* @func embWordBuildMatchTable ***********************************************
+/* @funcstatic wordCurIterNew *************************************************
+**
+** Returns an iterator over the ongoing matches, or NULL if there are none
+** so that new matches are appended to the list.
+**
+** @return [AjIList] Iterator over the ongoing matches
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static AjIList wordCurIterNew(void)
+{
+    if(!ajListGetLength(wordCurList))
+        return NULL;
+
+    /*ajDebug("wordCurList size %d\n",
+      ajListGetLength(wordCurList));*/
+
+    return ajListIterNew(wordCurList);
+}
+
+
+
+
+/* @funcstatic wordMatchPos ***************************************************
+**
+** Extends an ongoing match with a word found at a position in the first
+** sequence, or starts a new match.
+**
+** @param [u] hitlist [AjPList] List of all matches
+** @param [u] curiter [AjIList] Iterator over the ongoing matches, or NULL
+** @param [r] seq2 [const AjPSeq] Second sequence
+** @param [r] i [ajuint] Word position in the second sequence
+** @param [r] knew [ajuint] Word position in the first sequence
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void wordMatchPos(AjPList hitlist, AjIList curiter,
+                         const AjPSeq seq2, ajuint i, ajuint knew)
+{
+    EmbPWordMatch newmatch;
+    EmbPWordMatch curmatch = NULL;
+    ajuint kcur = 0;
+    ajuint kcur2 = 0;
+    AjBool matched = ajFalse;
+
+    /*ajDebug("knew: %u i:%u\n", knew, i);*/
+    /* compare to current hits to test for extending */
+
+    ajListIterRewind(curiter);
+
+    while(!ajListIterDone(curiter) )
+    {
+        curmatch = ajListIterGet(curiter);
+        kcur = curmatch->seq1start + curmatch->length -
+            wordLength + 1;
+        kcur2 = curmatch->seq2start + curmatch->length -
+            wordLength + 1;
+        /*ajDebug(".test kcur/knew %u/%u kcur2/i %u/%u\n",
+          kcur, knew, kcur2, i);*/
+
+        /* when we test, we may have already incremented
+           one of the matches - so test old and new kcur2 */
+        if(kcur2 != i && kcur2 != i+1)
+        {
+            /*ajDebug("finished kcur: %u kcur2: %u i: %u\n",
+              kcur, kcur2,i);*/
+            ajListIterRemove(curiter);
+            continue;
+        }
+
+        if(kcur == knew && kcur2 == i)
+        {			/* check continued matches */
+            curmatch->length++;
+            matched = ajTrue;
+            continue;
+        }
+    }
+
+    if(!matched)
+    {			/* new current match */
+        /* add to hitlist */
+        newmatch = embWordMatchNew(seq2, knew, i, wordLength);
+        ajListPushAppend(hitlist, newmatch);
+
+        if(curiter)
+        {			/* add to wordCurList */
+            /*ajDebug("...ajListInsert using curiter %u\n",
+              ajListGetLength(wordCurList));*/
+            wordListInsertOld(curiter, newmatch);
+        }
+        else
+        {
+            /*ajDebug("...ajListPushAppend to wordCurList %u\n",
+              ajListGetLength(wordCurList));*/
+            ajListPushAppend(wordCurList, newmatch);
+        }
+    }
+
+    return;
+}
+
+
+
+
+/* @funcstatic wordMatchDone **************************************************
+**
+** Completes a list of matches, ordering it if requested, and clears the
+** ongoing matches.
+**
+** @param [u] hitlist [AjPList] List of all matches
+** @param [r] orderit [ajint] 1 to sort results, else 0.
+** @return [void]
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+static void wordMatchDone(AjPList hitlist, ajint orderit)
+{
+    void *ptr = NULL;
+
+    /* wordCurListTrace(hitlist); */
+    if(orderit)
+	wordOrderMatchTable(hitlist);
+
+    /* wordCurListTrace(hitlist); */
+
+    while(ajListPop(wordCurList,(void **)&ptr));
+
+    return;
+}
+
+
+
+
+/* @funcstatic wordBuildMatchTable ********************************************
 **
 ** Create a linked list of all the matches and order them by the
 ** second sequence.
@@ -951,19 +1509,21 @@ static ajint wordMatchCmpPos(const void* v1, const void* v2)
 **                 which is a list of items in "all hits" being updated
 **   (c) new hits, found in the word table from the other sequence.
 **
-** @param [r] seq1MatchTable [const AjPTable] Match table
+** @param [r] table [const AjPTable] Match table, or NULL
+** @param [r] itable [const AjPTableinline] Inline key match table
+**                                          if table is NULL
 ** @param [r] seq2 [const AjPSeq] Second sequence
 ** @param [r] orderit [ajint] 1 to sort results at end, else 0.
 ** @return [AjPList] List of matches.
 ** @error NULL table was not built due to an error.
 **
-** @release 1.0.0
+** @release 6.6.0
 ** @@
 ******************************************************************************/
 
-AjPList embWordBuildMatchTable(const AjPTable seq1MatchTable,
-			       const AjPSeq seq2,
-				ajint orderit)
+static AjPList wordBuildMatchTable(const AjPTable table,
+                                   const AjPTableinline itable,
+                                   const AjPSeq seq2, ajint orderit)
 {
     ajuint i = 0;
     ajuint ilast;
@@ -973,17 +1533,10 @@ AjPList embWordBuildMatchTable(const AjPTable seq1MatchTable,
     EmbPWordSeqLocs* seqlocs=NULL;
     const char *startptr;
     EmbPWord wordmatch;
-    EmbPWordMatch newmatch;
-    EmbPWordMatch curmatch = NULL;
     AjIList newiter;
     AjIList curiter;
-    void *ptr = NULL;
 
     ajint *k = 0;
-    ajuint kcur = 0;
-    ajuint kcur2 = 0;
-    ajuint knew = 0;
-    AjBool matched = ajFalse;
 
     assert(wordLength > 0);
 
@@ -1003,11 +1556,16 @@ AjPList embWordBuildMatchTable(const AjPTable seq1MatchTable,
     startptr = ajSeqGetSeqC(seq2);
     ilast    = ajSeqGetLen(seq2) - wordLength;
 
-    /*ajDebug("embWordBuildMatchTable ilast: %u\n", ilast);*/
+    /*ajDebug("wordBuildMatchTable ilast: %u\n", ilast);*/
 
     while(i < (ilast+1))
     {
-	if((wordmatch = ajTableFetchmodV(seq1MatchTable, startptr)))
+	if(table)
+	    wordmatch = ajTableFetchmodV(table, startptr);
+	else
+	    wordmatch = ajTableinlineFetchmodC(itable, startptr);
+
+	if(wordmatch)
 	{
 	    /* match found so create EmbSWordMatch structure and fill it
 	    ** in. Then set next pos accordingly
@@ -1031,89 +1589,12 @@ AjPList embWordBuildMatchTable(const AjPTable seq1MatchTable,
 
 	    /* this is the list of matches for the current word and position */
 
-	    if(ajListGetLength(wordCurList))
-	    {
-                /*ajDebug("wordCurList size %d\n",
-                  ajListGetLength(wordCurList));*/
-		curiter = ajListIterNew(wordCurList);
-
-		curmatch = ajListIterGet(curiter);
-		kcur = curmatch->seq1start + curmatch->length - wordLength + 1;
-		kcur2 = curmatch->seq2start + curmatch->length - wordLength + 1;
-	    }
-	    else
-		curiter = NULL;
+	    curiter = wordCurIterNew();
 
 	    while(!ajListIterDone(newiter) )
 	    {
 		k = (ajint*) ajListIterGet(newiter);
-		knew = *k;
-
-                /*ajDebug("knew: %u i:%u\n", knew, i);*/
-		/* compare to current hits to test for extending */
-
-                ajListIterRewind(curiter);
-                matched = ajFalse;
-
-                while(!ajListIterDone(curiter) )
-                {
-		    curmatch = ajListIterGet(curiter);
-		    kcur = curmatch->seq1start + curmatch->length -
-                        wordLength + 1;
-                    kcur2 = curmatch->seq2start + curmatch->length -
-                        wordLength + 1;
-                    /*ajDebug(".test kcur/knew %u/%u kcur2/i %u/%u\n",
-                      kcur, knew, kcur2, i);*/
-
-                    /* when we test, we may have already incremented
-                       one of the matches - so test old and new kcur2 */
-                    if(kcur2 != i && kcur2 != i+1)
-                    {
-                        /*ajDebug("finished kcur: %u kcur2: %u i: %u\n",
-                          kcur, kcur2,i);*/
-                        ajListIterRemove(curiter);
-                        continue;
-                    }
-
-                    if(kcur == knew && kcur2 == i)
-                    {			/* check continued matches */
-                        /* ajDebug("**match knew: %d kcur: %d kcur2: %d "
-                           "start1: %d "
-                                "start2: %d len: %d i:%d\n",
-                                knew, kcur, kcur2,curmatch->seq1start,
-                                curmatch->seq2start,curmatch->length, i);*/
-			curmatch->length++;
-                        matched = ajTrue;
-                        continue;
-                    }
-                }
-
-                if(!matched)
-                {			/* new current match */
-                    /*ajDebug("save start1: %d start2: %d len: %d\n",
-                            match2->seq1start, match2->seq2start,
-                            match2->length);*/
-                    /* add to hitlist */
-                    newmatch = embWordMatchNew(seq2, knew, i, wordLength);
-                    ajListPushAppend(hitlist, newmatch);
-
-                    if(curiter)
-                    {			/* add to wordCurList */
-                        /*ajDebug("...ajListInsert using curiter %u\n",
-                          ajListGetLength(wordCurList));*/
-                        wordListInsertOld(curiter, newmatch);
-                        /*wordCurListTrace(wordCurList);*/
-                        /*wordCurIterTrace(curiter);*/
-                    }
-                    else
-                    {
-                        /*ajDebug("...ajListPushAppend to wordCurList %u\n",
-                          ajListGetLength(wordCurList));*/
-                        ajListPushAppend(wordCurList, newmatch);
-                        /* wordCurListTrace(wordCurList); */
-                    }
-                }
- 		/* ajDebug("k: %d i: %d\n", *k, i); */
+		wordMatchPos(hitlist, curiter, seq2, i, *k);
 	    }
 
 	    ajListIterDel(&newiter);
@@ -1127,13 +1608,141 @@ AjPList embWordBuildMatchTable(const AjPTable seq1MatchTable,
 	startptr++;
     }
 
-    /* wordCurListTrace(hitlist); */
-    if(orderit)
-	wordOrderMatchTable(hitlist);
+    wordMatchDone(hitlist, orderit);
 
-    /* wordCurListTrace(hitlist); */
+    return hitlist;
+}
 
-    while(ajListPop(wordCurList,(void **)&ptr));
+
+
+
+/* @func embWordBuildMatchTable ***********************************************
+**
+** Create a linked list of all the matches and order them by the
+** second sequence.
+**
+** We need three lists:
+**   (a) all hits, added in positional order
+**   (b) ongoing hits, where we have not reached the end yet
+**                 which is a list of items in "all hits" being updated
+**   (c) new hits, found in the word table from the other sequence.
+**
+** @param [r] seq1MatchTable [const AjPTable] Match table
+** @param [r] seq2 [const AjPSeq] Second sequence
+** @param [r] orderit [ajint] 1 to sort results at end, else 0.
+** @return [AjPList] List of matches.
+** @error NULL table was not built due to an error.
+**
+** @release 1.0.0
+** @@
+******************************************************************************/
+
+AjPList embWordBuildMatchTable(const AjPTable seq1MatchTable,
+			       const AjPSeq seq2,
+				ajint orderit)
+{
+    return wordBuildMatchTable(seq1MatchTable, NULL, seq2, orderit);
+}
+
+
+
+
+/* @func embWordBuildMatchIndex ***********************************************
+**
+** Create a linked list of all the matches with a word index and order
+** them by the second sequence.
+**
+** Gives the same list as embWordBuildMatchTable with a word table built
+** from the same sequence.
+**
+** @param [r] seq1Index [const EmbPWordIndex] Word index
+** @param [r] seq2 [const AjPSeq] Second sequence
+** @param [r] orderit [ajint] 1 to sort results at end, else 0.
+** @return [AjPList] List of matches.
+**
+** @release 6.6.0
+** @@
+******************************************************************************/
+
+AjPList embWordBuildMatchIndex(const EmbPWordIndex seq1Index,
+                               const AjPSeq seq2,
+                               ajint orderit)
+{
+    ajuint i;
+    ajuint j;
+    ajuint ilen;
+    ajuint ipos;
+    ajuint nbases = 0;
+    ajint base;
+    ajulong kmer = 0;
+    ajulong mask;
+    const char *seqstr;
+    const ajuint *offset;
+    AjPList hitlist = NULL;
+    AjIList curiter;
+
+    if(seq1Index->Table)
+        return wordBuildMatchTable(NULL, seq1Index->Table, seq2, orderit);
+
+    assert(wordLength == seq1Index->Wordlen);
+
+    hitlist = ajListNew();
+
+    if(!wordCurList)
+	wordCurList = ajListNew();
+
+    if(ajSeqGetLen(seq2) < wordLength)
+    {
+	ajWarn("ERROR: Sequence %S length %d less than word length %d",
+	       ajSeqGetUsaS(seq2), ajSeqGetLen(seq2), wordLength);
+
+	return hitlist;
+    }
+
+    seqstr = ajSeqGetSeqC(seq2);
+    ilen   = ajSeqGetLen(seq2);
+    mask   = wordIndexMask(wordLength);
+
+    /*
+    ** words with any base other than ACGT cannot be in the index,
+    ** so only look up words after wordLength packed bases
+    */
+
+    for(j = 0; j < ilen; j++)
+    {
+        base = wordIndexBase(seqstr[j]);
+
+        if(base < 0)
+        {
+            nbases = 0;
+            continue;
+        }
+
+        kmer = ((kmer << 2) | (ajulong) base) & mask;
+
+        if(++nbases < wordLength)
+            continue;
+
+        if(seq1Index->Direct)
+            offset = &seq1Index->Offsets[kmer];
+        else
+            offset = ajTableinlineFetchUlong(seq1Index->Kmers, kmer);
+
+        if(!offset || offset[1] == offset[0])
+            continue;
+
+        i = j + 1 - wordLength;
+
+        curiter = wordCurIterNew();
+
+        for(ipos = offset[0]; ipos < offset[1]; ipos++)
+            wordMatchPos(hitlist, curiter, seq2, i,
+                         seq1Index->Positions[ipos]);
+
+        ajListIterDel(&curiter);
+    }
+
+    wordMatchDone(hitlist, orderit);
 
     return hitlist;
 }
@@ -122,6 +122,43 @@ typedef struct EmbSWordSeqLocs {
 
 
 
+
+/* @data EmbPWordIndex ********************************************************
+**
+** NUCLEUS data structure for an index of the words in a sequence
+**
+** Nucleotide words are packed into 2 bits per base. Their start positions
+** are held in one array in order of packed word, with an array of offsets
+** to the first position of each word. Other sequences use a word table.
+**
+** @attr Table [AjPTableinline] Word table if words could not be packed
+** @attr Kmers [AjPTableinline] Offsets by packed word, if not Direct
+** @attr Offsets [ajuint*] Offsets of the positions of each word, with the
+**                         total number of positions as the last element
+** @attr Positions [ajuint*] Word start positions
+** @attr Seq [const AjPSeq] Indexed sequence
+** @attr Npos [ajuint] Number of word start positions
+** @attr Wordlen [ajuint] Word length
+** @attr Direct [AjBool] True if Offsets is indexed by packed word
+** @attr Padding [char[4]] Padding to alignment boundary
+** @@
+******************************************************************************/
+
+typedef struct EmbSWordIndex {
+  AjPTableinline Table;
+  AjPTableinline Kmers;
+  ajuint* Offsets;
+  ajuint* Positions;
+  const AjPSeq Seq;
+  ajuint Npos;
+  ajuint Wordlen;
+  AjBool Direct;
+  char Padding[4];
+} EmbOWordIndex;
+#define EmbPWordIndex EmbOWordIndex*
+
+
+
 /* @data EmbPWordRK ***********************************************************
 **
 ** Data structure that extends EmbPWord objects for efficient access
@@ -177,11 +214,15 @@ typedef struct EmbSWordRK {
 ** Prototype definitions
 */
 
+AjPList embWordBuildMatchIndex (const EmbPWordIndex seq1Index,
+				const AjPSeq seq2, ajint orderit);
 AjPList embWordBuildMatchTable (const AjPTable seq1MatchTable,
 				const AjPSeq seq2, ajint orderit);
 void    embWordClear (void);
 void    embWordExit(void);
+void    embWordFreeIndex(EmbPWordIndex *Pindex);
 void    embWordFreeTable(AjPTable *table);
+AjBool  embWordGetIndex (EmbPWordIndex *Pindex, const AjPSeq seq);
 AjBool  embWordGetTable (AjPTable *table, const AjPSeq seq);
 void    embWordLength (ajint wordlen);
 AjBool  embWordMatchIter (AjIList iter, ajint* start1, ajint* start2,